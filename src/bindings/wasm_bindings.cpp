@@ -13,21 +13,108 @@ using namespace memory_engine;
 // Global engine instance
 static Engine g_engine;
 
+// Background runs: one at a time. While a job runs the engine belongs to
+// the worker, so calls that touch it fail (false or null) until it ends;
+// getOccupancy and the job functions stay available.
+static BenchmarkJob g_job;
+
+struct JobResult {
+    bool concurrency = false;   ///< Which member holds the result
+    BenchmarkMetrics benchmark;
+    ConcurrencyMetrics concurrency_metrics;
+};
+static JobResult g_job_result;
+
+static bool engineBusy() {
+    return g_job.state() == JobState::RUNNING;
+}
+
 // JavaScript-accessible functions
-int setAllocator(int type) {
-    g_engine.set_allocator(static_cast<AllocatorType>(type));
-    return 0;
+// Registry id, e.g. "pool"; false if no allocator has that id
+bool setAllocator(const std::string& id) {
+    if (engineBusy()) return false;
+    return g_engine.set_allocator(id);
 }
 
-val runBenchmark(int objectSize, int objectCount, int iterations, int alignment) {
+// Every registered allocator with its capabilities and parameters
+val listAllocators() {
+    val result = val::array();
+    size_t index = 0;
+    for (const auto& entry : g_engine.registry().entries()) {
+        val allocator = val::object();
+        allocator.set("id", entry.id);
+        allocator.set("name", entry.display_name);
+        allocator.set("threadSafe", entry.capabilities.thread_safe);
+        allocator.set("arbitraryFree", entry.capabilities.arbitrary_free);
+        allocator.set("fixedSize", entry.capabilities.fixed_size);
+        allocator.set("numaBindable", entry.capabilities.numa_bindable);
+
+        val parameters = val::array();
+        size_t parameter_index = 0;
+        for (const auto& parameter : entry.parameters) {
+            val item = val::object();
+            item.set("name", parameter.name);
+            item.set("default", static_cast<double>(parameter.default_value));
+            item.set("description", parameter.description);
+            parameters.set(parameter_index++, item);
+        }
+        allocator.set("parameters", parameters);
+        result.set(index++, allocator);
+    }
+    return result;
+}
+
+// Rebuild an allocator from a { name: value } object; false on an unknown
+// id or parameter, or values the allocator cannot be built with
+bool configureAllocator(const std::string& id, val values) {
+    if (engineBusy()) return false;
+    AllocatorParams params;
+    val names = val::global("Object").call<val>("keys", values);
+    const size_t count = names["length"].as<size_t>();
+    for (size_t i = 0; i < count; ++i) {
+        std::string name = names[i].as<std::string>();
+        double value = values[name].as<double>();
+        if (!(value >= 0)) return false;
+        params.set(name, static_cast<size_t>(value));
+    }
+    return g_engine.configure_allocator(id, params);
+}
+
+// Percentiles plus the non-empty buckets as [lowerNs, upperNs, count]
+val histogramToVal(const LatencyHistogram& histogram) {
+    val result = val::object();
+    result.set("count", static_cast<double>(histogram.count()));
+    result.set("min", static_cast<double>(histogram.min()));
+    result.set("max", static_cast<double>(histogram.max()));
+    result.set("mean", histogram.mean());
+    result.set("p50", histogram.percentile(50.0));
+    result.set("p90", histogram.percentile(90.0));
+    result.set("p99", histogram.percentile(99.0));
+    result.set("p999", histogram.percentile(99.9));
+
+    val buckets = val::array();
+    size_t index = 0;
+    histogram.for_each_bucket([&](uint64_t lower, uint64_t upper, uint64_t count) {
+        val bucket = val::array();
+        bucket.set(0, static_cast<double>(lower));
+        bucket.set(1, static_cast<double>(upper));
+        bucket.set(2, static_cast<double>(count));
+        buckets.set(index++, bucket);
+    });
+    result.set("buckets", buckets);
+    return result;
+}
+
+BenchmarkConfig benchmarkConfig(int objectSize, int objectCount, int iterations, int alignment) {
     BenchmarkConfig config;
     config.object_size = objectSize;
     config.object_count = objectCount;
     config.iterations = iterations;
     config.alignment = alignment;
+    return config;
+}
 
-    auto metrics = g_engine.run_benchmark(config);
-
+val benchmarkToVal(const BenchmarkMetrics& metrics) {
     val result = val::object();
     result.set("allocatorName", metrics.allocator_name);
     result.set("meanAllocTime", metrics.allocation_time.mean);
@@ -39,29 +126,188 @@ val runBenchmark(int objectSize, int objectCount, int iterations, int alignment)
     result.set("throughput", metrics.throughput);
     result.set("peakMemory", metrics.peak_memory);
     result.set("fragmentation", metrics.fragmentation);
+    result.set("failedAllocations", static_cast<double>(metrics.failed_allocations));
+    result.set("rejectedDeallocations", static_cast<double>(metrics.rejected_deallocations));
+    result.set("allocLatency", histogramToVal(metrics.alloc_latency));
+    result.set("deallocLatency", histogramToVal(metrics.dealloc_latency));
+    result.set("cancelled", metrics.cancelled);
     
     return result;
 }
 
-val runConcurrencyTest(int testType, int threadCount, int iterations, int workSize) {
+// Blocks the calling thread; the page uses startBenchmark instead
+val runBenchmark(int objectSize, int objectCount, int iterations, int alignment) {
+    if (engineBusy()) return val::null();
+    return benchmarkToVal(g_engine.run_benchmark(benchmarkConfig(objectSize, objectCount, iterations, alignment)));
+}
+
+ConcurrencyConfig concurrencyConfig(int threadCount, int iterations, int workSize) {
     ConcurrencyConfig config;
     config.thread_count = threadCount;
     config.iterations = iterations;
     config.work_size = workSize;
+    return config;
+}
 
-    auto metrics = g_engine.run_concurrency_test(static_cast<ConcurrencyTest>(testType), config);
-
+val concurrencyToVal(const ConcurrencyMetrics& metrics) {
     val result = val::object();
     result.set("testName", metrics.test_name);
+    result.set("threads", static_cast<double>(metrics.thread_count));
     result.set("totalTimeMs", metrics.total_time_ms);
     result.set("contentionTimeMs", metrics.contention_time_ms);
     result.set("throughput", metrics.throughput);
     result.set("threadEfficiency", metrics.thread_efficiency);
+    result.set("startLatency", histogramToVal(metrics.start_latency));
+    result.set("acquireLatency", histogramToVal(metrics.acquire_latency));
     
     return result;
 }
 
+val runConcurrencyTest(int testType, int threadCount, int iterations, int workSize) {
+    if (engineBusy()) return val::null();
+    return concurrencyToVal(g_engine.run_concurrency_test(static_cast<ConcurrencyTest>(testType),
+                                                          concurrencyConfig(threadCount, iterations, workSize)));
+}
+
+// Route the engine's progress and cancellation through the job for one run
+static void attachJob(BenchmarkJob& job) {
+    g_engine.set_progress_callback([&job](int percent, const std::string& status) { job.report(percent, status); });
+    g_engine.set_cancel_flag(job.cancel_flag());
+}
+
+static void detachJob() {
+    g_engine.set_progress_callback(nullptr);
+    g_engine.set_cancel_flag(nullptr);
+}
+
+// Starts runBenchmark on a worker; false if a job is already running
+bool startBenchmark(int objectSize, int objectCount, int iterations, int alignment) {
+    BenchmarkConfig config = benchmarkConfig(objectSize, objectCount, iterations, alignment);
+    return g_job.start([config](BenchmarkJob& job) {
+        attachJob(job);
+        g_job_result.concurrency = false;
+        g_job_result.benchmark = g_engine.run_benchmark(config);
+        detachJob();
+    });
+}
+
+// Concurrency tests report only start and end, and a cancel takes effect
+// once the running test returns
+bool startConcurrencyTest(int testType, int threadCount, int iterations, int workSize) {
+    ConcurrencyConfig config = concurrencyConfig(threadCount, iterations, workSize);
+    return g_job.start([testType, config](BenchmarkJob& job) {
+        job.report(0, "Starting");
+        g_job_result.concurrency = true;
+        g_job_result.concurrency_metrics = g_engine.run_concurrency_test(static_cast<ConcurrencyTest>(testType), config);
+        job.report(100, "Done");
+    });
+}
+
+void cancelBenchmark() {
+    g_job.cancel();
+}
+
+// Drains the progress ring: { state, jobId, dropped, events: [{ percent, status }] }.
+// Call once per animation frame while state is "running".
+val pollProgress() {
+    static const char* const STATE_NAMES[] = {"idle", "running", "finished", "cancelled"};
+    JobState state = g_job.state();
+
+    val events = val::array();
+    size_t index = 0;
+    ProgressEvent event;
+    while (g_job.poll(event)) {
+        if (event.job_id != g_job.job_id()) continue;
+        val item = val::object();
+        item.set("percent", event.percent);
+        item.set("status", std::string(event.status));
+        events.set(index++, item);
+    }
+
+    val result = val::object();
+    result.set("state", std::string(STATE_NAMES[static_cast<int>(state)]));
+    result.set("jobId", g_job.job_id());
+    result.set("dropped", static_cast<double>(g_job.dropped_events()));
+    result.set("events", events);
+    return result;
+}
+
+// The last job's result in the shape its run* function returns; null while
+// running or before any job
+val takeResult() {
+    JobState state = g_job.state();
+    if (state != JobState::FINISHED && state != JobState::CANCELLED) return val::null();
+    return g_job_result.concurrency ? concurrencyToVal(g_job_result.concurrency_metrics)
+                                    : benchmarkToVal(g_job_result.benchmark);
+}
+
+// Producer-consumer handoff through one of the QueueKind queues
+val runQueueBenchmark(int queueKind, int producers, int consumers, int iterations, int capacity) {
+    if (engineBusy()) return val::null();
+    ConcurrencyConfig config;
+    config.queue = static_cast<QueueKind>(queueKind);
+    config.producers = producers;
+    config.consumers = consumers;
+    config.iterations = iterations;
+    config.queue_capacity = capacity;
+
+    auto metrics = g_engine.run_concurrency_test(ConcurrencyTest::PRODUCER_CONSUMER, config);
+
+    val result = val::object();
+    result.set("testName", metrics.test_name);
+    result.set("totalTimeMs", metrics.total_time_ms);
+    result.set("throughput", metrics.throughput);
+    result.set("items", static_cast<double>(metrics.items));
+    result.set("handoffLatency", histogramToVal(metrics.handoff_latency));
+
+    return result;
+}
+
+// Every lock implementation at 1, 2, 4, ... threads up to threadCount
+val runLockSweep(int threadCount, int iterations, int workSize, double readRatio) {
+    if (engineBusy()) return val::null();
+    ConcurrencyConfig config;
+    config.thread_count = threadCount;
+    config.iterations = iterations;
+    config.work_size = workSize;
+    config.read_ratio = readRatio;
+
+    val results = val::array();
+    size_t index = 0;
+    for (const auto& metrics : g_engine.run_lock_sweep(config)) {
+        val result = val::object();
+        result.set("testName", metrics.test_name);
+        result.set("threads", static_cast<double>(metrics.thread_count));
+        result.set("totalTimeMs", metrics.total_time_ms);
+        result.set("throughput", metrics.throughput);
+        result.set("acquireLatency", histogramToVal(metrics.acquire_latency));
+        results.set(index++, result);
+    }
+    return results;
+}
+
+// Counter layout x memory order sweep, one entry per combination
+val runCounterSweep(int threadCount, int iterations) {
+    if (engineBusy()) return val::null();
+    ConcurrencyConfig config;
+    config.thread_count = threadCount;
+    config.iterations = iterations;
+
+    val results = val::array();
+    size_t index = 0;
+    for (const auto& metrics : g_engine.run_counter_sweep(config)) {
+        val result = val::object();
+        result.set("testName", metrics.test_name);
+        result.set("totalTimeMs", metrics.total_time_ms);
+        result.set("throughput", metrics.throughput);
+        result.set("combineTimeNs", metrics.combine_time_ns);
+        results.set(index++, result);
+    }
+    return results;
+}
+
 val getStats() {
+    if (engineBusy()) return val::null();
     auto stats = g_engine.get_stats();
     
     val result = val::object();
@@ -76,27 +322,66 @@ val getStats() {
     return result;
 }
 
-val getMemoryGrid() {
-    auto grid = g_engine.get_memory_grid();
-    
-    val result = val::array();
-    for (size_t i = 0; i < grid.size(); ++i) {
-        result.set(i, grid[i]);
-    }
-    
+// Views straight into WASM memory: no copy and one boundary crossing. A view
+// is invalidated when memory grows or the allocator changes, so fetch it
+// again whenever version differs from the last draw.
+val levelsView(const OccupancyView& view) {
+    return val(typed_memory_view(view.cell_count, view.levels));
+}
+
+void setOccupancyTracking(bool enabled) {
+    if (engineBusy()) return;
+    g_engine.set_occupancy_tracking(enabled);
+}
+
+// { levels: Uint8Array (0 free .. 255 full per cell), cellCount, cellSize, span, highWater, version }
+val getOccupancy() {
+    OccupancyView view = g_engine.get_occupancy();
+    val result = val::object();
+    result.set("levels", levelsView(view));
+    result.set("cellCount", static_cast<double>(view.cell_count));
+    result.set("cellSize", static_cast<double>(view.cell_size));
+    result.set("span", static_cast<double>(view.span));
+    result.set("highWater", static_cast<double>(view.high_water));
+    result.set("version", static_cast<double>(view.version));
     return result;
 }
 
+// Cheap per-frame poll; redraw only when it changes
+double getOccupancyVersion() {
+    return static_cast<double>(g_engine.get_occupancy().version);
+}
+
+// Kept for older pages: the same levels view, which is truthy where used
+val getMemoryGrid() {
+    if (!g_engine.get_occupancy().levels && !engineBusy()) g_engine.set_occupancy_tracking(true);
+    return levelsView(g_engine.get_occupancy());
+}
+
 void resetAllocator() {
+    if (engineBusy()) return;
     g_engine.reset_current_allocator();
 }
 
 // Emscripten bindings
 EMSCRIPTEN_BINDINGS(memory_engine) {
     function("setAllocator", &setAllocator);
+    function("listAllocators", &listAllocators);
+    function("configureAllocator", &configureAllocator);
     function("runBenchmark", &runBenchmark);
     function("runConcurrencyTest", &runConcurrencyTest);
+    function("runQueueBenchmark", &runQueueBenchmark);
+    function("runLockSweep", &runLockSweep);
+    function("runCounterSweep", &runCounterSweep);
+    function("startBenchmark", &startBenchmark);
+    function("startConcurrencyTest", &startConcurrencyTest);
+    function("cancelBenchmark", &cancelBenchmark);
+    function("pollProgress", &pollProgress);
+    function("takeResult", &takeResult);
     function("getStats", &getStats);
     function("getMemoryGrid", &getMemoryGrid);
+    function("setOccupancyTracking", &setOccupancyTracking);
+    function("getOccupancy", &getOccupancy);
+    function("getOccupancyVersion", &getOccupancyVersion);
     function("resetAllocator", &resetAllocator);
 }
@@ -0,0 +1,196 @@
+/**
+ * @file allocator_adapters.hpp
+ * @brief std::pmr::memory_resource and STL Allocator adapters for BaseAllocator
+ *
+ * Lets standard containers draw their memory from any engine allocator:
+ *
+ *     PoolAllocator pool(64, 100000);
+ *     AllocatorResource resource(pool);
+ *     std::pmr::map<int, int> map(&resource);
+ *
+ *     std::vector<int, StlAllocator<int>> vec(StlAllocator<int>(pool));
+ *
+ * Fixed-size and fixed-capacity allocators cannot serve every request a
+ * container makes (a pool cannot hold a grown vector buffer), so both
+ * adapters hand such requests to a fallback resource, new/delete by default.
+ * Passing std::pmr::null_memory_resource() as the fallback makes them throw
+ * std::bad_alloc instead. Blocks that miss the requested alignment (pools
+ * and bitmaps ignore it) are handed back and take the fallback path too.
+ * Frees are routed by owns(), so allocators without tracks_ownership() (raw
+ * malloc) get no fallback: a failed request throws std::bad_alloc.
+ *
+ * @author Bambang Hutagalung
+ * @date 2026
+ */
+
+#ifndef ALLOCATOR_ADAPTERS_HPP
+#define ALLOCATOR_ADAPTERS_HPP
+
+#include "base_allocator.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <new>
+
+namespace memory_engine {
+
+namespace adapter_detail {
+
+// A block from allocator with the requested alignment, or nullptr. Pools,
+// bitmaps and the thread-cached pool ignore the alignment argument, so a
+// misaligned block is returned rather than handed to an over-aligned type.
+inline void* allocate_aligned(BaseAllocator& allocator, size_t bytes, size_t alignment) {
+    void* ptr = allocator.allocate(bytes, alignment);
+    if (ptr && (reinterpret_cast<uintptr_t>(ptr) & (alignment - 1)) != 0) {
+        allocator.deallocate(ptr);
+        return nullptr;
+    }
+    return ptr;
+}
+
+// The fallback to use when allocator refuses a request. owns() routes frees
+// back, so an allocator that claims every pointer must have no fallback.
+inline std::pmr::memory_resource* fallback_for(const BaseAllocator& allocator,
+                                               std::pmr::memory_resource* fallback) {
+    if (!fallback || !allocator.tracks_ownership()) return std::pmr::null_memory_resource();
+    return fallback;
+}
+
+} // namespace adapter_detail
+
+/**
+ * @class AllocatorResource
+ * @brief std::pmr::memory_resource over a BaseAllocator
+ *
+ * Not thread-safe beyond what the wrapped allocator provides; the fallback
+ * counters are plain integers.
+ */
+class AllocatorResource : public std::pmr::memory_resource {
+public:
+    /**
+     * @brief Constructor
+     * @param allocator Allocator to serve requests from; must outlive the resource
+     * @param fallback Resource for requests the allocator refuses; ignored
+     *        if the allocator does not track ownership
+     */
+    explicit AllocatorResource(BaseAllocator& allocator,
+                               std::pmr::memory_resource* fallback = std::pmr::new_delete_resource())
+        : m_allocator(&allocator)
+        , m_fallback(adapter_detail::fallback_for(allocator, fallback))
+    {
+    }
+
+    BaseAllocator& allocator() const { return *m_allocator; }
+    std::pmr::memory_resource* fallback() const { return m_fallback; }
+
+    /**
+     * @brief Get requests that went to the fallback resource
+     */
+    size_t fallback_allocations() const { return m_fallback_allocations; }
+
+    void reset_counters() { m_fallback_allocations = 0; }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        void* ptr = adapter_detail::allocate_aligned(*m_allocator, bytes ? bytes : 1, alignment);
+        if (ptr) return ptr;
+        m_fallback_allocations++;
+        return m_fallback->allocate(bytes, alignment); // Throws bad_alloc if it cannot
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+        if (m_allocator->owns(ptr)) {
+            m_allocator->deallocate(ptr);
+        } else {
+            m_fallback->deallocate(ptr, bytes, alignment);
+        }
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        auto* resource = dynamic_cast<const AllocatorResource*>(&other);
+        return resource && resource->m_allocator == m_allocator && resource->m_fallback == m_fallback;
+    }
+
+private:
+    BaseAllocator* m_allocator;
+    std::pmr::memory_resource* m_fallback;
+    size_t m_fallback_allocations = 0;
+};
+
+/**
+ * @class StlAllocator
+ * @brief C++ Allocator-concept adapter over a BaseAllocator
+ *
+ * A two-pointer value type, so containers can copy and rebind it freely;
+ * copies compare equal when they share the allocator and fallback. Unlike
+ * AllocatorResource it calls the engine allocator directly, without the
+ * extra virtual hop through memory_resource.
+ *
+ * @tparam T Value type
+ */
+template <typename T>
+class StlAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    /**
+     * @brief Constructor
+     * @param allocator Allocator to serve requests from; must outlive every copy
+     * @param fallback Resource for requests the allocator refuses; ignored
+     *        if the allocator does not track ownership
+     */
+    explicit StlAllocator(BaseAllocator& allocator,
+                          std::pmr::memory_resource* fallback = std::pmr::new_delete_resource()) noexcept
+        : m_allocator(&allocator)
+        , m_fallback(adapter_detail::fallback_for(allocator, fallback))
+    {
+    }
+
+    template <typename U>
+    StlAllocator(const StlAllocator<U>& other) noexcept
+        : m_allocator(other.allocator())
+        , m_fallback(other.fallback())
+    {
+    }
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) throw std::bad_array_new_length();
+        size_t bytes = n ? n * sizeof(T) : 1;
+        void* ptr = adapter_detail::allocate_aligned(*m_allocator, bytes, alignof(T));
+        if (!ptr) ptr = m_fallback->allocate(bytes, alignof(T));
+        return static_cast<T*>(ptr);
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept {
+        if (m_allocator->owns(ptr)) {
+            m_allocator->deallocate(ptr);
+        } else {
+            m_fallback->deallocate(ptr, n ? n * sizeof(T) : 1, alignof(T));
+        }
+    }
+
+    BaseAllocator* allocator() const noexcept { return m_allocator; }
+    std::pmr::memory_resource* fallback() const noexcept { return m_fallback; }
+
+    template <typename U>
+    bool operator==(const StlAllocator<U>& other) const noexcept {
+        return m_allocator == other.allocator() && m_fallback == other.fallback();
+    }
+
+    template <typename U>
+    bool operator!=(const StlAllocator<U>& other) const noexcept {
+        return !(*this == other);
+    }
+
+private:
+    BaseAllocator* m_allocator;
+    std::pmr::memory_resource* m_fallback;
+};
+
+} // namespace memory_engine
+
+#endif // ALLOCATOR_ADAPTERS_HPP
@@ -0,0 +1,200 @@
+/**
+ * @file allocator_registry.hpp
+ * @brief Name-keyed registry of allocator factories and their capabilities
+ *
+ * Each allocator header registers itself once with an id, a display name,
+ * capability flags and the parameters its factory takes. The engine, the
+ * command-line driver and the WASM API then enumerate the registry instead
+ * of keeping their own lists, so adding an allocator means adding its
+ * header and its MEMORY_ENGINE_REGISTER_ALLOCATOR line.
+ *
+ * @author Bambang Hutagalung
+ * @date 2026
+ */
+
+#ifndef ALLOCATOR_REGISTRY_HPP
+#define ALLOCATOR_REGISTRY_HPP
+
+#include "base_allocator.hpp"
+#include "../utils/numa.hpp"
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace memory_engine {
+
+/**
+ * @struct AllocatorCapabilities
+ * @brief What callers may assume without constructing the allocator
+ */
+struct AllocatorCapabilities {
+    bool thread_safe = false;      ///< allocate/deallocate may be called concurrently
+    bool arbitrary_free = true;    ///< Frees may come in any order (false: LIFO only)
+    bool fixed_size = false;       ///< Capacity is set at construction and does not grow
+    bool numa_bindable = false;    ///< Honours AllocatorParams::numa_node
+};
+
+/**
+ * @struct AllocatorParameter
+ * @brief One numeric factory parameter and its default
+ */
+struct AllocatorParameter {
+    std::string name;
+    size_t default_value = 0;
+    std::string description;
+};
+
+/**
+ * @class AllocatorParams
+ * @brief Parameter values for one factory call
+ *
+ * Values are looked up by name. AllocatorRegistry::create fills in the
+ * defaults of any parameter the caller left out, so factories can read
+ * every declared parameter with get().
+ */
+class AllocatorParams {
+public:
+    int numa_node = Numa::ANY_NODE;
+
+    AllocatorParams& set(const std::string& name, size_t value) {
+        for (auto& entry : m_values) {
+            if (entry.first == name) {
+                entry.second = value;
+                return *this;
+            }
+        }
+        m_values.emplace_back(name, value);
+        return *this;
+    }
+
+    bool has(const std::string& name) const {
+        for (const auto& entry : m_values) {
+            if (entry.first == name) return true;
+        }
+        return false;
+    }
+
+    size_t get(const std::string& name, size_t fallback = 0) const {
+        for (const auto& entry : m_values) {
+            if (entry.first == name) return entry.second;
+        }
+        return fallback;
+    }
+
+    const std::vector<std::pair<std::string, size_t>>& values() const { return m_values; }
+
+private:
+    std::vector<std::pair<std::string, size_t>> m_values;   ///< A handful at most; linear search is fine
+};
+
+/**
+ * @struct AllocatorDescriptor
+ * @brief Everything the registry knows about one allocator
+ */
+struct AllocatorDescriptor {
+    std::string id;                    ///< Stable lowercase key, e.g. "pool"
+    std::string display_name;          ///< Matches BaseAllocator::name() of the default instance
+    AllocatorCapabilities capabilities;
+    std::vector<AllocatorParameter> parameters;
+    std::function<std::unique_ptr<BaseAllocator>(const AllocatorParams&)> create;
+};
+
+/**
+ * @class AllocatorRegistry
+ * @brief Process-wide list of allocator descriptors, indexed by id
+ *
+ * Entries keep registration order, which for the built-in allocators is the
+ * order engine.hpp includes their headers. Lookup by id or index is O(1)
+ * and descriptors never move once added. Registration happens during static
+ * initialization and is not synchronized; register before starting threads.
+ */
+class AllocatorRegistry {
+public:
+    static AllocatorRegistry& instance() {
+        static AllocatorRegistry registry;
+        return registry;
+    }
+
+    /**
+     * @brief Add a descriptor
+     * @return false if the id is empty or taken, or there is no factory
+     */
+    bool add(AllocatorDescriptor descriptor) {
+        if (descriptor.id.empty() || !descriptor.create || m_index.count(descriptor.id)) return false;
+        m_index.emplace(descriptor.id, m_entries.size());
+        m_entries.push_back(std::move(descriptor));
+        return true;
+    }
+
+    size_t size() const { return m_entries.size(); }
+
+    const AllocatorDescriptor& at(size_t index) const { return m_entries[index]; }
+
+    const std::deque<AllocatorDescriptor>& entries() const { return m_entries; }
+
+    /**
+     * @return Index of the allocator, or -1 if no allocator has this id
+     */
+    int index_of(const std::string& id) const {
+        auto it = m_index.find(id);
+        return it == m_index.end() ? -1 : static_cast<int>(it->second);
+    }
+
+    const AllocatorDescriptor* find(const std::string& id) const {
+        int index = index_of(id);
+        return index < 0 ? nullptr : &m_entries[static_cast<size_t>(index)];
+    }
+
+    /**
+     * @brief Construct an allocator with defaults for any parameter not in params
+     * @return nullptr for an unknown id or parameter, or if the factory fails
+     */
+    std::unique_ptr<BaseAllocator> create(const std::string& id, const AllocatorParams& params = {}) const {
+        const AllocatorDescriptor* descriptor = find(id);
+        if (!descriptor) return nullptr;
+        return create(*descriptor, params);
+    }
+
+    static std::unique_ptr<BaseAllocator> create(const AllocatorDescriptor& descriptor,
+                                                 const AllocatorParams& params) {
+        for (const auto& value : params.values()) {
+            if (!find_parameter(descriptor, value.first)) return nullptr;
+        }
+        AllocatorParams resolved = params;
+        for (const AllocatorParameter& parameter : descriptor.parameters) {
+            if (!resolved.has(parameter.name)) resolved.set(parameter.name, parameter.default_value);
+        }
+        return descriptor.create(resolved);
+    }
+
+    static const AllocatorParameter* find_parameter(const AllocatorDescriptor& descriptor, const std::string& name) {
+        for (const AllocatorParameter& parameter : descriptor.parameters) {
+            if (parameter.name == name) return &parameter;
+        }
+        return nullptr;
+    }
+
+private:
+    AllocatorRegistry() = default;
+
+    std::deque<AllocatorDescriptor> m_entries;
+    std::unordered_map<std::string, size_t> m_index;
+};
+
+} // namespace memory_engine
+
+/**
+ * Registers an allocator from its own header. tag names the inline flag
+ * variable; the remaining arguments brace-initialize an AllocatorDescriptor.
+ * Being inline, the registration runs once per program however many
+ * translation units include the header.
+ */
+#define MEMORY_ENGINE_REGISTER_ALLOCATOR(tag, ...) \
+    inline const bool tag##_registered = ::memory_engine::AllocatorRegistry::instance().add( \
+        ::memory_engine::AllocatorDescriptor __VA_ARGS__)
+
+#endif // ALLOCATOR_REGISTRY_HPP
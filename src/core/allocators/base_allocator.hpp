@@ -8,6 +8,10 @@
 #ifndef BASE_ALLOCATOR_HPP
 #define BASE_ALLOCATOR_HPP
 
+#include "stats_policy.hpp"
+#include "../utils/allocation_profiler.hpp"
+#include "../utils/occupancy_map.hpp"
+#include "../utils/ring_buffer.hpp"
 #include <cstddef>
 #include <cstdint>
 #include <string>
@@ -15,6 +19,19 @@
 
 namespace memory_engine {
 
+/**
+ * @struct SizeClassStats
+ * @brief Occupancy of one size class in a segregated allocator
+ */
+struct SizeClassStats {
+    size_t block_size = 0;       ///< Block size of this class
+    size_t blocks_total = 0;     ///< Blocks reserved across all chunks
+    size_t blocks_used = 0;      ///< Blocks currently handed out
+    size_t chunk_count = 0;      ///< Number of pool chunks backing the class
+    size_t requested_bytes = 0;  ///< Bytes requested by live allocations
+    size_t waste_bytes = 0;      ///< Internal fragmentation (used blocks - requested)
+};
+
 /**
  * @struct AllocationStats
  * @brief Statistics for memory allocation tracking
@@ -27,8 +44,11 @@ struct AllocationStats {
     size_t current_bytes_used = 0;     ///< Currently used bytes
     size_t peak_bytes_used = 0;        ///< Peak memory usage
     size_t fragmentation_bytes = 0;    ///< Estimated fragmentation
+    size_t reserved_headroom_bytes = 0; ///< Reserved but uncommitted address space (growable arenas)
     double avg_allocation_time_ns = 0; ///< Average allocation time in nanoseconds
     double avg_dealloc_time_ns = 0;    ///< Average deallocation time in nanoseconds
+    size_t rejected_deallocations = 0; ///< Frees the allocator refused (kept under every policy)
+    std::vector<SizeClassStats> size_classes; ///< Per-class breakdown (size-class allocators only)
 };
 
 /**
@@ -39,8 +59,8 @@ struct AllocationInfo {
     void* address = nullptr;   ///< Memory address
     size_t size = 0;           ///< Allocation size
     size_t alignment = 0;      ///< Alignment requirement
-    uint64_t timestamp = 0;    ///< Allocation timestamp
-    bool is_active = false;    ///< Whether allocation is still active
+    uint64_t timestamp = 0;    ///< Event time in ns (Timer tick clock)
+    bool is_active = false;    ///< true for an allocation, false for the free of address
 };
 
 /**
@@ -87,6 +107,38 @@ public:
      */
     virtual void deallocate(void* ptr) = 0;
 
+    /**
+     * @brief Allocate several blocks of the same size in one call
+     * @param size Size in bytes of each block
+     * @param alignment Memory alignment requirement (must be power of 2)
+     * @param out Array receiving at least count pointers
+     * @param count Number of blocks requested
+     * @return Number of blocks allocated (stops at the first failure)
+     *
+     * The default loops over allocate(); allocators that can hand out
+     * blocks in one pass override it and record stats once per batch.
+     */
+    virtual size_t allocate_batch(size_t size, size_t alignment, void** out, size_t count) {
+        size_t allocated = 0;
+        while (allocated < count) {
+            void* ptr = allocate(size, alignment);
+            if (!ptr) break;
+            out[allocated++] = ptr;
+        }
+        return allocated;
+    }
+
+    /**
+     * @brief Deallocate several blocks in one call
+     * @param ptrs Pointers to deallocate, in allocation order
+     * @param count Number of pointers
+     */
+    virtual void deallocate_batch(void** ptrs, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            deallocate(ptrs[i]);
+        }
+    }
+
     /**
      * @brief Reset the allocator to initial state
      * 
@@ -102,6 +154,57 @@ public:
      */
     virtual bool owns(void* ptr) const = 0;
 
+    /**
+     * @brief Check if owns() tells this allocator's blocks from foreign ones
+     * @return false if owns() accepts any pointer; callers that mix in blocks
+     *         from elsewhere must not route frees by owns() then
+     */
+    virtual bool tracks_ownership() const { return true; }
+
+    /**
+     * @brief Check if allocate/deallocate may be called concurrently
+     * @return true if the allocator synchronizes internally
+     */
+    virtual bool is_thread_safe() const { return false; }
+
+    /**
+     * @brief Occupancy of fixed-size slots, for visualization
+     * @return One entry per slot (true = allocated); empty if the allocator has no slots
+     */
+    virtual std::vector<bool> get_allocation_grid() const { return {}; }
+
+    /**
+     * @brief Start or stop maintaining an occupancy map of the arena
+     * @param enabled true to build the map from the current state and keep it current
+     * @return false if the allocator has no arena to map
+     *
+     * Off by default; while on, every allocate and free also updates the map.
+     */
+    virtual bool set_occupancy_tracking(bool enabled) { (void)enabled; return false; }
+
+    /**
+     * @brief Current occupancy map; empty unless tracking is on
+     */
+    virtual OccupancyView occupancy() const { return {}; }
+
+    /**
+     * @brief Attach a sampling profiler, or detach it with nullptr
+     * @param profiler Profiler fed every allocation and free; not owned
+     * @return false if the allocator cannot be profiled (thread-safe
+     *         allocators, or a stats policy without PROFILE such as NoStats)
+     *
+     * Detach before destroying the profiler.
+     */
+    virtual bool set_profiler(AllocationProfiler* profiler) {
+        m_profiler = profiler;
+        return true;
+    }
+
+    /**
+     * @brief Currently attached profiler, or nullptr
+     */
+    AllocationProfiler* profiler() const { return m_profiler; }
+
     /**
      * @brief Get the name of this allocator
      * @return Allocator name
@@ -117,22 +220,36 @@ public:
     /**
      * @brief Get current allocation statistics
      * @return AllocationStats structure
+     *
+     * Derived metrics (e.g. fragmentation) are brought up to date on demand.
      */
-    const AllocationStats& stats() const { return m_stats; }
+    const AllocationStats& stats() const {
+        update_derived_stats();
+        return m_stats;
+    }
 
     /**
      * @brief Get allocation history (for visualization)
-     * @return Vector of allocation info
+     * @return Most recent allocation and free events, oldest first (FullHistory policy only)
      */
-    const std::vector<AllocationInfo>& allocation_history() const { 
+    const RingBuffer<AllocationInfo>& allocation_history() const { 
         return m_allocation_history; 
     }
 
+    /**
+     * @brief Set how many history entries are retained
+     * @param capacity Maximum entries (clears the current history)
+     */
+    void set_history_capacity(size_t capacity) {
+        m_allocation_history.set_capacity(capacity);
+    }
+
     /**
      * @brief Calculate fragmentation percentage
      * @return Fragmentation as percentage (0-100)
      */
     virtual double fragmentation_percentage() const {
+        update_derived_stats();
         if (m_stats.current_bytes_used == 0) return 0.0;
         return (static_cast<double>(m_stats.fragmentation_bytes) / 
                 static_cast<double>(m_stats.current_bytes_used)) * 100.0;
@@ -147,54 +264,260 @@ public:
     }
 
 protected:
+    static constexpr size_t DEFAULT_HISTORY_CAPACITY = 4096; ///< History ring buffer size
+
     std::string m_name;                              ///< Allocator name
     size_t m_total_size;                             ///< Total memory pool size
-    AllocationStats m_stats;                         ///< Allocation statistics
-    std::vector<AllocationInfo> m_allocation_history; ///< Allocation tracking
+    mutable AllocationStats m_stats;                 ///< Allocation statistics
+    RingBuffer<AllocationInfo> m_allocation_history{DEFAULT_HISTORY_CAPACITY}; ///< Recent allocations
+    size_t m_timing_countdown = 0;                   ///< Sampling state for OperationTimer
+    size_t m_timed_allocations = 0;                  ///< Allocations contributing to the average
+    size_t m_timed_deallocations = 0;                ///< Deallocations contributing to the average
+    AllocationProfiler* m_profiler = nullptr;        ///< Sampling profiler, if attached
+
+    /**
+     * @brief Recompute expensive derived statistics
+     *
+     * Called from stats() and fragmentation_percentage() so hot paths only
+     * maintain cheap counters. The default has nothing to derive.
+     */
+    virtual void update_derived_stats() const {}
 
     /**
      * @brief Record an allocation for statistics
+     * @tparam Policy Instrumentation policy of the calling allocator
      * @param ptr Allocated pointer
      * @param size Allocation size
      * @param alignment Alignment used
-     * @param time_ns Time taken in nanoseconds
+     * @param timer Timer that measured the operation
      */
-    void record_allocation(void* ptr, size_t size, size_t alignment, double time_ns) {
-        m_stats.total_allocations++;
-        m_stats.current_allocations++;
-        m_stats.total_bytes_allocated += size;
-        m_stats.current_bytes_used += size;
-        
-        if (m_stats.current_bytes_used > m_stats.peak_bytes_used) {
-            m_stats.peak_bytes_used = m_stats.current_bytes_used;
+    template <typename Policy>
+    void record_allocation(void* ptr, size_t size, size_t alignment, const OperationTimer<Policy>& timer) {
+        if constexpr (Policy::COUNTERS) {
+            m_stats.total_allocations++;
+            m_stats.current_allocations++;
+            m_stats.total_bytes_allocated += size;
+            m_stats.current_bytes_used += size;
+
+            if (m_stats.current_bytes_used > m_stats.peak_bytes_used) {
+                m_stats.peak_bytes_used = m_stats.current_bytes_used;
+            }
         }
 
-        // Update average allocation time
-        double total_time = m_stats.avg_allocation_time_ns * (m_stats.total_allocations - 1);
-        m_stats.avg_allocation_time_ns = (total_time + time_ns) / m_stats.total_allocations;
+        // Update average allocation time over the timed samples
+        if constexpr (Policy::TIMING) {
+            if (timer.sampled()) {
+                m_timed_allocations++;
+                double total_time = m_stats.avg_allocation_time_ns * (m_timed_allocations - 1);
+                m_stats.avg_allocation_time_ns = (total_time + timer.elapsed_ns()) / m_timed_allocations;
+            }
+        }
 
         // Record in history
-        AllocationInfo info;
-        info.address = ptr;
-        info.size = size;
-        info.alignment = alignment;
-        info.is_active = true;
-        m_allocation_history.push_back(info);
+        if constexpr (Policy::HISTORY) {
+            AllocationInfo info;
+            info.address = ptr;
+            info.size = size;
+            info.alignment = alignment;
+            info.timestamp = history_timestamp(timer);
+            info.is_active = true;
+            m_allocation_history.push_back(info);
+        }
+
+        if constexpr (Policy::PROFILE) {
+            if (m_profiler) m_profiler->on_allocate(ptr, size);
+        }
+
+        (void)ptr; (void)size; (void)alignment; (void)timer;
     }
 
     /**
      * @brief Record a deallocation for statistics
+     * @tparam Policy Instrumentation policy of the calling allocator
+     * @param ptr Deallocated pointer
      * @param size Size of deallocated memory
-     * @param time_ns Time taken in nanoseconds
+     * @param timer Timer that measured the operation
      */
-    void record_deallocation(size_t size, double time_ns) {
-        m_stats.total_deallocations++;
-        m_stats.current_allocations--;
-        m_stats.current_bytes_used -= size;
+    template <typename Policy>
+    void record_deallocation(void* ptr, size_t size, const OperationTimer<Policy>& timer) {
+        if constexpr (Policy::COUNTERS) {
+            m_stats.total_deallocations++;
+            m_stats.current_allocations--;
+            m_stats.current_bytes_used -= size;
+        }
+
+        // Update average deallocation time over the timed samples
+        if constexpr (Policy::TIMING) {
+            if (timer.sampled()) {
+                m_timed_deallocations++;
+                double total_time = m_stats.avg_dealloc_time_ns * (m_timed_deallocations - 1);
+                m_stats.avg_dealloc_time_ns = (total_time + timer.elapsed_ns()) / m_timed_deallocations;
+            }
+        }
+
+        record_free_event<Policy>(ptr, size, Policy::HISTORY ? history_timestamp(timer) : 0);
+
+        (void)size; (void)timer;
+    }
+
+    /**
+     * @brief Log one freed block to the history and the profiler
+     * @tparam Policy Instrumentation policy of the calling allocator
+     * @param ptr Freed pointer
+     * @param size Size of the freed block
+     * @param timestamp Event time for the history (see history_timestamp)
+     *
+     * record_deallocation does this itself; batch frees call it for each
+     * block they released, then record_deallocation_batch once.
+     */
+    template <typename Policy>
+    void record_free_event(void* ptr, size_t size, uint64_t timestamp) {
+        if constexpr (Policy::HISTORY) {
+            AllocationInfo info;
+            info.address = ptr;
+            info.size = size;
+            info.timestamp = timestamp;
+            m_allocation_history.push_back(info);
+        }
+
+        if constexpr (Policy::PROFILE) {
+            if (m_profiler) m_profiler->on_free(ptr);
+        }
+
+        (void)ptr; (void)size; (void)timestamp;
+    }
+
+    /**
+     * @brief set_profiler for allocators templated on a stats policy
+     * @tparam Policy Instrumentation policy of the calling allocator
+     * @param profiler Profiler to attach, or nullptr to detach
+     * @return false if Policy compiles the profiler hooks out
+     */
+    template <typename Policy>
+    bool attach_profiler(AllocationProfiler* profiler) {
+        if (!Policy::PROFILE && profiler) return false;
+        m_profiler = profiler;
+        return true;
+    }
+
+    /**
+     * @brief Time of an operation for the history, in ns on the Timer tick clock
+     *
+     * Reuses the timer's start stamp when it took one.
+     */
+    template <typename Policy>
+    static uint64_t history_timestamp(const OperationTimer<Policy>& timer) {
+        uint64_t ticks = timer.sampled() ? timer.begin_ticks() : Timer::ticks_begin();
+        return static_cast<uint64_t>(Timer::ticks_to_ns(ticks));
+    }
+
+    /**
+     * @brief Record a batch of same-sized allocations with one stats update
+     * @tparam Policy Instrumentation policy of the calling allocator
+     * @param ptrs Allocated pointers
+     * @param count Number of pointers
+     * @param size Size of each allocation
+     * @param alignment Alignment used
+     * @param timer Timer that measured the whole batch
+     */
+    template <typename Policy>
+    void record_allocation_batch(void* const* ptrs, size_t count, size_t size, size_t alignment,
+                                 const OperationTimer<Policy>& timer) {
+        if (count == 0) return;
 
-        // Update average deallocation time
-        double total_time = m_stats.avg_dealloc_time_ns * (m_stats.total_deallocations - 1);
-        m_stats.avg_dealloc_time_ns = (total_time + time_ns) / m_stats.total_deallocations;
+        if constexpr (Policy::COUNTERS) {
+            m_stats.total_allocations += count;
+            m_stats.current_allocations += count;
+            m_stats.total_bytes_allocated += size * count;
+            m_stats.current_bytes_used += size * count;
+
+            if (m_stats.current_bytes_used > m_stats.peak_bytes_used) {
+                m_stats.peak_bytes_used = m_stats.current_bytes_used;
+            }
+        }
+
+        // The batch counts as count samples of its per-block cost
+        if constexpr (Policy::TIMING) {
+            if (timer.sampled()) {
+                double total_time = m_stats.avg_allocation_time_ns * m_timed_allocations;
+                m_timed_allocations += count;
+                m_stats.avg_allocation_time_ns = (total_time + timer.elapsed_ns()) / m_timed_allocations;
+            }
+        }
+
+        if constexpr (Policy::HISTORY) {
+            uint64_t timestamp = history_timestamp(timer);
+            for (size_t i = 0; i < count; ++i) {
+                AllocationInfo info;
+                info.address = ptrs[i];
+                info.size = size;
+                info.alignment = alignment;
+                info.timestamp = timestamp;
+                info.is_active = true;
+                m_allocation_history.push_back(info);
+            }
+        }
+
+        if constexpr (Policy::PROFILE) {
+            if (m_profiler) {
+                for (size_t i = 0; i < count; ++i) m_profiler->on_allocate(ptrs[i], size);
+            }
+        }
+
+        (void)ptrs; (void)size; (void)alignment; (void)timer;
+    }
+
+    /**
+     * @brief Record a batch of deallocations with one stats update
+     * @tparam Policy Instrumentation policy of the calling allocator
+     * @param count Number of blocks freed
+     * @param bytes Total bytes freed
+     * @param timer Timer that measured the whole batch
+     */
+    template <typename Policy>
+    void record_deallocation_batch(size_t count, size_t bytes, const OperationTimer<Policy>& timer) {
+        if (count == 0) return;
+
+        if constexpr (Policy::COUNTERS) {
+            m_stats.total_deallocations += count;
+            m_stats.current_allocations -= count;
+            m_stats.current_bytes_used -= bytes;
+        }
+
+        if constexpr (Policy::TIMING) {
+            if (timer.sampled()) {
+                double total_time = m_stats.avg_dealloc_time_ns * m_timed_deallocations;
+                m_timed_deallocations += count;
+                m_stats.avg_dealloc_time_ns = (total_time + timer.elapsed_ns()) / m_timed_deallocations;
+            }
+        }
+
+        (void)bytes; (void)timer;
+    }
+
+    /**
+     * @brief Count a deallocation the allocator refused
+     *
+     * Called on error paths only (foreign pointer, double free, out-of-order
+     * stack free), so it is kept regardless of the stats policy.
+     */
+    void record_rejected_deallocation() {
+        m_stats.rejected_deallocations++;
+    }
+
+    /**
+     * @brief Clear statistics, sampling state and history
+     *
+     * Allocators call this when they release every block at once, so an
+     * attached profiler ends its live samples here too.
+     */
+    void reset_stats() {
+        if (m_profiler) m_profiler->on_release_all();
+        m_stats = AllocationStats{};
+        m_allocation_history.clear();
+        m_timing_countdown = 0;
+        m_timed_allocations = 0;
+        m_timed_deallocations = 0;
     }
 
     /**
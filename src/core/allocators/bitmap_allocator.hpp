@@ -0,0 +1,562 @@
+/**
+ * @file bitmap_allocator.hpp
+ * @brief Fixed-size block allocator with out-of-band occupancy bitmaps
+ * @author Bambang Hutagalung
+ * @date 2026
+ */
+
+#ifndef BITMAP_ALLOCATOR_HPP
+#define BITMAP_ALLOCATOR_HPP
+
+#include "allocator_registry.hpp"
+#include "base_allocator.hpp"
+#include "../utils/timer.hpp"
+#include "../utils/memory_utils.hpp"
+#include "../utils/numa.hpp"
+#include "../utils/simd.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace memory_engine {
+
+/**
+ * @enum BitmapPlacement
+ * @brief Where a bitmap allocator looks for free blocks first
+ */
+enum class BitmapPlacement {
+    LOWEST_ADDRESS,   ///< Always the lowest free run: compact, good locality, reuses hot blocks
+    NEXT_FIT          ///< Continue after the previous allocation, wrapping around
+};
+
+/**
+ * @class BasicBitmapAllocator
+ * @brief Block allocator whose free state lives in a bitmap beside the arena
+ *
+ * The same arena layout as BasicPoolAllocator. Instead of an intrusive free
+ * list, one bit per block (1 = free) is kept in a separate array, with a
+ * summary word above it that has one bit per bitmap word (1 = some block
+ * free). Finding a block scans the summary with Simd::find_first_set and
+ * takes the lowest bit of the word it names. The arena itself is never read
+ * on allocate or free, so a cold block is not pulled into cache until the
+ * caller touches it.
+ *
+ * Requests larger than one block take a contiguous run of blocks, found by
+ * alternating find_first_set/find_first_clear over the bitmap. Run lengths
+ * are stored beside the bitmap as well, so frees need no header, and
+ * double or interior-pointer frees are rejected.
+ *
+ * Advantages over the pool:
+ * - allocate touches only bitmap words, not the block
+ * - Multi-block runs, and lowest-address placement for compaction
+ * - The allocation grid is the bitmap, no list walk
+ *
+ * Disadvantages:
+ * - A summary scan instead of a single pointer pop per allocation
+ * - About 4 bytes of metadata per block (run length plus bitmap bits)
+ *
+ * @tparam StatsPolicy Instrumentation policy (see stats_policy.hpp)
+ */
+template <typename StatsPolicy = DefaultStatsPolicy>
+class BasicBitmapAllocator : public BaseAllocator {
+public:
+    /**
+     * @brief Constructor
+     * @param block_size Size of each block in bytes
+     * @param block_count Number of blocks to allocate
+     * @param alignment Memory alignment for blocks
+     * @param placement Search order for free blocks
+     * @param numa_node Node to bind the blocks to (Numa::ANY_NODE = first touch)
+     */
+    BasicBitmapAllocator(size_t block_size, size_t block_count, size_t alignment = alignof(std::max_align_t),
+                         BitmapPlacement placement = BitmapPlacement::LOWEST_ADDRESS,
+                         int numa_node = Numa::ANY_NODE)
+        : BaseAllocator("Bitmap Allocator", 0)
+        , m_block_size(align_size(block_size, alignment))
+        , m_block_count(block_count)
+        , m_alignment(alignment)
+        , m_placement(placement)
+        , m_memory(nullptr)
+        , m_allocated_blocks(0)
+        , m_cursor(0)
+        , m_numa_node(numa_node)
+    {
+        m_total_size = m_block_size * m_block_count;
+
+        // Node-bound pages are page-aligned; unbound memory if binding fails
+        if (m_numa_node != Numa::ANY_NODE && m_alignment <= MemoryUtils::get_page_size()) {
+            m_memory = static_cast<uint8_t*>(Numa::allocate_on_node(m_total_size, m_numa_node));
+        }
+        if (!m_memory) {
+            m_numa_node = Numa::ANY_NODE;
+            #ifdef _WIN32
+            m_memory = static_cast<uint8_t*>(_aligned_malloc(m_total_size, m_alignment));
+            #else
+            m_memory = static_cast<uint8_t*>(std::aligned_alloc(m_alignment, m_total_size));
+            #endif
+        }
+
+        if (m_memory) {
+            m_free_bits.resize((m_block_count + 63) / 64);
+            m_summary.resize((m_free_bits.size() + 63) / 64);
+            m_run_length.resize(m_block_count);
+            initialize_bitmap();
+        }
+    }
+
+    /**
+     * @brief Destructor
+     */
+    ~BasicBitmapAllocator() override {
+        if (m_memory) {
+            if (m_numa_node != Numa::ANY_NODE) {
+                Numa::free_on_node(m_memory, m_total_size);
+            } else {
+                #ifdef _WIN32
+                _aligned_free(m_memory);
+                #else
+                std::free(m_memory);
+                #endif
+            }
+            m_memory = nullptr;
+        }
+    }
+
+    // Disable copy
+    BasicBitmapAllocator(const BasicBitmapAllocator&) = delete;
+    BasicBitmapAllocator& operator=(const BasicBitmapAllocator&) = delete;
+
+    // Enable move
+    BasicBitmapAllocator(BasicBitmapAllocator&& other) noexcept
+        : BaseAllocator(std::move(other))
+        , m_block_size(other.m_block_size)
+        , m_block_count(other.m_block_count)
+        , m_alignment(other.m_alignment)
+        , m_placement(other.m_placement)
+        , m_memory(other.m_memory)
+        , m_free_bits(std::move(other.m_free_bits))
+        , m_summary(std::move(other.m_summary))
+        , m_run_length(std::move(other.m_run_length))
+        , m_allocated_blocks(other.m_allocated_blocks)
+        , m_cursor(other.m_cursor)
+        , m_numa_node(other.m_numa_node)
+        , m_occupancy(std::move(other.m_occupancy))
+    {
+        other.m_memory = nullptr;
+        other.m_allocated_blocks = 0;
+    }
+
+    /**
+     * @brief Allocate one block, or a contiguous run for larger sizes
+     * @param size Size requested; above block_size takes ceil(size / block_size) blocks
+     * @param alignment Alignment (ignored, uses the allocator's alignment)
+     * @return Pointer to the first block, or nullptr if no run is long enough
+     */
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) override {
+        (void)alignment; // Blocks use the allocator's alignment
+
+        // Divide before rounding: size + block_size - 1 wraps near SIZE_MAX
+        size_t blocks = size <= m_block_size ? 1 : size / m_block_size + (size % m_block_size != 0);
+        if (!m_memory || blocks > free_blocks() || blocks > MAX_RUN) {
+            return nullptr;
+        }
+
+        OperationTimer<StatsPolicy> timer(m_timing_countdown);
+        timer.start();
+
+        size_t first = blocks == 1 ? find_block() : find_run(blocks);
+        if (first == Simd::NPOS) {
+            timer.stop();
+            return nullptr;
+        }
+        take(first, blocks);
+
+        timer.stop();
+
+        void* ptr = m_memory + first * m_block_size;
+        record_allocation(ptr, blocks * m_block_size, m_alignment, timer);
+        if (m_occupancy.enabled()) m_occupancy.add(ptr, blocks * m_block_size);
+
+        return ptr;
+    }
+
+    /**
+     * @brief Return a block or run to the bitmap
+     * @param ptr Pointer returned by allocate
+     *
+     * Pointers into the middle of a run and runs already freed are rejected.
+     */
+    void deallocate(void* ptr) override {
+        if (!ptr) return;
+        size_t first = block_index(ptr);
+        if (first == Simd::NPOS || m_run_length[first] == 0) {
+            record_rejected_deallocation();
+            return;
+        }
+
+        OperationTimer<StatsPolicy> timer(m_timing_countdown);
+        timer.start();
+
+        size_t blocks = m_run_length[first];
+        release(first, blocks);
+
+        timer.stop();
+
+        record_deallocation(ptr, blocks * m_block_size, timer);
+        if (m_occupancy.enabled()) m_occupancy.remove(ptr, blocks * m_block_size);
+    }
+
+    /**
+     * @brief Take several single blocks in one pass
+     * @param size Size requested; above block_size falls back to one allocate() per run
+     * @param alignment Alignment (ignored, uses the allocator's alignment)
+     * @param out Array receiving the blocks
+     * @param count Number of blocks requested
+     * @return Number of blocks allocated (fewer if the bitmap runs out)
+     */
+    size_t allocate_batch(size_t size, size_t alignment, void** out, size_t count) override {
+        if (!m_memory) return 0;
+        if (size > m_block_size) return BaseAllocator::allocate_batch(size, alignment, out, count);
+
+        OperationTimer<StatsPolicy> timer(m_timing_countdown);
+        timer.start();
+
+        size_t allocated = 0;
+        while (allocated < count) {
+            size_t first = find_block();
+            if (first == Simd::NPOS) break;
+            take(first, 1);
+            out[allocated++] = m_memory + first * m_block_size;
+        }
+
+        timer.stop();
+
+        record_allocation_batch(out, allocated, m_block_size, m_alignment, timer);
+        if (m_occupancy.enabled()) {
+            for (size_t i = 0; i < allocated; ++i) m_occupancy.add(out[i], m_block_size);
+        }
+
+        return allocated;
+    }
+
+    /**
+     * @brief Free several blocks or runs in one pass
+     * @param ptrs Pointers to deallocate
+     * @param count Number of pointers
+     */
+    void deallocate_batch(void** ptrs, size_t count) override {
+        OperationTimer<StatsPolicy> timer(m_timing_countdown);
+        timer.start();
+
+        size_t freed = 0;
+        size_t bytes = 0;
+        const uint64_t timestamp = StatsPolicy::HISTORY ? history_timestamp(timer) : 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (!ptrs[i]) continue;
+            size_t first = block_index(ptrs[i]);
+            if (first == Simd::NPOS || m_run_length[first] == 0) {
+                record_rejected_deallocation();
+                continue;
+            }
+            size_t blocks = m_run_length[first];
+            if (m_occupancy.enabled()) m_occupancy.remove(ptrs[i], blocks * m_block_size);
+            record_free_event<StatsPolicy>(ptrs[i], blocks * m_block_size, timestamp);
+            release(first, blocks);
+            freed++;
+            bytes += blocks * m_block_size;
+        }
+
+        timer.stop();
+
+        record_deallocation_batch(freed, bytes, timer);
+    }
+
+    /**
+     * @brief Mark every block free
+     */
+    void reset() override {
+        if (m_memory) {
+            initialize_bitmap();
+        }
+        m_allocated_blocks = 0;
+        reset_stats();
+        if (m_occupancy.enabled()) m_occupancy.clear();
+    }
+
+    /**
+     * @brief Check if pointer belongs to this allocator's arena
+     * @param ptr Pointer to check
+     * @return true if pointer is within arena bounds
+     */
+    bool owns(void* ptr) const override {
+        if (!m_memory || !ptr) return false;
+
+        uint8_t* p = static_cast<uint8_t*>(ptr);
+        return p >= m_memory && p < (m_memory + m_total_size);
+    }
+
+    size_t free_blocks() const {
+        return m_block_count - m_allocated_blocks;
+    }
+
+    size_t allocated_blocks() const {
+        return m_allocated_blocks;
+    }
+
+    size_t block_size() const {
+        return m_block_size;
+    }
+
+    size_t block_count() const {
+        return m_block_count;
+    }
+
+    const uint8_t* base_address() const {
+        return m_memory;
+    }
+
+    /**
+     * @brief Get the NUMA node the arena is bound to
+     * @return Node index, or Numa::ANY_NODE if the arena is unbound
+     */
+    int numa_node() const {
+        return m_numa_node;
+    }
+
+    BitmapPlacement placement() const {
+        return m_placement;
+    }
+
+    /**
+     * @brief Change the search order; takes effect on the next allocation
+     * @param placement New placement
+     */
+    void set_placement(BitmapPlacement placement) {
+        m_placement = placement;
+        m_cursor = 0;
+    }
+
+    /**
+     * @brief Free-block bitmap, bit i of word i / 64 set when block i is free
+     * @return (block_count + 63) / 64 words; padding bits past the last block are clear
+     */
+    const uint64_t* free_bitmap() const {
+        return m_free_bits.data();
+    }
+
+    /**
+     * @brief Longest run of contiguous free blocks
+     * @return Block count of the largest run allocate() could serve right now
+     */
+    size_t largest_free_run() const {
+        size_t largest = 0;
+        size_t start = Simd::find_first_set(m_free_bits.data(), m_free_bits.size());
+        while (start != Simd::NPOS) {
+            size_t end = run_end(start);
+            largest = std::max(largest, end - start);
+            start = Simd::find_first_set(m_free_bits.data(), m_free_bits.size(), end);
+        }
+        return largest;
+    }
+
+    /**
+     * @brief Get available memory
+     * @return Bytes available for allocation
+     */
+    size_t available() const override {
+        return free_blocks() * m_block_size;
+    }
+
+    /**
+     * @brief Free blocks outside the largest free run, as a share of all free blocks
+     * @return 0 when the free space is one run (any run request up to it succeeds)
+     */
+    double fragmentation_percentage() const override {
+        size_t free = free_blocks();
+        if (free == 0) return 0.0;
+        return (1.0 - static_cast<double>(largest_free_run()) / static_cast<double>(free)) * 100.0;
+    }
+
+    /**
+     * @brief Get memory block grid for visualization
+     * @return Vector of bools (true = allocated, false = free), read straight from the bitmap
+     */
+    std::vector<bool> get_allocation_grid() const override {
+        std::vector<bool> grid(m_block_count);
+        for (size_t i = 0; i < m_block_count; ++i) {
+            grid[i] = !((m_free_bits[i / 64] >> (i % 64)) & 1);
+        }
+        return grid;
+    }
+
+    /**
+     * @brief Track one cell per block
+     * @return false if the arena could not be allocated
+     */
+    bool set_occupancy_tracking(bool enabled) override {
+        if (!enabled) {
+            m_occupancy.disable();
+            return true;
+        }
+        if (!m_memory) return false;
+        m_occupancy.enable(m_memory, m_total_size, m_block_size);
+        for (size_t i = 0; i < m_block_count; ++i) {
+            if (m_run_length[i]) m_occupancy.add(m_memory + i * m_block_size, m_run_length[i] * m_block_size);
+        }
+        return true;
+    }
+
+    OccupancyView occupancy() const override {
+        return m_occupancy.view();
+    }
+
+    /**
+     * @brief Attach a profiler; refused when StatsPolicy has no PROFILE hooks
+     */
+    bool set_profiler(AllocationProfiler* profiler) override {
+        return attach_profiler<StatsPolicy>(profiler);
+    }
+
+private:
+    static constexpr size_t MAX_RUN = UINT32_MAX;   ///< Run lengths are stored as uint32_t
+
+    size_t m_block_size;                ///< Size of each block
+    size_t m_block_count;               ///< Total number of blocks
+    size_t m_alignment;                 ///< Memory alignment
+    BitmapPlacement m_placement;        ///< Search order
+    uint8_t* m_memory;                  ///< Memory buffer
+    std::vector<uint64_t> m_free_bits;  ///< One bit per block, 1 = free
+    std::vector<uint64_t> m_summary;    ///< One bit per m_free_bits word, 1 = word has a free block
+    std::vector<uint32_t> m_run_length; ///< Blocks in the run starting here; 0 if no live run starts here
+    size_t m_allocated_blocks;          ///< Blocks in live runs
+    size_t m_cursor;                    ///< Next search start under NEXT_FIT
+    int m_numa_node;                    ///< Node the buffer is bound to, or Numa::ANY_NODE
+    OccupancyMap m_occupancy;           ///< One cell per block, while tracking is on
+
+    void initialize_bitmap() {
+        std::fill(m_free_bits.begin(), m_free_bits.end(), ~uint64_t{0});
+        // Padding past the last block stays "allocated" so scans never return it
+        if (m_block_count % 64) m_free_bits.back() = (uint64_t{1} << (m_block_count % 64)) - 1;
+        std::fill(m_summary.begin(), m_summary.end(), 0);
+        for (size_t w = 0; w < m_free_bits.size(); ++w) update_summary(w);
+        std::fill(m_run_length.begin(), m_run_length.end(), 0);
+        m_cursor = 0;
+    }
+
+    // First free block at or after the start block, via the summary; NPOS if none
+    size_t find_block_from(size_t start) const {
+        size_t w = start / 64;
+        if (w >= m_free_bits.size()) return Simd::NPOS;
+        uint64_t first = m_free_bits[w] & (~uint64_t{0} << (start % 64));
+        if (first) return w * 64 + Simd::count_trailing_zeros(first);
+
+        size_t word = Simd::find_first_set(m_summary.data(), m_summary.size(), w + 1);
+        if (word == Simd::NPOS) return Simd::NPOS;
+        return word * 64 + Simd::count_trailing_zeros(m_free_bits[word]);
+    }
+
+    size_t find_block() const {
+        if (m_placement == BitmapPlacement::LOWEST_ADDRESS || m_cursor == 0) return find_block_from(0);
+        size_t block = find_block_from(m_cursor);
+        return block != Simd::NPOS ? block : find_block_from(0);
+    }
+
+    // First block of a free run of at least blocks, at or after start, ending by limit
+    size_t find_run_from(size_t blocks, size_t start, size_t limit) const {
+        size_t first = Simd::find_first_set(m_free_bits.data(), m_free_bits.size(), start);
+        while (first != Simd::NPOS && first + blocks <= limit) {
+            size_t end = run_end(first);
+            if (end - first >= blocks) return first;
+            first = Simd::find_first_set(m_free_bits.data(), m_free_bits.size(), end);
+        }
+        return Simd::NPOS;
+    }
+
+    size_t find_run(size_t blocks) const {
+        if (m_placement == BitmapPlacement::LOWEST_ADDRESS || m_cursor == 0) {
+            return find_run_from(blocks, 0, m_block_count);
+        }
+        size_t first = find_run_from(blocks, m_cursor, m_block_count);
+        // Wrapped search: a run starting before the cursor may extend past it
+        return first != Simd::NPOS ? first : find_run_from(blocks, 0, std::min(m_block_count, m_cursor + blocks - 1));
+    }
+
+    // One past the last free block of the run containing first
+    size_t run_end(size_t first) const {
+        size_t end = Simd::find_first_clear(m_free_bits.data(), m_free_bits.size(), first);
+        return end == Simd::NPOS ? m_block_count : std::min(end, m_block_count);
+    }
+
+    void take(size_t first, size_t blocks) {
+        set_range(first, blocks, false);
+        m_run_length[first] = static_cast<uint32_t>(blocks);
+        m_allocated_blocks += blocks;
+        if (m_placement == BitmapPlacement::NEXT_FIT) {
+            m_cursor = first + blocks < m_block_count ? first + blocks : 0;
+        }
+    }
+
+    void release(size_t first, size_t blocks) {
+        set_range(first, blocks, true);
+        m_run_length[first] = 0;
+        m_allocated_blocks -= blocks;
+    }
+
+    // Block index of a run start, or NPOS for foreign or misaligned pointers
+    size_t block_index(void* ptr) const {
+        if (!owns(ptr)) return Simd::NPOS;
+        size_t offset = static_cast<size_t>(static_cast<uint8_t*>(ptr) - m_memory);
+        return offset % m_block_size == 0 ? offset / m_block_size : Simd::NPOS;
+    }
+
+    void set_range(size_t first, size_t blocks, bool free) {
+        size_t end = first + blocks;
+        while (first < end) {
+            size_t w = first / 64;
+            size_t bit = first % 64;
+            size_t span = std::min<size_t>(64 - bit, end - first);
+            uint64_t mask = (span == 64 ? ~uint64_t{0} : ((uint64_t{1} << span) - 1)) << bit;
+            if (free) {
+                m_free_bits[w] |= mask;
+            } else {
+                m_free_bits[w] &= ~mask;
+            }
+            update_summary(w);
+            first += span;
+        }
+    }
+
+    void update_summary(size_t word) {
+        uint64_t bit = uint64_t{1} << (word % 64);
+        if (m_free_bits[word]) {
+            m_summary[word / 64] |= bit;
+        } else {
+            m_summary[word / 64] &= ~bit;
+        }
+    }
+};
+
+using BitmapAllocator = BasicBitmapAllocator<>;
+
+MEMORY_ENGINE_REGISTER_ALLOCATOR(bitmap_allocator, {
+    "bitmap", "Bitmap Allocator", {false, true, true, true},
+    {{"block_size", 4096, "bytes per block; larger requests take a contiguous run"},
+     {"block_count", 10000, "blocks in the arena"},
+     {"alignment", alignof(std::max_align_t), "block alignment"},
+     {"placement", 0, "0 lowest address first, 1 next fit"}},
+    [](const AllocatorParams& params) -> std::unique_ptr<BaseAllocator> {
+        if (!params.get("block_size") || !params.get("block_count") ||
+            !MemoryUtils::is_power_of_two(params.get("alignment")) || params.get("placement") > 1) {
+            return nullptr;
+        }
+        return std::make_unique<BitmapAllocator>(params.get("block_size"), params.get("block_count"),
+                                                 params.get("alignment"),
+                                                 static_cast<BitmapPlacement>(params.get("placement")),
+                                                 params.numa_node);
+    }
+});
+
+} // namespace memory_engine
+
+#endif // BITMAP_ALLOCATOR_HPP
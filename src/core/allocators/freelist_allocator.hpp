@@ -8,10 +8,15 @@
 #ifndef FREELIST_ALLOCATOR_HPP
 #define FREELIST_ALLOCATOR_HPP
 
+#include "allocator_registry.hpp"
 #include "base_allocator.hpp"
 #include "../utils/timer.hpp"
+#include "../utils/memory_utils.hpp"
+#include "../utils/numa.hpp"
+#include "../utils/virtual_arena.hpp"
 #include <cstdlib>
 #include <algorithm>
+#include <iterator>
 
 namespace memory_engine {
 
@@ -20,150 +25,192 @@ namespace memory_engine {
  * @brief Allocation fit strategies
  */
 enum class FitPolicy {
-    FIRST_FIT,    ///< Use first block that fits
+    FIRST_FIT,    ///< Use first block found that fits (O(1) good fit)
     BEST_FIT,     ///< Use smallest block that fits
     WORST_FIT     ///< Use largest block (reduces fragmentation for some patterns)
 };
 
 /**
- * @class FreeListAllocator
- * @brief General-purpose allocator using free list management
- * 
- * The free list allocator maintains a linked list of free memory blocks.
- * It supports variable-size allocations and can merge adjacent free blocks
- * to reduce fragmentation.
- * 
+ * @class BasicFreeListAllocator
+ * @brief General-purpose allocator using segregated free lists
+ *
+ * Free blocks are indexed by size in a two-level set of bins (TLSF style):
+ * the first level splits sizes by power of two, the second level splits each
+ * power of two into 16 linear sub-ranges. Two bitmaps record which bins are
+ * non-empty, so finding a candidate bin is a couple of bit scans instead of
+ * a walk over every free block.
+ *
+ * Every block carries a header with its size and free/previous-free flags,
+ * and free blocks also store their size in a footer (boundary tag). Freed
+ * blocks are merged with their physical neighbours by looking only at the
+ * adjacent headers, without rescanning the free list.
+ *
+ * Fit policies:
+ * - FIRST_FIT takes the head of the first bin whose blocks are all large
+ *   enough (constant time, at most one sub-range of waste)
+ * - BEST_FIT scans only the single bin holding the smallest fitting blocks
+ * - WORST_FIT scans only the highest non-empty bin
+ *
  * Advantages:
  * - Supports variable-size allocations
  * - Can deallocate in any order
- * - Coalescing reduces fragmentation
- * 
+ * - Bounded search and O(1) coalescing keep tail latency predictable
+ *
  * Disadvantages:
  * - Slower than pool/stack allocators
  * - Can suffer from fragmentation
  * - More complex implementation
+ *
+ * @tparam StatsPolicy Instrumentation policy (see stats_policy.hpp)
  */
-class FreeListAllocator : public BaseAllocator {
+template <typename StatsPolicy = DefaultStatsPolicy>
+class BasicFreeListAllocator : public BaseAllocator {
 public:
     /**
      * @brief Constructor
      * @param size Total size of memory pool
      * @param policy Fit policy for finding free blocks
+     * @param numa_node Node to bind the arena to (Numa::ANY_NODE = first touch)
      */
-    explicit FreeListAllocator(size_t size, FitPolicy policy = FitPolicy::BEST_FIT)
+    explicit BasicFreeListAllocator(size_t size, FitPolicy policy = FitPolicy::BEST_FIT,
+                                    int numa_node = Numa::ANY_NODE)
         : BaseAllocator("Free List Allocator", size)
         , m_policy(policy)
         , m_memory(nullptr)
-        , m_free_list(nullptr)
+        , m_arena_size(size & ~(ALIGNMENT - 1))
+        , m_numa_node(numa_node)
     {
-        // Allocate memory
-        #ifdef _WIN32
-        m_memory = static_cast<uint8_t*>(_aligned_malloc(size, alignof(std::max_align_t)));
-        #else
-        m_memory = static_cast<uint8_t*>(std::aligned_alloc(alignof(std::max_align_t), size));
-        #endif
+        // Node-bound pages are page-aligned; unbound memory if binding fails
+        if (m_numa_node != Numa::ANY_NODE) {
+            m_memory = static_cast<uint8_t*>(Numa::allocate_on_node(size, m_numa_node));
+        }
+        if (!m_memory) {
+            m_numa_node = Numa::ANY_NODE;
+            #ifdef _WIN32
+            m_memory = static_cast<uint8_t*>(_aligned_malloc(size, ALIGNMENT));
+            #else
+            m_memory = static_cast<uint8_t*>(std::aligned_alloc(ALIGNMENT, align_size(size, ALIGNMENT)));
+            #endif
+        }
 
-        if (m_memory) {
-            // Initialize with single free block
-            m_free_list = reinterpret_cast<FreeBlock*>(m_memory);
-            m_free_list->size = size;
-            m_free_list->next = nullptr;
+        initialize_arena();
+    }
+
+    /**
+     * @brief Constructor for a growable arena on reserved virtual memory
+     * @param arena Reservation size, huge pages, NUMA node and initial commit
+     * @param policy Fit policy for finding free blocks
+     *
+     * When no free block fits, more of the reservation is committed and
+     * appended to the last block (doubling the arena, at least by the
+     * request). reset() returns everything past arena.initial_commit to the OS.
+     */
+    explicit BasicFreeListAllocator(const VirtualArenaConfig& arena, FitPolicy policy = FitPolicy::BEST_FIT)
+        : BaseAllocator("Free List Allocator", 0)
+        , m_policy(policy)
+        , m_memory(nullptr)
+        , m_arena_size(0)
+        , m_numa_node(Numa::ANY_NODE)
+        , m_arena(arena)
+        , m_initial_commit(std::max(arena.initial_commit, MIN_BLOCK_SIZE))
+    {
+        if (m_arena.base() && m_arena.commit(m_initial_commit)) {
+            m_memory = m_arena.base();
+            m_total_size = m_arena.reserved();
+            m_arena_size = m_arena.committed() & ~(ALIGNMENT - 1);
+            if (m_arena.numa_bound()) m_numa_node = arena.numa_node;
         }
+        initialize_arena();
     }
 
     /**
      * @brief Destructor
      */
-    ~FreeListAllocator() override {
+    ~BasicFreeListAllocator() override {
+        if (m_arena.base()) {
+            m_memory = nullptr; // Released by m_arena
+        }
         if (m_memory) {
-            #ifdef _WIN32
-            _aligned_free(m_memory);
-            #else
-            std::free(m_memory);
-            #endif
+            if (m_numa_node != Numa::ANY_NODE) {
+                Numa::free_on_node(m_memory, m_total_size);
+            } else {
+                #ifdef _WIN32
+                _aligned_free(m_memory);
+                #else
+                std::free(m_memory);
+                #endif
+            }
             m_memory = nullptr;
         }
     }
 
     // Disable copy
-    FreeListAllocator(const FreeListAllocator&) = delete;
-    FreeListAllocator& operator=(const FreeListAllocator&) = delete;
+    BasicFreeListAllocator(const BasicFreeListAllocator&) = delete;
+    BasicFreeListAllocator& operator=(const BasicFreeListAllocator&) = delete;
 
     /**
      * @brief Allocate memory
      * @param size Size to allocate
-     * @param alignment Alignment requirement
+     * @param alignment Alignment requirement (power of 2)
      * @return Pointer to allocated memory, or nullptr
      */
     void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) override {
         if (!m_memory || size == 0) return nullptr;
+        if (!is_power_of_two(alignment)) alignment = ALIGNMENT;
 
-        Timer timer;
+        OperationTimer<StatsPolicy> timer(m_timing_countdown);
         timer.start();
 
-        // Add header size and alignment padding
-        size_t total_size = size + sizeof(AllocationHeader);
-        total_size = align_size(total_size, alignment);
+        // Header, payload and worst-case shift to reach the requested alignment
+        size_t slack = alignment > ALIGNMENT ? alignment - ALIGNMENT : 0;
+        // Reject before summing: a size near SIZE_MAX wraps to a tiny block
+        if (size > SIZE_MAX - sizeof(AllocationHeader) - slack - ALIGNMENT) return nullptr;
+        size_t total_size = align_size(sizeof(AllocationHeader) + size + slack, ALIGNMENT);
+        if (total_size < MIN_BLOCK_SIZE) total_size = MIN_BLOCK_SIZE;
 
         // Find suitable block based on policy
-        FreeBlock* block = nullptr;
-        FreeBlock* prev_block = nullptr;
-        
-        switch (m_policy) {
-            case FitPolicy::FIRST_FIT:
-                find_first_fit(total_size, block, prev_block);
-                break;
-            case FitPolicy::BEST_FIT:
-                find_best_fit(total_size, block, prev_block);
-                break;
-            case FitPolicy::WORST_FIT:
-                find_worst_fit(total_size, block, prev_block);
-                break;
+        FreeBlock* block = find_block(total_size);
+        if (!block && grow(total_size)) {
+            block = find_block(total_size);
         }
 
         if (!block) {
             return nullptr; // No suitable block found
         }
 
-        // Calculate remaining size after allocation
-        size_t remaining = block->size - total_size;
-
-        if (remaining >= sizeof(FreeBlock) + MIN_BLOCK_SIZE) {
-            // Split block
-            FreeBlock* new_block = reinterpret_cast<FreeBlock*>(
-                reinterpret_cast<uint8_t*>(block) + total_size
-            );
-            new_block->size = remaining;
-            new_block->next = block->next;
-
-            if (prev_block) {
-                prev_block->next = new_block;
-            } else {
-                m_free_list = new_block;
-            }
+        remove_free_block(block);
+
+        // Split off the tail if it can hold a free block of its own
+        size_t block_size = block_size_of(block);
+        size_t remaining = block_size - total_size;
+        if (remaining >= MIN_BLOCK_SIZE) {
+            FreeBlock* tail = reinterpret_cast<FreeBlock*>(reinterpret_cast<uint8_t*>(block) + total_size);
+            write_free_block(tail, remaining, false);
+            insert_free_block(tail);
+            // The block after the tail already has PREV_FREE set
+            block_size = total_size;
         } else {
-            // Use entire block
-            total_size = block->size;
-
-            if (prev_block) {
-                prev_block->next = block->next;
-            } else {
-                m_free_list = block->next;
-            }
+            set_prev_free(next_physical(block, block_size), false);
         }
 
         // Write allocation header
         AllocationHeader* header = reinterpret_cast<AllocationHeader*>(block);
-        header->size = total_size;
-        header->adjustment = 0;
+        header->size = block_size | (header->size & PREV_FREE_FLAG);
+        header->adjustment = size;
+
+        // Shift the payload forward to satisfy alignment, leaving a back-tag
+        uint8_t* payload = reinterpret_cast<uint8_t*>(header + 1);
+        uint8_t* aligned = reinterpret_cast<uint8_t*>(align_size(reinterpret_cast<size_t>(payload), alignment));
+        if (aligned != payload) {
+            size_t shift = static_cast<size_t>(aligned - payload);
+            reinterpret_cast<size_t*>(aligned)[-2] = shift | SHIFT_TAG;
+        }
 
-        void* ptr = reinterpret_cast<void*>(header + 1);
+        void* ptr = reinterpret_cast<void*>(aligned);
 
         timer.stop();
-        record_allocation(ptr, size, alignment, timer.elapsed_ns());
-
-        // Update fragmentation estimate
-        update_fragmentation();
+        record_allocation(ptr, size, alignment, timer);
+        if (m_occupancy.enabled()) m_occupancy.add(block, block_size);
 
         return ptr;
     }
@@ -173,45 +220,45 @@ public:
      * @param ptr Pointer to deallocate
      */
     void deallocate(void* ptr) override {
-        if (!ptr || !owns(ptr)) return;
+        if (!ptr) return;
+        if (!owns(ptr)) {
+            record_rejected_deallocation();
+            return;
+        }
 
-        Timer timer;
+        OperationTimer<StatsPolicy> timer(m_timing_countdown);
         timer.start();
 
-        // Get header
-        AllocationHeader* header = reinterpret_cast<AllocationHeader*>(
-            static_cast<uint8_t*>(ptr) - sizeof(AllocationHeader)
-        );
-
-        size_t size = header->size;
-
-        // Create free block at this location
-        FreeBlock* free_block = reinterpret_cast<FreeBlock*>(header);
-        free_block->size = size;
+        AllocationHeader* header = header_from_pointer(ptr);
+        if (header->size & FREE_FLAG) { // Double free (merged-away headers keep FREE_FLAG too)
+            record_rejected_deallocation();
+            return;
+        }
 
-        // Insert into free list (sorted by address for coalescing)
-        insert_free_block(free_block);
+        size_t size = header->adjustment;
+        size_t block_size = header->size & ~FLAG_MASK;
 
-        // Coalesce adjacent blocks
-        coalesce();
+        // Merge with physical neighbours using the boundary tags
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(header);
+        block = coalesce(block);
+        insert_free_block(block);
 
         timer.stop();
-        record_deallocation(size - sizeof(AllocationHeader), timer.elapsed_ns());
-        
-        update_fragmentation();
+        record_deallocation(ptr, size, timer);
+        if (m_occupancy.enabled()) m_occupancy.remove(header, block_size);
     }
 
     /**
      * @brief Reset allocator
      */
     void reset() override {
-        if (m_memory) {
-            m_free_list = reinterpret_cast<FreeBlock*>(m_memory);
-            m_free_list->size = m_total_size;
-            m_free_list->next = nullptr;
+        if (m_arena.base()) {
+            m_arena.decommit(m_initial_commit);
+            m_arena_size = m_arena.committed() & ~(ALIGNMENT - 1);
         }
-        m_stats = AllocationStats{};
-        m_allocation_history.clear();
+        initialize_arena();
+        reset_stats();
+        if (m_occupancy.enabled()) m_occupancy.clear();
     }
 
     /**
@@ -221,23 +268,50 @@ public:
      */
     bool owns(void* ptr) const override {
         if (!m_memory || !ptr) return false;
-        
+
         uint8_t* p = static_cast<uint8_t*>(ptr);
-        return p >= m_memory && p < (m_memory + m_total_size);
+        return p >= m_memory && p < (m_memory + m_arena_size);
     }
 
     /**
      * @brief Get available memory
-     * @return Total free bytes
+     * @return Total free bytes (tracked incrementally), plus the uncommitted
+     *         reservation of a growable arena
      */
     size_t available() const override {
-        size_t total = 0;
-        FreeBlock* current = m_free_list;
-        while (current) {
-            total += current->size;
-            current = current->next;
-        }
-        return total;
+        return m_free_bytes + reserved_headroom();
+    }
+
+    /**
+     * @brief Get the part of a growable arena's reservation not yet committed
+     * @return Bytes the arena can still grow by (0 for a fixed arena)
+     */
+    size_t reserved_headroom() const {
+        return m_arena.base() ? m_arena.reserved() - m_arena_size : 0;
+    }
+
+    /**
+     * @brief Get the NUMA node the arena is bound to
+     * @return Node index, or Numa::ANY_NODE if the arena is unbound
+     */
+    int numa_node() const {
+        return m_numa_node;
+    }
+
+    /**
+     * @brief Get start of the arena
+     * @return First byte of the arena, or nullptr if allocation failed
+     */
+    const uint8_t* base_address() const {
+        return m_memory;
+    }
+
+    /**
+     * @brief Get the virtual arena backing a growable free list
+     * @return The arena; base() is nullptr for a fixed-size free list
+     */
+    const VirtualArena& arena() const {
+        return m_arena;
     }
 
     /**
@@ -262,180 +336,458 @@ public:
      */
     size_t free_block_count() const {
         size_t count = 0;
-        FreeBlock* current = m_free_list;
-        while (current) {
-            count++;
-            current = current->next;
-        }
+        for_each_free_block([&](const FreeBlock*) { count++; });
         return count;
     }
 
+    /**
+     * @brief Track allocated blocks, headers included, across the whole reservation
+     * @return false if the arena could not be allocated
+     */
+    bool set_occupancy_tracking(bool enabled) override {
+        if (!enabled) {
+            m_occupancy.disable();
+            return true;
+        }
+        if (!m_memory) return false;
+        m_occupancy.enable(m_memory, m_total_size);
+        for (uint8_t* p = m_memory; p < arena_end();) {
+            size_t size = reinterpret_cast<FreeBlock*>(p)->size;
+            if (!(size & FREE_FLAG)) m_occupancy.add(p, size & ~FLAG_MASK);
+            p += size & ~FLAG_MASK;
+        }
+        return true;
+    }
+
+    OccupancyView occupancy() const override {
+        return m_occupancy.view();
+    }
+
+    /**
+     * @brief Attach a profiler; refused when StatsPolicy has no PROFILE hooks
+     */
+    bool set_profiler(AllocationProfiler* profiler) override {
+        return attach_profiler<StatsPolicy>(profiler);
+    }
+
     /**
      * @brief Get largest free block size
      * @return Size of largest contiguous free region
      */
     size_t largest_free_block() const {
-        size_t largest = 0;
-        FreeBlock* current = m_free_list;
-        while (current) {
-            if (current->size > largest) {
-                largest = current->size;
+        if (m_largest_dirty) {
+            m_largest_free = 0;
+            if (m_fl_bitmap) {
+                // The highest non-empty bin holds the largest blocks
+                unsigned fl = MemoryUtils::floor_log2(m_fl_bitmap);
+                unsigned sl = MemoryUtils::floor_log2(m_sl_bitmap[fl]);
+                for (const FreeBlock* block = m_bins[fl][sl]; block; block = block->next) {
+                    m_largest_free = std::max(m_largest_free, block_size_of(block));
+                }
             }
-            current = current->next;
+            m_largest_dirty = false;
         }
-        return largest;
+        return m_largest_free;
     }
 
 private:
-    static constexpr size_t MIN_BLOCK_SIZE = 16; ///< Minimum block size
+    static constexpr size_t ALIGNMENT = 16;            ///< Block granularity and base alignment
+    static constexpr size_t FREE_FLAG = 0x1;           ///< Block is free
+    static constexpr size_t PREV_FREE_FLAG = 0x2;      ///< Physically previous block is free
+    static constexpr size_t SHIFT_TAG = 0x8;           ///< Marks an alignment back-tag (never set in sizes)
+    static constexpr size_t FLAG_MASK = ALIGNMENT - 1; ///< Low bits of size used for flags
+
+    static constexpr unsigned SL_BITS = 4;                        ///< log2 of sub-bins per power of two
+    static constexpr unsigned SL_COUNT = 1u << SL_BITS;           ///< Sub-bins per power of two
+    static constexpr unsigned FL_SHIFT = SL_BITS + 4;             ///< Sizes below 2^FL_SHIFT use linear bins
+    static constexpr size_t SMALL_BLOCK = size_t(1) << FL_SHIFT;  ///< Upper bound of linear bins
+    static constexpr unsigned FL_COUNT = 64 - FL_SHIFT + 1;       ///< First-level bins
+
+    /**
+     * @struct AllocationHeader
+     * @brief Allocated block header
+     */
+    struct AllocationHeader {
+        size_t size;       ///< Total block size | flags
+        size_t adjustment; ///< Requested size of the allocation
+    };
 
     /**
      * @struct FreeBlock
-     * @brief Free block header
+     * @brief Free block header (a size footer sits in the block's last word)
      */
     struct FreeBlock {
-        size_t size;     ///< Total size including header
-        FreeBlock* next; ///< Next free block
+        size_t size;     ///< Total size including header | flags
+        size_t unused;   ///< Overlays AllocationHeader::adjustment
+        FreeBlock* next; ///< Next free block in the same bin
+        FreeBlock* prev; ///< Previous free block in the same bin
     };
 
+    static constexpr size_t MIN_BLOCK_SIZE =
+        (sizeof(FreeBlock) + sizeof(size_t) + ALIGNMENT - 1) & ~(ALIGNMENT - 1); ///< Minimum block size
+
+    FitPolicy m_policy;     ///< Allocation policy
+    uint8_t* m_memory;      ///< Memory buffer
+    size_t m_arena_size;    ///< Usable bytes (multiple of ALIGNMENT)
+    int m_numa_node;        ///< Node the arena is bound to, or Numa::ANY_NODE
+    VirtualArena m_arena;   ///< Backing range when growable
+    size_t m_initial_commit = 0;             ///< Bytes a growable arena keeps committed across reset()
+    bool m_tail_free = false;                ///< Physically last block is free
+    uint64_t m_fl_bitmap = 0;                ///< Non-empty first-level bins
+    uint32_t m_sl_bitmap[FL_COUNT] = {};     ///< Non-empty second-level bins
+    FreeBlock* m_bins[FL_COUNT][SL_COUNT] = {}; ///< Bin heads
+    size_t m_free_bytes = 0;                 ///< Sum of free block sizes
+    mutable size_t m_largest_free = 0;       ///< Cached largest free block
+    mutable bool m_largest_dirty = false;    ///< Cache must be recomputed
+    OccupancyMap m_occupancy;                ///< Allocated blocks, while tracking is on
+
+    static size_t block_size_of(const FreeBlock* block) {
+        return block->size & ~FLAG_MASK;
+    }
+
+    uint8_t* arena_end() const {
+        return m_memory + m_arena_size;
+    }
+
     /**
-     * @struct AllocationHeader
-     * @brief Allocated block header
+     * @brief Get the physically following block, or nullptr at the arena end
      */
-    struct AllocationHeader {
-        size_t size;       ///< Total allocation size
-        size_t adjustment; ///< Alignment adjustment
-    };
+    FreeBlock* next_physical(FreeBlock* block, size_t size) const {
+        uint8_t* next = reinterpret_cast<uint8_t*>(block) + size;
+        return next < arena_end() ? reinterpret_cast<FreeBlock*>(next) : nullptr;
+    }
 
-    FitPolicy m_policy;    ///< Allocation policy
-    uint8_t* m_memory;     ///< Memory buffer
-    FreeBlock* m_free_list; ///< Head of free list
+    /**
+     * @brief Set or clear the PREV_FREE flag of block
+     *
+     * A null block is the end of the arena; the flag is kept in m_tail_free
+     * so growth can merge with a free last block.
+     */
+    void set_prev_free(FreeBlock* block, bool prev_free) {
+        if (!block) {
+            m_tail_free = prev_free;
+            return;
+        }
+        block->size = prev_free ? (block->size | PREV_FREE_FLAG) : (block->size & ~PREV_FREE_FLAG);
+    }
 
     /**
-     * @brief Find first fitting block
+     * @brief Write header and footer of a free block
+     * @note The caller flags the following block's PREV_FREE bit
      */
-    void find_first_fit(size_t size, FreeBlock*& out_block, FreeBlock*& out_prev) {
-        FreeBlock* current = m_free_list;
-        FreeBlock* prev = nullptr;
+    void write_free_block(FreeBlock* block, size_t size, bool prev_free) {
+        block->size = size | FREE_FLAG | (prev_free ? PREV_FREE_FLAG : 0);
+        block->next = nullptr;
+        block->prev = nullptr;
+        *reinterpret_cast<size_t*>(reinterpret_cast<uint8_t*>(block) + size - sizeof(size_t)) = size;
+    }
 
-        while (current) {
-            if (current->size >= size) {
-                out_block = current;
-                out_prev = prev;
-                return;
-            }
-            prev = current;
-            current = current->next;
+    /**
+     * @brief Recover the block header from a user pointer
+     */
+    static AllocationHeader* header_from_pointer(void* ptr) {
+        uint8_t* p = static_cast<uint8_t*>(ptr);
+        size_t tag = reinterpret_cast<size_t*>(p)[-2];
+        if (tag & SHIFT_TAG) {
+            p -= tag & ~FLAG_MASK;
         }
+        return reinterpret_cast<AllocationHeader*>(p) - 1;
+    }
 
-        out_block = nullptr;
-        out_prev = nullptr;
+    /**
+     * @brief Set up the arena as one free block
+     */
+    void initialize_arena() {
+        m_free_bytes = 0;
+        m_largest_free = 0;
+        m_largest_dirty = false;
+        m_fl_bitmap = 0;
+        std::fill(std::begin(m_sl_bitmap), std::end(m_sl_bitmap), 0u);
+        for (auto& row : m_bins) {
+            std::fill(std::begin(row), std::end(row), nullptr);
+        }
+
+        m_tail_free = false;
+        if (m_memory && m_arena_size >= MIN_BLOCK_SIZE) {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(m_memory);
+            write_free_block(block, m_arena_size, false);
+            insert_free_block(block);
+            m_tail_free = true;
+        }
     }
 
     /**
-     * @brief Find best fitting block
+     * @brief Commit more of a growable arena and free it onto the tail
+     * @param needed Size of the block that did not fit
+     * @return false for fixed arenas or when the reservation is exhausted
      */
-    void find_best_fit(size_t size, FreeBlock*& out_block, FreeBlock*& out_prev) {
-        FreeBlock* best = nullptr;
-        FreeBlock* best_prev = nullptr;
-        size_t best_size = SIZE_MAX;
+    bool grow(size_t needed) {
+        if (!m_arena.base()) return false;
+        size_t old_size = m_arena_size;
+        size_t target = std::min(old_size + std::max(needed + MIN_BLOCK_SIZE, old_size), m_arena.reserved());
+        if (target <= old_size || !m_arena.commit(target)) return false;
+        size_t added = (m_arena.committed() & ~(ALIGNMENT - 1)) - old_size;
+        if (added < MIN_BLOCK_SIZE) return false;
+
+        // Shape the new range as an allocated block and free it, so it
+        // merges with a free last block through the normal coalescing path
+        FreeBlock* extension = reinterpret_cast<FreeBlock*>(m_memory + old_size);
+        extension->size = added | (m_tail_free ? PREV_FREE_FLAG : 0);
+        m_arena_size = old_size + added;
+        insert_free_block(coalesce(extension));
+        return true;
+    }
 
-        FreeBlock* current = m_free_list;
-        FreeBlock* prev = nullptr;
+    /**
+     * @brief Map a block size to the bin that stores it
+     */
+    static void mapping_insert(size_t size, unsigned& fl, unsigned& sl) {
+        if (size < SMALL_BLOCK) {
+            fl = 0;
+            sl = static_cast<unsigned>(size / (SMALL_BLOCK / SL_COUNT));
+        } else {
+            unsigned log2 = MemoryUtils::floor_log2(size);
+            sl = static_cast<unsigned>(size >> (log2 - SL_BITS)) ^ SL_COUNT;
+            fl = log2 - FL_SHIFT + 1;
+        }
+    }
 
-        while (current) {
-            if (current->size >= size && current->size < best_size) {
-                best = current;
-                best_prev = prev;
-                best_size = current->size;
+    /**
+     * @brief Map a request to the first bin whose blocks are all large enough
+     * @return false if the rounded size overflows the bin range
+     */
+    static bool mapping_search(size_t size, unsigned& fl, unsigned& sl) {
+        if (size >= SMALL_BLOCK) {
+            size_t round = (size_t(1) << (MemoryUtils::floor_log2(size) - SL_BITS)) - 1;
+            if (size + round < size) return false;
+            size += round;
+        }
+        mapping_insert(size, fl, sl);
+        return true;
+    }
+
+    /**
+     * @brief Find the first non-empty bin at or above (fl, sl)
+     * @return false if there is none
+     */
+    bool find_nonempty_bin(unsigned& fl, unsigned& sl) const {
+        if (fl >= FL_COUNT) return false;
+
+        uint32_t sl_map = sl < SL_COUNT ? (m_sl_bitmap[fl] & (~0u << sl)) : 0;
+        if (!sl_map) {
+            uint64_t fl_map = fl + 1 < 64 ? (m_fl_bitmap & (~uint64_t(0) << (fl + 1))) : 0;
+            if (!fl_map) return false;
+            fl = MemoryUtils::count_trailing_zeros(fl_map);
+            sl_map = m_sl_bitmap[fl];
+        }
+        sl = MemoryUtils::count_trailing_zeros(sl_map);
+        return true;
+    }
+
+    /**
+     * @brief Smallest block >= size within the bin holding size itself
+     */
+    FreeBlock* scan_own_bin(size_t size) const {
+        unsigned fl, sl;
+        mapping_insert(size, fl, sl);
+
+        FreeBlock* best = nullptr;
+        for (FreeBlock* block = m_bins[fl][sl]; block; block = block->next) {
+            size_t block_size = block_size_of(block);
+            if (block_size >= size && (!best || block_size < block_size_of(best))) {
+                best = block;
             }
-            prev = current;
-            current = current->next;
         }
+        return best;
+    }
+
+    FreeBlock* find_block(size_t size) const {
+        switch (m_policy) {
+            case FitPolicy::FIRST_FIT:
+                return find_first_fit(size);
+            case FitPolicy::BEST_FIT:
+                return find_best_fit(size);
+            case FitPolicy::WORST_FIT:
+                return find_worst_fit(size);
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Find first fitting block
+     *
+     * Head of the first bin guaranteed to fit; falls back to the request's
+     * own bin, which may still contain a large enough block.
+     */
+    FreeBlock* find_first_fit(size_t size) const {
+        unsigned fl, sl;
+        if (mapping_search(size, fl, sl) && find_nonempty_bin(fl, sl)) {
+            return m_bins[fl][sl];
+        }
+        return scan_own_bin(size);
+    }
 
-        out_block = best;
-        out_prev = best_prev;
+    /**
+     * @brief Find best fitting block
+     *
+     * Every block in a higher bin is larger than every block in a lower one,
+     * so the smallest fit lives either in the request's own bin or in the
+     * next non-empty bin above it.
+     */
+    FreeBlock* find_best_fit(size_t size) const {
+        FreeBlock* best = scan_own_bin(size);
+        if (best) return best;
+
+        unsigned fl, sl;
+        mapping_insert(size, fl, sl);
+        sl++;
+        if (!find_nonempty_bin(fl, sl)) return nullptr;
+
+        for (FreeBlock* block = m_bins[fl][sl]; block; block = block->next) {
+            if (!best || block_size_of(block) < block_size_of(best)) {
+                best = block;
+            }
+        }
+        return best;
     }
 
     /**
      * @brief Find worst fitting block
      */
-    void find_worst_fit(size_t size, FreeBlock*& out_block, FreeBlock*& out_prev) {
-        FreeBlock* worst = nullptr;
-        FreeBlock* worst_prev = nullptr;
-        size_t worst_size = 0;
+    FreeBlock* find_worst_fit(size_t size) const {
+        if (!m_fl_bitmap) return nullptr;
 
-        FreeBlock* current = m_free_list;
-        FreeBlock* prev = nullptr;
+        unsigned fl = MemoryUtils::floor_log2(m_fl_bitmap);
+        unsigned sl = MemoryUtils::floor_log2(m_sl_bitmap[fl]);
 
-        while (current) {
-            if (current->size >= size && current->size > worst_size) {
-                worst = current;
-                worst_prev = prev;
-                worst_size = current->size;
+        FreeBlock* worst = nullptr;
+        for (FreeBlock* block = m_bins[fl][sl]; block; block = block->next) {
+            if (!worst || block_size_of(block) > block_size_of(worst)) {
+                worst = block;
             }
-            prev = current;
-            current = current->next;
         }
-
-        out_block = worst;
-        out_prev = worst_prev;
+        return (worst && block_size_of(worst) >= size) ? worst : nullptr;
     }
 
     /**
-     * @brief Insert block into sorted free list
+     * @brief Push a free block onto its bin
      */
     void insert_free_block(FreeBlock* block) {
-        if (!m_free_list || block < m_free_list) {
-            block->next = m_free_list;
-            m_free_list = block;
-            return;
-        }
+        size_t size = block_size_of(block);
+        unsigned fl, sl;
+        mapping_insert(size, fl, sl);
 
-        FreeBlock* current = m_free_list;
-        while (current->next && current->next < block) {
-            current = current->next;
+        m_free_bytes += size;
+        if (!m_largest_dirty && size > m_largest_free) m_largest_free = size;
+
+        FreeBlock* head = m_bins[fl][sl];
+        block->next = head;
+        block->prev = nullptr;
+        if (head) head->prev = block;
+        m_bins[fl][sl] = block;
+
+        m_fl_bitmap |= uint64_t(1) << fl;
+        m_sl_bitmap[fl] |= 1u << sl;
+    }
+
+    /**
+     * @brief Unlink a free block from its bin
+     */
+    void remove_free_block(FreeBlock* block) {
+        size_t size = block_size_of(block);
+        unsigned fl, sl;
+        mapping_insert(size, fl, sl);
+
+        m_free_bytes -= size;
+        if (size == m_largest_free) m_largest_dirty = true;
+
+        if (block->prev) {
+            block->prev->next = block->next;
+        } else {
+            m_bins[fl][sl] = block->next;
         }
+        if (block->next) block->next->prev = block->prev;
 
-        block->next = current->next;
-        current->next = block;
+        if (!m_bins[fl][sl]) {
+            m_sl_bitmap[fl] &= ~(1u << sl);
+            if (!m_sl_bitmap[fl]) m_fl_bitmap &= ~(uint64_t(1) << fl);
+        }
     }
 
     /**
-     * @brief Coalesce adjacent free blocks
+     * @brief Merge a freed block with free physical neighbours
+     * @return The merged free block (not yet in a bin)
      */
-    void coalesce() {
-        FreeBlock* current = m_free_list;
+    FreeBlock* coalesce(FreeBlock* block) {
+        size_t size = block_size_of(block);
+        bool prev_free = (block->size & PREV_FREE_FLAG) != 0;
+
+        FreeBlock* next = next_physical(block, size);
+        if (next && (next->size & FREE_FLAG)) {
+            remove_free_block(next);
+            size += block_size_of(next);
+        }
 
-        while (current && current->next) {
-            uint8_t* current_end = reinterpret_cast<uint8_t*>(current) + current->size;
-            
-            if (current_end == reinterpret_cast<uint8_t*>(current->next)) {
-                // Adjacent blocks - merge
-                current->size += current->next->size;
-                current->next = current->next->next;
-                // Don't advance - check for more merges
-            } else {
-                current = current->next;
+        if (prev_free) {
+            size_t prev_size = *(reinterpret_cast<size_t*>(block) - 1);
+            FreeBlock* prev = reinterpret_cast<FreeBlock*>(reinterpret_cast<uint8_t*>(block) - prev_size);
+            remove_free_block(prev);
+            size += prev_size;
+            // The absorbed header now lies inside prev; mark it free so
+            // a repeated free of the same pointer is still refused
+            block->size = FREE_FLAG;
+            block = prev;
+            prev_free = (prev->size & PREV_FREE_FLAG) != 0;
+        }
+
+        write_free_block(block, size, prev_free);
+        set_prev_free(next_physical(block, size), true);
+        return block;
+    }
+
+    template <typename Fn>
+    void for_each_free_block(Fn&& fn) const {
+        uint64_t fl_map = m_fl_bitmap;
+        while (fl_map) {
+            unsigned fl = MemoryUtils::count_trailing_zeros(fl_map);
+            fl_map &= fl_map - 1;
+            for (unsigned sl = 0; sl < SL_COUNT; ++sl) {
+                for (const FreeBlock* block = m_bins[fl][sl]; block; block = block->next) {
+                    fn(block);
+                }
             }
         }
     }
 
     /**
-     * @brief Update fragmentation estimate
+     * @brief Update fragmentation estimate (lazily, from stats())
+     *
+     * Only committed free blocks count: the uncommitted reservation is not
+     * fragmented, it is reported as reserved_headroom_bytes instead.
      */
-    void update_fragmentation() {
-        size_t free_memory = available();
+    void update_derived_stats() const override {
+        if constexpr (!StatsPolicy::COUNTERS) return;
+
         size_t largest = largest_free_block();
-        
-        if (free_memory > 0 && largest < free_memory) {
-            m_stats.fragmentation_bytes = free_memory - largest;
-        } else {
-            m_stats.fragmentation_bytes = 0;
-        }
+        m_stats.fragmentation_bytes = m_free_bytes > largest ? m_free_bytes - largest : 0;
+        m_stats.reserved_headroom_bytes = reserved_headroom();
     }
 };
 
+using FreeListAllocator = BasicFreeListAllocator<>;
+
+MEMORY_ENGINE_REGISTER_ALLOCATOR(freelist_allocator, {
+    "freelist", "Free List Allocator", {false, true, true, true},
+    {{"size", 16 * 1024 * 1024, "arena bytes"},
+     {"policy", static_cast<size_t>(FitPolicy::BEST_FIT), "0 first-fit, 1 best-fit, 2 worst-fit"}},
+    [](const AllocatorParams& params) -> std::unique_ptr<BaseAllocator> {
+        size_t policy = params.get("policy");
+        if (!params.get("size") || policy > static_cast<size_t>(FitPolicy::WORST_FIT)) return nullptr;
+        return std::make_unique<FreeListAllocator>(params.get("size"), static_cast<FitPolicy>(policy),
+                                                   params.numa_node);
+    }
+});
+
 } // namespace memory_engine
 
 #endif // FREELIST_ALLOCATOR_HPP
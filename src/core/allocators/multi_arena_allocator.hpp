@@ -0,0 +1,470 @@
+/**
+ * @file multi_arena_allocator.hpp
+ * @brief Thread-safe general-purpose allocator: one free-list arena per thread
+ * @author Bambang Hutagalung
+ * @date 2026
+ */
+
+#ifndef MULTI_ARENA_ALLOCATOR_HPP
+#define MULTI_ARENA_ALLOCATOR_HPP
+
+#include "allocator_registry.hpp"
+#include "base_allocator.hpp"
+#include "freelist_allocator.hpp"
+#include "../utils/memory_utils.hpp"
+#include "../utils/numa.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace memory_engine {
+
+/**
+ * @class BasicMultiArenaAllocator
+ * @brief Free-list arenas owned by threads, with lock-free remote frees
+ *
+ * The arena layout is mimalloc/jemalloc style: arena_count independent
+ * BasicFreeListAllocator heaps, each claimed by the first thread that
+ * allocates without one and released when that thread exits. Only the
+ * owner ever touches a heap, so its allocate and free run at free-list
+ * speed with no lock or atomic read-modify-write.
+ *
+ * A block freed by any other thread is pushed onto its arena's remote-free
+ * list, an intrusive lock-free stack whose link overlays the first word of
+ * the payload. The owner takes the whole list with one exchange the next
+ * time it allocates and frees the batch into its heap, so coalescing stays
+ * owner-only. The push is a single CAS, and it cannot suffer ABA because
+ * the owner never pops single nodes.
+ *
+ * Advantages:
+ * - Variable sizes and any-order frees, like FreeListAllocator, from any thread
+ * - No shared lock; threads contend only on a remote list, and only when
+ *   they free each other's blocks
+ *
+ * Disadvantages:
+ * - A thread cannot allocate once every arena is owned; size arena_count
+ *   for the threads alive at once
+ * - Remote frees become reusable, and leave stats(), only when the owner
+ *   next allocates
+ * - An arena can run out while others have room
+ * - A double free from a non-owner thread is not detected (as with free())
+ * - reset(), stats() and available() must only be called while no other
+ *   thread uses the allocator
+ *
+ * @tparam StatsPolicy Instrumentation policy of every arena
+ */
+template <typename StatsPolicy = DefaultStatsPolicy>
+class BasicMultiArenaAllocator : public BaseAllocator {
+public:
+    using Heap = BasicFreeListAllocator<StatsPolicy>;
+
+    static constexpr size_t DEFAULT_ARENA_SIZE = 4 * 1024 * 1024;
+    static constexpr size_t DEFAULT_ARENA_COUNT = 32;
+
+    /**
+     * @brief Constructor
+     * @param arena_size Bytes per arena
+     * @param arena_count Arenas, i.e. threads that can allocate at once
+     * @param policy Fit policy of every arena
+     * @param numa_node Node to bind the arenas to (Numa::ANY_NODE = first touch)
+     */
+    explicit BasicMultiArenaAllocator(size_t arena_size = DEFAULT_ARENA_SIZE,
+                                      size_t arena_count = DEFAULT_ARENA_COUNT,
+                                      FitPolicy policy = FitPolicy::BEST_FIT,
+                                      int numa_node = Numa::ANY_NODE)
+        : BaseAllocator("Multi-Arena Free List Allocator", 0)
+        , m_id(s_next_id.fetch_add(1, std::memory_order_relaxed))
+        , m_shared(std::make_shared<SharedState>())
+    {
+        SharedState& shared = *m_shared;
+        shared.arena_count = arena_count;
+        shared.arenas.reset(new Arena[arena_count]);
+        for (size_t i = 0; i < arena_count; ++i) {
+            shared.arenas[i].heap = std::make_unique<Heap>(arena_size, policy, numa_node);
+            const uint8_t* base = shared.arenas[i].heap->base_address();
+            if (!base) continue;
+            shared.ranges.push_back({reinterpret_cast<uintptr_t>(base),
+                                     reinterpret_cast<uintptr_t>(base) + shared.arenas[i].heap->total_size(), i});
+            m_total_size += shared.arenas[i].heap->total_size();
+        }
+        std::sort(shared.ranges.begin(), shared.ranges.end(),
+                  [](const Range& a, const Range& b) { return a.begin < b.begin; });
+    }
+
+    /**
+     * @brief Destructor
+     *
+     * The arenas are owned by the shared state, so threads that exit later
+     * find their binding expired instead of touching a freed heap.
+     */
+    ~BasicMultiArenaAllocator() override = default;
+
+    // Disable copy and move (thread bindings are keyed by instance)
+    BasicMultiArenaAllocator(const BasicMultiArenaAllocator&) = delete;
+    BasicMultiArenaAllocator& operator=(const BasicMultiArenaAllocator&) = delete;
+    BasicMultiArenaAllocator(BasicMultiArenaAllocator&&) = delete;
+    BasicMultiArenaAllocator& operator=(BasicMultiArenaAllocator&&) = delete;
+
+    /**
+     * @brief Allocate from the calling thread's arena
+     * @param size Size to allocate
+     * @param alignment Alignment requirement (power of 2)
+     * @return Pointer to allocated memory, or nullptr if the arena is full
+     *         or no arena is left to claim
+     */
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) override {
+        Arena* arena = local_arena();
+        if (!arena) return nullptr;
+
+        if (arena->remote_head.load(std::memory_order_relaxed)) drain(*arena);
+        void* ptr = arena->heap->allocate(size, alignment);
+        if (!ptr && arena->remote_head.load(std::memory_order_relaxed)) {
+            // Blocks freed elsewhere since the check above may make room
+            drain(*arena);
+            ptr = arena->heap->allocate(size, alignment);
+        }
+        return ptr;
+    }
+
+    /**
+     * @brief Free a block allocated by any thread
+     * @param ptr Pointer to deallocate
+     *
+     * The owner frees straight into its heap; any other thread pushes the
+     * block onto the owning arena's remote-free list.
+     */
+    void deallocate(void* ptr) override {
+        if (!ptr) return;
+        Arena* arena = arena_of(ptr);
+        if (!arena) {
+            m_shared->rejected.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // Only this thread can store its own token, so a stale read is never a false match
+        if (arena->owner.load(std::memory_order_relaxed) == thread_token()) {
+            arena->heap->deallocate(ptr);
+            return;
+        }
+
+        RemoteBlock* block = static_cast<RemoteBlock*>(ptr);
+        block->next = arena->remote_head.load(std::memory_order_relaxed);
+        while (!arena->remote_head.compare_exchange_weak(block->next, block, std::memory_order_release,
+                                                         std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief Reset every arena
+     *
+     * Must only be called while no other thread is using the allocator.
+     * Threads keep the arenas they own; pending remote frees are discarded
+     * along with everything else.
+     */
+    void reset() override {
+        for (size_t i = 0; i < m_shared->arena_count; ++i) {
+            Arena& arena = m_shared->arenas[i];
+            arena.remote_head.store(nullptr, std::memory_order_relaxed);
+            arena.remote_drained = 0;
+            arena.heap->reset();
+        }
+        m_shared->rejected.store(0, std::memory_order_relaxed);
+        reset_stats();
+    }
+
+    /**
+     * @brief Check if ptr lies in any arena
+     * @param ptr Pointer to check
+     * @return true if owned
+     */
+    bool owns(void* ptr) const override {
+        return ptr && arena_of(ptr) != nullptr;
+    }
+
+    /**
+     * @brief Arenas are owned per thread, so the allocator may be shared
+     * @return Always true
+     */
+    bool is_thread_safe() const override {
+        return true;
+    }
+
+    /**
+     * @brief A profiler is not synchronized, so only detaching succeeds
+     * @return true for nullptr
+     */
+    bool set_profiler(AllocationProfiler* profiler) override {
+        return profiler == nullptr;
+    }
+
+    /**
+     * @brief Drain and give up the calling thread's arena
+     *
+     * Its live blocks stay valid, and another thread may claim the arena.
+     * Called automatically when a thread exits.
+     */
+    void release_thread_arena() {
+        BindingTable& table = binding_table();
+        for (auto& binding : table.bindings) {
+            if (binding.owner_id == m_id) {
+                release(binding);
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Get the number of arenas
+     * @return Arena count (including any that could not be allocated)
+     */
+    size_t arena_count() const {
+        return m_shared->arena_count;
+    }
+
+    /**
+     * @brief Get the number of arenas currently owned by a thread
+     */
+    size_t owned_arenas() const {
+        size_t owned = 0;
+        for (size_t i = 0; i < m_shared->arena_count; ++i) {
+            if (m_shared->arenas[i].owner.load(std::memory_order_relaxed)) owned++;
+        }
+        return owned;
+    }
+
+    /**
+     * @brief Get the number of blocks owners have taken off remote-free lists
+     * @return Total since construction or the last reset()
+     */
+    size_t remote_frees() const {
+        size_t drained = 0;
+        for (size_t i = 0; i < m_shared->arena_count; ++i) drained += m_shared->arenas[i].remote_drained;
+        return drained;
+    }
+
+    /**
+     * @brief Get available memory
+     * @return Free bytes summed over all arenas
+     */
+    size_t available() const override {
+        size_t free_bytes = 0;
+        for (size_t i = 0; i < m_shared->arena_count; ++i) free_bytes += m_shared->arenas[i].heap->available();
+        return free_bytes;
+    }
+
+private:
+    /**
+     * @struct RemoteBlock
+     * @brief Link written into a block freed by a non-owner thread
+     */
+    struct RemoteBlock {
+        RemoteBlock* next;
+    };
+
+    /**
+     * @struct Arena
+     * @brief One heap plus its remote-free list, on its own cache lines
+     */
+    struct alignas(MemoryUtils::CACHE_LINE_SIZE) Arena {
+        std::unique_ptr<Heap> heap;
+        std::atomic<uint64_t> owner{0};                  ///< Owning thread's token, 0 = unclaimed
+        size_t remote_drained = 0;                       ///< Owner-only count of drained remote frees
+        alignas(MemoryUtils::CACHE_LINE_SIZE)
+        std::atomic<RemoteBlock*> remote_head{nullptr};  ///< Pushed by other threads, taken by the owner
+    };
+
+    /**
+     * @struct Range
+     * @brief Address range of one arena, for pointer-to-arena lookup
+     */
+    struct Range {
+        uintptr_t begin;
+        uintptr_t end;
+        size_t index;
+    };
+
+    /**
+     * @struct SharedState
+     * @brief Arenas and lookup table, shared with thread bindings
+     */
+    struct SharedState {
+        std::unique_ptr<Arena[]> arenas;
+        size_t arena_count = 0;
+        std::vector<Range> ranges;          ///< Sorted by begin; immutable after construction
+        std::atomic<size_t> rejected{0};    ///< Frees of pointers in no arena
+    };
+
+    /**
+     * @struct Binding
+     * @brief The arena the current thread owns in one allocator instance
+     */
+    struct Binding {
+        uint64_t owner_id = 0;                ///< Allocator instance id
+        std::weak_ptr<SharedState> shared;    ///< Liveness of the owning allocator
+        Arena* arena = nullptr;               ///< nullptr once released
+    };
+
+    /**
+     * @struct BindingTable
+     * @brief All bindings of the current thread; releases them on thread exit
+     */
+    struct BindingTable {
+        std::vector<Binding> bindings;
+
+        ~BindingTable() {
+            for (auto& binding : bindings) {
+                // Keeps the arena alive even if the allocator is gone
+                auto shared = binding.shared.lock();
+                if (shared) release(binding);
+            }
+        }
+    };
+
+    inline static std::atomic<uint64_t> s_next_id{1};     ///< Instance id generator
+    inline static std::atomic<uint64_t> s_next_token{1};  ///< Thread token generator
+
+    uint64_t m_id;                          ///< Unique instance id (never reused)
+    std::shared_ptr<SharedState> m_shared;  ///< Arenas
+
+    static BindingTable& binding_table() {
+        thread_local BindingTable table;
+        return table;
+    }
+
+    static uint64_t thread_token() {
+        thread_local const uint64_t token = s_next_token.fetch_add(1, std::memory_order_relaxed);
+        return token;
+    }
+
+    /**
+     * @brief The calling thread's arena, claiming an unowned one on first use
+     * @return nullptr if every arena is owned
+     */
+    Arena* local_arena() {
+        BindingTable& table = binding_table();
+        Binding* binding = nullptr;
+        for (auto& candidate : table.bindings) {
+            if (candidate.owner_id == m_id) {
+                if (candidate.arena) return candidate.arena;
+                binding = &candidate;
+                break;
+            }
+        }
+
+        if (!binding) {
+            // Drop bindings of allocators that no longer exist
+            table.bindings.erase(
+                std::remove_if(table.bindings.begin(), table.bindings.end(),
+                    [](const Binding& b) { return b.shared.expired(); }),
+                table.bindings.end());
+            table.bindings.push_back({m_id, m_shared, nullptr});
+            binding = &table.bindings.back();
+        }
+
+        const uint64_t token = thread_token();
+        for (size_t i = 0; i < m_shared->arena_count; ++i) {
+            Arena& arena = m_shared->arenas[i];
+            uint64_t unowned = 0;
+            // Acquire pairs with the previous owner's release, making its heap writes visible
+            if (arena.heap->base_address() &&
+                arena.owner.compare_exchange_strong(unowned, token, std::memory_order_acquire,
+                                                    std::memory_order_relaxed)) {
+                binding->arena = &arena;
+                return &arena;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Arena whose range contains ptr, or nullptr
+     */
+    Arena* arena_of(void* ptr) const {
+        const uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+        const auto& ranges = m_shared->ranges;
+        auto it = std::upper_bound(ranges.begin(), ranges.end(), address,
+                                   [](uintptr_t a, const Range& range) { return a < range.begin; });
+        if (it == ranges.begin()) return nullptr;
+        --it;
+        return address < it->end ? &m_shared->arenas[it->index] : nullptr;
+    }
+
+    /**
+     * @brief Free everything on the arena's remote list into its heap
+     * @note Owner thread only
+     */
+    static void drain(Arena& arena) {
+        RemoteBlock* block = arena.remote_head.exchange(nullptr, std::memory_order_acquire);
+        while (block) {
+            RemoteBlock* next = block->next;
+            arena.heap->deallocate(block);
+            arena.remote_drained++;
+            block = next;
+        }
+    }
+
+    /**
+     * @brief Drain the bound arena and hand it back
+     * @note Owner thread only
+     */
+    static void release(Binding& binding) {
+        if (!binding.arena) return;
+        drain(*binding.arena);
+        binding.arena->owner.store(0, std::memory_order_release);
+        binding.arena = nullptr;
+    }
+
+    /**
+     * @brief Sum the arenas' statistics (lazily, from stats())
+     *
+     * Peak usage is the sum of per-arena peaks, an upper bound on the
+     * allocator's true peak.
+     */
+    void update_derived_stats() const override {
+        const size_t rejected = m_shared->rejected.load(std::memory_order_relaxed);
+        m_stats.rejected_deallocations = rejected;
+        if constexpr (!StatsPolicy::COUNTERS) return;
+
+        AllocationStats total;
+        total.rejected_deallocations = rejected;
+        double alloc_time = 0;
+        double dealloc_time = 0;
+        for (size_t i = 0; i < m_shared->arena_count; ++i) {
+            const AllocationStats& s = m_shared->arenas[i].heap->stats();
+            total.total_allocations += s.total_allocations;
+            total.total_deallocations += s.total_deallocations;
+            total.current_allocations += s.current_allocations;
+            total.total_bytes_allocated += s.total_bytes_allocated;
+            total.current_bytes_used += s.current_bytes_used;
+            total.peak_bytes_used += s.peak_bytes_used;
+            total.fragmentation_bytes += s.fragmentation_bytes;
+            total.rejected_deallocations += s.rejected_deallocations;
+            alloc_time += s.avg_allocation_time_ns * s.total_allocations;
+            dealloc_time += s.avg_dealloc_time_ns * s.total_deallocations;
+        }
+        if (total.total_allocations) total.avg_allocation_time_ns = alloc_time / total.total_allocations;
+        if (total.total_deallocations) total.avg_dealloc_time_ns = dealloc_time / total.total_deallocations;
+        m_stats = total;
+    }
+};
+
+using MultiArenaAllocator = BasicMultiArenaAllocator<>;
+
+MEMORY_ENGINE_REGISTER_ALLOCATOR(multi_arena_allocator, {
+    "multi_arena", "Multi-Arena Free List Allocator", {true, true, true, true},
+    {{"arena_size", MultiArenaAllocator::DEFAULT_ARENA_SIZE, "bytes per arena"},
+     {"arena_count", MultiArenaAllocator::DEFAULT_ARENA_COUNT, "arenas; threads that can allocate at once"},
+     {"policy", static_cast<size_t>(FitPolicy::BEST_FIT), "0 first-fit, 1 best-fit, 2 worst-fit"}},
+    [](const AllocatorParams& params) -> std::unique_ptr<BaseAllocator> {
+        size_t policy = params.get("policy");
+        if (!params.get("arena_size") || !params.get("arena_count") ||
+            policy > static_cast<size_t>(FitPolicy::WORST_FIT)) return nullptr;
+        return std::make_unique<MultiArenaAllocator>(params.get("arena_size"), params.get("arena_count"),
+                                                     static_cast<FitPolicy>(policy), params.numa_node);
+    }
+});
+
+} // namespace memory_engine
+
+#endif // MULTI_ARENA_ALLOCATOR_HPP
@@ -8,8 +8,12 @@
 #ifndef POOL_ALLOCATOR_HPP
 #define POOL_ALLOCATOR_HPP
 
+#include "allocator_registry.hpp"
 #include "base_allocator.hpp"
 #include "../utils/timer.hpp"
+#include "../utils/memory_utils.hpp"
+#include "../utils/numa.hpp"
+#include <algorithm>
 #include <vector>
 #include <cstdlib>
 #include <cstring>
@@ -17,7 +21,7 @@
 namespace memory_engine {
 
 /**
- * @class PoolAllocator
+ * @class BasicPoolAllocator
  * @brief Fixed-size block allocator for efficient allocation of same-sized objects
  * 
  * The pool allocator pre-allocates a contiguous block of memory and divides it
@@ -33,16 +37,21 @@ namespace memory_engine {
  * - Fixed block size (internal fragmentation for smaller allocations)
  * - Fixed capacity (cannot grow)
  * - All blocks must be the same size
+ *
+ * @tparam StatsPolicy Instrumentation policy (see stats_policy.hpp)
  */
-class PoolAllocator : public BaseAllocator {
+template <typename StatsPolicy = DefaultStatsPolicy>
+class BasicPoolAllocator : public BaseAllocator {
 public:
     /**
      * @brief Constructor
      * @param block_size Size of each block in bytes
      * @param block_count Number of blocks to allocate
      * @param alignment Memory alignment for blocks
+     * @param numa_node Node to bind the blocks to (Numa::ANY_NODE = first touch)
      */
-    PoolAllocator(size_t block_size, size_t block_count, size_t alignment = alignof(std::max_align_t))
+    BasicPoolAllocator(size_t block_size, size_t block_count, size_t alignment = alignof(std::max_align_t),
+                       int numa_node = Numa::ANY_NODE)
         : BaseAllocator("Pool Allocator", 0)
         , m_block_size(align_size(block_size, alignment))
         , m_block_count(block_count)
@@ -50,18 +59,26 @@ public:
         , m_memory(nullptr)
         , m_free_list(nullptr)
         , m_allocated_blocks(0)
+        , m_numa_node(numa_node)
     {
         // Calculate total size with alignment padding
         m_total_size = m_block_size * m_block_count;
         
-        // Allocate aligned memory
-        #ifdef _WIN32
-        m_memory = static_cast<uint8_t*>(_aligned_malloc(m_total_size, m_alignment));
-        #else
-        m_memory = static_cast<uint8_t*>(std::aligned_alloc(m_alignment, m_total_size));
-        #endif
+        // Node-bound pages are page-aligned; unbound memory if binding fails
+        if (m_numa_node != Numa::ANY_NODE && m_alignment <= MemoryUtils::get_page_size()) {
+            m_memory = static_cast<uint8_t*>(Numa::allocate_on_node(m_total_size, m_numa_node));
+        }
+        if (!m_memory) {
+            m_numa_node = Numa::ANY_NODE;
+            #ifdef _WIN32
+            m_memory = static_cast<uint8_t*>(_aligned_malloc(m_total_size, m_alignment));
+            #else
+            m_memory = static_cast<uint8_t*>(std::aligned_alloc(m_alignment, m_total_size));
+            #endif
+        }
 
         if (m_memory) {
+            m_live.assign((m_block_count + 63) / 64, 0);
             initialize_free_list();
         }
     }
@@ -69,23 +86,27 @@ public:
     /**
      * @brief Destructor
      */
-    ~PoolAllocator() override {
+    ~BasicPoolAllocator() override {
         if (m_memory) {
-            #ifdef _WIN32
-            _aligned_free(m_memory);
-            #else
-            std::free(m_memory);
-            #endif
+            if (m_numa_node != Numa::ANY_NODE) {
+                Numa::free_on_node(m_memory, m_total_size);
+            } else {
+                #ifdef _WIN32
+                _aligned_free(m_memory);
+                #else
+                std::free(m_memory);
+                #endif
+            }
             m_memory = nullptr;
         }
     }
 
     // Disable copy
-    PoolAllocator(const PoolAllocator&) = delete;
-    PoolAllocator& operator=(const PoolAllocator&) = delete;
+    BasicPoolAllocator(const BasicPoolAllocator&) = delete;
+    BasicPoolAllocator& operator=(const BasicPoolAllocator&) = delete;
 
     // Enable move
-    PoolAllocator(PoolAllocator&& other) noexcept
+    BasicPoolAllocator(BasicPoolAllocator&& other) noexcept
         : BaseAllocator(std::move(other))
         , m_block_size(other.m_block_size)
         , m_block_count(other.m_block_count)
@@ -93,6 +114,9 @@ public:
         , m_memory(other.m_memory)
         , m_free_list(other.m_free_list)
         , m_allocated_blocks(other.m_allocated_blocks)
+        , m_numa_node(other.m_numa_node)
+        , m_occupancy(std::move(other.m_occupancy))
+        , m_live(std::move(other.m_live))
     {
         other.m_memory = nullptr;
         other.m_free_list = nullptr;
@@ -112,18 +136,20 @@ public:
             return nullptr;
         }
 
-        Timer timer;
+        OperationTimer<StatsPolicy> timer(m_timing_countdown);
         timer.start();
 
         // Pop from free list
         FreeBlock* block = m_free_list;
         m_free_list = block->next;
         m_allocated_blocks++;
+        set_live(block_index(block), true);
 
         timer.stop();
 
         void* ptr = reinterpret_cast<void*>(block);
-        record_allocation(ptr, m_block_size, m_alignment, timer.elapsed_ns());
+        record_allocation(ptr, m_block_size, m_alignment, timer);
+        if (m_occupancy.enabled()) m_occupancy.add(ptr, m_block_size);
 
         return ptr;
     }
@@ -131,22 +157,119 @@ public:
     /**
      * @brief Return a block to the pool
      * @param ptr Pointer to block to deallocate
+     *
+     * Foreign pointers, pointers into the middle of a block and blocks that
+     * are already free are counted as rejected and otherwise ignored.
      */
     void deallocate(void* ptr) override {
-        if (!ptr || !owns(ptr)) return;
+        if (!ptr) return;
+        if (!is_live_block(ptr)) {
+            record_rejected_deallocation();
+            return;
+        }
 
-        Timer timer;
+        OperationTimer<StatsPolicy> timer(m_timing_countdown);
         timer.start();
 
         // Push back to free list
         FreeBlock* block = reinterpret_cast<FreeBlock*>(ptr);
+        set_live(block_index(block), false);
         block->next = m_free_list;
         m_free_list = block;
         m_allocated_blocks--;
 
         timer.stop();
 
-        record_deallocation(m_block_size, timer.elapsed_ns());
+        record_deallocation(ptr, m_block_size, timer);
+        if (m_occupancy.enabled()) m_occupancy.remove(ptr, m_block_size);
+    }
+
+    /**
+     * @brief Pop several blocks from the free list in one pass
+     * @param size Size requested (must be <= block_size)
+     * @param alignment Alignment (ignored, uses pool alignment)
+     * @param out Array receiving the blocks
+     * @param count Number of blocks requested
+     * @return Number of blocks allocated (fewer if the pool runs out)
+     */
+    size_t allocate_batch(size_t size, size_t alignment, void** out, size_t count) override {
+        (void)alignment; // Pool uses its own alignment
+
+        if (!m_memory || size > m_block_size) {
+            return 0;
+        }
+
+        OperationTimer<StatsPolicy> timer(m_timing_countdown);
+        timer.start();
+
+        size_t allocated = 0;
+        FreeBlock* block = m_free_list;
+        while (allocated < count && block) {
+            out[allocated++] = block;
+            set_live(block_index(block), true);
+            block = block->next;
+        }
+        m_free_list = block;
+        m_allocated_blocks += allocated;
+
+        timer.stop();
+
+        record_allocation_batch(out, allocated, m_block_size, m_alignment, timer);
+        if (m_occupancy.enabled()) {
+            for (size_t i = 0; i < allocated; ++i) m_occupancy.add(out[i], m_block_size);
+        }
+
+        return allocated;
+    }
+
+    /**
+     * @brief Push several blocks back onto the free list in one pass
+     * @param ptrs Pointers to deallocate
+     * @param count Number of pointers
+     *
+     * Rejects the same pointers deallocate() does, including a block that
+     * appears twice in the batch.
+     */
+    void deallocate_batch(void** ptrs, size_t count) override {
+        OperationTimer<StatsPolicy> timer(m_timing_countdown);
+        timer.start();
+
+        size_t freed = 0;
+        std::vector<size_t> rejected; // Indices into ptrs; rare, so allocated lazily
+        FreeBlock* head = m_free_list;
+        for (size_t i = 0; i < count; ++i) {
+            if (!ptrs[i]) continue;
+            if (!is_live_block(ptrs[i])) {
+                record_rejected_deallocation();
+                rejected.push_back(i);
+                continue;
+            }
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(ptrs[i]);
+            set_live(block_index(block), false);
+            block->next = head;
+            head = block;
+            freed++;
+        }
+        m_free_list = head;
+        m_allocated_blocks -= freed;
+
+        timer.stop();
+
+        record_deallocation_batch(freed, freed * m_block_size, timer);
+        const bool history = StatsPolicy::HISTORY || (StatsPolicy::PROFILE && m_profiler);
+        if (m_occupancy.enabled() || history) {
+            const uint64_t timestamp = StatsPolicy::HISTORY ? history_timestamp(timer) : 0;
+            size_t next_rejected = 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (next_rejected < rejected.size() && rejected[next_rejected] == i) {
+                    next_rejected++;
+                    continue;
+                }
+                if (!ptrs[i]) continue;
+                if (m_occupancy.enabled()) m_occupancy.remove(ptrs[i], m_block_size);
+                if (history) record_free_event<StatsPolicy>(ptrs[i], m_block_size, timestamp);
+            }
+        }
     }
 
     /**
@@ -157,8 +280,8 @@ public:
             initialize_free_list();
         }
         m_allocated_blocks = 0;
-        m_stats = AllocationStats{};
-        m_allocation_history.clear();
+        reset_stats();
+        if (m_occupancy.enabled()) m_occupancy.clear();
     }
 
     /**
@@ -205,6 +328,22 @@ public:
         return m_block_count;
     }
 
+    /**
+     * @brief Get start of the pool's buffer
+     * @return Address of block 0, or nullptr if allocation failed
+     */
+    const uint8_t* base_address() const {
+        return m_memory;
+    }
+
+    /**
+     * @brief Get the NUMA node the arena is bound to
+     * @return Node index, or Numa::ANY_NODE if the arena is unbound
+     */
+    int numa_node() const {
+        return m_numa_node;
+    }
+
     /**
      * @brief Get available memory
      * @return Bytes available for allocation
@@ -225,22 +364,44 @@ public:
      * @brief Get memory block grid for visualization
      * @return Vector of bools (true = allocated, false = free)
      */
-    std::vector<bool> get_allocation_grid() const {
-        std::vector<bool> grid(m_block_count, true);
-        
-        // Mark free blocks
-        FreeBlock* current = m_free_list;
-        while (current) {
-            size_t index = (reinterpret_cast<uint8_t*>(current) - m_memory) / m_block_size;
-            if (index < m_block_count) {
-                grid[index] = false;
-            }
-            current = current->next;
+    std::vector<bool> get_allocation_grid() const override {
+        std::vector<bool> grid(m_block_count, false);
+        if (!m_memory) return grid;
+        for (size_t i = 0; i < m_block_count; ++i) {
+            grid[i] = is_live(i);
         }
-        
         return grid;
     }
 
+    /**
+     * @brief Track one cell per block
+     * @return false if the pool's buffer could not be allocated
+     */
+    bool set_occupancy_tracking(bool enabled) override {
+        if (!enabled) {
+            m_occupancy.disable();
+            return true;
+        }
+        if (!m_memory) return false;
+        m_occupancy.enable(m_memory, m_block_count * m_block_size, m_block_size);
+        std::vector<bool> grid = get_allocation_grid();
+        for (size_t i = 0; i < grid.size(); ++i) {
+            if (grid[i]) m_occupancy.add(m_memory + i * m_block_size, m_block_size);
+        }
+        return true;
+    }
+
+    OccupancyView occupancy() const override {
+        return m_occupancy.view();
+    }
+
+    /**
+     * @brief Attach a profiler; refused when StatsPolicy has no PROFILE hooks
+     */
+    bool set_profiler(AllocationProfiler* profiler) override {
+        return attach_profiler<StatsPolicy>(profiler);
+    }
+
 private:
     /**
      * @struct FreeBlock
@@ -256,12 +417,42 @@ private:
     uint8_t* m_memory;        ///< Memory buffer
     FreeBlock* m_free_list;   ///< Head of free list
     size_t m_allocated_blocks; ///< Number of allocated blocks
+    int m_numa_node;          ///< Node the buffer is bound to, or Numa::ANY_NODE
+    OccupancyMap m_occupancy; ///< One cell per block, while tracking is on
+    std::vector<uint64_t> m_live; ///< One bit per block, set while allocated
+
+    size_t block_index(const void* ptr) const {
+        return static_cast<size_t>(static_cast<const uint8_t*>(ptr) - m_memory) / m_block_size;
+    }
+
+    bool is_live(size_t index) const {
+        return (m_live[index / 64] >> (index % 64)) & 1;
+    }
+
+    void set_live(size_t index, bool live) {
+        uint64_t bit = uint64_t{1} << (index % 64);
+        if (live) {
+            m_live[index / 64] |= bit;
+        } else {
+            m_live[index / 64] &= ~bit;
+        }
+    }
+
+    /**
+     * @brief Check that ptr is the start of a block that is allocated
+     */
+    bool is_live_block(void* ptr) const {
+        if (!owns(ptr)) return false;
+        size_t offset = static_cast<size_t>(static_cast<uint8_t*>(ptr) - m_memory);
+        return offset % m_block_size == 0 && is_live(offset / m_block_size);
+    }
 
     /**
      * @brief Initialize the free list
      */
     void initialize_free_list() {
         m_free_list = nullptr;
+        std::fill(m_live.begin(), m_live.end(), 0);
         
         // Build free list from end to start for sequential access
         for (size_t i = m_block_count; i > 0; --i) {
@@ -272,6 +463,23 @@ private:
     }
 };
 
+using PoolAllocator = BasicPoolAllocator<>;
+
+MEMORY_ENGINE_REGISTER_ALLOCATOR(pool_allocator, {
+    "pool", "Pool Allocator", {false, true, true, true},
+    {{"block_size", 4096, "bytes per block; larger requests fail"},
+     {"block_count", 10000, "blocks in the pool"},
+     {"alignment", alignof(std::max_align_t), "block alignment"}},
+    [](const AllocatorParams& params) -> std::unique_ptr<BaseAllocator> {
+        if (!params.get("block_size") || !params.get("block_count") ||
+            !MemoryUtils::is_power_of_two(params.get("alignment"))) {
+            return nullptr;
+        }
+        return std::make_unique<PoolAllocator>(params.get("block_size"), params.get("block_count"),
+                                               params.get("alignment"), params.numa_node);
+    }
+});
+
 } // namespace memory_engine
 
 #endif // POOL_ALLOCATOR_HPP
@@ -0,0 +1,96 @@
+/**
+ * @file raw_malloc_allocator.hpp
+ * @brief Untracked malloc/free baseline
+ * @author Bambang Hutagalung
+ * @date 2026
+ */
+
+#ifndef RAW_MALLOC_ALLOCATOR_HPP
+#define RAW_MALLOC_ALLOCATOR_HPP
+
+#include "allocator_registry.hpp"
+#include "base_allocator.hpp"
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace memory_engine {
+
+/**
+ * @class RawMallocAllocator
+ * @brief The system allocator with nothing added
+ *
+ * Every call goes straight to malloc/free (posix_memalign for alignments
+ * above max_align_t, _aligned_malloc on Windows). No header, no bookkeeping
+ * and no statistics, so its numbers are what the system allocator costs on
+ * its own; StandardAllocator adds tracking on top of the same heap.
+ *
+ * Because nothing is tracked:
+ * - stats() stays empty under every policy
+ * - owns() accepts every non-null pointer, so tracks_ownership() is false
+ *   and adapters never mix fallback blocks in with its own
+ * - reset() cannot free live blocks; callers free everything they allocate
+ */
+class RawMallocAllocator : public BaseAllocator {
+public:
+    RawMallocAllocator()
+        : BaseAllocator("Raw malloc", SIZE_MAX) {}
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) override {
+        if (size == 0) return nullptr;
+        if (!is_power_of_two(alignment)) alignment = alignof(std::max_align_t);
+
+        #ifdef _WIN32
+        // _aligned_free() must release every block, so every block is aligned
+        return _aligned_malloc(size, alignment);
+        #else
+        if (alignment <= alignof(std::max_align_t)) return std::malloc(size);
+        void* ptr = nullptr;
+        return posix_memalign(&ptr, alignment, size) == 0 ? ptr : nullptr;
+        #endif
+    }
+
+    void deallocate(void* ptr) override {
+        #ifdef _WIN32
+        _aligned_free(ptr);
+        #else
+        std::free(ptr);
+        #endif
+    }
+
+    void reset() override {
+        reset_stats();
+    }
+
+    bool owns(void* ptr) const override {
+        return ptr != nullptr;
+    }
+
+    bool tracks_ownership() const override {
+        return false;
+    }
+
+    bool is_thread_safe() const override {
+        return true;
+    }
+
+    // Shared between threads, and a profiler is not synchronized
+    bool set_profiler(AllocationProfiler* profiler) override {
+        return profiler == nullptr;
+    }
+
+    size_t available() const override {
+        return SIZE_MAX;
+    }
+};
+
+MEMORY_ENGINE_REGISTER_ALLOCATOR(raw_malloc_allocator, {
+    "raw_malloc", "Raw malloc", {true, true, false, false}, {},
+    [](const AllocatorParams&) -> std::unique_ptr<BaseAllocator> { return std::make_unique<RawMallocAllocator>(); }
+});
+
+} // namespace memory_engine
+
+#endif // RAW_MALLOC_ALLOCATOR_HPP
@@ -0,0 +1,202 @@
+/**
+ * @file scoped_arena.hpp
+ * @brief RAII scopes and double-buffered frames on top of StackAllocator
+ * @author Bambang Hutagalung
+ * @date 2026
+ */
+
+#ifndef SCOPED_ARENA_HPP
+#define SCOPED_ARENA_HPP
+
+#include "stack_allocator.hpp"
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace memory_engine {
+
+/**
+ * @class BasicScopedArena
+ * @brief Bump-allocate freely, free everything at scope exit
+ *
+ * Takes a marker on construction and rolls the stack back to it on
+ * destruction (or release()), in constant time plus one call per
+ * registered destructor. Scopes on the same stack nest and must end in
+ * reverse order of creation, as C++ scopes naturally do.
+ *
+ * make<T>() constructs objects in the arena. Types that are not trivially
+ * destructible get a destructor record, itself allocated in the arena, and
+ * are destroyed in reverse order of construction before the rollback;
+ * trivially destructible types cost nothing extra.
+ *
+ * @tparam StatsPolicy Instrumentation policy of the underlying stack
+ */
+template <typename StatsPolicy = DefaultStatsPolicy>
+class BasicScopedArena {
+public:
+    using Stack = BasicStackAllocator<StatsPolicy>;
+
+    /**
+     * @brief Open a scope at the current top of stack
+     * @param stack Stack to allocate from; must outlive the scope
+     */
+    explicit BasicScopedArena(Stack& stack)
+        : m_stack(stack)
+        , m_marker(stack.get_marker())
+        , m_destructors(nullptr)
+    {
+    }
+
+    ~BasicScopedArena() {
+        release();
+    }
+
+    BasicScopedArena(const BasicScopedArena&) = delete;
+    BasicScopedArena& operator=(const BasicScopedArena&) = delete;
+
+    /**
+     * @brief Allocate raw memory for the lifetime of the scope
+     * @return Pointer, or nullptr if the stack is full
+     */
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        return m_stack.allocate(size, alignment);
+    }
+
+    /**
+     * @brief Construct a T that lives until the scope ends
+     * @return The object, or nullptr if the stack is full
+     */
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        DestructorRecord* record = nullptr;
+        if constexpr (!std::is_trivially_destructible<T>::value) {
+            record = static_cast<DestructorRecord*>(
+                m_stack.allocate(sizeof(DestructorRecord), alignof(DestructorRecord)));
+            if (!record) return nullptr;
+        }
+
+        void* memory = m_stack.allocate(sizeof(T), alignof(T));
+        if (!memory) return nullptr; // The record is reclaimed with the scope
+
+        T* object = new (memory) T(std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible<T>::value) {
+            record->destroy = [](void* p) { static_cast<T*>(p)->~T(); };
+            record->object = object;
+            record->next = m_destructors;
+            m_destructors = record;
+        }
+        return object;
+    }
+
+    /**
+     * @brief Destroy every object and roll back now
+     *
+     * The scope stays open and can be reused from its original marker.
+     */
+    void release() {
+        for (DestructorRecord* record = m_destructors; record; record = record->next) {
+            record->destroy(record->object);
+        }
+        m_destructors = nullptr;
+        m_stack.rollback_to_marker(m_marker);
+    }
+
+    /**
+     * @brief Get bytes allocated in this scope, headers and padding included
+     */
+    size_t used() const {
+        return m_stack.get_marker().offset - m_marker.offset;
+    }
+
+    Stack& stack() { return m_stack; }
+
+private:
+    struct DestructorRecord {
+        void (*destroy)(void*);
+        void* object;
+        DestructorRecord* next;
+    };
+
+    Stack& m_stack;                    ///< Underlying stack
+    typename Stack::Marker m_marker;   ///< Top of stack when the scope opened
+    DestructorRecord* m_destructors;   ///< Newest first
+};
+
+/**
+ * @class BasicFrameAllocator
+ * @brief Double-buffered per-frame (per-request) scratch memory
+ *
+ * Two stacks alternate: allocations go to the current frame, and flip()
+ * makes the other stack current after releasing it. Memory from the frame
+ * that just ended therefore stays valid for one more frame, which lets a
+ * frame hand results to the next without copying.
+ *
+ * @tparam StatsPolicy Instrumentation policy of the two stacks
+ */
+template <typename StatsPolicy = DefaultStatsPolicy>
+class BasicFrameAllocator {
+public:
+    using Stack = BasicStackAllocator<StatsPolicy>;
+    using Scope = BasicScopedArena<StatsPolicy>;
+
+    /**
+     * @brief Constructor
+     * @param frame_size Bytes per frame buffer
+     */
+    explicit BasicFrameAllocator(size_t frame_size)
+        : m_frames{Stack(frame_size), Stack(frame_size)}
+        , m_scopes{Scope(m_frames[0]), Scope(m_frames[1])}
+    {
+    }
+
+    /**
+     * @brief Constructor for growable frame buffers
+     * @param arena Virtual memory reservation used for each of the two buffers
+     */
+    explicit BasicFrameAllocator(const VirtualArenaConfig& arena)
+        : m_frames{Stack(arena), Stack(arena)}
+        , m_scopes{Scope(m_frames[0]), Scope(m_frames[1])}
+    {
+    }
+
+    BasicFrameAllocator(const BasicFrameAllocator&) = delete;
+    BasicFrameAllocator& operator=(const BasicFrameAllocator&) = delete;
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        return current().allocate(size, alignment);
+    }
+
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        return current().template make<T>(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief End the current frame
+     *
+     * Objects from two frames ago are destroyed and their memory reused;
+     * the frame just ended remains readable until the next flip().
+     */
+    void flip() {
+        m_current ^= 1;
+        m_scopes[m_current].release();
+        m_frame_count++;
+    }
+
+    Scope& current() { return m_scopes[m_current]; }
+    Scope& previous() { return m_scopes[m_current ^ 1]; }
+    size_t frame_count() const { return m_frame_count; }
+
+private:
+    Stack m_frames[2];       ///< Declared before the scopes that reference them
+    Scope m_scopes[2];
+    size_t m_current = 0;
+    size_t m_frame_count = 0;
+};
+
+using ScopedArena = BasicScopedArena<>;
+using FrameAllocator = BasicFrameAllocator<>;
+
+} // namespace memory_engine
+
+#endif // SCOPED_ARENA_HPP
@@ -0,0 +1,469 @@
+/**
+ * @file size_class_allocator.hpp
+ * @brief Segregated size-class allocator built from pool allocators
+ * @author Bambang Hutagalung
+ * @date 2026
+ */
+
+#ifndef SIZE_CLASS_ALLOCATOR_HPP
+#define SIZE_CLASS_ALLOCATOR_HPP
+
+#include "allocator_registry.hpp"
+#include "base_allocator.hpp"
+#include "pool_allocator.hpp"
+#include "freelist_allocator.hpp"
+#include "../utils/timer.hpp"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace memory_engine {
+
+/**
+ * @class BasicSizeClassAllocator
+ * @brief Routes each request to a pool of the nearest geometric size class
+ *
+ * Small requests are rounded up to one of a set of size classes spaced at
+ * two steps per power of two (16, 32, 48, 64, 96, 128, ... up to the small
+ * object limit). Above 32 bytes a request wastes under a third of its
+ * block. Below that the 16 B granularity dominates: there is no class
+ * between 16 and 32, so a 17 B request wastes 15 of 32. Each class is a
+ * list of PoolAllocator chunks; a new chunk is added when all existing ones
+ * are full. Requests above the small object limit fall back to a
+ * FreeListAllocator.
+ *
+ * Advantages:
+ * - O(1) size-class lookup and O(1) small-object allocation
+ * - Bounded internal fragmentation for mixed object sizes
+ * - Classes grow on demand, so no single fixed capacity
+ *
+ * Disadvantages:
+ * - Deallocation needs an address lookup to find the owning chunk
+ * - Grown chunks are kept until destruction (reset() only empties them)
+ * - Large allocations inherit the cost of the free list fallback
+ *
+ * @tparam StatsPolicy Instrumentation policy (see stats_policy.hpp)
+ */
+template <typename StatsPolicy = DefaultStatsPolicy>
+class BasicSizeClassAllocator : public BaseAllocator {
+public:
+    static constexpr size_t MIN_CLASS_SIZE = 16; ///< Smallest size class (and class granularity)
+
+    /**
+     * @brief Constructor
+     * @param max_small_size Largest request served from a size class
+     * @param chunk_size Bytes reserved per pool chunk when a class grows
+     * @param large_arena_size Size of the free list arena for large requests
+     */
+    explicit BasicSizeClassAllocator(size_t max_small_size = 4096,
+                                size_t chunk_size = 64 * 1024,
+                                size_t large_arena_size = 16 * 1024 * 1024)
+        : BaseAllocator("Size-Class Allocator", 0)
+        , m_max_small_size(align_size(max_small_size < MIN_CLASS_SIZE ? MIN_CLASS_SIZE : max_small_size,
+                                      MIN_CLASS_SIZE))
+        , m_chunk_size(chunk_size)
+        , m_large(std::make_unique<LargeAllocator>(large_arena_size))
+    {
+        build_size_classes();
+        m_total_size = m_large->total_size();
+    }
+
+    // Disable copy
+    BasicSizeClassAllocator(const BasicSizeClassAllocator&) = delete;
+    BasicSizeClassAllocator& operator=(const BasicSizeClassAllocator&) = delete;
+
+    /**
+     * @brief Allocate from the matching size class or the large fallback
+     * @param size Size to allocate
+     * @param alignment Alignment requirement
+     * @return Pointer to allocated memory, or nullptr
+     */
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) override {
+        if (size == 0) return nullptr;
+
+        OperationTimer<StatsPolicy> timer(m_timing_countdown);
+        timer.start();
+
+        void* ptr = nullptr;
+        size_t class_index = find_class(size, alignment);
+
+        if (class_index < m_classes.size()) {
+            ptr = allocate_small(class_index, size);
+        } else {
+            ptr = m_large->allocate(size, alignment);
+            if (ptr) m_large_sizes[ptr] = size;
+        }
+
+        timer.stop();
+
+        if (ptr) {
+            record_allocation(ptr, size, alignment, timer);
+        }
+
+        return ptr;
+    }
+
+    /**
+     * @brief Return memory to its size class or to the large fallback
+     * @param ptr Pointer to deallocate
+     */
+    void deallocate(void* ptr) override {
+        if (!ptr) return;
+
+        OperationTimer<StatsPolicy> timer(m_timing_countdown);
+        timer.start();
+
+        size_t size = 0;
+        const ChunkRef* ref = find_chunk(ptr);
+        if (ref) {
+            size = deallocate_small(*ref, ptr);
+            if (size == 0) { // Double free, or not the start of a block
+                record_rejected_deallocation();
+                return;
+            }
+        } else {
+            auto it = m_large_sizes.find(ptr);
+            if (it == m_large_sizes.end()) { // Not our pointer
+                record_rejected_deallocation();
+                return;
+            }
+            size = it->second;
+            m_large_sizes.erase(it);
+            m_large->deallocate(ptr);
+        }
+
+        timer.stop();
+        record_deallocation(ptr, size, timer);
+    }
+
+    /**
+     * @brief Empty every class and the large arena
+     *
+     * Grown chunks are kept so a following run does not pay for growth again.
+     */
+    void reset() override {
+        for (auto& size_class : m_classes) {
+            size_class.partial.clear();
+            for (size_t i = 0; i < size_class.chunks.size(); ++i) {
+                Chunk& chunk = size_class.chunks[i];
+                chunk.pool->reset();
+                std::fill(chunk.requested.begin(), chunk.requested.end(), 0);
+                size_class.partial.push_back(i);
+            }
+        }
+        m_large->reset();
+        m_large_sizes.clear();
+
+        reset_stats();
+        publish_class_layout();
+    }
+
+    /**
+     * @brief Check ownership
+     * @param ptr Pointer to check
+     * @return true if the pointer lies in a chunk or the large arena
+     */
+    bool owns(void* ptr) const override {
+        if (!ptr) return false;
+        return find_chunk(ptr) != nullptr || m_large->owns(ptr);
+    }
+
+    /**
+     * @brief Get available memory
+     * @return Free bytes in reserved chunks plus the large arena
+     */
+    size_t available() const override {
+        size_t total = m_large->available();
+        for (const auto& size_class : m_classes) {
+            for (const auto& chunk : size_class.chunks) {
+                total += chunk.pool->available();
+            }
+        }
+        return total;
+    }
+
+    /**
+     * @brief Get number of size classes
+     * @return Class count (excluding the large fallback)
+     */
+    size_t class_count() const {
+        return m_classes.size();
+    }
+
+    /**
+     * @brief Get block size of a class
+     * @param index Class index
+     * @return Block size in bytes
+     */
+    size_t class_block_size(size_t index) const {
+        return index < m_classes.size() ? m_classes[index].block_size : 0;
+    }
+
+    /**
+     * @brief Get the largest request served from a size class
+     * @return Small object limit in bytes
+     */
+    size_t max_small_size() const {
+        return m_max_small_size;
+    }
+
+    /**
+     * @brief Track the large-object arena; size-class chunks are reported in stats().size_classes
+     */
+    bool set_occupancy_tracking(bool enabled) override {
+        return m_large->set_occupancy_tracking(enabled);
+    }
+
+    OccupancyView occupancy() const override {
+        return m_large->occupancy();
+    }
+
+    /**
+     * @brief Attach a profiler; refused when StatsPolicy has no PROFILE hooks
+     */
+    bool set_profiler(AllocationProfiler* profiler) override {
+        return attach_profiler<StatsPolicy>(profiler);
+    }
+
+private:
+    // Inner allocators are not instrumented; this allocator records the stats
+    using ChunkPool = BasicPoolAllocator<NoStats>;
+    using LargeAllocator = BasicFreeListAllocator<NoStats>;
+
+    /**
+     * @struct Chunk
+     * @brief One pool backing a size class
+     */
+    struct Chunk {
+        std::unique_ptr<ChunkPool> pool;    ///< Fixed-size pool
+        std::vector<uint32_t> requested;     ///< Requested size per block (0 = free)
+    };
+
+    /**
+     * @struct SizeClass
+     * @brief All chunks serving one block size
+     */
+    struct SizeClass {
+        size_t block_size = 0;        ///< Block size
+        size_t alignment = 0;         ///< Natural alignment of the blocks
+        size_t blocks_per_chunk = 0;  ///< Blocks added per growth step
+        std::vector<Chunk> chunks;    ///< Backing pools
+        std::vector<size_t> partial;  ///< Chunks with at least one free block
+    };
+
+    /**
+     * @struct ChunkRef
+     * @brief Address-map entry locating a chunk
+     */
+    struct ChunkRef {
+        size_t class_index;
+        size_t chunk_index;
+    };
+
+    size_t m_max_small_size;                        ///< Small object limit
+    size_t m_chunk_size;                            ///< Bytes per growth step
+    std::vector<SizeClass> m_classes;               ///< Size classes, ascending
+    std::vector<uint8_t> m_class_lookup;            ///< (size - 1) / 16 -> class index
+    std::map<const uint8_t*, ChunkRef> m_chunk_map; ///< Chunk base -> location
+    std::unique_ptr<LargeAllocator> m_large;        ///< Fallback for large requests
+    std::unordered_map<void*, size_t> m_large_sizes; ///< Requested size of large allocations
+
+    /**
+     * @brief Generate geometric classes and the O(1) size lookup table
+     */
+    void build_size_classes() {
+        std::vector<size_t> sizes;
+        for (size_t base = MIN_CLASS_SIZE; base <= m_max_small_size; base *= 2) {
+            sizes.push_back(base);
+            // Half step between powers of two, kept on the class granularity
+            size_t mid = base + base / 2;
+            if (base >= 2 * MIN_CLASS_SIZE && mid < m_max_small_size) {
+                sizes.push_back(mid);
+            }
+        }
+        if (sizes.back() != m_max_small_size) {
+            sizes.push_back(m_max_small_size);
+        }
+
+        for (size_t block_size : sizes) {
+            SizeClass size_class;
+            size_class.block_size = block_size;
+            size_class.alignment = block_size & (~block_size + 1); // Lowest set bit
+            if (size_class.alignment > alignof(std::max_align_t) * 4) {
+                size_class.alignment = alignof(std::max_align_t) * 4;
+            }
+            if (size_class.alignment < alignof(std::max_align_t)) {
+                size_class.alignment = alignof(std::max_align_t);
+            }
+            size_class.blocks_per_chunk = std::max<size_t>(m_chunk_size / block_size, 16);
+            m_classes.push_back(std::move(size_class));
+        }
+
+        m_class_lookup.resize(m_max_small_size / MIN_CLASS_SIZE);
+        size_t class_index = 0;
+        for (size_t slot = 0; slot < m_class_lookup.size(); ++slot) {
+            size_t slot_size = (slot + 1) * MIN_CLASS_SIZE;
+            while (m_classes[class_index].block_size < slot_size) class_index++;
+            m_class_lookup[slot] = static_cast<uint8_t>(class_index);
+        }
+
+        publish_class_layout();
+    }
+
+    /**
+     * @brief Map a request to a class index
+     * @return Class index, or class_count() for the large fallback
+     */
+    size_t find_class(size_t size, size_t alignment) const {
+        if (size > m_max_small_size) return m_classes.size();
+
+        size_t index = m_class_lookup[(size - 1) / MIN_CLASS_SIZE];
+        while (index < m_classes.size() && m_classes[index].alignment < alignment) {
+            index++;
+        }
+        return index;
+    }
+
+    /**
+     * @brief Add a pool chunk to a class
+     * @return true if the chunk was created
+     */
+    bool grow_class(size_t class_index) {
+        SizeClass& size_class = m_classes[class_index];
+
+        Chunk chunk;
+        chunk.pool = std::make_unique<ChunkPool>(size_class.block_size, size_class.blocks_per_chunk,
+                                                     size_class.alignment);
+        if (!chunk.pool->base_address()) return false;
+        chunk.requested.assign(size_class.blocks_per_chunk, 0);
+
+        size_t chunk_index = size_class.chunks.size();
+        m_chunk_map[chunk.pool->base_address()] = ChunkRef{class_index, chunk_index};
+        m_total_size += chunk.pool->total_size();
+
+        size_class.chunks.push_back(std::move(chunk));
+        size_class.partial.push_back(chunk_index);
+
+        if constexpr (StatsPolicy::COUNTERS) {
+            m_stats.size_classes[class_index].blocks_total += size_class.blocks_per_chunk;
+            m_stats.size_classes[class_index].chunk_count++;
+        }
+        return true;
+    }
+
+    void* allocate_small(size_t class_index, size_t size) {
+        SizeClass& size_class = m_classes[class_index];
+
+        if (size_class.partial.empty() && !grow_class(class_index)) {
+            return nullptr;
+        }
+
+        size_t chunk_index = size_class.partial.back();
+        Chunk& chunk = size_class.chunks[chunk_index];
+        void* ptr = chunk.pool->allocate(size);
+        if (!ptr) return nullptr;
+
+        if (chunk.pool->free_blocks() == 0) {
+            size_class.partial.pop_back();
+        }
+
+        size_t block = (static_cast<uint8_t*>(ptr) - chunk.pool->base_address()) / size_class.block_size;
+        chunk.requested[block] = static_cast<uint32_t>(size);
+
+        if constexpr (StatsPolicy::COUNTERS) {
+            SizeClassStats& class_stats = m_stats.size_classes[class_index];
+            class_stats.blocks_used++;
+            class_stats.requested_bytes += size;
+            class_stats.waste_bytes += size_class.block_size - size;
+            m_stats.fragmentation_bytes += size_class.block_size - size;
+        }
+
+        return ptr;
+    }
+
+    /**
+     * @brief Free a small block
+     * @return Requested size of the freed allocation, or 0 if the block is not live
+     *
+     * requested doubles as the live bit (allocations are never 0 bytes), so
+     * a double free is refused before it reaches the pool's free list.
+     */
+    size_t deallocate_small(const ChunkRef& ref, void* ptr) {
+        SizeClass& size_class = m_classes[ref.class_index];
+        Chunk& chunk = size_class.chunks[ref.chunk_index];
+
+        size_t offset = static_cast<size_t>(static_cast<uint8_t*>(ptr) - chunk.pool->base_address());
+        if (offset % size_class.block_size != 0) return 0;
+        size_t block = offset / size_class.block_size;
+        size_t size = chunk.requested[block];
+        if (size == 0) return 0;
+        chunk.requested[block] = 0;
+
+        bool was_full = chunk.pool->free_blocks() == 0;
+        chunk.pool->deallocate(ptr);
+        if (was_full) {
+            size_class.partial.push_back(ref.chunk_index);
+        }
+
+        if constexpr (StatsPolicy::COUNTERS) {
+            SizeClassStats& class_stats = m_stats.size_classes[ref.class_index];
+            class_stats.blocks_used--;
+            class_stats.requested_bytes -= size;
+            class_stats.waste_bytes -= size_class.block_size - size;
+            m_stats.fragmentation_bytes -= size_class.block_size - size;
+        }
+
+        return size;
+    }
+
+    /**
+     * @brief Locate the chunk containing a pointer
+     * @return Chunk reference, or nullptr if no chunk contains it
+     */
+    const ChunkRef* find_chunk(void* ptr) const {
+        if (m_chunk_map.empty()) return nullptr;
+
+        const uint8_t* p = static_cast<const uint8_t*>(ptr);
+        auto it = m_chunk_map.upper_bound(p);
+        if (it == m_chunk_map.begin()) return nullptr;
+        --it;
+
+        const Chunk& chunk = m_classes[it->second.class_index].chunks[it->second.chunk_index];
+        if (!chunk.pool->owns(ptr)) return nullptr;
+        return &it->second;
+    }
+
+    /**
+     * @brief Rebuild the per-class stats entries after construction or reset
+     */
+    void publish_class_layout() {
+        if constexpr (!StatsPolicy::COUNTERS) return;
+
+        m_stats.size_classes.assign(m_classes.size(), SizeClassStats{});
+        for (size_t i = 0; i < m_classes.size(); ++i) {
+            m_stats.size_classes[i].block_size = m_classes[i].block_size;
+            m_stats.size_classes[i].blocks_total = m_classes[i].blocks_per_chunk * m_classes[i].chunks.size();
+            m_stats.size_classes[i].chunk_count = m_classes[i].chunks.size();
+        }
+    }
+};
+
+using SizeClassAllocator = BasicSizeClassAllocator<>;
+
+MEMORY_ENGINE_REGISTER_ALLOCATOR(size_class_allocator, {
+    "size_class", "Size-Class Allocator", {false, true, false, false},
+    {{"max_small_size", 4096, "largest request served by a size class"},
+     {"chunk_size", 64 * 1024, "bytes added to a class when it runs out"},
+     {"large_arena_size", 16 * 1024 * 1024, "free list arena for larger requests"}},
+    [](const AllocatorParams& params) -> std::unique_ptr<BaseAllocator> {
+        if (!params.get("chunk_size") || !params.get("large_arena_size")) return nullptr;
+        return std::make_unique<SizeClassAllocator>(params.get("max_small_size"), params.get("chunk_size"),
+                                                    params.get("large_arena_size"));
+    }
+});
+
+} // namespace memory_engine
+
+#endif // SIZE_CLASS_ALLOCATOR_HPP
@@ -8,15 +8,19 @@
 #ifndef STACK_ALLOCATOR_HPP
 #define STACK_ALLOCATOR_HPP
 
+#include "allocator_registry.hpp"
 #include "base_allocator.hpp"
 #include "../utils/timer.hpp"
+#include "../utils/memory_utils.hpp"
+#include "../utils/numa.hpp"
+#include "../utils/virtual_arena.hpp"
 #include <cstdlib>
 #include <cassert>
 
 namespace memory_engine {
 
 /**
- * @class StackAllocator
+ * @class BasicStackAllocator
  * @brief LIFO (Last-In-First-Out) memory allocator
  * 
  * The stack allocator allocates memory linearly from a pre-allocated buffer.
@@ -31,60 +35,118 @@ namespace memory_engine {
  * Disadvantages:
  * - Must deallocate in reverse order
  * - Cannot deallocate arbitrary blocks
- * - Fixed total size
+ * - Fixed total size, unless built on a growable VirtualArena
+ *
+ * @tparam StatsPolicy Instrumentation policy (see stats_policy.hpp)
  */
-class StackAllocator : public BaseAllocator {
+template <typename StatsPolicy = DefaultStatsPolicy>
+class BasicStackAllocator : public BaseAllocator {
 public:
     /**
      * @brief Allocation marker for batch deallocation
+     *
+     * Captures everything rollback_to_marker() restores, so a rollback is
+     * constant time however much was allocated after the marker.
      */
-    using Marker = size_t;
+    struct Marker {
+        size_t offset = 0;           ///< Top of the stack
+        size_t previous_offset = 0;  ///< Start of the allocation below the top
+        size_t allocations = 0;      ///< Live allocations when the marker was taken
+        size_t bytes_used = 0;       ///< Live bytes when the marker was taken
+    };
 
     /**
      * @brief Constructor
      * @param size Total size of the stack in bytes
      * @param alignment Default alignment for allocations
+     * @param numa_node Node to bind the buffer to (Numa::ANY_NODE = first touch)
      */
-    explicit StackAllocator(size_t size, size_t alignment = alignof(std::max_align_t))
+    explicit BasicStackAllocator(size_t size, size_t alignment = alignof(std::max_align_t),
+                                 int numa_node = Numa::ANY_NODE)
         : BaseAllocator("Stack Allocator", size)
         , m_alignment(alignment)
         , m_memory(nullptr)
         , m_current_offset(0)
         , m_previous_offset(0)
+        , m_numa_node(numa_node)
+        , m_capacity(size)
     {
-        // Allocate aligned memory
-        #ifdef _WIN32
-        m_memory = static_cast<uint8_t*>(_aligned_malloc(size, m_alignment));
-        #else
-        m_memory = static_cast<uint8_t*>(std::aligned_alloc(m_alignment, size));
-        #endif
+        // Node-bound pages are page-aligned; unbound memory if binding fails
+        if (m_numa_node != Numa::ANY_NODE && m_alignment <= MemoryUtils::get_page_size()) {
+            m_memory = static_cast<uint8_t*>(Numa::allocate_on_node(size, m_numa_node));
+        }
+        if (!m_memory) {
+            m_numa_node = Numa::ANY_NODE;
+            #ifdef _WIN32
+            m_memory = static_cast<uint8_t*>(_aligned_malloc(size, m_alignment));
+            #else
+            m_memory = static_cast<uint8_t*>(std::aligned_alloc(m_alignment, size));
+            #endif
+        }
+    }
+
+    /**
+     * @brief Constructor for a growable stack on reserved virtual memory
+     * @param arena Reservation size, huge pages, NUMA node and initial commit
+     * @param alignment Default alignment for allocations
+     *
+     * Pages are committed as the top of the stack grows; reset() returns
+     * everything past arena.initial_commit to the OS.
+     */
+    explicit BasicStackAllocator(const VirtualArenaConfig& arena, size_t alignment = alignof(std::max_align_t))
+        : BaseAllocator("Stack Allocator", 0)
+        , m_alignment(alignment)
+        , m_memory(nullptr)
+        , m_current_offset(0)
+        , m_previous_offset(0)
+        , m_numa_node(Numa::ANY_NODE)
+        , m_capacity(0)
+        , m_arena(arena)
+        , m_initial_commit(arena.initial_commit)
+    {
+        m_memory = m_arena.base();
+        m_total_size = m_arena.reserved();
+        m_capacity = m_arena.committed();
+        if (m_arena.numa_bound()) m_numa_node = arena.numa_node;
     }
 
     /**
      * @brief Destructor
      */
-    ~StackAllocator() override {
+    ~BasicStackAllocator() override {
+        if (m_arena.base()) {
+            m_memory = nullptr; // Released by m_arena
+        }
         if (m_memory) {
-            #ifdef _WIN32
-            _aligned_free(m_memory);
-            #else
-            std::free(m_memory);
-            #endif
+            if (m_numa_node != Numa::ANY_NODE) {
+                Numa::free_on_node(m_memory, m_total_size);
+            } else {
+                #ifdef _WIN32
+                _aligned_free(m_memory);
+                #else
+                std::free(m_memory);
+                #endif
+            }
             m_memory = nullptr;
         }
     }
 
     // Disable copy
-    StackAllocator(const StackAllocator&) = delete;
-    StackAllocator& operator=(const StackAllocator&) = delete;
+    BasicStackAllocator(const BasicStackAllocator&) = delete;
+    BasicStackAllocator& operator=(const BasicStackAllocator&) = delete;
 
     // Enable move
-    StackAllocator(StackAllocator&& other) noexcept
+    BasicStackAllocator(BasicStackAllocator&& other) noexcept
         : BaseAllocator(std::move(other))
         , m_alignment(other.m_alignment)
         , m_memory(other.m_memory)
         , m_current_offset(other.m_current_offset)
         , m_previous_offset(other.m_previous_offset)
+        , m_numa_node(other.m_numa_node)
+        , m_capacity(other.m_capacity)
+        , m_arena(std::move(other.m_arena))
+        , m_initial_commit(other.m_initial_commit)
+        , m_occupancy(std::move(other.m_occupancy))
     {
         other.m_memory = nullptr;
         other.m_current_offset = 0;
@@ -100,17 +162,16 @@ public:
     void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) override {
         if (!m_memory || size == 0) return nullptr;
 
-        Timer timer;
+        OperationTimer<StatsPolicy> timer(m_timing_countdown);
         timer.start();
 
-        // Calculate aligned address
+        // Align the user pointer; the header sits immediately before it
         size_t current_addr = reinterpret_cast<size_t>(m_memory + m_current_offset);
-        size_t aligned_addr = align_size(current_addr, alignment);
-        size_t adjustment = aligned_addr - current_addr;
+        size_t adjustment = header_adjustment(current_addr, alignment);
 
         // Check if we have enough space
         size_t total_size = adjustment + sizeof(AllocationHeader) + size;
-        if (m_current_offset + total_size > m_total_size) {
+        if (!ensure_capacity(m_current_offset + total_size)) {
             return nullptr; // Stack is full
         }
 
@@ -128,7 +189,8 @@ public:
         void* ptr = reinterpret_cast<void*>(header + 1);
 
         timer.stop();
-        record_allocation(ptr, size, alignment, timer.elapsed_ns());
+        record_allocation(ptr, size, alignment, timer);
+        if (m_occupancy.enabled()) m_occupancy.move_top(m_previous_offset, m_current_offset);
 
         return ptr;
     }
@@ -149,14 +211,15 @@ public:
         size_t expected_offset = reinterpret_cast<uint8_t*>(ptr) - m_memory + header->size;
         if (expected_offset != m_current_offset) {
             // Not the top allocation - cannot deallocate out of order
-            // In a real implementation, you might want to handle this differently
+            record_rejected_deallocation();
             return;
         }
 
-        Timer timer;
+        OperationTimer<StatsPolicy> timer(m_timing_countdown);
         timer.start();
 
         size_t size = header->size;
+        size_t top = m_current_offset;
 
         // Pop the stack
         m_current_offset = m_previous_offset;
@@ -170,7 +233,99 @@ public:
         }
 
         timer.stop();
-        record_deallocation(size, timer.elapsed_ns());
+        record_deallocation(ptr, size, timer);
+        if (m_occupancy.enabled()) m_occupancy.move_top(top, m_current_offset);
+    }
+
+    /**
+     * @brief Bump-allocate several blocks in one pass
+     * @param size Size of each block
+     * @param alignment Alignment requirement
+     * @param out Array receiving the blocks
+     * @param count Number of blocks requested
+     * @return Number of blocks allocated (fewer if the stack fills up)
+     */
+    size_t allocate_batch(size_t size, size_t alignment, void** out, size_t count) override {
+        if (!m_memory || size == 0) return 0;
+
+        OperationTimer<StatsPolicy> timer(m_timing_countdown);
+        timer.start();
+
+        size_t allocated = 0;
+        const size_t top = m_current_offset;
+        size_t offset = m_current_offset;
+        size_t previous = m_previous_offset;
+        while (allocated < count) {
+            size_t current_addr = reinterpret_cast<size_t>(m_memory + offset);
+            size_t adjustment = header_adjustment(current_addr, alignment);
+            if (!ensure_capacity(offset + adjustment + sizeof(AllocationHeader) + size)) {
+                break; // Stack is full
+            }
+
+            size_t header_offset = offset + adjustment;
+            AllocationHeader* header = reinterpret_cast<AllocationHeader*>(m_memory + header_offset);
+            header->size = size;
+            header->adjustment = adjustment;
+            header->previous_offset = previous;
+
+            previous = offset;
+            offset = header_offset + sizeof(AllocationHeader) + size;
+            out[allocated++] = header + 1;
+        }
+        m_current_offset = offset;
+        m_previous_offset = previous;
+
+        timer.stop();
+        record_allocation_batch(out, allocated, size, alignment, timer);
+        if (m_occupancy.enabled()) m_occupancy.move_top(top, m_current_offset);
+
+        return allocated;
+    }
+
+    /**
+     * @brief Pop several allocations off the stack in one pass
+     * @param ptrs Pointers in allocation order; freed last to first
+     * @param count Number of pointers
+     *
+     * Stops at the first pointer that is not the current top of the stack;
+     * it and the non-null pointers before it count as rejected.
+     */
+    void deallocate_batch(void** ptrs, size_t count) override {
+        if (!m_memory) return;
+
+        OperationTimer<StatsPolicy> timer(m_timing_countdown);
+        timer.start();
+
+        size_t freed = 0;
+        size_t freed_bytes = 0;
+        const size_t top = m_current_offset;
+        const uint64_t timestamp = StatsPolicy::HISTORY ? history_timestamp(timer) : 0;
+        for (size_t i = count; i > 0; --i) {
+            void* ptr = ptrs[i - 1];
+            if (!ptr) continue;
+
+            AllocationHeader* header = reinterpret_cast<AllocationHeader*>(
+                static_cast<uint8_t*>(ptr) - sizeof(AllocationHeader)
+            );
+            size_t expected_offset = reinterpret_cast<uint8_t*>(ptr) - m_memory + header->size;
+            if (expected_offset != m_current_offset) {
+                // This and every non-null pointer below it stay allocated
+                for (size_t j = 0; j < i; ++j) {
+                    if (ptrs[j]) m_stats.rejected_deallocations++;
+                }
+                break;
+            }
+
+            m_current_offset = m_previous_offset;
+            m_previous_offset = m_current_offset > 0 ? header->previous_offset : 0;
+            record_free_event<StatsPolicy>(ptr, header->size, timestamp);
+            freed++;
+            freed_bytes += header->size;
+        }
+
+        timer.stop();
+        record_deallocation_batch(freed, freed_bytes, timer);
+        if (m_occupancy.enabled()) m_occupancy.move_top(top, m_current_offset);
     }
 
     /**
@@ -178,46 +333,48 @@ public:
      * @return Current stack position
      */
     Marker get_marker() const {
-        return m_current_offset;
+        return {m_current_offset, m_previous_offset, m_stats.current_allocations, m_stats.current_bytes_used};
     }
 
     /**
-     * @brief Roll back to a previous marker position
+     * @brief Roll back to a previous marker position in O(1)
      * @param marker Marker to roll back to
-     * 
+     *
      * This deallocates all memory allocated after the marker was obtained.
+     * Markers above the current top (already rolled back past) are ignored.
+     * Committed pages of a growable stack are kept for reuse. An attached
+     * profiler scans its live samples for the released range.
      */
-    void rollback_to_marker(Marker marker) {
-        if (marker > m_current_offset) return;
-        
-        // Calculate how much we're freeing
-        size_t freed = m_current_offset - marker;
-        
-        m_current_offset = marker;
-        
-        // Find the previous offset
-        if (marker > 0) {
-            // Search backwards for the header
-            // This is a simplified version - real implementation would track this
-            m_previous_offset = 0;
-        } else {
-            m_previous_offset = 0;
+    void rollback_to_marker(const Marker& marker) {
+        if (marker.offset > m_current_offset) return;
+
+        if constexpr (StatsPolicy::COUNTERS) {
+            if (m_stats.current_allocations > marker.allocations) {
+                m_stats.total_deallocations += m_stats.current_allocations - marker.allocations;
+            }
+            m_stats.current_allocations = marker.allocations;
+            m_stats.current_bytes_used = marker.bytes_used;
         }
-
-        // Update stats
-        if (freed > 0) {
-            m_stats.current_bytes_used = marker;
+        if (m_occupancy.enabled()) m_occupancy.move_top(m_current_offset, marker.offset);
+        if constexpr (StatsPolicy::PROFILE) {
+            if (m_profiler) m_profiler->on_release_range(m_memory + marker.offset, m_memory + m_current_offset);
         }
+        m_current_offset = marker.offset;
+        m_previous_offset = marker.previous_offset;
     }
 
     /**
      * @brief Reset the stack to empty
      */
     void reset() override {
+        if (m_occupancy.enabled()) m_occupancy.move_top(m_current_offset, 0);
         m_current_offset = 0;
         m_previous_offset = 0;
-        m_stats = AllocationStats{};
-        m_allocation_history.clear();
+        if (m_arena.base()) {
+            m_arena.decommit(m_initial_commit);
+            m_capacity = m_arena.committed();
+        }
+        reset_stats();
     }
 
     /**
@@ -232,6 +389,22 @@ public:
         return p >= m_memory && p < (m_memory + m_total_size);
     }
 
+    /**
+     * @brief Get the NUMA node the arena is bound to
+     * @return Node index, or Numa::ANY_NODE if the arena is unbound
+     */
+    int numa_node() const {
+        return m_numa_node;
+    }
+
+    /**
+     * @brief Get the virtual arena backing a growable stack
+     * @return The arena; base() is nullptr for a fixed-size stack
+     */
+    const VirtualArena& arena() const {
+        return m_arena;
+    }
+
     /**
      * @brief Get available bytes
      * @return Remaining capacity
@@ -258,6 +431,32 @@ public:
         return 0.0; // Simplified
     }
 
+    /**
+     * @brief Track the used prefix of the arena; high_water is the deepest the stack has been
+     * @return false if the stack has no buffer
+     */
+    bool set_occupancy_tracking(bool enabled) override {
+        if (!enabled) {
+            m_occupancy.disable();
+            return true;
+        }
+        if (!m_memory) return false;
+        m_occupancy.enable(m_memory, m_total_size);
+        m_occupancy.move_top(0, m_current_offset);
+        return true;
+    }
+
+    OccupancyView occupancy() const override {
+        return m_occupancy.view();
+    }
+
+    /**
+     * @brief Attach a profiler; refused when StatsPolicy has no PROFILE hooks
+     */
+    bool set_profiler(AllocationProfiler* profiler) override {
+        return attach_profiler<StatsPolicy>(profiler);
+    }
+
     /**
      * @brief Get visual representation of stack usage
      * @return Usage percentage
@@ -281,8 +480,46 @@ private:
     uint8_t* m_memory;         ///< Memory buffer
     size_t m_current_offset;   ///< Current top of stack
     size_t m_previous_offset;  ///< Previous top (for deallocation)
+    int m_numa_node;           ///< Node the buffer is bound to, or Numa::ANY_NODE
+    size_t m_capacity;         ///< Usable bytes (committed bytes when growable)
+    VirtualArena m_arena;      ///< Backing range when growable
+    size_t m_initial_commit = 0; ///< Bytes a growable stack keeps committed across reset()
+    OccupancyMap m_occupancy;  ///< Used prefix, while tracking is on
+
+    /**
+     * @brief Make sure bytes [0, end) are usable, committing more if growable
+     */
+    bool ensure_capacity(size_t end) {
+        if (end <= m_capacity) return true;
+        if (!m_arena.base() || !m_arena.commit(end)) return false;
+        m_capacity = m_arena.committed();
+        return true;
+    }
+
+    /**
+     * @brief Padding before the header so that the header and the pointer
+     * after it are both aligned
+     */
+    static size_t header_adjustment(size_t current_addr, size_t alignment) {
+        size_t align = std::max(alignment, alignof(AllocationHeader));
+        return align_size(current_addr + sizeof(AllocationHeader), align)
+            - sizeof(AllocationHeader) - current_addr;
+    }
 };
 
+using StackAllocator = BasicStackAllocator<>;
+
+// Frees must come in LIFO order; others are rejected
+MEMORY_ENGINE_REGISTER_ALLOCATOR(stack_allocator, {
+    "stack", "Stack Allocator", {false, false, true, true},
+    {{"size", 16 * 1024 * 1024, "arena bytes"},
+     {"alignment", alignof(std::max_align_t), "default alignment"}},
+    [](const AllocatorParams& params) -> std::unique_ptr<BaseAllocator> {
+        if (!params.get("size") || !MemoryUtils::is_power_of_two(params.get("alignment"))) return nullptr;
+        return std::make_unique<StackAllocator>(params.get("size"), params.get("alignment"), params.numa_node);
+    }
+});
+
 } // namespace memory_engine
 
 #endif // STACK_ALLOCATOR_HPP
@@ -8,33 +8,44 @@
 #ifndef STANDARD_ALLOCATOR_HPP
 #define STANDARD_ALLOCATOR_HPP
 
+#include "allocator_registry.hpp"
 #include "base_allocator.hpp"
 #include "../utils/timer.hpp"
-#include <unordered_map>
+#include "../utils/pointer_set.hpp"
+#include <algorithm>
+#include <cstdint>
 #include <new>
 
 namespace memory_engine {
 
 /**
- * @class StandardAllocator
+ * @class BasicStandardAllocator
  * @brief Wrapper around standard new/delete operators
  * 
  * This allocator serves as a baseline for comparing custom allocator
  * performance. It uses the standard C++ memory allocation functions
  * with added tracking and statistics.
+ *
+ * Tracking adds no allocation to the hot path. Each block carries an inline
+ * header (size, alignment and links in a list of live blocks for reset()),
+ * and a PointerSet marks the live block addresses. owns() consults only the
+ * set, never the block, so foreign and already-freed pointers are safe.
+ *
+ * @tparam StatsPolicy Instrumentation policy (see stats_policy.hpp)
  */
-class StandardAllocator : public BaseAllocator {
+template <typename StatsPolicy = DefaultStatsPolicy>
+class BasicStandardAllocator : public BaseAllocator {
 public:
     /**
      * @brief Constructor
      */
-    StandardAllocator() 
+    BasicStandardAllocator() 
         : BaseAllocator("Standard (new/delete)", SIZE_MAX) {}
 
     /**
      * @brief Destructor - deallocates all tracked memory
      */
-    ~StandardAllocator() override {
+    ~BasicStandardAllocator() override {
         reset();
     }
 
@@ -49,30 +60,31 @@ public:
         if (!is_power_of_two(alignment)) {
             alignment = alignof(std::max_align_t);
         }
+        alignment = std::max(alignment, alignof(std::max_align_t));
 
-        Timer timer;
+        OperationTimer<StatsPolicy> timer(m_timing_countdown);
         timer.start();
 
-        void* ptr = nullptr;
-        
-        #if __cpp_aligned_new >= 201606L
-        // Use aligned new if available (C++17)
-        if (alignment > alignof(std::max_align_t)) {
-            ptr = ::operator new(size, std::align_val_t(alignment), std::nothrow);
-        } else {
-            ptr = ::operator new(size, std::nothrow);
+        const size_t prefix = header_space(alignment);
+        if (size > SIZE_MAX - prefix) return nullptr;
+        uint8_t* raw = static_cast<uint8_t*>(raw_new(prefix + size, alignment));
+        if (!raw) return nullptr;
+
+        uint8_t* ptr = raw + prefix;
+        AllocationHeader* header = header_of(ptr);
+        if (!m_live_set.insert(ptr)) {
+            raw_delete(raw, alignment); // Untrackable address, or out of memory for a map node
+            return nullptr;
         }
-        #else
-        // Fallback for older standards
-        ptr = ::operator new(size, std::nothrow);
-        #endif
+        header->size = size;
+        header->alignment = alignment;
+        header->prev = nullptr;
+        header->next = m_live;
+        if (m_live) m_live->prev = header;
+        m_live = header;
 
         timer.stop();
-
-        if (ptr) {
-            m_allocations[ptr] = {size, alignment};
-            record_allocation(ptr, size, alignment, timer.elapsed_ns());
-        }
+        record_allocation(ptr, size, alignment, timer);
 
         return ptr;
     }
@@ -84,49 +96,34 @@ public:
     void deallocate(void* ptr) override {
         if (!ptr) return;
 
-        auto it = m_allocations.find(ptr);
-        if (it == m_allocations.end()) return; // Not our pointer
+        if (!owns(ptr)) { // Not our pointer, or already freed
+            record_rejected_deallocation();
+            return;
+        }
 
-        Timer timer;
+        OperationTimer<StatsPolicy> timer(m_timing_countdown);
         timer.start();
 
-        size_t size = it->second.first;
-        size_t alignment = it->second.second;
-
-        #if __cpp_aligned_new >= 201606L
-        if (alignment > alignof(std::max_align_t)) {
-            ::operator delete(ptr, std::align_val_t(alignment));
-        } else {
-            ::operator delete(ptr);
-        }
-        #else
-        ::operator delete(ptr);
-        #endif
+        AllocationHeader* header = header_of(ptr);
+        size_t size = header->size;
+        unlink(header);
+        release(header);
 
         timer.stop();
 
-        m_allocations.erase(it);
-        record_deallocation(size, timer.elapsed_ns());
+        record_deallocation(ptr, size, timer);
     }
 
     /**
      * @brief Reset - deallocate all tracked memory
      */
     void reset() override {
-        for (auto& [ptr, info] : m_allocations) {
-            #if __cpp_aligned_new >= 201606L
-            if (info.second > alignof(std::max_align_t)) {
-                ::operator delete(ptr, std::align_val_t(info.second));
-            } else {
-                ::operator delete(ptr);
-            }
-            #else
-            ::operator delete(ptr);
-            #endif
+        while (m_live) {
+            AllocationHeader* header = m_live;
+            m_live = header->next;
+            release(header);
         }
-        m_allocations.clear();
-        m_stats = AllocationStats{};
-        m_allocation_history.clear();
+        reset_stats();
     }
 
     /**
@@ -135,7 +132,7 @@ public:
      * @return true if tracked by this allocator
      */
     bool owns(void* ptr) const override {
-        return m_allocations.find(ptr) != m_allocations.end();
+        return ptr && m_live_set.contains(ptr);
     }
 
     /**
@@ -146,11 +143,78 @@ public:
         return SIZE_MAX; // Effectively unlimited
     }
 
+    /**
+     * @brief Attach a profiler; refused when StatsPolicy has no PROFILE hooks
+     */
+    bool set_profiler(AllocationProfiler* profiler) override {
+        return attach_profiler<StatsPolicy>(profiler);
+    }
+
 private:
-    /// Map of allocated pointers to {size, alignment}
-    std::unordered_map<void*, std::pair<size_t, size_t>> m_allocations;
+    /**
+     * @struct AllocationHeader
+     * @brief Stored immediately before each returned pointer
+     */
+    struct AllocationHeader {
+        AllocationHeader* prev;  ///< Live list, for reset()
+        AllocationHeader* next;
+        size_t size;             ///< Requested size
+        size_t alignment;        ///< Effective alignment (at least max_align_t)
+    };
+
+    AllocationHeader* m_live = nullptr;  ///< Newest live block
+    PointerSet m_live_set;               ///< Addresses of live blocks
+
+    static AllocationHeader* header_of(void* ptr) {
+        return reinterpret_cast<AllocationHeader*>(static_cast<uint8_t*>(ptr) - sizeof(AllocationHeader));
+    }
+
+    // Header rounded up so the pointer after it keeps the block's alignment
+    static size_t header_space(size_t alignment) {
+        return align_size(sizeof(AllocationHeader), alignment);
+    }
+
+    void unlink(AllocationHeader* header) {
+        if (header->prev) header->prev->next = header->next;
+        else m_live = header->next;
+        if (header->next) header->next->prev = header->prev;
+    }
+
+    void release(AllocationHeader* header) {
+        size_t alignment = header->alignment;
+        m_live_set.erase(header + 1);
+        raw_delete(reinterpret_cast<uint8_t*>(header + 1) - header_space(alignment), alignment);
+    }
+
+    static void* raw_new(size_t size, size_t alignment) {
+        #if __cpp_aligned_new >= 201606L
+        if (alignment > alignof(std::max_align_t)) {
+            return ::operator new(size, std::align_val_t(alignment), std::nothrow);
+        }
+        #endif
+        return ::operator new(size, std::nothrow);
+    }
+
+    static void raw_delete(void* raw, size_t alignment) {
+        #if __cpp_aligned_new >= 201606L
+        if (alignment > alignof(std::max_align_t)) {
+            ::operator delete(raw, std::align_val_t(alignment));
+            return;
+        }
+        #endif
+        (void)alignment;
+        ::operator delete(raw);
+    }
 };
 
+using StandardAllocator = BasicStandardAllocator<>;
+
+// Layout-preserving new/delete with per-allocation tracking
+MEMORY_ENGINE_REGISTER_ALLOCATOR(standard_allocator, {
+    "standard", "Standard (new/delete)", {false, true, false, false}, {},
+    [](const AllocatorParams&) -> std::unique_ptr<BaseAllocator> { return std::make_unique<StandardAllocator>(); }
+});
+
 } // namespace memory_engine
 
 #endif // STANDARD_ALLOCATOR_HPP
@@ -0,0 +1,139 @@
+/**
+ * @file stats_policy.hpp
+ * @brief Compile-time instrumentation policies for allocators
+ * @author Bambang Hutagalung
+ * @date 2026
+ */
+
+#ifndef STATS_POLICY_HPP
+#define STATS_POLICY_HPP
+
+#include "../utils/timer.hpp"
+#include <cstddef>
+#include <type_traits>
+
+/**
+ * @def MEMORY_ENGINE_STATS
+ * @brief Set to 0 to make NoStats the default allocator policy
+ *
+ * Production builds can define MEMORY_ENGINE_STATS=0 (CMake option
+ * MEMORY_ENGINE_ENABLE_STATS=OFF) so allocate/deallocate do no bookkeeping.
+ */
+#ifndef MEMORY_ENGINE_STATS
+#define MEMORY_ENGINE_STATS 1
+#endif
+
+namespace memory_engine {
+
+/**
+ * @struct NoStats
+ * @brief No counters, no timing, no history, no profiler hooks
+ */
+struct NoStats {
+    static constexpr bool COUNTERS = false;
+    static constexpr bool TIMING = false;
+    static constexpr bool HISTORY = false;
+    static constexpr bool PROFILE = false;
+    static constexpr size_t TIMING_SAMPLE_INTERVAL = 0;
+};
+
+/**
+ * @struct CountersOnly
+ * @brief Allocation/byte counters without clock reads or history
+ *
+ * Every policy but NoStats keeps the profiler hooks (PROFILE): one branch
+ * on the attached profiler per operation.
+ */
+struct CountersOnly {
+    static constexpr bool COUNTERS = true;
+    static constexpr bool TIMING = false;
+    static constexpr bool HISTORY = false;
+    static constexpr bool PROFILE = true;
+    static constexpr size_t TIMING_SAMPLE_INTERVAL = 0;
+};
+
+/**
+ * @struct SampledTiming
+ * @brief Counters plus timing of every Nth operation
+ * @tparam Interval Operations between timed samples
+ */
+template <size_t Interval = 64>
+struct SampledTiming {
+    static_assert(Interval > 0, "Sample interval must be positive");
+    static constexpr bool COUNTERS = true;
+    static constexpr bool TIMING = true;
+    static constexpr bool HISTORY = false;
+    static constexpr bool PROFILE = true;
+    static constexpr size_t TIMING_SAMPLE_INTERVAL = Interval;
+};
+
+/**
+ * @struct FullHistory
+ * @brief Counters, timing of every operation and a bounded allocation history
+ */
+struct FullHistory {
+    static constexpr bool COUNTERS = true;
+    static constexpr bool TIMING = true;
+    static constexpr bool HISTORY = true;
+    static constexpr bool PROFILE = true;
+    static constexpr size_t TIMING_SAMPLE_INTERVAL = 1;
+};
+
+/// Policy used by the allocator aliases (PoolAllocator, StackAllocator, ...)
+using DefaultStatsPolicy = std::conditional_t<MEMORY_ENGINE_STATS != 0, FullHistory, NoStats>;
+
+/**
+ * @class OperationTimer
+ * @brief Times one allocator operation if the policy asks for it
+ *
+ * Compiles to nothing for policies without TIMING; for sampled policies
+ * only every TIMING_SAMPLE_INTERVAL-th operation reads the clock.
+ */
+template <typename Policy>
+class OperationTimer {
+public:
+    explicit OperationTimer(size_t& sample_countdown) : m_countdown(sample_countdown) {}
+
+    void start() {
+        if constexpr (Policy::TIMING) {
+            if constexpr (Policy::TIMING_SAMPLE_INTERVAL > 1) {
+                if (m_countdown == 0) {
+                    m_countdown = Policy::TIMING_SAMPLE_INTERVAL;
+                    m_sampled = true;
+                }
+                m_countdown--;
+            } else {
+                m_sampled = true;
+            }
+            if (m_sampled) m_begin = Timer::ticks_begin();
+        }
+    }
+
+    void stop() {
+        if constexpr (Policy::TIMING) {
+            if (m_sampled) m_elapsed_ns = Timer::sample_ns(m_begin, Timer::ticks_end());
+        }
+    }
+
+    bool sampled() const { return m_sampled; }
+
+    // Timer ticks at start(); valid only when sampled()
+    uint64_t begin_ticks() const { return m_begin; }
+
+    double elapsed_ns() const {
+        if constexpr (Policy::TIMING) {
+            return m_sampled ? static_cast<double>(m_elapsed_ns) : 0.0;
+        }
+        return 0.0;
+    }
+
+private:
+    size_t& m_countdown;
+    bool m_sampled = false;
+    uint64_t m_begin = 0;
+    uint64_t m_elapsed_ns = 0;
+};
+
+} // namespace memory_engine
+
+#endif // STATS_POLICY_HPP
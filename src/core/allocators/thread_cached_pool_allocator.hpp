@@ -0,0 +1,529 @@
+/**
+ * @file thread_cached_pool_allocator.hpp
+ * @brief Thread-safe fixed-size pool with per-thread block caches
+ * @author Bambang Hutagalung
+ * @date 2026
+ */
+
+#ifndef THREAD_CACHED_POOL_ALLOCATOR_HPP
+#define THREAD_CACHED_POOL_ALLOCATOR_HPP
+
+#include "allocator_registry.hpp"
+#include "base_allocator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace memory_engine {
+
+/**
+ * @class ThreadCachedPoolAllocator
+ * @brief Fixed-size block pool that can be shared between threads
+ *
+ * Blocks live in a single contiguous buffer, exactly like PoolAllocator, but
+ * every thread keeps a small private cache ("magazine") of free blocks in
+ * front of the shared central free list. Allocation and deallocation only
+ * touch the calling thread's cache; the central list is locked once per
+ * batch, when a cache runs dry (refill) or grows past twice the batch size
+ * (drain).
+ *
+ * Advantages:
+ * - O(1) lock-free fast path for both allocate and deallocate
+ * - Central lock is taken once per batch instead of once per call
+ * - Blocks freed on another thread are simply cached there (no remote queue)
+ *
+ * Disadvantages:
+ * - Blocks parked in thread caches are invisible to other threads, so the
+ *   pool can report exhaustion while a few batches are still cached
+ * - Statistics are published per batch, so they lag behind the fast path
+ * - reset() must only be called while no other thread uses the pool
+ */
+class ThreadCachedPoolAllocator : public BaseAllocator {
+public:
+    static constexpr size_t DEFAULT_BATCH_SIZE = 32; ///< Blocks moved per refill/drain
+
+    /**
+     * @brief Constructor
+     * @param block_size Size of each block in bytes
+     * @param block_count Number of blocks to allocate
+     * @param batch_size Blocks moved between a thread cache and the central list at once
+     * @param alignment Memory alignment for blocks
+     */
+    ThreadCachedPoolAllocator(size_t block_size, size_t block_count,
+                              size_t batch_size = DEFAULT_BATCH_SIZE,
+                              size_t alignment = alignof(std::max_align_t))
+        : BaseAllocator("Thread-Cached Pool Allocator", 0)
+        , m_block_size(align_size(block_size < sizeof(FreeBlock) ? sizeof(FreeBlock) : block_size, alignment))
+        , m_block_count(block_count)
+        , m_batch_size(batch_size > 0 ? batch_size : 1)
+        , m_alignment(alignment)
+        , m_id(s_next_id.fetch_add(1, std::memory_order_relaxed))
+        , m_shared(std::make_shared<SharedState>())
+    {
+        m_total_size = m_block_size * m_block_count;
+        m_shared->block_size = m_block_size;
+
+        // Allocate aligned memory
+        #ifdef _WIN32
+        m_shared->memory = static_cast<uint8_t*>(_aligned_malloc(m_total_size, m_alignment));
+        #else
+        m_shared->memory = static_cast<uint8_t*>(std::aligned_alloc(m_alignment, m_total_size));
+        #endif
+
+        if (m_shared->memory) {
+            initialize_free_list();
+        }
+    }
+
+    /**
+     * @brief Destructor
+     *
+     * Releases the shared state once no thread is draining into it. A thread
+     * that exits after this finds its weak_ptr expired and drops its cached
+     * blocks without touching the buffer; they are not handed back.
+     */
+    ~ThreadCachedPoolAllocator() override = default;
+
+    // Disable copy and move (thread caches are keyed by instance)
+    ThreadCachedPoolAllocator(const ThreadCachedPoolAllocator&) = delete;
+    ThreadCachedPoolAllocator& operator=(const ThreadCachedPoolAllocator&) = delete;
+    ThreadCachedPoolAllocator(ThreadCachedPoolAllocator&&) = delete;
+    ThreadCachedPoolAllocator& operator=(ThreadCachedPoolAllocator&&) = delete;
+
+    /**
+     * @brief Allocate a block from the calling thread's cache
+     * @param size Size requested (must be <= block_size)
+     * @param alignment Alignment (ignored, uses pool alignment)
+     * @return Pointer to allocated block, or nullptr if the pool is exhausted
+     */
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) override {
+        (void)alignment; // Pool uses its own alignment
+
+        if (!m_shared->memory || size > m_block_size) {
+            return nullptr;
+        }
+
+        ThreadCache& cache = local_cache();
+        if (!cache.head && !refill(cache)) {
+            return nullptr;
+        }
+
+        FreeBlock* block = cache.head;
+        cache.head = block->next;
+        cache.count--;
+        cache.pending_allocations++;
+
+        return reinterpret_cast<void*>(block);
+    }
+
+    /**
+     * @brief Return a block to the calling thread's cache
+     * @param ptr Pointer to block to deallocate (may come from any thread)
+     */
+    void deallocate(void* ptr) override {
+        if (!ptr) return;
+        if (!owns(ptr)) {
+            std::lock_guard<std::mutex> lock(m_shared->mutex);
+            m_shared->rejected_deallocations++;
+            return;
+        }
+
+        ThreadCache& cache = local_cache();
+
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(ptr);
+        block->next = cache.head;
+        cache.head = block;
+        cache.count++;
+        cache.pending_deallocations++;
+
+        if (cache.count > 2 * m_batch_size) {
+            std::lock_guard<std::mutex> lock(m_shared->mutex);
+            drain(*m_shared, cache, m_batch_size);
+        }
+    }
+
+    /**
+     * @brief Reset pool to initial state
+     *
+     * Must only be called while no other thread is using the allocator.
+     * Outstanding thread caches are invalidated lazily on their next use.
+     */
+    void reset() override {
+        std::lock_guard<std::mutex> lock(m_shared->mutex);
+        m_shared->epoch++;
+        if (m_shared->memory) {
+            initialize_free_list();
+        }
+        m_shared->published_allocations = 0;
+        m_shared->published_deallocations = 0;
+        m_shared->peak_allocations = 0;
+        m_shared->rejected_deallocations = 0;
+        reset_stats();
+    }
+
+    /**
+     * @brief Check if pointer belongs to this pool
+     * @param ptr Pointer to check
+     * @return true if pointer is within pool bounds
+     */
+    bool owns(void* ptr) const override {
+        if (!m_shared->memory || !ptr) return false;
+
+        uint8_t* p = static_cast<uint8_t*>(ptr);
+        return p >= m_shared->memory && p < (m_shared->memory + m_total_size);
+    }
+
+    /**
+     * @brief Thread-cached pool may be shared between threads
+     * @return Always true
+     */
+    bool is_thread_safe() const override {
+        return true;
+    }
+
+    /**
+     * @brief A profiler is not synchronized, so only detaching succeeds
+     * @return true for nullptr
+     */
+    bool set_profiler(AllocationProfiler* profiler) override {
+        return profiler == nullptr;
+    }
+
+    /**
+     * @brief Return the calling thread's cached blocks to the central list
+     *
+     * Also publishes the thread's pending statistics. Called automatically
+     * when a thread exits.
+     */
+    void flush_thread_cache() {
+        ThreadCache& cache = local_cache();
+        std::lock_guard<std::mutex> lock(m_shared->mutex);
+        drain(*m_shared, cache, cache.count);
+    }
+
+    /**
+     * @brief Get number of blocks on the central free list
+     * @return Free block count, excluding blocks parked in thread caches
+     */
+    size_t central_free_blocks() const {
+        std::lock_guard<std::mutex> lock(m_shared->mutex);
+        return m_shared->free_count;
+    }
+
+    /**
+     * @brief Get block size
+     * @return Size of each block
+     */
+    size_t block_size() const {
+        return m_block_size;
+    }
+
+    /**
+     * @brief Get total block count
+     * @return Total number of blocks
+     */
+    size_t block_count() const {
+        return m_block_count;
+    }
+
+    /**
+     * @brief Get refill/drain batch size
+     * @return Blocks moved per central list operation
+     */
+    size_t batch_size() const {
+        return m_batch_size;
+    }
+
+    /**
+     * @brief Get available memory
+     * @return Bytes on the central free list
+     */
+    size_t available() const override {
+        return central_free_blocks() * m_block_size;
+    }
+
+    /**
+     * @brief Pool allocator has no external fragmentation
+     * @return Always 0
+     */
+    double fragmentation_percentage() const override {
+        return 0.0;
+    }
+
+protected:
+    /**
+     * @brief Copy the published counters into the statistics
+     *
+     * Caches publish from any thread under the central lock, so the
+     * counters are read under it too rather than written into m_stats.
+     */
+    void update_derived_stats() const override {
+        std::lock_guard<std::mutex> lock(m_shared->mutex);
+        m_stats.rejected_deallocations = m_shared->rejected_deallocations;
+        if (!DefaultStatsPolicy::COUNTERS) return;
+
+        size_t allocs = m_shared->published_allocations;
+        size_t frees = m_shared->published_deallocations;
+        m_stats.total_allocations = allocs;
+        m_stats.total_deallocations = frees;
+        m_stats.current_allocations = allocs > frees ? allocs - frees : 0;
+        m_stats.total_bytes_allocated = allocs * m_block_size;
+        m_stats.current_bytes_used = m_stats.current_allocations * m_block_size;
+        m_stats.peak_bytes_used = m_shared->peak_allocations * m_block_size;
+    }
+
+private:
+    /**
+     * @struct FreeBlock
+     * @brief Node in the free lists
+     */
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    /**
+     * @struct SharedState
+     * @brief Central free list and buffer, shared with thread caches
+     */
+    struct SharedState {
+        std::mutex mutex;                    ///< Guards everything below
+        uint8_t* memory = nullptr;           ///< Memory buffer
+        size_t block_size = 0;               ///< Size of each block
+        FreeBlock* free_list = nullptr;      ///< Central free list
+        size_t free_count = 0;               ///< Blocks on the central list
+        std::atomic<uint64_t> epoch{0};      ///< Bumped by reset(); read unlocked by local_cache()
+        size_t published_allocations = 0;    ///< Allocations flushed by caches
+        size_t published_deallocations = 0;  ///< Deallocations flushed by caches
+        size_t peak_allocations = 0;         ///< Highest published live count
+        size_t rejected_deallocations = 0;   ///< Foreign pointers passed to deallocate
+
+        ~SharedState() {
+            if (memory) {
+                #ifdef _WIN32
+                _aligned_free(memory);
+                #else
+                std::free(memory);
+                #endif
+            }
+        }
+    };
+
+    /**
+     * @struct ThreadCache
+     * @brief Per-thread magazine of free blocks for one allocator instance
+     */
+    struct ThreadCache {
+        uint64_t owner_id = 0;                ///< Allocator instance id
+        std::weak_ptr<SharedState> shared;    ///< Liveness of the owning allocator
+        uint64_t epoch = 0;                   ///< Epoch the cached blocks belong to
+        FreeBlock* head = nullptr;            ///< Cached free blocks
+        size_t count = 0;                     ///< Number of cached blocks
+        size_t pending_allocations = 0;       ///< Allocations not yet published
+        size_t pending_deallocations = 0;     ///< Deallocations not yet published
+    };
+
+    /**
+     * @struct CacheTable
+     * @brief All caches of the current thread; flushes them on thread exit
+     */
+    struct CacheTable {
+        std::vector<ThreadCache> caches;
+        size_t last = 0; ///< Index of the most recently used cache
+
+        ~CacheTable() {
+            for (auto& cache : caches) {
+                // Only hand blocks back while the allocator is alive; the lock
+                // keeps it from freeing the buffer mid-drain
+                auto shared = cache.shared.lock();
+                if (shared) {
+                    std::lock_guard<std::mutex> lock(shared->mutex);
+                    drain(*shared, cache, cache.count);
+                }
+            }
+        }
+    };
+
+    inline static std::atomic<uint64_t> s_next_id{1}; ///< Instance id generator
+
+    size_t m_block_size;    ///< Size of each block
+    size_t m_block_count;   ///< Total number of blocks
+    size_t m_batch_size;    ///< Blocks per refill/drain
+    size_t m_alignment;     ///< Memory alignment
+    uint64_t m_id;          ///< Unique instance id (never reused)
+    std::shared_ptr<SharedState> m_shared; ///< Central state
+
+    static CacheTable& cache_table() {
+        thread_local CacheTable table;
+        return table;
+    }
+
+    /**
+     * @brief Find (or create) the calling thread's cache for this allocator
+     */
+    ThreadCache& local_cache() {
+        CacheTable& table = cache_table();
+
+        if (table.last < table.caches.size() && table.caches[table.last].owner_id == m_id) {
+            return current_epoch(table.caches[table.last]);
+        }
+
+        for (size_t i = 0; i < table.caches.size(); ++i) {
+            if (table.caches[i].owner_id == m_id) {
+                table.last = i;
+                return current_epoch(table.caches[i]);
+            }
+        }
+
+        // Drop caches of allocators that no longer exist
+        table.caches.erase(
+            std::remove_if(table.caches.begin(), table.caches.end(),
+                [](const ThreadCache& c) { return c.shared.expired(); }),
+            table.caches.end());
+
+        ThreadCache fresh;
+        fresh.owner_id = m_id;
+        fresh.shared = m_shared;
+        {
+            std::lock_guard<std::mutex> lock(m_shared->mutex);
+            fresh.epoch = m_shared->epoch;
+        }
+        table.caches.push_back(fresh);
+        table.last = table.caches.size() - 1;
+        return table.caches.back();
+    }
+
+    /**
+     * @brief Drop a cache left over from before the last reset()
+     *
+     * reset() requires the allocator to be quiescent, so a relaxed read is
+     * enough to see its epoch bump. Without this check the fast paths would
+     * keep handing out blocks that reset() already put back on the central
+     * list.
+     */
+    ThreadCache& current_epoch(ThreadCache& cache) {
+        if (cache.epoch != m_shared->epoch.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(m_shared->mutex);
+            revalidate(*m_shared, cache);
+        }
+        return cache;
+    }
+
+    /**
+     * @brief Move up to one batch from the central list into the cache
+     * @return true if at least one block is now cached
+     */
+    bool refill(ThreadCache& cache) {
+        std::lock_guard<std::mutex> lock(m_shared->mutex);
+        SharedState& shared = *m_shared;
+        revalidate(shared, cache);
+        publish(shared, cache);
+
+        size_t moved = 0;
+        while (moved < m_batch_size && shared.free_list) {
+            FreeBlock* block = shared.free_list;
+            shared.free_list = block->next;
+            block->next = cache.head;
+            cache.head = block;
+            moved++;
+        }
+        shared.free_count -= moved;
+        cache.count += moved;
+
+        return cache.head != nullptr;
+    }
+
+    /**
+     * @brief Discard a cache whose blocks predate the last reset()
+     * @note Caller must hold the central lock
+     */
+    static void revalidate(SharedState& shared, ThreadCache& cache) {
+        if (cache.epoch != shared.epoch) {
+            cache.head = nullptr;
+            cache.count = 0;
+            cache.pending_allocations = 0;
+            cache.pending_deallocations = 0;
+            cache.epoch = shared.epoch;
+        }
+    }
+
+    /**
+     * @brief Move up to @p count blocks from the cache to the central list
+     * @note Caller must hold the central lock
+     */
+    static void drain(SharedState& shared, ThreadCache& cache, size_t count) {
+        revalidate(shared, cache);
+        publish(shared, cache);
+
+        if (count == 0 || !cache.head) return;
+
+        // Detach the first `count` blocks as one chain
+        FreeBlock* first = cache.head;
+        FreeBlock* last = first;
+        size_t moved = 1;
+        while (moved < count && last->next) {
+            last = last->next;
+            moved++;
+        }
+        cache.head = last->next;
+        cache.count -= moved;
+
+        last->next = shared.free_list;
+        shared.free_list = first;
+        shared.free_count += moved;
+    }
+
+    /**
+     * @brief Fold a cache's pending counters into the published totals
+     * @note Caller must hold the central lock
+     */
+    static void publish(SharedState& shared, ThreadCache& cache) {
+        if (cache.pending_allocations == 0 && cache.pending_deallocations == 0) return;
+
+        shared.published_allocations += cache.pending_allocations;
+        shared.published_deallocations += cache.pending_deallocations;
+        cache.pending_allocations = 0;
+        cache.pending_deallocations = 0;
+
+        size_t allocs = shared.published_allocations;
+        size_t frees = shared.published_deallocations;
+        if (allocs > frees && allocs - frees > shared.peak_allocations) {
+            shared.peak_allocations = allocs - frees;
+        }
+    }
+
+    /**
+     * @brief Initialize the central free list
+     * @note Caller must hold the central lock (or be the constructor)
+     */
+    void initialize_free_list() {
+        m_shared->free_list = nullptr;
+
+        // Build free list from end to start for sequential access
+        for (size_t i = m_block_count; i > 0; --i) {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(m_shared->memory + (i - 1) * m_block_size);
+            block->next = m_shared->free_list;
+            m_shared->free_list = block;
+        }
+        m_shared->free_count = m_block_count;
+    }
+};
+
+// Extra blocks leave headroom for batches parked in per-thread caches
+MEMORY_ENGINE_REGISTER_ALLOCATOR(thread_cached_pool_allocator, {
+    "thread_cached_pool", "Thread-Cached Pool Allocator", {true, true, true, false},
+    {{"block_size", 4096, "bytes per block; larger requests fail"},
+     {"block_count", 12000, "blocks in the shared pool"},
+     {"batch_size", ThreadCachedPoolAllocator::DEFAULT_BATCH_SIZE, "blocks moved per cache refill or flush"}},
+    [](const AllocatorParams& params) -> std::unique_ptr<BaseAllocator> {
+        if (!params.get("block_size") || !params.get("block_count") || !params.get("batch_size")) return nullptr;
+        return std::make_unique<ThreadCachedPoolAllocator>(params.get("block_size"), params.get("block_count"),
+                                                           params.get("batch_size"));
+    }
+});
+
+} // namespace memory_engine
+
+#endif // THREAD_CACHED_POOL_ALLOCATOR_HPP
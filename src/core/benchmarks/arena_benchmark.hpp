@@ -0,0 +1,172 @@
+/**
+ * @file arena_benchmark.hpp
+ * @brief Per-request allocation bursts: general-purpose heap vs. scoped arenas
+ */
+
+#ifndef ARENA_BENCHMARK_HPP
+#define ARENA_BENCHMARK_HPP
+
+#include "../allocators/scoped_arena.hpp"
+#include "../allocators/standard_allocator.hpp"
+#include "../utils/histogram.hpp"
+#include "../utils/statistics.hpp"
+#include "../utils/timer.hpp"
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace memory_engine {
+
+struct RequestBurstConfig {
+    size_t requests = 10000;
+    size_t allocations_per_request = 64;
+    size_t min_size = 16;
+    size_t max_size = 512;
+    double object_ratio = 0.25;   ///< Share of allocations that are std::string objects (need destructors)
+    uint64_t seed = 1;
+};
+
+struct RequestBurstMetrics {
+    std::string allocator_name;
+    LatencyHistogram request_latency;   ///< One whole request: allocate, write, free everything
+    double total_time_ms = 0;
+    double throughput = 0;              ///< Requests per second
+    size_t failed_allocations = 0;
+};
+
+class ArenaBenchmark {
+public:
+    /**
+     * Every variant serves the same request sequence. A request makes
+     * allocations_per_request allocations of random size, writes each, and
+     * frees them all when it ends: one by one for the heaps, by scope exit
+     * or frame flip for the arenas.
+     */
+    std::vector<RequestBurstMetrics> run_request_burst(const RequestBurstConfig& config) {
+        std::vector<Allocation> pattern = make_pattern(config);
+        size_t burst = std::max<size_t>(config.allocations_per_request, 1);
+        size_t arena_size = burst * (config.max_size + 128) * 2;
+        std::vector<RequestBurstMetrics> results;
+
+        std::vector<void*> blocks(burst);
+        std::vector<std::string*> objects(burst);
+
+        results.push_back(run("new/delete", config, pattern, [&](const Allocation* request, size_t count,
+                                                                  size_t& failed) {
+            size_t block_count = 0, object_count = 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (request[i].object) {
+                    objects[object_count++] = new std::string(request[i].size % 15, 'x');
+                } else {
+                    void* block = ::operator new(request[i].size, std::nothrow);
+                    if (!block) { failed++; continue; }
+                    std::memset(block, 1, request[i].size);
+                    blocks[block_count++] = block;
+                }
+            }
+            for (size_t i = 0; i < object_count; ++i) delete objects[i];
+            for (size_t i = 0; i < block_count; ++i) ::operator delete(blocks[i]);
+        }));
+
+        // Uninstrumented so the numbers compare allocation strategies, not
+        // the cost of the stats policy
+        BasicStandardAllocator<NoStats> standard;
+        results.push_back(run(standard.name(), config, pattern, [&](const Allocation* request, size_t count,
+                                                                    size_t& failed) {
+            size_t block_count = 0, object_count = 0;
+            for (size_t i = 0; i < count; ++i) {
+                void* memory = standard.allocate(request[i].object ? sizeof(std::string) : request[i].size);
+                if (!memory) { failed++; continue; }
+                if (request[i].object) {
+                    objects[object_count++] = new (memory) std::string(request[i].size % 15, 'x');
+                } else {
+                    std::memset(memory, 1, request[i].size);
+                    blocks[block_count++] = memory;
+                }
+            }
+            for (size_t i = 0; i < object_count; ++i) {
+                objects[i]->~basic_string();
+                standard.deallocate(objects[i]);
+            }
+            for (size_t i = 0; i < block_count; ++i) standard.deallocate(blocks[i]);
+        }));
+
+        BasicStackAllocator<NoStats> stack(arena_size);
+        results.push_back(run("ScopedArena", config, pattern, [&](const Allocation* request, size_t count,
+                                                                  size_t& failed) {
+            BasicScopedArena<NoStats> scope(stack);
+            for (size_t i = 0; i < count; ++i) {
+                if (request[i].object) {
+                    if (!scope.make<std::string>(request[i].size % 15, 'x')) failed++;
+                } else if (void* block = scope.allocate(request[i].size)) {
+                    std::memset(block, 1, request[i].size);
+                } else {
+                    failed++;
+                }
+            }
+        }));
+
+        BasicFrameAllocator<NoStats> frames(arena_size);
+        results.push_back(run("FrameAllocator", config, pattern, [&](const Allocation* request, size_t count,
+                                                                     size_t& failed) {
+            for (size_t i = 0; i < count; ++i) {
+                if (request[i].object) {
+                    if (!frames.make<std::string>(request[i].size % 15, 'x')) failed++;
+                } else if (void* block = frames.allocate(request[i].size)) {
+                    std::memset(block, 1, request[i].size);
+                } else {
+                    failed++;
+                }
+            }
+            frames.flip();
+        }));
+
+        return results;
+    }
+
+private:
+    struct Allocation {
+        size_t size;
+        bool object;
+    };
+
+    static std::vector<Allocation> make_pattern(const RequestBurstConfig& config) {
+        std::mt19937_64 rng(config.seed);
+        size_t min_size = std::max<size_t>(config.min_size, 1);
+        std::uniform_int_distribution<size_t> size(min_size, std::max(config.max_size, min_size));
+        std::bernoulli_distribution object(std::min(std::max(config.object_ratio, 0.0), 1.0));
+
+        // One request's worth, replayed for every request
+        std::vector<Allocation> pattern(std::max<size_t>(config.allocations_per_request, 1));
+        for (auto& allocation : pattern) {
+            allocation.size = size(rng);
+            allocation.object = object(rng);
+        }
+        return pattern;
+    }
+
+    template <typename Request>
+    static RequestBurstMetrics run(const std::string& name, const RequestBurstConfig& config,
+                                   const std::vector<Allocation>& pattern, Request&& request) {
+        RequestBurstMetrics metrics;
+        metrics.allocator_name = name;
+
+        Timer total;
+        total.start();
+        for (size_t r = 0; r < config.requests; ++r) {
+            uint64_t t0 = Timer::ticks_begin();
+            request(pattern.data(), pattern.size(), metrics.failed_allocations);
+            metrics.request_latency.record(Timer::sample_ns(t0, Timer::ticks_end()));
+        }
+        total.stop();
+
+        metrics.total_time_ms = total.elapsed_ms();
+        metrics.throughput = Statistics::throughput(config.requests, total.elapsed_ns());
+        return metrics;
+    }
+};
+
+} // namespace memory_engine
+
+#endif // ARENA_BENCHMARK_HPP
@@ -0,0 +1,267 @@
+/**
+ * @file auto_tuner.hpp
+ * @brief Allocator parameter sweep over a workload, reduced to a Pareto front
+ *
+ * The engine's allocators have fixed shapes (pool block size and count,
+ * arena sizes, fit policy). The right shape depends on the workload, and
+ * these numbers used to be tuned by hand for each service. The tuner
+ * replays one workload, synthetic or recorded, against a fresh instance of
+ * every candidate configuration. It keeps the configurations no other
+ * candidate beats on throughput, p99 latency and memory footprint at once.
+ */
+
+#ifndef AUTO_TUNER_HPP
+#define AUTO_TUNER_HPP
+
+#include "../allocators/bitmap_allocator.hpp"
+#include "../allocators/freelist_allocator.hpp"
+#include "../allocators/pool_allocator.hpp"
+#include "../allocators/size_class_allocator.hpp"
+#include "../allocators/stack_allocator.hpp"
+#include "../concurrency/thread_pool.hpp"
+#include "../utils/memory_utils.hpp"
+#include "trace_replay.hpp"
+#include "workload_generator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace memory_engine {
+
+struct AutoTuneConfig {
+    std::vector<size_t> pool_block_sizes = {64, 128, 256, 512, 1024, 2048, 4096};
+    std::vector<FitPolicy> fit_policies = {FitPolicy::FIRST_FIT, FitPolicy::BEST_FIT, FitPolicy::WORST_FIT};
+    std::vector<size_t> arena_sizes;                        ///< Stack/free list/large arena bytes; empty = from arena_multipliers
+    std::vector<double> arena_multipliers = {1.5, 2, 4};    ///< Times the workload's peak live bytes
+    std::vector<size_t> size_class_chunks = {16 * 1024, 64 * 1024, 256 * 1024};
+    double pool_headroom = 1.1;   ///< Pool blocks = peak live objects * headroom
+    size_t repetitions = 3;       ///< Replays per candidate; throughput and p99 are medians
+    size_t parallelism = 1;       ///< Candidates replayed at once on the thread pool (>1 skews latency)
+};
+
+/**
+ * @struct TuningResult
+ * @brief One candidate configuration and how it did
+ */
+struct TuningResult {
+    std::string allocator;
+    std::string parameters;          ///< e.g. "block=256 count=11000"
+    double throughput = 0;           ///< Replayed ops per second (median over repetitions)
+    double p99_latency_ns = 0;       ///< Allocation p99 (median over repetitions)
+    size_t footprint_bytes = 0;      ///< Memory the allocator held at its peak
+    size_t failed_allocations = 0;
+    size_t rejected_frees = 0;
+    bool feasible = false;           ///< Served every allocation and accepted every free
+    bool pareto = false;             ///< No feasible candidate is at least as good on all three and better on one
+    std::function<std::unique_ptr<BaseAllocator>()> create;   ///< Builds this configuration (NoStats)
+};
+
+struct AutoTuneReport {
+    std::string error;                   ///< Non-empty if the workload could not be loaded
+    size_t op_count = 0;
+    size_t peak_live_objects = 0;        ///< Workload profile the candidates were sized from
+    size_t peak_live_bytes = 0;
+    size_t max_request = 0;
+    double total_time_ms = 0;
+    std::vector<TuningResult> candidates;    ///< Pareto front first, each group by throughput
+    size_t pareto_count = 0;
+};
+
+class AutoTuner {
+public:
+    void set_thread_pool(ThreadPool* pool) { m_pool = pool; }
+
+    AutoTuneReport tune(const WorkloadConfig& workload, const AutoTuneConfig& config = {}) {
+        std::vector<TraceRecord> records = WorkloadGenerator::generate(workload);
+        return tune(records.data(), records.size(), config);
+    }
+
+    AutoTuneReport tune_file(const std::string& path, const AutoTuneConfig& config = {}) {
+        TraceReader reader;
+        if (!reader.open(path)) {
+            AutoTuneReport report;
+            report.error = reader.error();
+            return report;
+        }
+        return tune(reader.records(), reader.record_count(), config);
+    }
+
+    /**
+     * Candidates are NoStats instances, so the numbers are what the
+     * configuration costs in production. Each candidate gets its own
+     * instance. With parallelism > 1 they replay concurrently on the thread
+     * pool; that finishes sooner, but candidates compete for cache and
+     * memory bandwidth, so keep it at 1 when p99 matters.
+     */
+    AutoTuneReport tune(const TraceRecord* records, size_t count, const AutoTuneConfig& config) {
+        AutoTuneReport report;
+        report.op_count = count;
+        profile(records, count, report);
+
+        Timer timer;
+        timer.start();
+        report.candidates = make_candidates(report, config);
+
+        size_t workers = std::min(std::max<size_t>(config.parallelism, 1), report.candidates.size());
+        if (workers > 1 && m_pool) {
+            std::atomic<size_t> next{0};
+            m_pool->run_parallel(workers, [&](size_t) {
+                for (size_t i = next.fetch_add(1); i < report.candidates.size(); i = next.fetch_add(1)) {
+                    evaluate(report.candidates[i], records, count, config);
+                }
+            });
+        } else {
+            for (TuningResult& candidate : report.candidates) evaluate(candidate, records, count, config);
+        }
+
+        mark_pareto(report);
+        timer.stop();
+        report.total_time_ms = timer.elapsed_ms();
+        return report;
+    }
+
+private:
+    ThreadPool* m_pool = nullptr;
+
+    static void profile(const TraceRecord* records, size_t count, AutoTuneReport& report) {
+        std::unordered_map<uint64_t, size_t> live;
+        size_t live_bytes = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const TraceRecord& record = records[i];
+            if (record.op == static_cast<uint8_t>(TraceOp::ALLOCATE)) {
+                size_t size = static_cast<size_t>(record.size);
+                auto inserted = live.emplace(record.object_id, size);
+                if (!inserted.second) {
+                    live_bytes -= inserted.first->second;
+                    inserted.first->second = size;
+                }
+                live_bytes += size;
+                report.max_request = std::max(report.max_request, size);
+            } else {
+                auto it = live.find(record.object_id);
+                if (it == live.end()) continue;
+                live_bytes -= it->second;
+                live.erase(it);
+            }
+            report.peak_live_objects = std::max(report.peak_live_objects, live.size());
+            report.peak_live_bytes = std::max(report.peak_live_bytes, live_bytes);
+        }
+    }
+
+    static std::vector<TuningResult> make_candidates(const AutoTuneReport& report, const AutoTuneConfig& config) {
+        std::vector<TuningResult> candidates;
+        auto add = [&](const std::string& allocator, const std::string& parameters,
+                       std::function<std::unique_ptr<BaseAllocator>()> create) {
+            TuningResult candidate;
+            candidate.allocator = allocator;
+            candidate.parameters = parameters;
+            candidate.create = std::move(create);
+            candidates.push_back(std::move(candidate));
+        };
+
+        // A pool only serves requests up to its block size; a bitmap arena of the
+        // same shape is the out-of-band alternative
+        size_t blocks = static_cast<size_t>(std::ceil(report.peak_live_objects * std::max(config.pool_headroom, 1.0)));
+        blocks = std::max<size_t>(blocks, 1);
+        for (size_t block : config.pool_block_sizes) {
+            if (block < report.max_request) continue;
+            add("Pool Allocator", "block=" + std::to_string(block) + " count=" + std::to_string(blocks),
+                [block, blocks] { return std::make_unique<BasicPoolAllocator<NoStats>>(block, blocks); });
+            add("Bitmap Allocator", "block=" + std::to_string(block) + " count=" + std::to_string(blocks),
+                [block, blocks] { return std::make_unique<BasicBitmapAllocator<NoStats>>(block, blocks); });
+        }
+
+        std::vector<size_t> arenas = config.arena_sizes;
+        if (arenas.empty()) {
+            for (double multiplier : config.arena_multipliers) {
+                size_t bytes = static_cast<size_t>(report.peak_live_bytes * multiplier);
+                arenas.push_back(MemoryUtils::align_forward(std::max<size_t>(bytes, MemoryUtils::MB(1)),
+                                                            MemoryUtils::MB(1)));
+            }
+        }
+        std::sort(arenas.begin(), arenas.end());
+        arenas.erase(std::unique(arenas.begin(), arenas.end()), arenas.end());
+
+        for (size_t arena : arenas) {
+            std::string size = "arena=" + std::to_string(arena >> 20) + "MB";
+            add("Stack Allocator", size, [arena] { return std::make_unique<BasicStackAllocator<NoStats>>(arena); });
+            for (FitPolicy policy : config.fit_policies) {
+                add("Free List Allocator", size + " " + fit_policy_name(policy), [arena, policy] {
+                    return std::make_unique<BasicFreeListAllocator<NoStats>>(arena, policy);
+                });
+            }
+            for (size_t chunk : config.size_class_chunks) {
+                add("Size-Class Allocator", "chunk=" + std::to_string(chunk >> 10) + "KB large_" + size,
+                    [arena, chunk] { return std::make_unique<BasicSizeClassAllocator<NoStats>>(4096, chunk, arena); });
+            }
+        }
+        return candidates;
+    }
+
+    static void evaluate(TuningResult& candidate, const TraceRecord* records, size_t count,
+                         const AutoTuneConfig& config) {
+        std::unique_ptr<BaseAllocator> allocator = candidate.create();
+        TraceReplayer replayer;
+        TraceReplayConfig replay;
+        replay.sample_interval = 0;
+
+        std::vector<double> throughput, p99;
+        for (size_t rep = 0; rep < std::max<size_t>(config.repetitions, 1); ++rep) {
+            TraceReplayMetrics metrics = replayer.replay(*allocator, records, count, replay);
+            throughput.push_back(metrics.throughput);
+            p99.push_back(metrics.allocation_time.p99);
+            candidate.failed_allocations = std::max(candidate.failed_allocations, metrics.failed_allocations);
+            candidate.rejected_frees = std::max(candidate.rejected_frees, metrics.rejected_frees);
+            // Fixed arenas hold their whole size; grown ones (size classes) report what they reached
+            candidate.footprint_bytes = std::max(candidate.footprint_bytes,
+                                                 std::max(allocator->total_size(), metrics.peak_live_bytes));
+        }
+
+        candidate.throughput = Statistics::analyze(throughput).median;
+        candidate.p99_latency_ns = Statistics::analyze(p99).median;
+        candidate.feasible = candidate.failed_allocations == 0 && candidate.rejected_frees == 0;
+    }
+
+    static bool dominates(const TuningResult& a, const TuningResult& b) {
+        bool no_worse = a.throughput >= b.throughput && a.p99_latency_ns <= b.p99_latency_ns &&
+                        a.footprint_bytes <= b.footprint_bytes;
+        bool better = a.throughput > b.throughput || a.p99_latency_ns < b.p99_latency_ns ||
+                      a.footprint_bytes < b.footprint_bytes;
+        return no_worse && better;
+    }
+
+    static void mark_pareto(AutoTuneReport& report) {
+        std::vector<TuningResult>& candidates = report.candidates;
+        for (TuningResult& candidate : candidates) {
+            if (!candidate.feasible) continue;
+            candidate.pareto = std::none_of(candidates.begin(), candidates.end(), [&](const TuningResult& other) {
+                return other.feasible && dominates(other, candidate);
+            });
+        }
+        std::stable_sort(candidates.begin(), candidates.end(), [](const TuningResult& a, const TuningResult& b) {
+            if (a.pareto != b.pareto) return a.pareto;
+            if (a.feasible != b.feasible) return a.feasible;
+            return a.throughput > b.throughput;
+        });
+        report.pareto_count = static_cast<size_t>(std::count_if(
+            candidates.begin(), candidates.end(), [](const TuningResult& c) { return c.pareto; }));
+    }
+
+    static const char* fit_policy_name(FitPolicy policy) {
+        switch (policy) {
+            case FitPolicy::FIRST_FIT: return "first-fit";
+            case FitPolicy::BEST_FIT: return "best-fit";
+            case FitPolicy::WORST_FIT: return "worst-fit";
+        }
+        return "unknown";
+    }
+};
+
+} // namespace memory_engine
+
+#endif // AUTO_TUNER_HPP
@@ -0,0 +1,134 @@
+/**
+ * @file benchmark_job.hpp
+ * @brief One benchmark at a time on a background thread, with streamed progress
+ *
+ * The WASM page used to call into the engine synchronously, which froze the
+ * UI for the length of the run. A BenchmarkJob runs the work on its own
+ * thread (a pthread from Emscripten's pool in the browser). Progress goes
+ * through an SPSCQueue in the shared heap, and the page drains it once per
+ * animation frame. Cancellation is a flag the engine's runners check between
+ * iterations.
+ */
+
+#ifndef BENCHMARK_JOB_HPP
+#define BENCHMARK_JOB_HPP
+
+#include "../concurrency/concurrent_queue.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace memory_engine {
+
+enum class JobState : uint8_t {
+    IDLE,
+    RUNNING,
+    FINISHED,
+    CANCELLED
+};
+
+/**
+ * @struct ProgressEvent
+ * @brief One progress report, fixed-size so it can sit in the ring
+ */
+struct ProgressEvent {
+    uint32_t job_id = 0;
+    int32_t percent = 0;
+    char status[56] = {};   ///< Truncated, always NUL-terminated
+};
+
+/**
+ * @class BenchmarkJob
+ * @brief Owns the worker thread, the progress ring and the cancel flag
+ *
+ * start(), poll(), cancel() and state() are called from one controlling
+ * thread; report() and cancel_requested() from inside the work. Progress is
+ * lossy: when the controller falls behind, new events are dropped and
+ * counted rather than stalling the benchmark. The final outcome is carried
+ * by state(), never by the ring, so it cannot be lost.
+ */
+class BenchmarkJob {
+public:
+    using Work = std::function<void(BenchmarkJob&)>;
+
+    static constexpr size_t DEFAULT_CAPACITY = 256;
+
+    explicit BenchmarkJob(size_t capacity = DEFAULT_CAPACITY) : m_events(capacity) {}
+
+    ~BenchmarkJob() {
+        cancel();
+        if (m_thread.joinable()) m_thread.join();
+    }
+
+    BenchmarkJob(const BenchmarkJob&) = delete;
+    BenchmarkJob& operator=(const BenchmarkJob&) = delete;
+
+    /**
+     * @brief Run work on a new thread
+     * @return false if a job is still running
+     */
+    bool start(Work work) {
+        if (state() == JobState::RUNNING) return false;
+        if (m_thread.joinable()) m_thread.join();
+
+        // The old worker is gone, so the consumer may drain its leftovers
+        ProgressEvent stale;
+        while (m_events.try_pop(stale)) {}
+
+        m_job_id++;
+        m_dropped.store(0, std::memory_order_relaxed);
+        m_cancel.store(false, std::memory_order_relaxed);
+        m_state.store(JobState::RUNNING, std::memory_order_release);
+        m_thread = std::thread([this, work = std::move(work)] {
+            work(*this);
+            m_state.store(m_cancel.load(std::memory_order_relaxed) ? JobState::CANCELLED : JobState::FINISHED,
+                          std::memory_order_release);
+        });
+        return true;
+    }
+
+    // Worker side: queue a progress event, or count it as dropped if the ring is full
+    void report(int percent, const std::string& status) {
+        ProgressEvent event;
+        event.job_id = m_job_id;
+        event.percent = percent;
+        size_t length = std::min(status.size(), sizeof(event.status) - 1);
+        std::memcpy(event.status, status.data(), length);
+        if (!m_events.try_push(event)) m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Controller side: next queued event, oldest first
+    bool poll(ProgressEvent& out) { return m_events.try_pop(out); }
+
+    // Takes effect at the work's next check; state() ends as CANCELLED
+    void cancel() { m_cancel.store(true, std::memory_order_relaxed); }
+
+    bool cancel_requested() const { return m_cancel.load(std::memory_order_relaxed); }
+    const std::atomic<bool>* cancel_flag() const { return &m_cancel; }
+
+    /**
+     * FINISHED or CANCELLED is published after the work returns, with
+     * release ordering, so anything the work wrote is visible once the
+     * controller sees it.
+     */
+    JobState state() const { return m_state.load(std::memory_order_acquire); }
+
+    uint32_t job_id() const { return m_job_id; }
+    size_t dropped_events() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    SPSCQueue<ProgressEvent> m_events;
+    std::thread m_thread;
+    uint32_t m_job_id = 0;
+    std::atomic<JobState> m_state{JobState::IDLE};
+    std::atomic<bool> m_cancel{false};
+    std::atomic<size_t> m_dropped{0};
+};
+
+} // namespace memory_engine
+
+#endif // BENCHMARK_JOB_HPP
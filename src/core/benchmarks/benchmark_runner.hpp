@@ -6,10 +6,23 @@
 #ifndef BENCHMARK_RUNNER_HPP
 #define BENCHMARK_RUNNER_HPP
 
+#include "../allocators/allocator_adapters.hpp"
 #include "../allocators/base_allocator.hpp"
+#include "trace_replay.hpp"
+#include "workload_generator.hpp"
 #include "../utils/timer.hpp"
 #include "../utils/statistics.hpp"
+#include "../utils/histogram.hpp"
+#include "../utils/perf_counters.hpp"
+#include <atomic>
 #include <functional>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <thread>
 #include <vector>
 #include <string>
 
@@ -19,18 +32,66 @@ struct BenchmarkConfig {
     size_t object_size = 256;
     size_t object_count = 10000;
     size_t iterations = 10;
+    size_t warmup_iterations = 0;      ///< Untimed iterations first (page faults, caches, lazy init)
     size_t alignment = 8;
-    size_t thread_count = 1;
-    bool randomize_order = false;
+    size_t thread_count = 1;           ///< >1 splits object_count across concurrent threads
+    size_t batch_size = 0;             ///< >0 uses allocate_batch/deallocate_batch in chunks of this size
+    FreeOrder free_order = FreeOrder::FIFO; ///< FIFO, LIFO or RANDOM; INTERLEAVED needs run_workload
+    bool randomize_order = false;      ///< Shorthand for free_order = RANDOM
+    bool per_op_timing = true;         ///< Time every call into latency histograms (two clock reads per op)
+    bool perf_counters = false;        ///< Count hardware events around the alloc and free loops (Linux)
 };
 
 struct BenchmarkMetrics {
-    BenchmarkResult allocation_time;
+    BenchmarkResult allocation_time;   ///< Per-op distribution (per-iteration means if !per_op_timing)
     BenchmarkResult deallocation_time;
-    double throughput = 0;
+    BenchmarkResult alloc_iteration_time;   ///< Mean ns per allocation of each timed iteration
+    BenchmarkResult dealloc_iteration_time; ///< Same for frees; these carry the confidence intervals
+    LatencyHistogram alloc_latency;    ///< Every timed allocation, all iterations and threads
+    LatencyHistogram dealloc_latency;
+    double throughput = 0;             ///< Allocations per second over the timed loops
     double peak_memory = 0;
     double fragmentation = 0;
+    size_t thread_count = 1;
+    size_t failed_allocations = 0;     ///< allocate() returned nullptr, summed over iterations
+    size_t rejected_deallocations = 0; ///< Frees the allocator refused, summed over iterations
+    PerfCounters alloc_counters;       ///< Per allocation, when config.perf_counters (available == 0 otherwise)
+    PerfCounters dealloc_counters;     ///< Per deallocation
+    bool cancelled = false;            ///< Stopped early; the numbers cover the iterations that finished
+    std::string allocator_name;
+};
+
+enum class ContainerWorkload {
+    VECTOR_GROWTH,   ///< push_back without reserve, so the buffer regrows geometrically
+    MAP_CHURN,       ///< std::map random insert and erase (one node per element)
+    STRING_BUILD     ///< Strings built by appending, replacing older ones in a ring
+};
+
+enum class ContainerAdapter {
+    STD_ALLOCATOR,   ///< std::allocator, the baseline every other row is compared to
+    PMR_RESOURCE,    ///< std::pmr containers over AllocatorResource
+    STL_ALLOCATOR    ///< Containers templated on StlAllocator
+};
+
+struct ContainerConfig {
+    size_t operations = 100000;   ///< push_backs, map updates or string appends per iteration
+    size_t iterations = 5;
+    size_t vector_length = 1000;  ///< VECTOR_GROWTH elements per vector before it is dropped
+    size_t key_range = 10000;     ///< MAP_CHURN keys, drawn uniformly; about half are live at a time
+    size_t string_length = 256;   ///< STRING_BUILD characters per string, appended 8 at a time
+    size_t live_strings = 64;     ///< STRING_BUILD strings kept before the oldest is replaced
+    uint64_t seed = 1;
+};
+
+struct ContainerMetrics {
     std::string allocator_name;
+    ContainerWorkload workload = ContainerWorkload::VECTOR_GROWTH;
+    ContainerAdapter adapter = ContainerAdapter::STD_ALLOCATOR;
+    BenchmarkResult iteration_time;    ///< ns per iteration
+    double throughput = 0;             ///< Operations per second
+    double speedup = 1;                ///< STD_ALLOCATOR time / this time on the same workload
+    size_t fallback_allocations = 0;   ///< PMR_RESOURCE requests the allocator refused
+    size_t rejected_deallocations = 0; ///< Frees the allocator refused (e.g. out-of-order stack frees)
 };
 
 class BenchmarkRunner {
@@ -43,7 +104,17 @@ public:
         m_progress_callback = callback;
     }
 
+    // Checked before each iteration; a set flag ends the run with metrics.cancelled
+    void set_cancel_flag(const std::atomic<bool>* flag) {
+        m_cancel_flag = flag;
+    }
+
     BenchmarkMetrics run_allocation_benchmark(BaseAllocator& allocator, const BenchmarkConfig& config) {
+        if (config.thread_count > 1) {
+            return run_multithreaded_benchmark(allocator, config);
+        }
+        warm_up(allocator, config);
+
         BenchmarkMetrics metrics;
         metrics.allocator_name = allocator.name();
 
@@ -52,35 +123,67 @@ public:
         std::vector<void*> pointers;
         pointers.reserve(config.object_count);
 
+        std::mt19937_64 rng(config.object_count);
+        double total_alloc_ns = 0;
+        size_t total_allocated = 0;
+        PerfCounterGroup* counters = config.perf_counters ? &PerfCounterGroup::for_this_thread() : nullptr;
+        PerfCounters alloc_events;
+        PerfCounters dealloc_events;
+
         for (size_t iter = 0; iter < config.iterations; ++iter) {
+            if (cancel_requested()) {
+                metrics.cancelled = true;
+                break;
+            }
             allocator.reset();
             pointers.clear();
 
             // Allocation phase
             Timer alloc_timer;
+            if (counters) counters->start();
             alloc_timer.start();
             
-            for (size_t i = 0; i < config.object_count; ++i) {
-                void* ptr = allocator.allocate(config.object_size, config.alignment);
-                if (ptr) pointers.push_back(ptr);
+            if (config.per_op_timing) {
+                allocate_timed(allocator, config, config.object_count, pointers, metrics.alloc_latency);
+            } else if (config.batch_size > 0) {
+                allocate_batched(allocator, config, config.object_count, pointers);
+            } else {
+                for (size_t i = 0; i < config.object_count; ++i) {
+                    void* ptr = allocator.allocate(config.object_size, config.alignment);
+                    if (ptr) pointers.push_back(ptr);
+                }
             }
             
             alloc_timer.stop();
+            if (counters) alloc_events += counters->stop();
             alloc_times.push_back(alloc_timer.elapsed_ns() / config.object_count);
+            total_alloc_ns += alloc_timer.elapsed_ns();
+            total_allocated += pointers.size();
 
             metrics.peak_memory = std::max(metrics.peak_memory, 
                 static_cast<double>(allocator.stats().peak_bytes_used));
+            metrics.failed_allocations += config.object_count - pointers.size();
+            apply_free_order(pointers, config, rng);
 
             // Deallocation phase
             Timer dealloc_timer;
+            if (counters) counters->start();
             dealloc_timer.start();
             
-            for (void* ptr : pointers) {
-                allocator.deallocate(ptr);
+            if (config.per_op_timing) {
+                deallocate_timed(allocator, config, pointers, metrics.dealloc_latency);
+            } else if (config.batch_size > 0) {
+                deallocate_batched(allocator, config, pointers);
+            } else {
+                for (void* ptr : pointers) {
+                    allocator.deallocate(ptr);
+                }
             }
             
             dealloc_timer.stop();
-            dealloc_times.push_back(dealloc_timer.elapsed_ns() / pointers.size());
+            if (counters) dealloc_events += counters->stop();
+            if (!pointers.empty()) dealloc_times.push_back(dealloc_timer.elapsed_ns() / pointers.size());
+            metrics.rejected_deallocations += allocator.stats().rejected_deallocations;
 
             if (m_progress_callback) {
                 int percent = static_cast<int>((iter + 1) * 100 / config.iterations);
@@ -88,16 +191,523 @@ public:
             }
         }
 
-        metrics.allocation_time = Statistics::analyze(alloc_times);
-        metrics.deallocation_time = Statistics::analyze(dealloc_times);
-        metrics.throughput = Statistics::throughput(config.object_count, metrics.allocation_time.mean);
+        if (config.per_op_timing) {
+            metrics.allocation_time = metrics.alloc_latency.summarize();
+            metrics.deallocation_time = metrics.dealloc_latency.summarize();
+        } else {
+            metrics.allocation_time = Statistics::analyze(alloc_times);
+            metrics.deallocation_time = Statistics::analyze(dealloc_times);
+        }
+        metrics.alloc_iteration_time = Statistics::analyze(alloc_times);
+        metrics.dealloc_iteration_time = Statistics::analyze(dealloc_times);
+        metrics.throughput = Statistics::throughput(total_allocated, total_alloc_ns);
+        metrics.fragmentation = allocator.fragmentation_percentage();
+        metrics.alloc_counters = alloc_events.per_op(total_allocated);
+        metrics.dealloc_counters = dealloc_events.per_op(total_allocated);
+
+        return metrics;
+    }
+
+    // Splits object_count across thread_count threads sharing one allocator.
+    // Allocators that are not thread-safe are serialized behind a global mutex,
+    // which is the baseline a thread-safe allocator has to beat.
+    BenchmarkMetrics run_multithreaded_benchmark(BaseAllocator& allocator, const BenchmarkConfig& config) {
+        warm_up(allocator, config);
+        BenchmarkMetrics metrics;
+        metrics.allocator_name = allocator.name();
+
+        const size_t thread_count = std::max<size_t>(config.thread_count, 1);
+        metrics.thread_count = thread_count;
+
+        const bool needs_lock = !allocator.is_thread_safe();
+        std::mutex allocator_mutex;
+
+        std::vector<double> alloc_times;
+        std::vector<double> dealloc_times;
+        double total_alloc_wall_ns = 0;
+        size_t total_allocated = 0;
+        PerfCounters alloc_events;
+        PerfCounters dealloc_events;
+
+        for (size_t iter = 0; iter < config.iterations; ++iter) {
+            if (cancel_requested()) {
+                metrics.cancelled = true;
+                break;
+            }
+            allocator.reset();
+
+            std::vector<double> thread_alloc_ns(thread_count, 0);
+            std::vector<double> thread_dealloc_ns(thread_count, 0);
+            std::vector<size_t> thread_allocated(thread_count, 0);
+            std::vector<uint64_t> thread_alloc_done(thread_count, 0);
+            std::vector<LatencyHistogram> thread_alloc_latency(thread_count);
+            std::vector<LatencyHistogram> thread_dealloc_latency(thread_count);
+            std::vector<PerfCounters> thread_alloc_events(thread_count);
+            std::vector<PerfCounters> thread_dealloc_events(thread_count);
+            std::atomic<size_t> ready{0};
+            std::atomic<bool> go{false};
+
+            std::vector<std::thread> threads;
+            threads.reserve(thread_count);
+            for (size_t t = 0; t < thread_count; ++t) {
+                size_t share = config.object_count / thread_count +
+                    (t < config.object_count % thread_count ? 1 : 0);
+
+                threads.emplace_back([&, t, share]() {
+                    std::vector<void*> pointers;
+                    pointers.reserve(share);
+                    std::mt19937_64 rng(iter * thread_count + t);
+                    // Opened before the barrier, so the syscalls stay untimed
+                    PerfCounterGroup* counters = config.perf_counters ? &PerfCounterGroup::for_this_thread() : nullptr;
+
+                    ready.fetch_add(1);
+                    while (!go.load(std::memory_order_acquire)) {
+                        std::this_thread::yield();
+                    }
+
+                    // Serializes calls into allocators that are not thread-safe; with
+                    // per-op timing the lock wait is part of the measured latency
+                    auto call = [&](auto&& fn) {
+                        if (needs_lock) {
+                            std::lock_guard<std::mutex> lock(allocator_mutex);
+                            return fn();
+                        }
+                        return fn();
+                    };
+                    const bool timed = config.per_op_timing;
+                    LatencyHistogram& alloc_latency = thread_alloc_latency[t];
+                    LatencyHistogram& dealloc_latency = thread_dealloc_latency[t];
+
+                    Timer alloc_timer;
+                    if (counters) counters->start();
+                    alloc_timer.start();
+                    if (config.batch_size > 0) {
+                        // One lock acquisition per batch instead of per object
+                        for (size_t done = 0; done < share; done += config.batch_size) {
+                            size_t chunk = std::min(config.batch_size, share - done);
+                            size_t start = pointers.size();
+                            pointers.resize(start + chunk);
+                            uint64_t t0 = timed ? Timer::ticks_begin() : 0;
+                            size_t got = call([&] {
+                                return allocator.allocate_batch(config.object_size, config.alignment,
+                                                                pointers.data() + start, chunk);
+                            });
+                            if (timed && got) alloc_latency.record_n(Timer::sample_ns(t0, Timer::ticks_end()) / got, got);
+                            pointers.resize(start + got);
+                            if (got < chunk) break;
+                        }
+                    } else {
+                        for (size_t i = 0; i < share; ++i) {
+                            uint64_t t0 = timed ? Timer::ticks_begin() : 0;
+                            void* ptr = call([&] {
+                                return allocator.allocate(config.object_size, config.alignment);
+                            });
+                            if (!ptr) continue;
+                            if (timed) alloc_latency.record(Timer::sample_ns(t0, Timer::ticks_end()));
+                            pointers.push_back(ptr);
+                        }
+                    }
+                    alloc_timer.stop();
+                    thread_alloc_done[t] = Timer::ticks_end();
+                    if (counters) thread_alloc_events[t] = counters->stop();
+                    apply_free_order(pointers, config, rng);
+
+                    Timer dealloc_timer;
+                    if (counters) counters->start();
+                    dealloc_timer.start();
+                    if (config.batch_size > 0) {
+                        for_each_free_batch(pointers, config, [&](void** batch, size_t count) {
+                            uint64_t t0 = timed ? Timer::ticks_begin() : 0;
+                            call([&] { allocator.deallocate_batch(batch, count); });
+                            if (timed) dealloc_latency.record_n(Timer::sample_ns(t0, Timer::ticks_end()) / count, count);
+                        });
+                    } else {
+                        for (void* ptr : pointers) {
+                            uint64_t t0 = timed ? Timer::ticks_begin() : 0;
+                            call([&] { allocator.deallocate(ptr); });
+                            if (timed) dealloc_latency.record(Timer::sample_ns(t0, Timer::ticks_end()));
+                        }
+                    }
+                    dealloc_timer.stop();
+                    if (counters) thread_dealloc_events[t] = counters->stop();
+
+                    thread_alloc_ns[t] = alloc_timer.elapsed_ns();
+                    thread_dealloc_ns[t] = dealloc_timer.elapsed_ns();
+                    thread_allocated[t] = pointers.size();
+                });
+            }
+
+            // Start all threads together so spawn cost stays out of the samples
+            while (ready.load() < thread_count) {
+                std::this_thread::yield();
+            }
+            uint64_t release = Timer::ticks_begin();
+            go.store(true, std::memory_order_release);
+            for (auto& thread : threads) thread.join();
+
+            double alloc_per_op = 0;
+            double dealloc_per_op = 0;
+            size_t active_threads = 0;
+            for (size_t t = 0; t < thread_count; ++t) {
+                metrics.alloc_latency.merge(thread_alloc_latency[t]);
+                metrics.dealloc_latency.merge(thread_dealloc_latency[t]);
+                if (config.perf_counters) {
+                    alloc_events += thread_alloc_events[t];
+                    dealloc_events += thread_dealloc_events[t];
+                }
+                if (thread_allocated[t] == 0) continue;
+                alloc_per_op += thread_alloc_ns[t] / thread_allocated[t];
+                dealloc_per_op += thread_dealloc_ns[t] / thread_allocated[t];
+                total_allocated += thread_allocated[t];
+                active_threads++;
+            }
+            if (active_threads > 0) {
+                alloc_times.push_back(alloc_per_op / active_threads);
+                dealloc_times.push_back(dealloc_per_op / active_threads);
+            }
+            // Wall time of the allocation phase: release until the last thread is done
+            uint64_t last_done = release;
+            for (uint64_t ticks : thread_alloc_done) last_done = std::max(last_done, ticks);
+            total_alloc_wall_ns += Timer::ticks_to_ns(last_done - release);
+            metrics.failed_allocations += config.object_count -
+                std::accumulate(thread_allocated.begin(), thread_allocated.end(), size_t{0});
+
+            metrics.peak_memory = std::max(metrics.peak_memory,
+                static_cast<double>(allocator.stats().peak_bytes_used));
+            metrics.rejected_deallocations += allocator.stats().rejected_deallocations;
+
+            if (m_progress_callback) {
+                int percent = static_cast<int>((iter + 1) * 100 / config.iterations);
+                m_progress_callback(percent, "Running iteration " + std::to_string(iter + 1) +
+                    " (" + std::to_string(thread_count) + " threads)");
+            }
+        }
+
+        if (config.per_op_timing) {
+            metrics.allocation_time = metrics.alloc_latency.summarize();
+            metrics.deallocation_time = metrics.dealloc_latency.summarize();
+        } else {
+            metrics.allocation_time = Statistics::analyze(alloc_times);
+            metrics.deallocation_time = Statistics::analyze(dealloc_times);
+        }
+        metrics.alloc_iteration_time = Statistics::analyze(alloc_times);
+        metrics.dealloc_iteration_time = Statistics::analyze(dealloc_times);
+        // Aggregate throughput: all threads' allocations over the phase's wall time
+        metrics.throughput = Statistics::throughput(total_allocated, total_alloc_wall_ns);
         metrics.fragmentation = allocator.fragmentation_percentage();
+        metrics.alloc_counters = alloc_events.per_op(total_allocated);
+        metrics.dealloc_counters = dealloc_events.per_op(total_allocated);
 
         return metrics;
     }
 
+    // Generates a synthetic workload and replays it like a recorded trace
+    TraceReplayMetrics run_workload(BaseAllocator& allocator, const WorkloadConfig& workload,
+                                    const TraceReplayConfig& replay_config = {}) {
+        std::vector<TraceRecord> records = WorkloadGenerator::generate(workload);
+        TraceReplayer replayer;
+        replayer.set_progress_callback(m_progress_callback);
+        replayer.set_cancel_flag(m_cancel_flag);
+        return replayer.replay(allocator, records.data(), records.size(), replay_config);
+    }
+
+    // Runs the same config once per thread count, e.g. {1, 2, 4, 8, 16}
+    std::vector<BenchmarkMetrics> run_thread_scaling(BaseAllocator& allocator, const BenchmarkConfig& config,
+                                                     const std::vector<size_t>& thread_counts) {
+        std::vector<BenchmarkMetrics> results;
+        results.reserve(thread_counts.size());
+        for (size_t threads : thread_counts) {
+            BenchmarkConfig scaled = config;
+            scaled.thread_count = threads;
+            results.push_back(run_multithreaded_benchmark(allocator, scaled));
+        }
+        return results;
+    }
+
+    /**
+     * Runs every ContainerWorkload through std::allocator, AllocatorResource
+     * and StlAllocator over allocator. The allocator is reset before each
+     * iteration; requests it cannot serve go to new/delete and, for the pmr
+     * rows, are counted in fallback_allocations.
+     */
+    std::vector<ContainerMetrics> run_container_benchmark(BaseAllocator& allocator, const ContainerConfig& config) {
+        static const ContainerWorkload workloads[] = {
+            ContainerWorkload::VECTOR_GROWTH, ContainerWorkload::MAP_CHURN, ContainerWorkload::STRING_BUILD};
+        static const ContainerAdapter adapters[] = {
+            ContainerAdapter::STD_ALLOCATOR, ContainerAdapter::PMR_RESOURCE, ContainerAdapter::STL_ALLOCATOR};
+
+        std::vector<ContainerMetrics> results;
+        size_t step = 0;
+        for (ContainerWorkload workload : workloads) {
+            size_t baseline = results.size();
+            for (ContainerAdapter adapter : adapters) {
+                results.push_back(run_container(allocator, config, workload, adapter));
+                if (m_progress_callback) {
+                    int percent = static_cast<int>(++step * 100 / 9);
+                    m_progress_callback(percent, std::string("Container ") + container_workload_name(workload));
+                }
+            }
+            for (size_t i = baseline; i < results.size(); ++i) {
+                if (results[i].iteration_time.mean > 0) {
+                    results[i].speedup = results[baseline].iteration_time.mean / results[i].iteration_time.mean;
+                }
+            }
+        }
+        return results;
+    }
+
+    static const char* container_workload_name(ContainerWorkload workload) {
+        switch (workload) {
+            case ContainerWorkload::VECTOR_GROWTH: return "vector growth";
+            case ContainerWorkload::MAP_CHURN: return "map churn";
+            case ContainerWorkload::STRING_BUILD: return "string build";
+        }
+        return "unknown";
+    }
+
+    static const char* container_adapter_name(ContainerAdapter adapter) {
+        switch (adapter) {
+            case ContainerAdapter::STD_ALLOCATOR: return "std::allocator";
+            case ContainerAdapter::PMR_RESOURCE: return "pmr resource";
+            case ContainerAdapter::STL_ALLOCATOR: return "StlAllocator";
+        }
+        return "unknown";
+    }
+
 private:
     ProgressCallback m_progress_callback;
+    const std::atomic<bool>* m_cancel_flag = nullptr;
+
+    bool cancel_requested() const {
+        return m_cancel_flag && m_cancel_flag->load(std::memory_order_relaxed);
+    }
+
+    // Runs the config's warm-up iterations with nothing recorded or reported
+    void warm_up(BaseAllocator& allocator, const BenchmarkConfig& config) {
+        if (config.warmup_iterations == 0) return;
+        BenchmarkConfig warmup = config;
+        warmup.iterations = config.warmup_iterations;
+        warmup.warmup_iterations = 0;
+        warmup.per_op_timing = false;
+        warmup.perf_counters = false;
+
+        ProgressCallback progress;
+        std::swap(progress, m_progress_callback);
+        run_allocation_benchmark(allocator, warmup);
+        std::swap(progress, m_progress_callback);
+    }
+
+    template <typename Alloc, typename T>
+    using Rebind = typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+
+    static ContainerMetrics run_container(BaseAllocator& allocator, const ContainerConfig& config,
+                                          ContainerWorkload workload, ContainerAdapter adapter) {
+        ContainerMetrics metrics;
+        metrics.allocator_name = adapter == ContainerAdapter::STD_ALLOCATOR ? "new/delete" : allocator.name();
+        metrics.workload = workload;
+        metrics.adapter = adapter;
+
+        std::vector<double> times;
+        double total_ns = 0;
+        volatile size_t sink = 0;
+        for (size_t iter = 0; iter < config.iterations; ++iter) {
+            allocator.reset();
+            size_t rejected = allocator.stats().rejected_deallocations;
+            AllocatorResource resource(allocator);
+
+            Timer timer;
+            timer.start();
+            switch (adapter) {
+                case ContainerAdapter::STD_ALLOCATOR:
+                    sink = sink + container_workload(config, workload, std::allocator<char>());
+                    break;
+                case ContainerAdapter::PMR_RESOURCE:
+                    sink = sink + container_workload(config, workload, std::pmr::polymorphic_allocator<char>(&resource));
+                    break;
+                case ContainerAdapter::STL_ALLOCATOR:
+                    sink = sink + container_workload(config, workload, StlAllocator<char>(allocator));
+                    break;
+            }
+            timer.stop();
+
+            times.push_back(timer.elapsed_ns());
+            total_ns += timer.elapsed_ns();
+            metrics.fallback_allocations += resource.fallback_allocations();
+            metrics.rejected_deallocations += allocator.stats().rejected_deallocations - rejected;
+        }
+        allocator.reset();
+
+        metrics.iteration_time = Statistics::analyze(times);
+        metrics.throughput = Statistics::throughput(config.operations * config.iterations, total_ns);
+        return metrics;
+    }
+
+    // Returns a checksum so the containers' contents stay observable
+    template <typename Alloc>
+    static size_t container_workload(const ContainerConfig& config, ContainerWorkload workload, const Alloc& alloc) {
+        size_t checksum = 0;
+        switch (workload) {
+            case ContainerWorkload::VECTOR_GROWTH: {
+                using Vector = std::vector<uint64_t, Rebind<Alloc, uint64_t>>;
+                const size_t length = std::max<size_t>(config.vector_length, 1);
+                for (size_t done = 0; done < config.operations;) {
+                    Vector vector{Rebind<Alloc, uint64_t>(alloc)};
+                    for (size_t i = 0; i < length && done < config.operations; ++i, ++done) {
+                        vector.push_back(done);
+                    }
+                    checksum += vector.size();
+                }
+                break;
+            }
+            case ContainerWorkload::MAP_CHURN: {
+                using Value = std::pair<const uint64_t, uint64_t>;
+                using Map = std::map<uint64_t, uint64_t, std::less<uint64_t>, Rebind<Alloc, Value>>;
+                Map map{Rebind<Alloc, Value>(alloc)};
+                const uint64_t range = std::max<size_t>(config.key_range, 1);
+                uint64_t state = config.seed | 1;
+                for (size_t op = 0; op < config.operations; ++op) {
+                    state ^= state << 13;
+                    state ^= state >> 7;
+                    state ^= state << 17;
+                    uint64_t key = state % range;
+                    if (op & 1) {
+                        map.erase(key);
+                    } else {
+                        map.emplace(key, op);
+                    }
+                }
+                checksum += map.size();
+                break;
+            }
+            case ContainerWorkload::STRING_BUILD: {
+                using String = std::basic_string<char, std::char_traits<char>, Rebind<Alloc, char>>;
+                using Strings = std::vector<String, Rebind<Alloc, String>>;
+                const size_t live = std::max<size_t>(config.live_strings, 1);
+                Strings strings{Rebind<Alloc, String>(alloc)};
+                strings.reserve(live);
+                for (size_t i = 0; i < live; ++i) strings.emplace_back(String(Rebind<Alloc, char>(alloc)));
+
+                size_t slot = 0;
+                String current{Rebind<Alloc, char>(alloc)};
+                for (size_t op = 0; op < config.operations; ++op) {
+                    current.append("01234567", 8);
+                    if (current.size() >= config.string_length) {
+                        checksum += current.size();
+                        strings[slot] = std::move(current);
+                        slot = (slot + 1) % live;
+                        current = String(Rebind<Alloc, char>(alloc));
+                    }
+                }
+                break;
+            }
+        }
+        return checksum;
+    }
+
+    // Reorders pointers for the deallocation phase (outside the timed region)
+    static FreeOrder free_order(const BenchmarkConfig& config) {
+        return config.randomize_order ? FreeOrder::RANDOM : config.free_order;
+    }
+
+    static void apply_free_order(std::vector<void*>& pointers, const BenchmarkConfig& config,
+                                 std::mt19937_64& rng) {
+        FreeOrder order = free_order(config);
+        if (order == FreeOrder::LIFO && config.batch_size == 0) {
+            std::reverse(pointers.begin(), pointers.end());
+        } else if (order == FreeOrder::RANDOM) {
+            std::shuffle(pointers.begin(), pointers.end(), rng);
+        }
+    }
+
+    // Per-op timed allocation; a batch records its mean cost once per block
+    static void allocate_timed(BaseAllocator& allocator, const BenchmarkConfig& config, size_t count,
+                               std::vector<void*>& pointers, LatencyHistogram& histogram) {
+        if (config.batch_size > 0) {
+            size_t start = pointers.size();
+            pointers.resize(start + count);
+            size_t allocated = 0;
+            while (allocated < count) {
+                size_t chunk = std::min(config.batch_size, count - allocated);
+                uint64_t t0 = Timer::ticks_begin();
+                size_t got = allocator.allocate_batch(config.object_size, config.alignment,
+                                                      pointers.data() + start + allocated, chunk);
+                uint64_t t1 = Timer::ticks_end();
+                if (got) histogram.record_n(Timer::sample_ns(t0, t1) / got, got);
+                allocated += got;
+                if (got < chunk) break;
+            }
+            pointers.resize(start + allocated);
+            return;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t t0 = Timer::ticks_begin();
+            void* ptr = allocator.allocate(config.object_size, config.alignment);
+            uint64_t t1 = Timer::ticks_end();
+            if (ptr) {
+                histogram.record(Timer::sample_ns(t0, t1));
+                pointers.push_back(ptr);
+            }
+        }
+    }
+
+    static void deallocate_timed(BaseAllocator& allocator, const BenchmarkConfig& config,
+                                 std::vector<void*>& pointers, LatencyHistogram& histogram) {
+        if (config.batch_size > 0) {
+            for_each_free_batch(pointers, config, [&](void** batch, size_t count) {
+                uint64_t t0 = Timer::ticks_begin();
+                allocator.deallocate_batch(batch, count);
+                uint64_t t1 = Timer::ticks_end();
+                histogram.record_n(Timer::sample_ns(t0, t1) / count, count);
+            });
+            return;
+        }
+
+        for (void* ptr : pointers) {
+            uint64_t t0 = Timer::ticks_begin();
+            allocator.deallocate(ptr);
+            uint64_t t1 = Timer::ticks_end();
+            histogram.record(Timer::sample_ns(t0, t1));
+        }
+    }
+
+    // Appends up to count objects to pointers, batch_size per allocate_batch call
+    static size_t allocate_batched(BaseAllocator& allocator, const BenchmarkConfig& config,
+                                   size_t count, std::vector<void*>& pointers) {
+        size_t start = pointers.size();
+        pointers.resize(start + count);
+        size_t allocated = 0;
+        while (allocated < count) {
+            size_t chunk = std::min(config.batch_size, count - allocated);
+            size_t got = allocator.allocate_batch(config.object_size, config.alignment,
+                                                  pointers.data() + start + allocated, chunk);
+            allocated += got;
+            if (got < chunk) break;
+        }
+        pointers.resize(start + allocated);
+        return allocated;
+    }
+
+    // Hands pointers out batch_size at a time. Batches keep allocation order
+    // internally, so LIFO walks the batches back to front (see apply_free_order).
+    template <typename Fn>
+    static void for_each_free_batch(std::vector<void*>& pointers, const BenchmarkConfig& config, Fn&& fn) {
+        size_t count = pointers.size();
+        size_t batches = (count + config.batch_size - 1) / config.batch_size;
+        bool backwards = free_order(config) == FreeOrder::LIFO;
+        for (size_t b = 0; b < batches; ++b) {
+            size_t index = backwards ? batches - 1 - b : b;
+            size_t start = index * config.batch_size;
+            fn(pointers.data() + start, std::min(config.batch_size, count - start));
+        }
+    }
+
+    static void deallocate_batched(BaseAllocator& allocator, const BenchmarkConfig& config,
+                                   std::vector<void*>& pointers) {
+        for_each_free_batch(pointers, config, [&](void** batch, size_t count) {
+            allocator.deallocate_batch(batch, count);
+        });
+    }
 };
 
 } // namespace memory_engine
@@ -6,22 +6,85 @@
 #ifndef CONCURRENCY_BENCHMARK_HPP
 #define CONCURRENCY_BENCHMARK_HPP
 
+#include "../concurrency/concurrent_queue.hpp"
+#include "../concurrency/locks.hpp"
+#include "../concurrency/thread_pool.hpp"
+#include "../utils/histogram.hpp"
+#include "../utils/perf_counters.hpp"
 #include "../utils/timer.hpp"
 #include "../utils/statistics.hpp"
+#include <algorithm>
 #include <atomic>
 #include <mutex>
 #include <thread>
 #include <vector>
 #include <functional>
+#include <memory>
 #include <condition_variable>
 #include <queue>
+#include <shared_mutex>
+#include <string>
+#include <type_traits>
 
 namespace memory_engine {
 
+enum class QueueKind {
+    MUTEX,         ///< std::queue behind a mutex and condition variable
+    MPMC_RING,     ///< BoundedMPMCQueue
+    SPSC_RING,     ///< SPSCQueue (always one producer and one consumer)
+    SEGMENTED      ///< SegmentedQueue
+};
+
+enum class LockKind {
+    STD_MUTEX,
+    TTAS_SPIN,     ///< TTASSpinLock
+    TICKET,        ///< TicketLock
+    MCS,           ///< MCSLock
+    FUTEX,         ///< FutexLock
+    SHARED_MUTEX   ///< std::shared_mutex; read_ratio of the sections take it shared
+};
+
+enum class CounterLayout {
+    SHARED,     ///< One atomic counter hit by every thread
+    ADJACENT,   ///< One counter per thread, packed together (false sharing)
+    PADDED,     ///< One counter per thread, each on its own cache line
+    STRIPED     ///< counter_stripes padded counters; threads share stripes, reads sum them
+};
+
+enum class CounterOrder {
+    RELAXED,
+    ACQ_REL,    ///< acq_rel RMW; release store / acquire load for single_writer
+    SEQ_CST
+};
+
 struct ConcurrencyConfig {
     size_t thread_count = 4;
     size_t iterations = 1000;
     size_t work_size = 100;
+    bool pin_threads = false;                 ///< Pin pool worker i to CPU i
+    bool perf_counters = false;               ///< Count hardware events on every worker (Linux)
+
+    // Lock contention only
+    LockKind lock = LockKind::STD_MUTEX;
+    double read_ratio = 0.0;                  ///< Share of sections that only read (shared for SHARED_MUTEX)
+    size_t lock_sample_interval = 8;          ///< Time every Nth acquisition (1 = all)
+
+    // Producer-consumer only
+    QueueKind queue = QueueKind::MUTEX;
+    size_t producers = 0;                     ///< 0 = thread_count / 2 (at least 1)
+    size_t consumers = 0;                     ///< 0 = thread_count / 2 (at least 1)
+    size_t queue_capacity = 1024;             ///< Ring capacity, or slots per segment
+    BaseAllocator* queue_allocator = nullptr; ///< Queue storage; nullptr = operator new
+
+    // Counter contention only; each thread performs `iterations` increments
+    CounterLayout counter_layout = CounterLayout::SHARED;
+    CounterOrder counter_order = CounterOrder::RELAXED;
+    size_t counter_stripes = 0;               ///< STRIPED: 0 = thread_count / 2 (at least 1)
+    bool single_writer = false;               ///< ADJACENT/PADDED: load+store instead of fetch_add
+
+    // Cross-thread free only; thread_count / 2 producer-consumer pairs
+    BaseAllocator* allocator = nullptr;       ///< Allocator under test (required)
+    size_t object_size = 64;
 };
 
 struct ConcurrencyMetrics {
@@ -30,162 +93,414 @@ struct ConcurrencyMetrics {
     double throughput = 0;
     double thread_efficiency = 0;
     std::string test_name;
+    size_t thread_count = 0;          ///< Threads that actually ran (after any clamp)
+    size_t items = 0;                 ///< Producer-consumer: items handed over; counters: final total
+    double combine_time_ns = 0;       ///< Counters: time to sum all counter slots once
+    LatencyHistogram start_latency;   ///< Thread creation / task scheduling: request to task start
+    LatencyHistogram acquire_latency; ///< Lock contention: sampled lock() call to acquisition
+    LatencyHistogram handoff_latency; ///< Producer-consumer: push start to pop, per item
+    LatencyHistogram free_latency;    ///< Cross-thread free: each deallocate() on the consumer
+    PerfCounters counters;            ///< Per operation, summed over workers (pool-based tests only)
 };
 
+// Timed tests run on a persistent ThreadPool: workers are released from a
+// start barrier together, so thread creation stays out of the numbers
+// (except in run_thread_creation, which measures exactly that).
 class ConcurrencyBenchmark {
 public:
-    // Mutex contention test
-    ConcurrencyMetrics run_mutex_contention(const ConcurrencyConfig& config) {
-        ConcurrencyMetrics metrics;
-        metrics.test_name = "Mutex Contention";
-
-        std::mutex mtx;
-        std::atomic<size_t> counter{0};
-        std::atomic<double> wait_time{0};
-
-        Timer total_timer;
-        total_timer.start();
+    // Uses pool if set (Engine shares its own); otherwise a private pool on first use
+    void set_thread_pool(ThreadPool* pool) { m_pool = pool; }
 
-        std::vector<std::thread> threads;
-        for (size_t t = 0; t < config.thread_count; ++t) {
-            threads.emplace_back([&]() {
-                for (size_t i = 0; i < config.iterations; ++i) {
-                    Timer wait_timer;
-                    wait_timer.start();
-                    
-                    std::lock_guard<std::mutex> lock(mtx);
-                    
-                    wait_timer.stop();
-                    wait_time.fetch_add(wait_timer.elapsed_ns());
-
-                    // Simulate work
-                    volatile size_t work = 0;
-                    for (size_t w = 0; w < config.work_size; ++w) {
-                        work += w;
-                    }
-                    counter++;
-                }
-            });
+    ThreadPool& thread_pool() {
+        if (!m_pool) {
+            m_owned_pool = std::make_unique<ThreadPool>();
+            m_pool = m_owned_pool.get();
         }
+        return *m_pool;
+    }
 
-        for (auto& t : threads) t.join();
+    // Lock contention test: thread_count workers each enter a critical
+    // section of work_size units `iterations` times, using config.lock
+    ConcurrencyMetrics run_mutex_contention(const ConcurrencyConfig& config) {
+        switch (config.lock) {
+            case LockKind::STD_MUTEX: {
+                std::mutex lock;
+                return run_lock(lock, config);
+            }
+            case LockKind::TTAS_SPIN: {
+                TTASSpinLock lock;
+                return run_lock(lock, config);
+            }
+            case LockKind::TICKET: {
+                TicketLock lock;
+                return run_lock(lock, config);
+            }
+            case LockKind::MCS: {
+                MCSLock lock;
+                return run_lock(lock, config);
+            }
+            case LockKind::FUTEX: {
+                FutexLock lock;
+                return run_lock(lock, config);
+            }
+            case LockKind::SHARED_MUTEX: {
+                std::shared_mutex lock;
+                return run_lock(lock, config);
+            }
+        }
+        return {};
+    }
 
-        total_timer.stop();
-        metrics.total_time_ms = total_timer.elapsed_ms();
-        metrics.contention_time_ms = wait_time.load() / 1000000.0;
-        metrics.throughput = Statistics::throughput(counter.load(), total_timer.elapsed_ns());
-        metrics.thread_efficiency = (config.iterations * config.thread_count) / 
-            (metrics.total_time_ms * config.thread_count);
+    // Every lock at 1, 2, 4, ... threads up to config.thread_count
+    std::vector<ConcurrencyMetrics> run_lock_sweep(const ConcurrencyConfig& config) {
+        std::vector<size_t> thread_counts;
+        for (size_t n = 1; n < config.thread_count; n *= 2) thread_counts.push_back(n);
+        thread_counts.push_back(std::max<size_t>(config.thread_count, 1));
+
+        std::vector<ConcurrencyMetrics> results;
+        ConcurrencyConfig sweep = config;
+        for (auto kind : {LockKind::STD_MUTEX, LockKind::TTAS_SPIN, LockKind::TICKET,
+                          LockKind::MCS, LockKind::FUTEX, LockKind::SHARED_MUTEX}) {
+            sweep.lock = kind;
+            for (size_t threads : thread_counts) {
+                sweep.thread_count = threads;
+                results.push_back(run_mutex_contention(sweep));
+            }
+        }
+        return results;
+    }
 
-        return metrics;
+    static const char* lock_name(LockKind kind) {
+        switch (kind) {
+            case LockKind::STD_MUTEX: return "std::mutex";
+            case LockKind::TTAS_SPIN: return "TTAS spin";
+            case LockKind::TICKET: return "ticket";
+            case LockKind::MCS: return "MCS";
+            case LockKind::FUTEX: return "futex";
+            case LockKind::SHARED_MUTEX: return "shared_mutex";
+        }
+        return "unknown";
     }
 
     // Atomic operations test
     ConcurrencyMetrics run_atomic_performance(const ConcurrencyConfig& config) {
         ConcurrencyMetrics metrics;
         metrics.test_name = "Atomic Performance";
+        metrics.thread_count = std::min(config.thread_count, ThreadPool::MAX_WORKERS);
 
         std::atomic<size_t> counter{0};
 
-        Timer total_timer;
-        total_timer.start();
-
-        std::vector<std::thread> threads;
-        for (size_t t = 0; t < config.thread_count; ++t) {
-            threads.emplace_back([&]() {
-                for (size_t i = 0; i < config.iterations; ++i) {
-                    counter.fetch_add(1, std::memory_order_relaxed);
-                    
-                    // Simulate additional atomic ops
-                    for (size_t w = 0; w < config.work_size / 10; ++w) {
-                        counter.fetch_add(1, std::memory_order_seq_cst);
-                    }
+        PerfCounters events;
+        double elapsed_ns = run_measured(config, config.thread_count, events, [&](size_t) {
+            for (size_t i = 0; i < config.iterations; ++i) {
+                counter.fetch_add(1, std::memory_order_relaxed);
+                
+                // Simulate additional atomic ops
+                for (size_t w = 0; w < config.work_size / 10; ++w) {
+                    counter.fetch_add(1, std::memory_order_seq_cst);
                 }
-            });
-        }
-
-        for (auto& t : threads) t.join();
+            }
+        });
 
-        total_timer.stop();
-        metrics.total_time_ms = total_timer.elapsed_ms();
+        metrics.total_time_ms = elapsed_ns / 1000000.0;
         metrics.contention_time_ms = 0;
-        metrics.throughput = Statistics::throughput(counter.load(), total_timer.elapsed_ns());
+        metrics.throughput = Statistics::throughput(counter.load(), elapsed_ns);
+        metrics.counters = events.per_op(counter.load());
 
         return metrics;
     }
 
-    // Producer-Consumer test
+    // Producer-Consumer test: every producer pushes config.iterations items;
+    // each item carries its push timestamp so consumers can record the handoff
     ConcurrencyMetrics run_producer_consumer(const ConcurrencyConfig& config) {
+        size_t producers = config.producers ? config.producers : std::max<size_t>(config.thread_count / 2, 1);
+        size_t consumers = config.consumers ? config.consumers : std::max<size_t>(config.thread_count / 2, 1);
+        if (config.queue == QueueKind::SPSC_RING) producers = consumers = 1;
+
+        // run_parallel drops workers past MAX_WORKERS, and consumers would
+        // then wait forever for producers that never ran; keep both sides
+        const size_t requested_producers = producers;
+        const size_t requested_consumers = consumers;
+        const bool clamped = producers + consumers > ThreadPool::MAX_WORKERS;
+        if (clamped) {
+            consumers = std::max<size_t>(consumers * ThreadPool::MAX_WORKERS / (producers + consumers), 1);
+            producers = ThreadPool::MAX_WORKERS - consumers;
+        }
+
         ConcurrencyMetrics metrics;
-        metrics.test_name = "Producer-Consumer";
+        switch (config.queue) {
+            case QueueKind::MUTEX: {
+                MutexQueue queue;
+                metrics = run_handoff(queue, producers, consumers, config);
+                break;
+            }
+            case QueueKind::MPMC_RING: {
+                BoundedMPMCQueue<HandoffItem> queue(config.queue_capacity, config.queue_allocator);
+                metrics = run_handoff(queue, producers, consumers, config);
+                break;
+            }
+            case QueueKind::SPSC_RING: {
+                SPSCQueue<HandoffItem> queue(config.queue_capacity, config.queue_allocator);
+                metrics = run_handoff(queue, producers, consumers, config);
+                break;
+            }
+            case QueueKind::SEGMENTED: {
+                SegmentedQueue<HandoffItem> queue(config.queue_capacity, config.queue_allocator);
+                metrics = run_handoff(queue, producers, consumers, config);
+                break;
+            }
+        }
+        metrics.test_name = std::string("Producer-Consumer (") + queue_name(config.queue) + ", " +
+            std::to_string(producers) + "P/" + std::to_string(consumers) + "C";
+        metrics.thread_count = producers + consumers;
+        if (clamped) {
+            metrics.test_name += ", clamped from " + std::to_string(requested_producers) + "P/" +
+                std::to_string(requested_consumers) + "C";
+        }
+        metrics.test_name += ")";
+        return metrics;
+    }
 
-        std::queue<int> queue;
-        std::mutex queue_mutex;
-        std::condition_variable cv;
-        std::atomic<bool> done{false};
-        std::atomic<size_t> items_processed{0};
+    // Counter layout test: how the placement of per-thread counters and the
+    // memory order of the increment affect scaling
+    ConcurrencyMetrics run_counter_contention(const ConcurrencyConfig& config) {
+        switch (config.counter_order) {
+            case CounterOrder::RELAXED:
+                return run_counter_layout<std::memory_order_relaxed>(config);
+            case CounterOrder::ACQ_REL:
+                return run_counter_layout<std::memory_order_acq_rel>(config);
+            case CounterOrder::SEQ_CST:
+                return run_counter_layout<std::memory_order_seq_cst>(config);
+        }
+        return {};
+    }
 
-        Timer total_timer;
-        total_timer.start();
+    // Every layout under every memory order (single_writer variants included)
+    std::vector<ConcurrencyMetrics> run_counter_sweep(const ConcurrencyConfig& config) {
+        std::vector<ConcurrencyMetrics> results;
+        ConcurrencyConfig sweep = config;
+        for (auto order : {CounterOrder::RELAXED, CounterOrder::ACQ_REL, CounterOrder::SEQ_CST}) {
+            sweep.counter_order = order;
+            for (auto layout : {CounterLayout::SHARED, CounterLayout::ADJACENT,
+                                CounterLayout::PADDED, CounterLayout::STRIPED}) {
+                sweep.counter_layout = layout;
+                sweep.single_writer = false;
+                results.push_back(run_counter_contention(sweep));
+                if (layout == CounterLayout::ADJACENT || layout == CounterLayout::PADDED) {
+                    sweep.single_writer = true;
+                    results.push_back(run_counter_contention(sweep));
+                }
+            }
+        }
+        return results;
+    }
 
-        // Producers
-        std::vector<std::thread> producers;
-        for (size_t t = 0; t < config.thread_count / 2; ++t) {
-            producers.emplace_back([&]() {
-                for (size_t i = 0; i < config.iterations; ++i) {
-                    std::lock_guard<std::mutex> lock(queue_mutex);
-                    queue.push(static_cast<int>(i));
-                    cv.notify_one();
+    static const char* counter_layout_name(CounterLayout layout) {
+        switch (layout) {
+            case CounterLayout::SHARED: return "shared";
+            case CounterLayout::ADJACENT: return "adjacent";
+            case CounterLayout::PADDED: return "padded";
+            case CounterLayout::STRIPED: return "striped";
+        }
+        return "unknown";
+    }
+
+    static const char* counter_order_name(CounterOrder order) {
+        switch (order) {
+            case CounterOrder::RELAXED: return "relaxed";
+            case CounterOrder::ACQ_REL: return "acq_rel";
+            case CounterOrder::SEQ_CST: return "seq_cst";
+        }
+        return "unknown";
+    }
+
+    // Cross-thread free test: each pair's producer allocates object_size
+    // bytes from config.allocator and hands the block through an SPSC ring
+    // to its consumer, which frees it. Every free is remote, the pattern a
+    // per-thread arena must route back to its owner. Allocators that are not
+    // thread-safe are serialized behind one mutex, as in allocator scaling.
+    ConcurrencyMetrics run_cross_thread_free(const ConcurrencyConfig& config) {
+        // run_parallel drops workers past MAX_WORKERS, and a consumer whose
+        // producer never ran would wait forever; keep whole pairs
+        const size_t requested_pairs = std::max<size_t>(config.thread_count / 2, 1);
+        const size_t pairs = std::min(requested_pairs, ThreadPool::MAX_WORKERS / 2);
+        BaseAllocator* allocator = config.allocator;
+
+        ConcurrencyMetrics metrics;
+        metrics.test_name = std::string("Cross-Thread Free (") + (allocator ? allocator->name() : "no allocator") +
+            ", " + std::to_string(pairs) + (pairs == 1 ? " pair" : " pairs");
+        if (pairs < requested_pairs) {
+            metrics.test_name += ", clamped from " + std::to_string(requested_pairs);
+        }
+        metrics.test_name += ")";
+        metrics.thread_count = 2 * pairs;
+        if (!allocator) return metrics;
+
+        const bool needs_lock = !allocator->is_thread_safe();
+        std::mutex allocator_mutex;
+        auto call = [&](auto&& fn) {
+            if (needs_lock) {
+                std::lock_guard<std::mutex> lock(allocator_mutex);
+                return fn();
+            }
+            return fn();
+        };
+
+        allocator->reset();
+        std::vector<std::unique_ptr<SPSCQueue<void*>>> rings;
+        for (size_t p = 0; p < pairs; ++p) rings.push_back(std::make_unique<SPSCQueue<void*>>(config.queue_capacity));
+        std::unique_ptr<std::atomic<bool>[]> produced(new std::atomic<bool>[pairs]);
+        for (size_t p = 0; p < pairs; ++p) produced[p].store(false, std::memory_order_relaxed);
+        std::vector<LatencyHistogram> latencies(pairs);
+        std::vector<size_t> freed(pairs, 0);
+        std::vector<size_t> failed(pairs, 0);
+
+        auto consume = [&](size_t c) {
+            SPSCQueue<void*>& ring = *rings[c];
+            LatencyHistogram& latency = latencies[c];
+            void* ptr = nullptr;
+            size_t count = 0;
+            auto release = [&] {
+                uint64_t t0 = Timer::ticks_begin();
+                call([&] { allocator->deallocate(ptr); });
+                latency.record(Timer::sample_ns(t0, Timer::ticks_end()));
+                count++;
+            };
+            unsigned spins = 0;
+            for (;;) {
+                if (ring.try_pop(ptr)) {
+                    release();
+                    spins = 0;
+                } else if (produced[c].load(std::memory_order_acquire)) {
+                    // The producer is done, so a failed pop now means empty
+                    if (!ring.try_pop(ptr)) break;
+                    release();
+                } else {
+                    backoff(spins);
                 }
-            });
-        }
-
-        // Consumers
-        std::vector<std::thread> consumers;
-        for (size_t t = 0; t < config.thread_count / 2; ++t) {
-            consumers.emplace_back([&]() {
-                while (!done.load() || !queue.empty()) {
-                    std::unique_lock<std::mutex> lock(queue_mutex);
-                    if (cv.wait_for(lock, std::chrono::milliseconds(1), 
-                        [&]() { return !queue.empty() || done.load(); })) {
-                        if (!queue.empty()) {
-                            queue.pop();
-                            items_processed++;
-                        }
-                    }
+            }
+            freed[c] = count;
+        };
+
+        auto produce = [&](size_t p) {
+            SPSCQueue<void*>& ring = *rings[p];
+            for (size_t i = 0; i < config.iterations; ++i) {
+                void* ptr = call([&] { return allocator->allocate(config.object_size); });
+                if (!ptr) {
+                    failed[p]++;
+                    continue;
                 }
-            });
+                *static_cast<volatile uint8_t*>(ptr) = static_cast<uint8_t>(i);
+                for (unsigned spins = 0; !ring.try_push(ptr);) backoff(spins);
+            }
+            produced[p].store(true, std::memory_order_release);
+        };
+
+        // Workers [0, pairs) consume, the rest produce
+        PerfCounters events;
+        double elapsed_ns = run_measured(config, 2 * pairs, events, [&](size_t index) {
+            if (index < pairs) {
+                consume(index);
+            } else {
+                produce(index - pairs);
+            }
+        });
+
+        size_t total_failed = 0;
+        for (size_t p = 0; p < pairs; ++p) {
+            metrics.free_latency.merge(latencies[p]);
+            metrics.items += freed[p];
+            total_failed += failed[p];
         }
+        if (total_failed) metrics.test_name += " " + std::to_string(total_failed) + " FAILED";
 
-        for (auto& t : producers) t.join();
-        done.store(true);
-        cv.notify_all();
-        for (auto& t : consumers) t.join();
+        metrics.total_time_ms = elapsed_ns / 1000000.0;
+        metrics.throughput = Statistics::throughput(metrics.items, elapsed_ns);
+        metrics.counters = events.per_op(metrics.items);
+        metrics.thread_efficiency = metrics.throughput / pairs;
+        return metrics;
+    }
 
-        total_timer.stop();
-        metrics.total_time_ms = total_timer.elapsed_ms();
-        metrics.throughput = Statistics::throughput(items_processed.load(), total_timer.elapsed_ns());
+    // run_cross_thread_free at 1, 2, 4, ... pairs up to thread_count / 2
+    std::vector<ConcurrencyMetrics> run_cross_thread_sweep(const ConcurrencyConfig& config) {
+        const size_t max_pairs = std::max<size_t>(config.thread_count / 2, 1);
+        std::vector<ConcurrencyMetrics> results;
+        ConcurrencyConfig sweep = config;
+        for (size_t pairs = 1;; pairs *= 2) {
+            pairs = std::min(pairs, max_pairs);
+            sweep.thread_count = 2 * pairs;
+            results.push_back(run_cross_thread_free(sweep));
+            if (pairs == max_pairs) break;
+        }
+        return results;
+    }
 
-        return metrics;
+    static const char* queue_name(QueueKind kind) {
+        switch (kind) {
+            case QueueKind::MUTEX: return "mutex queue";
+            case QueueKind::MPMC_RING: return "MPMC ring";
+            case QueueKind::SPSC_RING: return "SPSC ring";
+            case QueueKind::SEGMENTED: return "segmented";
+        }
+        return "unknown";
     }
 
     // Thread creation overhead test
     ConcurrencyMetrics run_thread_creation(const ConcurrencyConfig& config) {
         ConcurrencyMetrics metrics;
         metrics.test_name = "Thread Creation";
+        metrics.thread_count = config.thread_count;
 
         Timer total_timer;
         total_timer.start();
 
+        std::vector<uint64_t> start_ns(config.thread_count);
         for (size_t i = 0; i < config.iterations; ++i) {
             std::vector<std::thread> threads;
             for (size_t t = 0; t < config.thread_count; ++t) {
-                threads.emplace_back([]() {
+                uint64_t requested = Timer::ticks_begin();
+                threads.emplace_back([&start_ns, t, requested]() {
+                    start_ns[t] = Timer::sample_ns(requested, Timer::ticks_end());
                     volatile int x = 0;
                     for (int i = 0; i < 100; ++i) x += i;
                 });
             }
             for (auto& t : threads) t.join();
+            for (uint64_t ns : start_ns) metrics.start_latency.record(ns);
+        }
+
+        total_timer.stop();
+        metrics.total_time_ms = total_timer.elapsed_ms();
+        metrics.throughput = (config.iterations * config.thread_count) / (metrics.total_time_ms / 1000.0);
+
+        return metrics;
+    }
+
+    // Same rounds of thread_count tiny tasks as run_thread_creation, but
+    // dispatched to the pool; the difference is the cost of spawning threads
+    ConcurrencyMetrics run_task_scheduling(const ConcurrencyConfig& config) {
+        ConcurrencyMetrics metrics;
+        metrics.test_name = "Task Scheduling";
+        metrics.thread_count = config.thread_count;
+
+        ThreadPool& pool = workers(config);
+        pool.ensure_workers(config.thread_count);
+
+        Timer total_timer;
+        total_timer.start();
+
+        std::vector<uint64_t> start_ns(config.thread_count);
+        for (size_t i = 0; i < config.iterations; ++i) {
+            for (size_t t = 0; t < config.thread_count; ++t) {
+                uint64_t requested = Timer::ticks_begin();
+                pool.submit([&start_ns, t, requested]() {
+                    start_ns[t] = Timer::sample_ns(requested, Timer::ticks_end());
+                    volatile int x = 0;
+                    for (int i = 0; i < 100; ++i) x += i;
+                });
+            }
+            pool.wait_idle();
+            for (uint64_t ns : start_ns) metrics.start_latency.record(ns);
         }
 
         total_timer.stop();
@@ -194,6 +509,308 @@ public:
 
         return metrics;
     }
+
+private:
+    ThreadPool* m_pool = nullptr;
+    std::unique_ptr<ThreadPool> m_owned_pool;
+
+    ThreadPool& workers(const ConcurrencyConfig& config) {
+        ThreadPool& pool = thread_pool();
+        pool.set_pinning(config.pin_threads);
+        return pool;
+    }
+
+    // run_parallel, plus every worker's hardware counters summed into events
+    // when config.perf_counters is set. An untimed pass opens the workers'
+    // counter groups first so the timed run only pays for two reads each.
+    template <typename Fn>
+    double run_measured(const ConcurrencyConfig& config, size_t count, PerfCounters& events, Fn&& fn) {
+        ThreadPool& pool = workers(config);
+        if (!config.perf_counters) return pool.run_parallel(count, fn);
+
+        pool.run_parallel(count, [](size_t) { PerfCounterGroup::for_this_thread(); });
+        std::vector<PerfCounters> per_worker(count);
+        double elapsed_ns = pool.run_parallel(count, [&](size_t index) {
+            PerfCounterGroup& group = PerfCounterGroup::for_this_thread();
+            group.start();
+            fn(index);
+            per_worker[index] = group.stop();
+        });
+        for (const auto& worker : per_worker) events += worker;
+        return elapsed_ns;
+    }
+
+    template <typename Lock>
+    ConcurrencyMetrics run_lock(Lock& lock, const ConcurrencyConfig& config) {
+        constexpr bool SHARED = std::is_same<Lock, std::shared_mutex>::value;
+        // run_parallel runs at most MAX_WORKERS threads; count only those
+        const size_t thread_count = std::min(std::max<size_t>(config.thread_count, 1), ThreadPool::MAX_WORKERS);
+        const size_t interval = std::max<size_t>(config.lock_sample_interval, 1);
+        const uint32_t read_threshold = static_cast<uint32_t>(
+            std::min(std::max(config.read_ratio, 0.0), 1.0) * 4294967295.0);
+
+        std::vector<LatencyHistogram> latencies(thread_count);
+        std::vector<size_t> writes(thread_count, 0);
+        size_t protected_value = 0; // Only written under the exclusive lock
+
+        PerfCounters events;
+        double elapsed_ns = run_measured(config, thread_count, events, [&](size_t t) {
+            LatencyHistogram& latency = latencies[t];
+            size_t my_writes = 0;
+            size_t countdown = t % interval; // Stagger samples across threads
+            uint32_t rng = static_cast<uint32_t>(t) * 2654435761u + 1;
+
+            for (size_t i = 0; i < config.iterations; ++i) {
+                rng ^= rng << 13;
+                rng ^= rng >> 17;
+                rng ^= rng << 5;
+                const bool read = rng < read_threshold;
+                const bool sampled = ++countdown >= interval;
+                if (sampled) countdown = 0;
+
+                uint64_t t0 = sampled ? Timer::ticks_begin() : 0;
+                if constexpr (SHARED) {
+                    if (read) {
+                        lock.lock_shared();
+                    } else {
+                        lock.lock();
+                    }
+                } else {
+                    lock.lock();
+                }
+                if (sampled) latency.record(Timer::sample_ns(t0, Timer::ticks_end()));
+
+                volatile size_t work = read ? protected_value : 0;
+                for (size_t w = 0; w < config.work_size; ++w) work += w;
+                if (!read) {
+                    protected_value++;
+                    my_writes++;
+                }
+
+                if constexpr (SHARED) {
+                    if (read) {
+                        lock.unlock_shared();
+                    } else {
+                        lock.unlock();
+                    }
+                } else {
+                    lock.unlock();
+                }
+            }
+            writes[t] = my_writes;
+        });
+
+        ConcurrencyMetrics metrics;
+        size_t total_writes = 0;
+        for (size_t t = 0; t < thread_count; ++t) {
+            metrics.acquire_latency.merge(latencies[t]);
+            total_writes += writes[t];
+        }
+        metrics.thread_count = thread_count;
+        metrics.items = thread_count * config.iterations;
+        metrics.test_name = std::string("Lock Contention (") + lock_name(config.lock) + ", " +
+            std::to_string(thread_count) + (thread_count == 1 ? " thread" : " threads");
+        if (thread_count < config.thread_count) {
+            metrics.test_name += ", clamped from " + std::to_string(config.thread_count);
+        }
+        metrics.test_name += ")";
+        if (protected_value != total_writes) metrics.test_name += " LOST UPDATES";
+
+        metrics.total_time_ms = elapsed_ns / 1000000.0;
+        // Sampled waits scaled back up to every acquisition
+        metrics.contention_time_ms = metrics.acquire_latency.mean() * metrics.items / 1000000.0;
+        metrics.throughput = Statistics::throughput(metrics.items, elapsed_ns);
+        metrics.counters = events.per_op(metrics.items);
+        metrics.thread_efficiency = (config.iterations * thread_count) /
+            (metrics.total_time_ms * thread_count);
+        return metrics;
+    }
+
+    struct HandoffItem {
+        uint64_t sequence;
+        uint64_t push_ticks;
+    };
+
+    // Mutex/condition-variable baseline with the same try_push/try_pop shape;
+    // consumers block in wait_pop instead of spinning
+    class MutexQueue {
+    public:
+        bool try_push(const HandoffItem& item) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_items.push(item);
+            }
+            m_cv.notify_one();
+            return true;
+        }
+
+        // Blocks until an item arrives or close() was called and the queue drained
+        bool wait_pop(HandoffItem& out) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [&] { return !m_items.empty() || m_closed; });
+            if (m_items.empty()) return false;
+            out = m_items.front();
+            m_items.pop();
+            return true;
+        }
+
+        void close() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_closed = true;
+            }
+            m_cv.notify_all();
+        }
+
+    private:
+        std::queue<HandoffItem> m_items;
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        bool m_closed = false;
+    };
+
+    struct alignas(MemoryUtils::CACHE_LINE_SIZE) PaddedCounter {
+        std::atomic<uint64_t> value{0};
+    };
+
+    static constexpr std::memory_order load_order(std::memory_order order) {
+        return order == std::memory_order_acq_rel ? std::memory_order_acquire : order;
+    }
+
+    static constexpr std::memory_order store_order(std::memory_order order) {
+        return order == std::memory_order_acq_rel ? std::memory_order_release : order;
+    }
+
+    template <std::memory_order Order>
+    ConcurrencyMetrics run_counter_layout(const ConcurrencyConfig& config) {
+        const size_t threads_count = std::max<size_t>(config.thread_count, 1);
+        const CounterLayout layout = config.counter_layout;
+        const bool single_writer = config.single_writer &&
+            (layout == CounterLayout::ADJACENT || layout == CounterLayout::PADDED);
+
+        size_t slots = 1;
+        if (layout == CounterLayout::ADJACENT || layout == CounterLayout::PADDED) {
+            slots = threads_count;
+        } else if (layout == CounterLayout::STRIPED) {
+            slots = config.counter_stripes ? config.counter_stripes : std::max<size_t>(threads_count / 2, 1);
+        }
+
+        // ADJACENT packs 8-byte counters; the others give each its own line
+        std::vector<std::atomic<uint64_t>> packed(layout == CounterLayout::ADJACENT ? slots : 0);
+        std::vector<PaddedCounter> padded(layout == CounterLayout::ADJACENT ? 0 : slots);
+        auto counter = [&](size_t index) -> std::atomic<uint64_t>& {
+            return layout == CounterLayout::ADJACENT ? packed[index] : padded[index].value;
+        };
+        for (size_t i = 0; i < slots; ++i) counter(i).store(0, std::memory_order_relaxed);
+
+        PerfCounters events;
+        double elapsed_ns = run_measured(config, threads_count, events, [&](size_t t) {
+            std::atomic<uint64_t>& mine = counter(t % slots);
+            if (single_writer) {
+                for (size_t i = 0; i < config.iterations; ++i) {
+                    mine.store(mine.load(load_order(Order)) + 1, store_order(Order));
+                }
+            } else {
+                for (size_t i = 0; i < config.iterations; ++i) {
+                    mine.fetch_add(1, Order);
+                }
+            }
+        });
+
+        // Combine step: what a reader of a sharded counter pays
+        Timer combine_timer;
+        combine_timer.start();
+        uint64_t total = 0;
+        for (size_t i = 0; i < slots; ++i) total += counter(i).load(load_order(Order));
+        combine_timer.stop();
+
+        ConcurrencyMetrics metrics;
+        metrics.test_name = std::string("Counter ") + counter_layout_name(layout) +
+            (single_writer ? " single-writer" : "") + " (" + counter_order_name(config.counter_order) + ")";
+        metrics.thread_count = std::min(threads_count, ThreadPool::MAX_WORKERS);
+        metrics.items = static_cast<size_t>(total);
+        metrics.total_time_ms = elapsed_ns / 1000000.0;
+        metrics.combine_time_ns = combine_timer.elapsed_ns();
+        metrics.throughput = Statistics::throughput(static_cast<size_t>(total), elapsed_ns);
+        metrics.counters = events.per_op(static_cast<size_t>(total));
+        metrics.thread_efficiency = metrics.throughput / threads_count;
+        return metrics;
+    }
+
+    // Spin briefly, then yield so an oversubscribed run still makes progress
+    static void backoff(unsigned& spins) {
+        if (++spins < 64) {
+            MemoryUtils::cpu_relax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    template <typename Queue>
+    ConcurrencyMetrics run_handoff(Queue& queue, size_t producers, size_t consumers,
+                                   const ConcurrencyConfig& config) {
+        ConcurrencyMetrics metrics;
+        std::atomic<size_t> producers_running{producers};
+        std::vector<LatencyHistogram> latencies(consumers);
+        std::vector<size_t> consumed(consumers, 0);
+
+        auto consume = [&](size_t c) {
+            LatencyHistogram& latency = latencies[c];
+            HandoffItem item;
+            size_t count = 0;
+            auto take = [&] {
+                latency.record(Timer::sample_ns(item.push_ticks, Timer::ticks_end()));
+                count++;
+            };
+            if constexpr (std::is_same<Queue, MutexQueue>::value) {
+                while (queue.wait_pop(item)) take();
+            } else {
+                unsigned spins = 0;
+                for (;;) {
+                    if (queue.try_pop(item)) {
+                        take();
+                        spins = 0;
+                    } else if (producers_running.load(std::memory_order_acquire) == 0) {
+                        // All pushes have completed, so a failed pop now means empty
+                        if (!queue.try_pop(item)) break;
+                        take();
+                    } else {
+                        backoff(spins);
+                    }
+                }
+            }
+            consumed[c] = count;
+        };
+
+        auto produce = [&](size_t p) {
+            for (size_t i = 0; i < config.iterations; ++i) {
+                HandoffItem item{p * config.iterations + i, Timer::ticks_begin()};
+                for (unsigned spins = 0; !queue.try_push(item);) backoff(spins);
+            }
+            if (producers_running.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                if constexpr (std::is_same<Queue, MutexQueue>::value) queue.close();
+            }
+        };
+
+        // Workers [0, consumers) consume, the rest produce
+        PerfCounters events;
+        double elapsed_ns = run_measured(config, producers + consumers, events, [&](size_t index) {
+            if (index < consumers) {
+                consume(index);
+            } else {
+                produce(index - consumers);
+            }
+        });
+
+        for (size_t c = 0; c < consumers; ++c) {
+            metrics.handoff_latency.merge(latencies[c]);
+            metrics.items += consumed[c];
+        }
+        metrics.total_time_ms = elapsed_ns / 1000000.0;
+        metrics.throughput = Statistics::throughput(metrics.items, elapsed_ns);
+        metrics.counters = events.per_op(metrics.items);
+        return metrics;
+    }
 };
 
 } // namespace memory_engine
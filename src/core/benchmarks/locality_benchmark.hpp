@@ -0,0 +1,325 @@
+/**
+ * @file locality_benchmark.hpp
+ * @brief Traversal cost of linked structures built through an allocator
+ *
+ * The allocation benchmarks time allocate()/deallocate() only. This one
+ * times what comes after: walking the objects the allocator placed. A bump
+ * allocator lays nodes out in allocation order, while a LIFO free list hands
+ * freed blocks back in reverse. An allocator that scatters nodes makes every
+ * later traversal pay for it in cache and TLB misses.
+ */
+
+#ifndef LOCALITY_BENCHMARK_HPP
+#define LOCALITY_BENCHMARK_HPP
+
+#include "../allocators/base_allocator.hpp"
+#include "../utils/memory_utils.hpp"
+#include "../utils/perf_counters.hpp"
+#include "../utils/statistics.hpp"
+#include "../utils/timer.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace memory_engine {
+
+enum class LocalityStructure {
+    LINKED_LIST,     ///< Sequential: follow next; random: follow a shuffled second link
+    BINARY_TREE,     ///< Sequential: in-order walk; random: key lookups, every node on the path counted
+    POINTER_ARRAY    ///< Sequential: table order; random: shuffled order (independent loads)
+};
+
+struct LocalityConfig {
+    size_t node_count = 65536;
+    size_t node_size = 64;        ///< Bytes per node, links included (at least 48)
+    size_t churn_rounds = 2;      ///< Free-and-reallocate rounds between building and traversing
+    double churn_ratio = 0.1;     ///< Share of nodes freed, then reallocated, per round
+    size_t passes = 5;            ///< Timed traversals of each kind, after one untimed pass
+    size_t random_lookups = 0;    ///< BINARY_TREE searches per random pass; 0 = node_count
+    bool perf_counters = false;   ///< Count hardware events per node visited
+    uint64_t seed = 1;
+};
+
+struct LocalityMetrics {
+    std::string allocator_name;
+    LocalityStructure structure = LocalityStructure::LINKED_LIST;
+    size_t nodes = 0;                   ///< Nodes live during the traversals
+    size_t failed_allocations = 0;
+    size_t rejected_deallocations = 0;  ///< Churn frees the allocator refused (e.g. out-of-order stack frees)
+    double build_time_ms = 0;
+    double churn_time_ms = 0;
+
+    // Layout after churn, the same for every structure of one run
+    double median_stride = 0;           ///< Median |address gap| between logically adjacent nodes, bytes
+    double adjacent_ratio = 0;          ///< Share of logical neighbours within 2 node sizes of each other
+    size_t pages_touched = 0;           ///< Distinct pages holding nodes
+
+    BenchmarkResult sequential_time;    ///< ns per node visited, one sample per pass
+    BenchmarkResult random_time;
+    double sequential_throughput = 0;   ///< Nodes visited per second
+    double random_throughput = 0;
+    double random_penalty = 1;          ///< random_time.mean / sequential_time.mean
+    PerfCounters sequential_counters;   ///< Per node visited
+    PerfCounters random_counters;
+};
+
+class LocalityBenchmark {
+public:
+    /**
+     * Allocates node_count nodes in logical order, then runs churn_rounds
+     * rounds. Each round frees a random churn_ratio of the nodes and
+     * reallocates them in that same order, so the allocator's reuse policy
+     * decides where they land. The list, tree and pointer table are then
+     * linked over the same nodes (one layout, three access patterns) and
+     * each is traversed sequentially and randomly.
+     *
+     * The allocator is reset before and after. Node memory is written once
+     * per build and only read while timed.
+     */
+    std::vector<LocalityMetrics> run(BaseAllocator& allocator, const LocalityConfig& config) {
+        const size_t node_size = std::max(config.node_size, sizeof(Node));
+        std::mt19937_64 rng(config.seed);
+        LocalityMetrics base;
+        base.allocator_name = allocator.name();
+
+        allocator.reset();
+        std::vector<Node*> nodes;
+        nodes.reserve(config.node_count);
+
+        Timer timer;
+        timer.start();
+        for (size_t i = 0; i < config.node_count; ++i) {
+            Node* node = create(allocator, node_size, i);
+            if (!node) {
+                base.failed_allocations++;
+                break;
+            }
+            nodes.push_back(node);
+        }
+        timer.stop();
+        base.build_time_ms = timer.elapsed_ms();
+
+        timer.start();
+        size_t rejected = allocator.stats().rejected_deallocations;
+        std::vector<size_t> victims(nodes.size());
+        for (size_t round = 0; round < config.churn_rounds && !nodes.empty(); ++round) {
+            size_t churn = static_cast<size_t>(nodes.size() * std::min(std::max(config.churn_ratio, 0.0), 1.0));
+            std::iota(victims.begin(), victims.end(), size_t(0));
+            for (size_t i = 0; i < churn; ++i) {
+                std::swap(victims[i], victims[i + rng() % (victims.size() - i)]);
+            }
+            for (size_t i = 0; i < churn; ++i) allocator.deallocate(nodes[victims[i]]);
+            for (size_t i = 0; i < churn; ++i) {
+                nodes[victims[i]] = create(allocator, node_size, victims[i]);
+                if (!nodes[victims[i]]) base.failed_allocations++;
+            }
+        }
+        timer.stop();
+        base.churn_time_ms = timer.elapsed_ms();
+        base.rejected_deallocations = allocator.stats().rejected_deallocations - rejected;
+
+        // Nodes that could not be reallocated drop out; keys stay the logical order
+        nodes.erase(std::remove(nodes.begin(), nodes.end(), nullptr), nodes.end());
+        for (size_t i = 0; i < nodes.size(); ++i) nodes[i]->key = i;
+        base.nodes = nodes.size();
+        measure_layout(nodes, node_size, base);
+
+        std::vector<size_t> order(nodes.size());
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::shuffle(order.begin(), order.end(), rng);
+        link(nodes, order);
+
+        std::vector<size_t> lookups(config.random_lookups ? config.random_lookups : nodes.size());
+        for (size_t& key : lookups) key = nodes.empty() ? 0 : rng() % nodes.size();
+        Node* root = nodes.empty() ? nullptr : nodes[nodes.size() / 2];
+
+        std::vector<LocalityMetrics> results;
+        static const LocalityStructure structures[] = {
+            LocalityStructure::LINKED_LIST, LocalityStructure::BINARY_TREE, LocalityStructure::POINTER_ARRAY};
+        for (LocalityStructure structure : structures) {
+            LocalityMetrics metrics = base;
+            metrics.structure = structure;
+            measure(config, metrics, false, [&] { return traverse(structure, false, nodes, order, lookups, root); });
+            measure(config, metrics, true, [&] { return traverse(structure, true, nodes, order, lookups, root); });
+            if (metrics.sequential_time.mean > 0) {
+                metrics.random_penalty = metrics.random_time.mean / metrics.sequential_time.mean;
+            }
+            results.push_back(metrics);
+        }
+
+        for (Node* node : nodes) allocator.deallocate(node);
+        allocator.reset();
+        return results;
+    }
+
+    static const char* structure_name(LocalityStructure structure) {
+        switch (structure) {
+            case LocalityStructure::LINKED_LIST: return "linked list";
+            case LocalityStructure::BINARY_TREE: return "binary tree";
+            case LocalityStructure::POINTER_ARRAY: return "pointer array";
+        }
+        return "unknown";
+    }
+
+private:
+    // Every structure's links live in every node; the rest of node_size is payload
+    struct Node {
+        Node* next;    ///< List order
+        Node* skip;    ///< Random permutation cycle
+        Node* left;
+        Node* right;
+        uint64_t key;  ///< Logical position
+        uint64_t value;
+    };
+
+    static Node* create(BaseAllocator& allocator, size_t node_size, size_t key) {
+        void* memory = allocator.allocate(node_size, alignof(Node));
+        if (!memory) return nullptr;
+        std::memset(memory, 0, node_size);
+        Node* node = static_cast<Node*>(memory);
+        node->key = key;
+        node->value = key * 2 + 1;
+        return node;
+    }
+
+    static void link(std::vector<Node*>& nodes, const std::vector<size_t>& order) {
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            nodes[i]->next = i + 1 < nodes.size() ? nodes[i + 1] : nullptr;
+            nodes[order[i]]->skip = i + 1 < order.size() ? nodes[order[i + 1]] : nullptr;
+        }
+        link_tree(nodes, 0, nodes.size());
+    }
+
+    // Balanced BST over [first, last) by logical position; returns the subtree root
+    static Node* link_tree(std::vector<Node*>& nodes, size_t first, size_t last) {
+        if (first >= last) return nullptr;
+        size_t middle = first + (last - first) / 2;
+        nodes[middle]->left = link_tree(nodes, first, middle);
+        nodes[middle]->right = link_tree(nodes, middle + 1, last);
+        return nodes[middle];
+    }
+
+    static void measure_layout(const std::vector<Node*>& nodes, size_t node_size, LocalityMetrics& metrics) {
+        if (nodes.empty()) return;
+
+        std::vector<double> strides;
+        size_t adjacent = 0;
+        for (size_t i = 1; i < nodes.size(); ++i) {
+            uintptr_t a = reinterpret_cast<uintptr_t>(nodes[i - 1]);
+            uintptr_t b = reinterpret_cast<uintptr_t>(nodes[i]);
+            uintptr_t gap = a > b ? a - b : b - a;
+            strides.push_back(static_cast<double>(gap));
+            if (gap <= 2 * node_size) adjacent++;
+        }
+        if (!strides.empty()) {
+            std::nth_element(strides.begin(), strides.begin() + strides.size() / 2, strides.end());
+            metrics.median_stride = strides[strides.size() / 2];
+            metrics.adjacent_ratio = static_cast<double>(adjacent) / strides.size();
+        }
+
+        const size_t page_size = MemoryUtils::get_page_size();
+        std::vector<uintptr_t> pages;
+        pages.reserve(nodes.size());
+        for (Node* node : nodes) pages.push_back(reinterpret_cast<uintptr_t>(node) / page_size);
+        std::sort(pages.begin(), pages.end());
+        metrics.pages_touched = static_cast<size_t>(std::unique(pages.begin(), pages.end()) - pages.begin());
+    }
+
+    /**
+     * @brief One traversal
+     * @return Nodes visited; the checksum goes to a volatile sink
+     */
+    static size_t traverse(LocalityStructure structure, bool random, const std::vector<Node*>& nodes,
+                           const std::vector<size_t>& order, const std::vector<size_t>& lookups, Node* root) {
+        if (nodes.empty()) return 0;
+
+        uint64_t sum = 0;
+        size_t visited = 0;
+        switch (structure) {
+            case LocalityStructure::LINKED_LIST:
+                for (Node* node = random ? nodes[order[0]] : nodes[0]; node; node = random ? node->skip : node->next) {
+                    sum += node->value;
+                    visited++;
+                }
+                break;
+            case LocalityStructure::BINARY_TREE:
+                if (random) {
+                    for (size_t key : lookups) {
+                        Node* node = root;
+                        while (node && node->key != key) {
+                            visited++;
+                            node = key < node->key ? node->left : node->right;
+                        }
+                        if (node) {
+                            sum += node->value;
+                            visited++;
+                        }
+                    }
+                } else {
+                    // Iterative in-order walk; depth is log2(n) for the balanced tree
+                    Node* stack[64];
+                    size_t depth = 0;
+                    Node* node = root;
+                    while (node || depth > 0) {
+                        while (node) {
+                            stack[depth++] = node;
+                            node = node->left;
+                        }
+                        node = stack[--depth];
+                        sum += node->value;
+                        visited++;
+                        node = node->right;
+                    }
+                }
+                break;
+            case LocalityStructure::POINTER_ARRAY:
+                if (random) {
+                    for (size_t index : order) sum += nodes[index]->value;
+                } else {
+                    for (Node* node : nodes) sum += node->value;
+                }
+                visited = nodes.size();
+                break;
+        }
+
+        static volatile uint64_t sink;
+        sink = sink + sum;
+        return visited;
+    }
+
+    template <typename Traversal>
+    static void measure(const LocalityConfig& config, LocalityMetrics& metrics, bool random, Traversal&& traversal) {
+        traversal(); // Untimed: warms the caches to their steady state for this pattern
+
+        PerfCounterGroup* group = config.perf_counters ? &PerfCounterGroup::for_this_thread() : nullptr;
+        PerfCounters events;
+        std::vector<double> times;
+        size_t total_visits = 0;
+        double total_ns = 0;
+        for (size_t pass = 0; pass < std::max<size_t>(config.passes, 1); ++pass) {
+            if (group) group->start();
+            Timer timer;
+            timer.start();
+            size_t visits = traversal();
+            timer.stop();
+            if (group) events += group->stop();
+
+            total_visits += visits;
+            total_ns += timer.elapsed_ns();
+            times.push_back(visits ? timer.elapsed_ns() / visits : 0);
+        }
+
+        (random ? metrics.random_time : metrics.sequential_time) = Statistics::analyze(times);
+        (random ? metrics.random_throughput : metrics.sequential_throughput) =
+            Statistics::throughput(total_visits, total_ns);
+        (random ? metrics.random_counters : metrics.sequential_counters) = events.per_op(total_visits);
+    }
+};
+
+} // namespace memory_engine
+
+#endif // LOCALITY_BENCHMARK_HPP
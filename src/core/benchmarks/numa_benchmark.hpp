@@ -0,0 +1,188 @@
+/**
+ * @file numa_benchmark.hpp
+ * @brief Local vs. remote node allocate-and-touch throughput
+ */
+
+#ifndef NUMA_BENCHMARK_HPP
+#define NUMA_BENCHMARK_HPP
+
+#include "../allocators/pool_allocator.hpp"
+#include "../allocators/stack_allocator.hpp"
+#include "../allocators/freelist_allocator.hpp"
+#include "../utils/numa.hpp"
+#include "../utils/statistics.hpp"
+#include "../utils/timer.hpp"
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace memory_engine {
+
+enum class NumaArena {
+    POOL,
+    STACK,
+    FREELIST
+};
+
+struct NumaConfig {
+    NumaArena arena = NumaArena::POOL;
+    size_t thread_count = 2;          ///< Threads pinned to the CPU node, one arena each
+    size_t block_size = 256;
+    size_t blocks_per_round = 131072; ///< 32 MB per thread by default, well past the LLC
+    size_t rounds = 10;               ///< Timed rounds after one untimed warm-up round
+};
+
+struct NumaMetrics {
+    std::string test_name;
+    int cpu_node = 0;
+    int memory_node = 0;
+    bool pinned = false;          ///< Every thread ran on cpu_node's CPUs
+    bool bound = false;           ///< Every arena was bound to memory_node
+    double total_time_ms = 0;
+    double throughput = 0;        ///< Blocks allocated and written per second
+    double bandwidth_gbps = 0;    ///< Bytes written per second / 1e9
+    double remote_penalty = 0;    ///< Throughput lost vs. the local run of cpu_node, percent
+};
+
+class NumaBenchmark {
+public:
+    /**
+     * Threads pinned to cpu_node allocate blocks_per_round blocks from their
+     * own arena bound to memory_node, write every byte, then reset the arena.
+     * The warm-up round faults the pages in, so the timed rounds measure
+     * access cost rather than page faults.
+     */
+    NumaMetrics run_placement(const NumaConfig& config, int cpu_node, int memory_node) {
+        const size_t thread_count = std::max<size_t>(config.thread_count, 1);
+        std::atomic<size_t> ready{0};
+        std::atomic<size_t> pinned{0};
+        std::atomic<size_t> bound{0};
+        std::atomic<bool> go{false};
+        std::vector<double> thread_ns(thread_count, 0);
+        std::vector<size_t> thread_blocks(thread_count, 0);
+
+        std::vector<std::thread> threads;
+        threads.reserve(thread_count);
+        for (size_t t = 0; t < thread_count; ++t) {
+            threads.emplace_back([&, t]() {
+                if (Numa::bind_current_thread(cpu_node)) pinned.fetch_add(1);
+                std::unique_ptr<BaseAllocator> arena = make_arena(config, memory_node);
+                std::vector<void*> blocks(config.blocks_per_round);
+
+                size_t got = touch_round(*arena, config, blocks); // Warm-up
+                int node = got ? Numa::node_of(blocks[0]) : Numa::ANY_NODE;
+                if (arena_node(*arena) == memory_node && (node == memory_node || node == Numa::ANY_NODE)) {
+                    bound.fetch_add(1);
+                }
+
+                ready.fetch_add(1);
+                while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+
+                Timer timer;
+                timer.start();
+                size_t total = 0;
+                for (size_t round = 0; round < config.rounds; ++round) {
+                    total += touch_round(*arena, config, blocks);
+                }
+                timer.stop();
+                thread_ns[t] = timer.elapsed_ns();
+                thread_blocks[t] = total;
+            });
+        }
+
+        while (ready.load() < thread_count) std::this_thread::yield();
+        go.store(true, std::memory_order_release);
+        for (auto& thread : threads) thread.join();
+
+        NumaMetrics metrics;
+        metrics.cpu_node = cpu_node;
+        metrics.memory_node = memory_node;
+        metrics.pinned = pinned.load() == thread_count;
+        metrics.bound = bound.load() == thread_count;
+        metrics.test_name = std::string(arena_name(config.arena)) + " cpu node " + std::to_string(cpu_node) +
+            " / memory node " + std::to_string(memory_node) + (cpu_node == memory_node ? " (local)" : " (remote)");
+
+        double slowest_ns = 0;
+        size_t blocks = 0;
+        for (size_t t = 0; t < thread_count; ++t) {
+            slowest_ns = std::max(slowest_ns, thread_ns[t]);
+            blocks += thread_blocks[t];
+        }
+        metrics.total_time_ms = slowest_ns / 1000000.0;
+        metrics.throughput = Statistics::throughput(blocks, slowest_ns);
+        metrics.bandwidth_gbps = metrics.throughput * config.block_size / 1e9;
+        return metrics;
+    }
+
+    // Every (cpu node, memory node) pair; a single entry on non-NUMA machines
+    std::vector<NumaMetrics> run_matrix(const NumaConfig& config) {
+        std::vector<NumaMetrics> results;
+        int nodes = Numa::node_count();
+        for (int cpu_node = 0; cpu_node < nodes; ++cpu_node) {
+            if (Numa::node_cpus(cpu_node).empty()) continue; // Memory-only node
+            size_t local = results.size() + cpu_node;
+            for (int memory_node = 0; memory_node < nodes; ++memory_node) {
+                results.push_back(run_placement(config, cpu_node, memory_node));
+            }
+            double local_throughput = results[local].throughput;
+            for (size_t i = local - cpu_node; i < results.size(); ++i) {
+                if (local_throughput > 0) {
+                    results[i].remote_penalty = (1.0 - results[i].throughput / local_throughput) * 100.0;
+                }
+            }
+        }
+        return results;
+    }
+
+    static const char* arena_name(NumaArena arena) {
+        switch (arena) {
+            case NumaArena::POOL: return "pool";
+            case NumaArena::STACK: return "stack";
+            case NumaArena::FREELIST: return "free list";
+        }
+        return "unknown";
+    }
+
+private:
+    static std::unique_ptr<BaseAllocator> make_arena(const NumaConfig& config, int node) {
+        size_t blocks = config.blocks_per_round;
+        switch (config.arena) {
+            case NumaArena::POOL:
+                return std::make_unique<PoolAllocator>(config.block_size, blocks, alignof(std::max_align_t), node);
+            case NumaArena::STACK:
+                // Room for the per-allocation header and alignment padding
+                return std::make_unique<StackAllocator>(blocks * (config.block_size + 64), alignof(std::max_align_t), node);
+            case NumaArena::FREELIST:
+                return std::make_unique<FreeListAllocator>(blocks * (config.block_size + 64), FitPolicy::BEST_FIT, node);
+        }
+        return nullptr;
+    }
+
+    static int arena_node(const BaseAllocator& arena) {
+        if (auto* pool = dynamic_cast<const PoolAllocator*>(&arena)) return pool->numa_node();
+        if (auto* stack = dynamic_cast<const StackAllocator*>(&arena)) return stack->numa_node();
+        if (auto* free_list = dynamic_cast<const FreeListAllocator*>(&arena)) return free_list->numa_node();
+        return Numa::ANY_NODE;
+    }
+
+    // Allocates until the round is full, writes every block, then resets
+    static size_t touch_round(BaseAllocator& arena, const NumaConfig& config, std::vector<void*>& blocks) {
+        size_t got = 0;
+        for (; got < blocks.size(); ++got) {
+            blocks[got] = arena.allocate(config.block_size);
+            if (!blocks[got]) break;
+        }
+        for (size_t i = 0; i < got; ++i) {
+            std::memset(blocks[i], static_cast<int>(i), config.block_size);
+        }
+        arena.reset();
+        return got;
+    }
+};
+
+} // namespace memory_engine
+
+#endif // NUMA_BENCHMARK_HPP
@@ -0,0 +1,402 @@
+/**
+ * @file result_report.hpp
+ * @brief Machine-readable benchmark results, environment metadata and baseline comparison
+ *
+ * A ResultReport is a flat list of ResultRecords, one per measured quantity
+ * (test, allocator, variant, metric), each with its full BenchmarkResult
+ * summary. It exports as JSON (loadable again as a baseline) or CSV. Two
+ * reports of the same configuration compare record by record with Welch's
+ * t-test, so only changes that are both significant and large enough get
+ * flagged.
+ */
+
+#ifndef RESULT_REPORT_HPP
+#define RESULT_REPORT_HPP
+
+#include "../allocators/stats_policy.hpp"
+#include "../utils/json.hpp"
+#include "../utils/memory_utils.hpp"
+#include "../utils/numa.hpp"
+#include "../utils/perf_counters.hpp"
+#include "../utils/statistics.hpp"
+#include "../utils/timer.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+#include <sys/utsname.h>
+#endif
+
+// CMake passes these for the native driver; other builds report "unknown"
+#ifndef MEMORY_ENGINE_BUILD_TYPE
+#define MEMORY_ENGINE_BUILD_TYPE "unknown"
+#endif
+#ifndef MEMORY_ENGINE_BUILD_FLAGS
+#define MEMORY_ENGINE_BUILD_FLAGS "unknown"
+#endif
+
+namespace memory_engine {
+
+/**
+ * @struct EnvironmentInfo
+ * @brief Where and how a report was produced
+ */
+struct EnvironmentInfo {
+    std::string cpu_model = "unknown";
+    std::string architecture = "unknown";
+    std::string os = "unknown";
+    std::string compiler = "unknown";
+    std::string build_type = MEMORY_ENGINE_BUILD_TYPE;
+    std::string build_flags = MEMORY_ENGINE_BUILD_FLAGS;
+    std::string timer_backend;
+    std::string timestamp;          ///< UTC, ISO 8601
+    unsigned logical_cpus = 0;
+    int numa_nodes = 1;
+    size_t page_size = 0;
+    bool optimized = false;         ///< Compiled with optimization (__OPTIMIZE__ or NDEBUG)
+    bool stats_enabled = MEMORY_ENGINE_STATS != 0;
+    bool perf_counters = false;     ///< perf_event support compiled in
+
+    static EnvironmentInfo collect() {
+        EnvironmentInfo info;
+        info.cpu_model = read_cpu_model();
+        info.architecture = architecture_name();
+        info.os = os_name();
+        info.compiler = compiler_name();
+        info.timer_backend = Timer::calibration().backend;
+        info.logical_cpus = std::thread::hardware_concurrency();
+        info.numa_nodes = Numa::node_count();
+        info.page_size = MemoryUtils::get_page_size();
+        #if defined(__OPTIMIZE__) || defined(NDEBUG)
+        info.optimized = true;
+        #endif
+        #ifdef MEMORY_ENGINE_HAS_PERF_EVENT
+        info.perf_counters = true;
+        #endif
+
+        std::time_t now = std::time(nullptr);
+        char buffer[32] = {};
+        #ifdef _WIN32
+        std::tm utc;
+        gmtime_s(&utc, &now);
+        #else
+        std::tm utc;
+        gmtime_r(&now, &utc);
+        #endif
+        std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &utc);
+        info.timestamp = buffer;
+        return info;
+    }
+
+    /**
+     * @brief Fields that make two runs incomparable when they differ
+     */
+    std::vector<std::string> differences(const EnvironmentInfo& other) const {
+        std::vector<std::string> fields;
+        if (cpu_model != other.cpu_model) fields.push_back("cpu_model");
+        if (architecture != other.architecture) fields.push_back("architecture");
+        if (compiler != other.compiler) fields.push_back("compiler");
+        if (build_type != other.build_type) fields.push_back("build_type");
+        if (build_flags != other.build_flags) fields.push_back("build_flags");
+        if (stats_enabled != other.stats_enabled) fields.push_back("stats_enabled");
+        if (logical_cpus != other.logical_cpus) fields.push_back("logical_cpus");
+        return fields;
+    }
+
+private:
+    static std::string read_cpu_model() {
+        #ifdef __linux__
+        // x86 reports "model name"; many ARM kernels only "Hardware" or "CPU part"
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line, fallback;
+        while (std::getline(cpuinfo, line)) {
+            size_t colon = line.find(':');
+            if (colon == std::string::npos) continue;
+            std::string key = line.substr(0, line.find_last_not_of(" \t", colon - 1) + 1);
+            std::string value = colon + 2 <= line.size() ? line.substr(colon + 2) : "";
+            if (key == "model name" && !value.empty()) return value;
+            if ((key == "Hardware" || key == "CPU part") && fallback.empty()) fallback = value;
+        }
+        if (!fallback.empty()) return fallback;
+        #elif defined(_WIN32)
+        if (const char* identifier = std::getenv("PROCESSOR_IDENTIFIER")) return identifier;
+        #endif
+        return "unknown";
+    }
+
+    static const char* architecture_name() {
+        #if defined(__x86_64__) || defined(_M_X64)
+        return "x86_64";
+        #elif defined(__aarch64__) || defined(_M_ARM64)
+        return "aarch64";
+        #elif defined(__i386__) || defined(_M_IX86)
+        return "x86";
+        #elif defined(__arm__)
+        return "arm";
+        #elif defined(__wasm__)
+        return "wasm";
+        #else
+        return "unknown";
+        #endif
+    }
+
+    static std::string os_name() {
+        #if defined(_WIN32)
+        return "Windows";
+        #elif defined(__EMSCRIPTEN__)
+        return "Emscripten";
+        #else
+        struct utsname name;
+        if (uname(&name) != 0) return "unknown";
+        return std::string(name.sysname) + " " + name.release;
+        #endif
+    }
+
+    static std::string compiler_name() {
+        std::string standard = " (C++" + std::to_string(__cplusplus / 100 % 100) + ")";
+        #if defined(__clang__)
+        return std::string("clang ") + __clang_version__ + standard;
+        #elif defined(__GNUC__)
+        return std::string("gcc ") + __VERSION__ + standard;
+        #elif defined(_MSC_VER)
+        return "MSVC " + std::to_string(_MSC_FULL_VER) + standard;
+        #else
+        return "unknown" + standard;
+        #endif
+    }
+};
+
+/**
+ * @struct ResultRecord
+ * @brief One measured quantity
+ */
+struct ResultRecord {
+    std::string test;         ///< e.g. "alloc", "scaling", "locality"
+    std::string allocator;
+    std::string variant;      ///< Parameters that tell records of one test apart, e.g. "size=256 threads=4"
+    std::string metric;       ///< e.g. "alloc", "free", "sequential"
+    std::string unit;         ///< e.g. "ns/op"
+    bool lower_is_better = true;
+    BenchmarkResult result;   ///< Distribution over iterations; carries the confidence interval
+
+    std::string key() const {
+        return test + " | " + allocator + " | " + variant + " | " + metric;
+    }
+};
+
+/**
+ * @struct ResultChange
+ * @brief A record present in both the baseline and the current report
+ */
+struct ResultChange {
+    ResultRecord baseline;
+    ResultRecord current;
+    Comparison comparison;
+    bool regression = false;   ///< Significant, at least the threshold, and in the bad direction
+    bool improvement = false;
+};
+
+class ResultReport {
+public:
+    EnvironmentInfo environment;
+    std::vector<std::pair<std::string, std::string>> settings;   ///< Run configuration, as given
+    std::vector<ResultRecord> records;
+
+    void add(const ResultRecord& record) { records.push_back(record); }
+
+    std::string to_json() const {
+        std::ostringstream out;
+        const EnvironmentInfo& env = environment;
+        out << "{\n  \"schema\": " << SCHEMA_VERSION << ",\n  \"environment\": {"
+            << "\"cpu_model\":" << JsonValue::quote(env.cpu_model)
+            << ",\"architecture\":" << JsonValue::quote(env.architecture)
+            << ",\"os\":" << JsonValue::quote(env.os)
+            << ",\"compiler\":" << JsonValue::quote(env.compiler)
+            << ",\"build_type\":" << JsonValue::quote(env.build_type)
+            << ",\"build_flags\":" << JsonValue::quote(env.build_flags)
+            << ",\"timer_backend\":" << JsonValue::quote(env.timer_backend)
+            << ",\"timestamp\":" << JsonValue::quote(env.timestamp)
+            << ",\"logical_cpus\":" << env.logical_cpus
+            << ",\"numa_nodes\":" << env.numa_nodes
+            << ",\"page_size\":" << env.page_size
+            << ",\"optimized\":" << (env.optimized ? "true" : "false")
+            << ",\"stats_enabled\":" << (env.stats_enabled ? "true" : "false")
+            << ",\"perf_counters\":" << (env.perf_counters ? "true" : "false") << "},\n  \"settings\": {";
+        for (size_t i = 0; i < settings.size(); ++i) {
+            out << (i ? "," : "") << JsonValue::quote(settings[i].first) << ":" << JsonValue::quote(settings[i].second);
+        }
+        out << "},\n  \"results\": [";
+        for (size_t i = 0; i < records.size(); ++i) {
+            const ResultRecord& record = records[i];
+            const BenchmarkResult& r = record.result;
+            out << (i ? ",\n    " : "\n    ")
+                << "{\"test\":" << JsonValue::quote(record.test)
+                << ",\"allocator\":" << JsonValue::quote(record.allocator)
+                << ",\"variant\":" << JsonValue::quote(record.variant)
+                << ",\"metric\":" << JsonValue::quote(record.metric)
+                << ",\"unit\":" << JsonValue::quote(record.unit)
+                << ",\"lower_is_better\":" << (record.lower_is_better ? "true" : "false")
+                << ",\"samples\":" << r.sample_count;
+            for (const auto& field : result_fields()) out << ",\"" << field.first << "\":" << number(r.*field.second);
+            out << "}";
+        }
+        out << (records.empty() ? "]\n}\n" : "\n  ]\n}\n");
+        return out.str();
+    }
+
+    // Environment and settings as leading "# key=value" lines, then one row per record
+    std::string to_csv() const {
+        std::ostringstream out;
+        const EnvironmentInfo& env = environment;
+        out << "# cpu_model=" << env.cpu_model << "\n# architecture=" << env.architecture
+            << "\n# os=" << env.os << "\n# compiler=" << env.compiler
+            << "\n# build_type=" << env.build_type << "\n# build_flags=" << env.build_flags
+            << "\n# timer_backend=" << env.timer_backend << "\n# timestamp=" << env.timestamp
+            << "\n# logical_cpus=" << env.logical_cpus << "\n# numa_nodes=" << env.numa_nodes
+            << "\n# stats_enabled=" << (env.stats_enabled ? 1 : 0) << "\n";
+        for (const auto& setting : settings) out << "# " << setting.first << "=" << setting.second << "\n";
+
+        out << "test,allocator,variant,metric,unit,lower_is_better,samples";
+        for (const auto& field : result_fields()) out << "," << field.first;
+        out << "\n";
+        for (const ResultRecord& record : records) {
+            out << csv_field(record.test) << "," << csv_field(record.allocator) << ","
+                << csv_field(record.variant) << "," << csv_field(record.metric) << ","
+                << csv_field(record.unit) << "," << (record.lower_is_better ? 1 : 0) << ","
+                << record.result.sample_count;
+            for (const auto& field : result_fields()) out << "," << number(record.result.*field.second);
+            out << "\n";
+        }
+        return out.str();
+    }
+
+    /**
+     * @brief Load a report written by to_json()
+     * @return false with error set when the file is missing or malformed
+     */
+    static bool load_json(const std::string& path, ResultReport& out, std::string* error = nullptr) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            if (error) *error = "cannot open " + path;
+            return false;
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+
+        JsonValue document;
+        if (!JsonValue::parse(buffer.str(), document, error)) return false;
+        if (!document.is_object() || !document["results"].is_array()) {
+            if (error) *error = path + " is not a result report";
+            return false;
+        }
+
+        out = ResultReport();
+        const JsonValue& env = document["environment"];
+        out.environment.cpu_model = env["cpu_model"].string();
+        out.environment.architecture = env["architecture"].string();
+        out.environment.os = env["os"].string();
+        out.environment.compiler = env["compiler"].string();
+        out.environment.build_type = env["build_type"].string();
+        out.environment.build_flags = env["build_flags"].string();
+        out.environment.timer_backend = env["timer_backend"].string();
+        out.environment.timestamp = env["timestamp"].string();
+        out.environment.logical_cpus = static_cast<unsigned>(env["logical_cpus"].number());
+        out.environment.numa_nodes = static_cast<int>(env["numa_nodes"].number(1));
+        out.environment.page_size = static_cast<size_t>(env["page_size"].number());
+        out.environment.optimized = env["optimized"].boolean();
+        out.environment.stats_enabled = env["stats_enabled"].boolean();
+        out.environment.perf_counters = env["perf_counters"].boolean();
+        for (const auto& setting : document["settings"].members()) {
+            out.settings.emplace_back(setting.first, setting.second.string());
+        }
+
+        for (const JsonValue& item : document["results"].items()) {
+            ResultRecord record;
+            record.test = item["test"].string();
+            record.allocator = item["allocator"].string();
+            record.variant = item["variant"].string();
+            record.metric = item["metric"].string();
+            record.unit = item["unit"].string();
+            record.lower_is_better = item["lower_is_better"].boolean(true);
+            record.result.sample_count = static_cast<size_t>(item["samples"].number());
+            for (const auto& field : result_fields()) record.result.*field.second = item[field.first].number();
+            out.records.push_back(record);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Match records by key against a baseline and test each pair
+     * @param threshold_percent Smallest |change| that counts, so tiny but
+     *        significant shifts from long runs are not flagged
+     *
+     * Records missing from either side are skipped.
+     */
+    std::vector<ResultChange> compare(const ResultReport& baseline, double threshold_percent) const {
+        std::vector<ResultChange> changes;
+        for (const ResultRecord& current : records) {
+            const std::string key = current.key();
+            for (const ResultRecord& before : baseline.records) {
+                if (before.key() != key) continue;
+
+                ResultChange change;
+                change.baseline = before;
+                change.current = current;
+                change.comparison = Statistics::compare(before.result, current.result);
+                double change_percent = change.comparison.change_percent;
+                bool large = std::fabs(change_percent) >= threshold_percent;
+                bool worse = current.lower_is_better ? change_percent > 0 : change_percent < 0;
+                change.regression = change.comparison.significant && large && worse;
+                change.improvement = change.comparison.significant && large && !worse;
+                changes.push_back(change);
+                break;
+            }
+        }
+        return changes;
+    }
+
+private:
+    static constexpr int SCHEMA_VERSION = 1;
+
+    using Field = std::pair<const char*, double BenchmarkResult::*>;
+
+    static const std::vector<Field>& result_fields() {
+        static const std::vector<Field> fields = {
+            {"mean", &BenchmarkResult::mean},       {"median", &BenchmarkResult::median},
+            {"std_dev", &BenchmarkResult::std_dev}, {"min", &BenchmarkResult::min},
+            {"max", &BenchmarkResult::max},         {"p95", &BenchmarkResult::p95},
+            {"p99", &BenchmarkResult::p99},         {"p999", &BenchmarkResult::p999},
+            {"ci_low", &BenchmarkResult::ci_low},   {"ci_high", &BenchmarkResult::ci_high}};
+        return fields;
+    }
+
+    // JSON has no inf/nan; null reads back as 0
+    static std::string number(double value) {
+        if (!std::isfinite(value)) return "null";
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.10g", value);
+        return buffer;
+    }
+
+    static std::string csv_field(const std::string& text) {
+        if (text.find_first_of(",\"\n") == std::string::npos) return text;
+        std::string out = "\"";
+        for (char c : text) {
+            if (c == '"') out += '"';
+            out += c;
+        }
+        return out + "\"";
+    }
+};
+
+} // namespace memory_engine
+
+#endif // RESULT_REPORT_HPP
@@ -0,0 +1,50 @@
+/**
+ * @file trace_format.hpp
+ * @brief On-disk format of allocation traces
+ *
+ * A trace is a TraceFileHeader followed by fixed-size TraceRecords. The
+ * header only uses fixed-width types so the recorder can write it without
+ * pulling in anything that allocates.
+ */
+
+#ifndef TRACE_FORMAT_HPP
+#define TRACE_FORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace memory_engine {
+
+enum class TraceOp : uint8_t {
+    ALLOCATE = 0,
+    DEALLOCATE = 1
+};
+
+// Object ids only have to be unique among live objects; the recorder uses
+// the address returned by the real allocator. realloc is recorded as a
+// DEALLOCATE of the old id followed by an ALLOCATE of the new one.
+struct TraceRecord {
+    uint64_t object_id;
+    uint64_t size;        ///< Requested bytes (0 for DEALLOCATE)
+    uint32_t thread_id;   ///< Recorder-assigned id, 1-based in order of first use
+    uint16_t alignment;   ///< Requested alignment, 0 for the platform default
+    uint8_t op;           ///< TraceOp
+    uint8_t reserved;
+};
+
+struct TraceFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t record_count; ///< 0 if the writer exited early; derive from file size
+};
+
+static_assert(sizeof(TraceRecord) == 24, "TraceRecord layout is part of the file format");
+static_assert(sizeof(TraceFileHeader) == 24, "TraceFileHeader layout is part of the file format");
+
+constexpr char TRACE_MAGIC[8] = {'M', 'E', 'T', 'R', 'A', 'C', 'E', '1'};
+constexpr uint32_t TRACE_VERSION = 1;
+
+} // namespace memory_engine
+
+#endif // TRACE_FORMAT_HPP
@@ -0,0 +1,333 @@
+/**
+ * @file trace_replay.hpp
+ * @brief Replays recorded allocation traces against an allocator
+ */
+
+#ifndef TRACE_REPLAY_HPP
+#define TRACE_REPLAY_HPP
+
+#include "trace_format.hpp"
+#include "../allocators/base_allocator.hpp"
+#include "../utils/mapped_file.hpp"
+#include "../utils/histogram.hpp"
+#include "../utils/memory_utils.hpp"
+#include "../utils/statistics.hpp"
+#include "../utils/timer.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace memory_engine {
+
+struct TraceReplayConfig {
+    size_t sample_interval = 10000;          ///< Ops between timeline samples (0 = start/end only)
+    bool free_remaining = true;              ///< Free objects still live at the end (untimed)
+};
+
+struct TraceTimelinePoint {
+    size_t op_index = 0;
+    size_t live_objects = 0;
+    size_t live_bytes = 0;         ///< Bytes requested by live objects
+    size_t allocator_bytes = 0;    ///< Allocator's current_bytes_used
+    double fragmentation = 0;      ///< Allocator fragmentation percentage
+    size_t rss_bytes = 0;          ///< Process RSS (0 where unsupported)
+};
+
+struct TraceReplayMetrics {
+    std::string allocator_name;
+    std::string error;             ///< Non-empty if the trace could not be replayed
+    bool cancelled = false;        ///< Stopped early; op_count is the ops actually replayed
+    size_t op_count = 0;
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    size_t failed_allocations = 0; ///< allocate() returned nullptr
+    size_t unmatched_frees = 0;    ///< Frees of ids never allocated in the trace
+    size_t rejected_frees = 0;     ///< Frees the allocator refused (e.g. out-of-order stack frees)
+    size_t thread_count = 0;       ///< Distinct recorded threads (replay is sequential)
+    BenchmarkResult allocation_time;
+    BenchmarkResult deallocation_time;
+    LatencyHistogram alloc_latency;  ///< Every successful allocation
+    LatencyHistogram dealloc_latency;
+    double replay_time_ms = 0;
+    double throughput = 0;         ///< Replayed ops per second
+    size_t peak_live_bytes = 0;
+    size_t peak_rss_bytes = 0;     ///< Highest sampled RSS during the replay
+    size_t rss_growth_bytes = 0;   ///< Peak sampled RSS minus RSS before the replay
+    std::vector<TraceTimelinePoint> timeline;
+};
+
+// Validates and maps a trace file; records are read straight from the mapping.
+class TraceReader {
+public:
+    bool open(const std::string& path) {
+        m_records = nullptr;
+        m_count = 0;
+        m_error.clear();
+
+        if (!m_file.open(path)) {
+            m_error = "cannot open " + path;
+            return false;
+        }
+        if (m_file.size() < sizeof(TraceFileHeader)) {
+            m_error = "trace too small for header";
+            return false;
+        }
+
+        std::memcpy(&m_header, m_file.data(), sizeof(m_header));
+        if (std::memcmp(m_header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) {
+            m_error = "not an allocation trace";
+            return false;
+        }
+        if (m_header.version != TRACE_VERSION || m_header.record_size != sizeof(TraceRecord)) {
+            m_error = "unsupported trace version";
+            return false;
+        }
+
+        size_t available = (m_file.size() - sizeof(TraceFileHeader)) / sizeof(TraceRecord);
+        m_count = m_header.record_count ? std::min<size_t>(m_header.record_count, available) : available;
+        m_records = reinterpret_cast<const TraceRecord*>(m_file.data() + sizeof(TraceFileHeader));
+        return true;
+    }
+
+    const TraceFileHeader& header() const { return m_header; }
+    const TraceRecord* records() const { return m_records; }
+    size_t record_count() const { return m_count; }
+    const std::string& error() const { return m_error; }
+
+private:
+    MappedFile m_file;
+    TraceFileHeader m_header{};
+    const TraceRecord* m_records = nullptr;
+    size_t m_count = 0;
+    std::string m_error;
+};
+
+// Buffered trace writer for generated traces; the LD_PRELOAD recorder has
+// its own allocation-free writer.
+class TraceWriter {
+public:
+    ~TraceWriter() { close(); }
+
+    bool open(const std::string& path) {
+        close();
+        m_file = std::fopen(path.c_str(), "wb");
+        if (!m_file) return false;
+        m_count = 0;
+        write_header();
+        return true;
+    }
+
+    void write(const TraceRecord& record) {
+        if (!m_file) return;
+        std::fwrite(&record, sizeof(record), 1, m_file);
+        m_count++;
+    }
+
+    void allocate(uint64_t object_id, uint64_t size, uint16_t alignment = 0, uint32_t thread_id = 1) {
+        write({object_id, size, thread_id, alignment, static_cast<uint8_t>(TraceOp::ALLOCATE), 0});
+    }
+
+    void deallocate(uint64_t object_id, uint32_t thread_id = 1) {
+        write({object_id, 0, thread_id, 0, static_cast<uint8_t>(TraceOp::DEALLOCATE), 0});
+    }
+
+    // Patches the final record count into the header
+    void close() {
+        if (!m_file) return;
+        std::fseek(m_file, 0, SEEK_SET);
+        write_header();
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+
+    size_t record_count() const { return m_count; }
+
+private:
+    std::FILE* m_file = nullptr;
+    size_t m_count = 0;
+
+    void write_header() {
+        TraceFileHeader header{};
+        std::memcpy(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+        header.version = TRACE_VERSION;
+        header.record_size = sizeof(TraceRecord);
+        header.record_count = m_count;
+        std::fwrite(&header, sizeof(header), 1, m_file);
+    }
+};
+
+class TraceReplayer {
+public:
+    using ProgressCallback = std::function<void(int percent, const std::string& status)>;
+
+    void set_progress_callback(ProgressCallback callback) {
+        m_progress_callback = callback;
+    }
+
+    // Checked once per progress step (1% of the trace)
+    void set_cancel_flag(const std::atomic<bool>* flag) {
+        m_cancel_flag = flag;
+    }
+
+    TraceReplayMetrics replay_file(BaseAllocator& allocator, const std::string& path,
+                                   const TraceReplayConfig& config = {}) {
+        TraceReader reader;
+        if (!reader.open(path)) {
+            TraceReplayMetrics metrics;
+            metrics.allocator_name = allocator.name();
+            metrics.error = reader.error();
+            return metrics;
+        }
+        return replay(allocator, reader.records(), reader.record_count(), config);
+    }
+
+    // Replays records in file order on the calling thread
+    TraceReplayMetrics replay(BaseAllocator& allocator, const TraceRecord* records, size_t count,
+                              const TraceReplayConfig& config = {}) {
+        TraceReplayMetrics metrics;
+        metrics.allocator_name = allocator.name();
+        metrics.op_count = count;
+
+        allocator.reset();
+
+        struct LiveObject {
+            void* ptr;
+            size_t size;
+        };
+        std::unordered_map<uint64_t, LiveObject> live;
+        std::unordered_set<uint32_t> threads;
+        uint32_t last_thread = 0;
+
+        size_t live_objects = 0;
+        size_t live_bytes = 0;
+        size_t rss_start = MemoryUtils::current_rss();
+        metrics.peak_rss_bytes = rss_start;
+
+        auto sample = [&](size_t op_index) {
+            TraceTimelinePoint point;
+            point.op_index = op_index;
+            point.live_objects = live_objects;
+            point.live_bytes = live_bytes;
+            point.allocator_bytes = allocator.stats().current_bytes_used;
+            point.fragmentation = allocator.fragmentation_percentage();
+            point.rss_bytes = MemoryUtils::current_rss();
+            metrics.peak_rss_bytes = std::max(metrics.peak_rss_bytes, point.rss_bytes);
+            metrics.timeline.push_back(point);
+        };
+        sample(0);
+
+        const size_t progress_step = std::max<size_t>(count / 100, 1);
+        Timer replay_timer;
+        replay_timer.start();
+
+        for (size_t i = 0; i < count; ++i) {
+            const TraceRecord& record = records[i];
+            if (record.thread_id != last_thread) {
+                threads.insert(record.thread_id);
+                last_thread = record.thread_id;
+            }
+
+            if (record.op == static_cast<uint8_t>(TraceOp::ALLOCATE)) {
+                size_t alignment = record.alignment ? record.alignment : alignof(std::max_align_t);
+                size_t size = static_cast<size_t>(record.size);
+
+                // An id that is still live means the trace missed a free; drop the old object
+                auto existing = live.find(record.object_id);
+                if (existing != live.end()) {
+                    if (existing->second.ptr) {
+                        allocator.deallocate(existing->second.ptr);
+                        live_objects--;
+                        live_bytes -= existing->second.size;
+                    }
+                    live.erase(existing);
+                }
+
+                uint64_t t0 = Timer::ticks_begin();
+                void* ptr = allocator.allocate(size, alignment);
+                uint64_t t1 = Timer::ticks_end();
+
+                metrics.allocations++;
+                if (!ptr) {
+                    // Keep the id so its free is not reported as unmatched
+                    metrics.failed_allocations++;
+                    live.emplace(record.object_id, LiveObject{nullptr, 0});
+                } else {
+                    metrics.alloc_latency.record(Timer::sample_ns(t0, t1));
+                    live.emplace(record.object_id, LiveObject{ptr, size});
+                    live_objects++;
+                    live_bytes += size;
+                    metrics.peak_live_bytes = std::max(metrics.peak_live_bytes, live_bytes);
+                }
+            } else {
+                auto it = live.find(record.object_id);
+                if (it == live.end()) {
+                    metrics.unmatched_frees++;
+                } else if (!it->second.ptr) {
+                    live.erase(it);
+                } else {
+                    uint64_t t0 = Timer::ticks_begin();
+                    allocator.deallocate(it->second.ptr);
+                    uint64_t t1 = Timer::ticks_end();
+
+                    metrics.deallocations++;
+                    metrics.dealloc_latency.record(Timer::sample_ns(t0, t1));
+                    live_objects--;
+                    live_bytes -= it->second.size;
+                    live.erase(it);
+                }
+            }
+
+            if (config.sample_interval && (i + 1) % config.sample_interval == 0) {
+                // Reading RSS and fragmentation is not part of the replay
+                replay_timer.stop();
+                sample(i + 1);
+                replay_timer.start();
+            }
+            if ((i + 1) % progress_step == 0) {
+                if (m_progress_callback) {
+                    int percent = static_cast<int>((i + 1) * 100 / count);
+                    m_progress_callback(percent, "Replaying op " + std::to_string(i + 1));
+                }
+                if (m_cancel_flag && m_cancel_flag->load(std::memory_order_relaxed) && i + 1 < count) {
+                    metrics.cancelled = true;
+                    count = i + 1;
+                }
+            }
+        }
+
+        replay_timer.stop();
+        metrics.op_count = count;
+        if (!config.sample_interval || count % config.sample_interval != 0) {
+            sample(count);
+        }
+
+        metrics.replay_time_ms = replay_timer.elapsed_ms();
+        metrics.throughput = Statistics::throughput(count, replay_timer.elapsed_ns());
+        metrics.allocation_time = metrics.alloc_latency.summarize();
+        metrics.deallocation_time = metrics.dealloc_latency.summarize();
+        metrics.thread_count = threads.size();
+        metrics.rss_growth_bytes = metrics.peak_rss_bytes > rss_start ? metrics.peak_rss_bytes - rss_start : 0;
+        metrics.rejected_frees = allocator.stats().rejected_deallocations;
+
+        if (config.free_remaining) {
+            for (auto& entry : live) {
+                if (entry.second.ptr) allocator.deallocate(entry.second.ptr);
+            }
+        }
+
+        return metrics;
+    }
+
+private:
+    ProgressCallback m_progress_callback;
+    const std::atomic<bool>* m_cancel_flag = nullptr;
+};
+
+} // namespace memory_engine
+
+#endif // TRACE_REPLAY_HPP
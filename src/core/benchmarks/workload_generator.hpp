@@ -0,0 +1,172 @@
+/**
+ * @file workload_generator.hpp
+ * @brief Parametric synthetic allocation workloads
+ *
+ * Workloads are generated as trace records so they replay through the same
+ * TraceReplayer (latency, fragmentation and RSS timeline) as recorded traces.
+ */
+
+#ifndef WORKLOAD_GENERATOR_HPP
+#define WORKLOAD_GENERATOR_HPP
+
+#include "trace_format.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace memory_engine {
+
+enum class SizeDistribution {
+    FIXED,       ///< Always min_size
+    UNIFORM,     ///< Uniform in [min_size, max_size]
+    POWER_LAW,   ///< Bounded power law: many small objects, a long tail of large ones
+    BIMODAL      ///< Mix of small_size and large_size (each +/-25%)
+};
+
+enum class LifetimeModel {
+    EXPONENTIAL,  ///< Lifetime ~ Exp(mean_lifetime) allocations
+    GENERATIONAL  ///< Most objects die young, survivors live long (weak generational hypothesis)
+};
+
+enum class FreeOrder {
+    FIFO,         ///< Free in allocation order after all allocations
+    LIFO,         ///< Free in reverse allocation order after all allocations
+    RANDOM,       ///< Free in random order after all allocations
+    INTERLEAVED   ///< Free each object when its lifetime expires, between allocations
+};
+
+struct WorkloadConfig {
+    std::string name = "workload";
+    size_t object_count = 100000;    ///< Number of allocations
+    size_t alignment = 0;            ///< 0 = platform default
+    uint64_t seed = 42;
+
+    SizeDistribution size_distribution = SizeDistribution::UNIFORM;
+    size_t min_size = 16;
+    size_t max_size = 4096;
+    double power_law_alpha = 1.5;    ///< Tail exponent for POWER_LAW (> 0, != 1 handled)
+    size_t small_size = 32;          ///< BIMODAL small mode
+    size_t large_size = 2048;        ///< BIMODAL large mode
+    double small_fraction = 0.9;     ///< BIMODAL share of small objects
+
+    FreeOrder free_order = FreeOrder::INTERLEAVED;
+
+    // Lifetimes are measured in allocations and only apply to INTERLEAVED
+    LifetimeModel lifetime_model = LifetimeModel::EXPONENTIAL;
+    double mean_lifetime = 1000;     ///< EXPONENTIAL mean
+    double young_fraction = 0.9;     ///< GENERATIONAL share of short-lived objects
+    double young_lifetime = 50;      ///< GENERATIONAL mean for young objects
+    double old_lifetime = 20000;     ///< GENERATIONAL mean for survivors
+};
+
+class WorkloadGenerator {
+public:
+    // Every allocated object is freed exactly once, so a correct allocator
+    // replays the result without rejected frees.
+    static std::vector<TraceRecord> generate(const WorkloadConfig& config) {
+        std::mt19937_64 rng(config.seed);
+        std::vector<TraceRecord> records;
+        records.reserve(config.object_count * 2);
+
+        const uint16_t alignment = static_cast<uint16_t>(config.alignment);
+
+        if (config.free_order == FreeOrder::INTERLEAVED) {
+            // Min-heap of (death time, object id)
+            using Death = std::pair<double, uint64_t>;
+            std::priority_queue<Death, std::vector<Death>, std::greater<Death>> deaths;
+
+            for (uint64_t id = 1; id <= config.object_count; ++id) {
+                double now = static_cast<double>(id);
+                while (!deaths.empty() && deaths.top().first <= now) {
+                    records.push_back(free_record(deaths.top().second));
+                    deaths.pop();
+                }
+                records.push_back(alloc_record(id, draw_size(config, rng), alignment));
+                deaths.emplace(now + draw_lifetime(config, rng), id);
+            }
+            while (!deaths.empty()) {
+                records.push_back(free_record(deaths.top().second));
+                deaths.pop();
+            }
+            return records;
+        }
+
+        for (uint64_t id = 1; id <= config.object_count; ++id) {
+            records.push_back(alloc_record(id, draw_size(config, rng), alignment));
+        }
+
+        std::vector<uint64_t> order(config.object_count);
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i + 1;
+        if (config.free_order == FreeOrder::LIFO) {
+            std::reverse(order.begin(), order.end());
+        } else if (config.free_order == FreeOrder::RANDOM) {
+            std::shuffle(order.begin(), order.end(), rng);
+        }
+        for (uint64_t id : order) records.push_back(free_record(id));
+
+        return records;
+    }
+
+private:
+    static TraceRecord alloc_record(uint64_t id, size_t size, uint16_t alignment) {
+        return {id, size, 1, alignment, static_cast<uint8_t>(TraceOp::ALLOCATE), 0};
+    }
+
+    static TraceRecord free_record(uint64_t id) {
+        return {id, 0, 1, 0, static_cast<uint8_t>(TraceOp::DEALLOCATE), 0};
+    }
+
+    static double uniform01(std::mt19937_64& rng) {
+        return std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+    }
+
+    static size_t draw_size(const WorkloadConfig& config, std::mt19937_64& rng) {
+        const double lo = static_cast<double>(std::max<size_t>(config.min_size, 1));
+        const double hi = static_cast<double>(std::max(config.max_size, config.min_size));
+
+        switch (config.size_distribution) {
+            case SizeDistribution::FIXED:
+                return static_cast<size_t>(lo);
+            case SizeDistribution::UNIFORM:
+                return std::uniform_int_distribution<size_t>(static_cast<size_t>(lo), static_cast<size_t>(hi))(rng);
+            case SizeDistribution::POWER_LAW: {
+                // Inverse CDF of p(x) ~ x^-alpha on [lo, hi]
+                double u = uniform01(rng);
+                double a = config.power_law_alpha;
+                double x;
+                if (std::abs(a - 1.0) < 1e-9) {
+                    x = lo * std::pow(hi / lo, u);
+                } else {
+                    double e = 1.0 - a;
+                    x = std::pow(std::pow(lo, e) + u * (std::pow(hi, e) - std::pow(lo, e)), 1.0 / e);
+                }
+                return std::min(static_cast<size_t>(x), static_cast<size_t>(hi));
+            }
+            case SizeDistribution::BIMODAL: {
+                size_t mode = uniform01(rng) < config.small_fraction ? config.small_size : config.large_size;
+                size_t spread = mode / 4;
+                size_t size = std::uniform_int_distribution<size_t>(mode - spread, mode + spread)(rng);
+                return std::max<size_t>(size, 1);
+            }
+        }
+        return static_cast<size_t>(lo);
+    }
+
+    static double draw_lifetime(const WorkloadConfig& config, std::mt19937_64& rng) {
+        double mean = config.mean_lifetime;
+        if (config.lifetime_model == LifetimeModel::GENERATIONAL) {
+            mean = uniform01(rng) < config.young_fraction ? config.young_lifetime : config.old_lifetime;
+        }
+        // Strictly positive so an object survives at least until the next allocation
+        return std::max(std::exponential_distribution<double>(1.0 / std::max(mean, 1e-9))(rng), 1e-6);
+    }
+};
+
+} // namespace memory_engine
+
+#endif // WORKLOAD_GENERATOR_HPP
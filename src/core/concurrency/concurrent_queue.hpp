@@ -0,0 +1,471 @@
+/**
+ * @file concurrent_queue.hpp
+ * @brief Lock-free queues whose storage comes from a BaseAllocator
+ *
+ * - BoundedMPMCQueue: Vyukov's bounded ring, one sequence number per cell
+ * - SPSCQueue: single-producer/single-consumer ring with cached indices
+ * - SegmentedQueue: unbounded MPMC list of fetch-and-add array segments
+ *
+ * All three only support trivially copyable element types and expose
+ * non-blocking try_push/try_pop; callers decide how to wait.
+ */
+
+#ifndef CONCURRENT_QUEUE_HPP
+#define CONCURRENT_QUEUE_HPP
+
+#include "../allocators/base_allocator.hpp"
+#include "../utils/memory_utils.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+namespace memory_engine {
+
+/**
+ * @class QueueMemory
+ * @brief Routes queue storage through a BaseAllocator
+ *
+ * Calls are serialized for allocators that are not thread-safe. Requests the
+ * allocator cannot satisfy (too large for a pool block, arena exhausted,
+ * misaligned) fall back to aligned operator new so the queue keeps working;
+ * fallback_allocations() reports how often that happened. Frees are routed
+ * by owns(), so an allocator without tracks_ownership() gets no fallback and
+ * a refused request fails: allocate() throws std::bad_alloc, the nothrow
+ * overload returns nullptr.
+ */
+class QueueMemory {
+    template <typename Fn>
+    auto locked(Fn&& fn) {
+        if (m_serialize) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return fn();
+        }
+        return fn();
+    }
+
+public:
+    static constexpr size_t ALIGNMENT = MemoryUtils::CACHE_LINE_SIZE;
+
+    explicit QueueMemory(BaseAllocator* allocator = nullptr)
+        : m_allocator(allocator), m_serialize(allocator && !allocator->is_thread_safe()) {}
+
+    QueueMemory(const QueueMemory&) = delete;
+    QueueMemory& operator=(const QueueMemory&) = delete;
+
+    // Throws std::bad_alloc if neither the allocator nor the fallback can serve bytes
+    void* allocate(size_t bytes) {
+        void* ptr = allocate(bytes, std::nothrow);
+        if (!ptr) throw std::bad_alloc();
+        return ptr;
+    }
+
+    // Returns nullptr instead of throwing
+    void* allocate(size_t bytes, const std::nothrow_t&) {
+        if (m_allocator) {
+            void* ptr = locked([&] { return m_allocator->allocate(bytes, ALIGNMENT); });
+            if (ptr && reinterpret_cast<uintptr_t>(ptr) % ALIGNMENT == 0) return ptr;
+            if (ptr) locked([&] { m_allocator->deallocate(ptr); });
+            if (!m_allocator->tracks_ownership()) return nullptr;
+            m_fallbacks.fetch_add(1, std::memory_order_relaxed);
+        }
+        return ::operator new(bytes, std::align_val_t(ALIGNMENT), std::nothrow);
+    }
+
+    void deallocate(void* ptr) {
+        if (!ptr) return;
+        if (m_allocator) {
+            bool owned = locked([&] {
+                if (!m_allocator->owns(ptr)) return false;
+                m_allocator->deallocate(ptr);
+                return true;
+            });
+            if (owned) return;
+        }
+        ::operator delete(ptr, std::align_val_t(ALIGNMENT));
+    }
+
+    BaseAllocator* allocator() const { return m_allocator; }
+    size_t fallback_allocations() const { return m_fallbacks.load(std::memory_order_relaxed); }
+
+private:
+    BaseAllocator* m_allocator;
+    bool m_serialize;
+    std::mutex m_mutex;
+    std::atomic<size_t> m_fallbacks{0};
+};
+
+/**
+ * @class BoundedMPMCQueue
+ * @brief Bounded multi-producer/multi-consumer ring (Dmitry Vyukov's design)
+ *
+ * Each cell carries a sequence number that says whose turn it is, so a
+ * producer and a consumer only contend on the cell they both want, plus one
+ * CAS on their own position counter.
+ */
+template <typename T>
+class BoundedMPMCQueue {
+    static_assert(std::is_trivially_copyable<T>::value, "queue elements must be trivially copyable");
+
+public:
+    /**
+     * @param capacity Rounded up to a power of two (minimum 2)
+     * @param allocator Source of the cell array; nullptr uses operator new
+     */
+    explicit BoundedMPMCQueue(size_t capacity, BaseAllocator* allocator = nullptr)
+        : m_memory(allocator) {
+        m_capacity = MemoryUtils::next_power_of_two(capacity < 2 ? 2 : capacity);
+        m_mask = m_capacity - 1;
+        m_cells = static_cast<Cell*>(m_memory.allocate(m_capacity * sizeof(Cell)));
+        for (size_t i = 0; i < m_capacity; ++i) {
+            new (&m_cells[i]) Cell();
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~BoundedMPMCQueue() {
+        for (size_t i = 0; i < m_capacity; ++i) m_cells[i].~Cell();
+        m_memory.deallocate(m_cells);
+    }
+
+    BoundedMPMCQueue(const BoundedMPMCQueue&) = delete;
+    BoundedMPMCQueue& operator=(const BoundedMPMCQueue&) = delete;
+
+    /**
+     * @brief Append value
+     * @return false if the queue is full
+     */
+    bool try_push(const T& value) {
+        Cell* cell;
+        size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = value;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest value
+     * @return false if the queue is empty (or its head is still being written)
+     */
+    bool try_pop(T& out) {
+        Cell* cell;
+        size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        out = cell->value;
+        cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const { return m_capacity; }
+    const QueueMemory& memory() const { return m_memory; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T value;
+    };
+
+    QueueMemory m_memory;
+    Cell* m_cells = nullptr;
+    size_t m_capacity = 0;
+    size_t m_mask = 0;
+    alignas(MemoryUtils::CACHE_LINE_SIZE) std::atomic<size_t> m_enqueue_pos{0};
+    alignas(MemoryUtils::CACHE_LINE_SIZE) std::atomic<size_t> m_dequeue_pos{0};
+};
+
+/**
+ * @class SPSCQueue
+ * @brief Bounded single-producer/single-consumer ring
+ *
+ * Producer and consumer indices live on separate cache lines, and each side
+ * caches the other's index so the shared line is only re-read when the ring
+ * looks full (producer) or empty (consumer).
+ */
+template <typename T>
+class SPSCQueue {
+    static_assert(std::is_trivially_copyable<T>::value, "queue elements must be trivially copyable");
+
+public:
+    explicit SPSCQueue(size_t capacity, BaseAllocator* allocator = nullptr)
+        : m_memory(allocator) {
+        m_capacity = MemoryUtils::next_power_of_two(capacity < 2 ? 2 : capacity);
+        m_mask = m_capacity - 1;
+        m_slots = static_cast<T*>(m_memory.allocate(m_capacity * sizeof(T)));
+    }
+
+    ~SPSCQueue() { m_memory.deallocate(m_slots); }
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    // Producer thread only
+    bool try_push(const T& value) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cached_head == m_capacity) {
+            m_cached_head = m_head.load(std::memory_order_acquire);
+            if (tail - m_cached_head == m_capacity) return false;
+        }
+        m_slots[tail & m_mask] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread only
+    bool try_pop(T& out) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cached_tail) {
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cached_tail) return false;
+        }
+        out = m_slots[head & m_mask];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const { return m_capacity; }
+    const QueueMemory& memory() const { return m_memory; }
+
+private:
+    QueueMemory m_memory;
+    T* m_slots = nullptr;
+    size_t m_capacity = 0;
+    size_t m_mask = 0;
+    alignas(MemoryUtils::CACHE_LINE_SIZE) std::atomic<size_t> m_head{0};  ///< Consumer line
+    size_t m_cached_tail = 0;
+    alignas(MemoryUtils::CACHE_LINE_SIZE) std::atomic<size_t> m_tail{0};  ///< Producer line
+    size_t m_cached_head = 0;
+};
+
+/**
+ * @class SegmentedQueue
+ * @brief Unbounded MPMC queue of linked array segments
+ *
+ * Producers and consumers claim slots in the tail/head segment with a single
+ * fetch_add; a consumer that reaches a slot before its producer marks it
+ * abandoned and the producer retries in a later slot. Full segments are
+ * linked on demand. Drained segments are retired and freed once no thread is
+ * inside the queue, so memory is reclaimed whenever traffic pauses, and at
+ * destruction at the latest.
+ */
+template <typename T>
+class SegmentedQueue {
+    static_assert(std::is_trivially_copyable<T>::value, "queue elements must be trivially copyable");
+
+public:
+    /**
+     * @param segment_size Slots per segment
+     * @param allocator Source of segments; nullptr uses operator new
+     */
+    explicit SegmentedQueue(size_t segment_size = 1024, BaseAllocator* allocator = nullptr)
+        : m_memory(allocator), m_segment_size(segment_size < 2 ? 2 : segment_size) {
+        Segment* first = new_segment();
+        if (!first) throw std::bad_alloc();
+        m_head.store(first, std::memory_order_relaxed);
+        m_tail.store(first, std::memory_order_relaxed);
+    }
+
+    ~SegmentedQueue() {
+        free_list(m_retired.exchange(nullptr));
+        Segment* segment = m_head.load(std::memory_order_relaxed);
+        while (segment) {
+            Segment* next = segment->next.load(std::memory_order_relaxed);
+            free_segment(segment);
+            segment = next;
+        }
+    }
+
+    SegmentedQueue(const SegmentedQueue&) = delete;
+    SegmentedQueue& operator=(const SegmentedQueue&) = delete;
+
+    /**
+     * @brief Append value
+     * @return false only if no memory is left for a new segment
+     */
+    bool try_push(const T& value) {
+        Guard guard(*this);
+        for (;;) {
+            Segment* tail = m_tail.load(std::memory_order_acquire);
+            size_t index = tail->enqueue_index.fetch_add(1, std::memory_order_acq_rel);
+            if (index < m_segment_size) {
+                Slot& slot = tail->slots()[index];
+                slot.value = value;
+                uint8_t expected = SLOT_EMPTY;
+                if (slot.state.compare_exchange_strong(expected, SLOT_FULL, std::memory_order_acq_rel)) {
+                    return true;
+                }
+                continue; // A consumer gave up on this slot
+            }
+
+            Segment* next = tail->next.load(std::memory_order_acquire);
+            if (!next) {
+                Segment* segment = new_segment();
+                if (!segment) return false;
+                segment->slots()[0].value = value;
+                segment->slots()[0].state.store(SLOT_FULL, std::memory_order_relaxed);
+                segment->enqueue_index.store(1, std::memory_order_relaxed);
+
+                Segment* expected = nullptr;
+                if (tail->next.compare_exchange_strong(expected, segment, std::memory_order_acq_rel)) {
+                    m_tail.compare_exchange_strong(tail, segment, std::memory_order_acq_rel);
+                    return true;
+                }
+                free_segment(segment);
+                next = expected;
+            }
+            m_tail.compare_exchange_strong(tail, next, std::memory_order_acq_rel);
+        }
+    }
+
+    /**
+     * @brief Remove the oldest value
+     * @return false if the queue is empty
+     */
+    bool try_pop(T& out) {
+        Guard guard(*this);
+        for (;;) {
+            Segment* head = m_head.load(std::memory_order_acquire);
+            size_t dequeued = head->dequeue_index.load(std::memory_order_acquire);
+
+            if (dequeued >= m_segment_size) {
+                Segment* next = head->next.load(std::memory_order_acquire);
+                if (!next) return false;
+                if (m_head.compare_exchange_strong(head, next, std::memory_order_acq_rel)) retire(head);
+                continue;
+            }
+            // Claiming a slot nobody has reserved yet would only abandon it
+            if (dequeued >= head->enqueue_index.load(std::memory_order_acquire)) return false;
+
+            size_t index = head->dequeue_index.fetch_add(1, std::memory_order_acq_rel);
+            if (index >= m_segment_size) continue;
+
+            Slot& slot = head->slots()[index];
+            if (slot.state.exchange(SLOT_TAKEN, std::memory_order_acq_rel) == SLOT_FULL) {
+                out = slot.value;
+                return true;
+            }
+        }
+    }
+
+    size_t segment_size() const { return m_segment_size; }
+    const QueueMemory& memory() const { return m_memory; }
+
+private:
+    static constexpr uint8_t SLOT_EMPTY = 0;
+    static constexpr uint8_t SLOT_FULL = 1;
+    static constexpr uint8_t SLOT_TAKEN = 2;  ///< Consumed, or abandoned by a consumer that came early
+
+    struct Slot {
+        std::atomic<uint8_t> state{SLOT_EMPTY};
+        T value;
+    };
+
+    // Header followed by m_segment_size slots in the same allocation
+    struct alignas(MemoryUtils::CACHE_LINE_SIZE) Segment {
+        alignas(MemoryUtils::CACHE_LINE_SIZE) std::atomic<size_t> enqueue_index{0};
+        alignas(MemoryUtils::CACHE_LINE_SIZE) std::atomic<size_t> dequeue_index{0};
+        std::atomic<Segment*> next{nullptr};
+        Segment* retired_next = nullptr;
+
+        Slot* slots() { return reinterpret_cast<Slot*>(this + 1); }
+    };
+
+    // Counts threads inside push/pop; see leave() for how that gates frees
+    class Guard {
+    public:
+        explicit Guard(SegmentedQueue& queue) : m_queue(queue) {
+            m_queue.m_active.fetch_add(1, std::memory_order_seq_cst);
+        }
+        ~Guard() { m_queue.leave(); }
+    private:
+        SegmentedQueue& m_queue;
+    };
+
+    QueueMemory m_memory;
+    size_t m_segment_size;
+    alignas(MemoryUtils::CACHE_LINE_SIZE) std::atomic<Segment*> m_head{nullptr};
+    alignas(MemoryUtils::CACHE_LINE_SIZE) std::atomic<Segment*> m_tail{nullptr};
+    alignas(MemoryUtils::CACHE_LINE_SIZE) std::atomic<size_t> m_active{0};
+    std::atomic<Segment*> m_retired{nullptr};
+
+    // nullptr when out of memory, so try_push can report it
+    Segment* new_segment() {
+        void* memory = m_memory.allocate(sizeof(Segment) + m_segment_size * sizeof(Slot), std::nothrow);
+        if (!memory) return nullptr;
+        Segment* segment = new (memory) Segment();
+        for (size_t i = 0; i < m_segment_size; ++i) new (&segment->slots()[i]) Slot();
+        return segment;
+    }
+
+    void free_segment(Segment* segment) {
+        for (size_t i = 0; i < m_segment_size; ++i) segment->slots()[i].~Slot();
+        segment->~Segment();
+        m_memory.deallocate(segment);
+    }
+
+    void free_list(Segment* segment) {
+        while (segment) {
+            Segment* next = segment->retired_next;
+            free_segment(segment);
+            segment = next;
+        }
+    }
+
+    // Called by the consumer whose CAS unlinked segment from m_head
+    void retire(Segment* segment) {
+        push_retired(segment, segment);
+    }
+
+    void push_retired(Segment* first, Segment* last) {
+        Segment* top = m_retired.load(std::memory_order_relaxed);
+        do {
+            last->retired_next = top;
+        } while (!m_retired.compare_exchange_weak(top, first, std::memory_order_acq_rel));
+    }
+
+    // Segments on the retired list were unlinked before we took the list.
+    // Only threads already inside the queue at that point can still hold
+    // them, so if the active count drops to zero as we leave, all of those
+    // threads are gone and the list can be freed; otherwise put it back.
+    void leave() {
+        Segment* retired = nullptr;
+        if (m_retired.load(std::memory_order_relaxed)) {
+            retired = m_retired.exchange(nullptr, std::memory_order_acq_rel);
+        }
+        if (m_active.fetch_sub(1, std::memory_order_seq_cst) == 1) {
+            free_list(retired);
+        } else if (retired) {
+            Segment* last = retired;
+            while (last->retired_next) last = last->retired_next;
+            push_retired(retired, last);
+        }
+    }
+};
+
+} // namespace memory_engine
+
+#endif // CONCURRENT_QUEUE_HPP
@@ -0,0 +1,215 @@
+/**
+ * @file locks.hpp
+ * @brief Spin and futex locks for the lock contention benchmarks
+ *
+ * Every lock is BasicLockable (lock/unlock), so std::lock_guard works with
+ * all of them.
+ */
+
+#ifndef LOCKS_HPP
+#define LOCKS_HPP
+
+#include "../utils/memory_utils.hpp"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#ifdef _MSC_VER
+#pragma comment(lib, "Synchronization.lib")
+#endif
+#endif
+
+namespace memory_engine {
+
+/**
+ * @class TTASSpinLock
+ * @brief Test-and-test-and-set spinlock with exponential backoff
+ *
+ * Waiters spin on a plain load (the line stays shared in their caches) and
+ * only attempt the exchange once the lock looks free.
+ */
+class TTASSpinLock {
+public:
+    static constexpr unsigned MAX_BACKOFF = 1024;  ///< Pause iterations
+    static constexpr unsigned YIELD_AFTER = 16;    ///< Failed attempts before yielding
+
+    void lock() {
+        unsigned backoff = 1;
+        unsigned attempts = 0;
+        for (;;) {
+            if (!m_locked.exchange(true, std::memory_order_acquire)) return;
+            while (m_locked.load(std::memory_order_relaxed)) {
+                if (++attempts > YIELD_AFTER) {
+                    std::this_thread::yield();
+                } else {
+                    for (unsigned i = 0; i < backoff; ++i) MemoryUtils::cpu_relax();
+                    if (backoff < MAX_BACKOFF) backoff <<= 1;
+                }
+            }
+        }
+    }
+
+    bool try_lock() {
+        return !m_locked.load(std::memory_order_relaxed) && !m_locked.exchange(true, std::memory_order_acquire);
+    }
+
+    void unlock() { m_locked.store(false, std::memory_order_release); }
+
+private:
+    alignas(MemoryUtils::CACHE_LINE_SIZE) std::atomic<bool> m_locked{false};
+};
+
+/**
+ * @class TicketLock
+ * @brief FIFO spinlock: take a ticket, wait until it is served
+ *
+ * Fair, but every release invalidates the serving line in all waiters.
+ * Waiters back off in proportion to their distance from the head.
+ */
+class TicketLock {
+public:
+    void lock() {
+        uint32_t ticket = m_next.fetch_add(1, std::memory_order_relaxed);
+        unsigned attempts = 0;
+        for (;;) {
+            uint32_t serving = m_serving.load(std::memory_order_acquire);
+            if (serving == ticket) return;
+            if (++attempts > 64) {
+                std::this_thread::yield();
+            } else {
+                uint32_t distance = ticket - serving;
+                for (uint32_t i = 0; i < distance * 16; ++i) MemoryUtils::cpu_relax();
+            }
+        }
+    }
+
+    void unlock() {
+        m_serving.store(m_serving.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+private:
+    alignas(MemoryUtils::CACHE_LINE_SIZE) std::atomic<uint32_t> m_next{0};
+    alignas(MemoryUtils::CACHE_LINE_SIZE) std::atomic<uint32_t> m_serving{0};
+};
+
+/**
+ * @class MCSLock
+ * @brief Mellor-Crummey/Scott queue lock
+ *
+ * Each waiter spins on its own node, so a release touches exactly one other
+ * core's cache line. lock(node)/unlock(node) take a caller-provided node;
+ * the plain lock()/unlock() use a per-thread node and so allow only one
+ * MCSLock to be held that way per thread at a time.
+ */
+class MCSLock {
+public:
+    struct alignas(MemoryUtils::CACHE_LINE_SIZE) Node {
+        std::atomic<Node*> next{nullptr};
+        std::atomic<bool> waiting{false};
+    };
+
+    void lock(Node& node) {
+        node.next.store(nullptr, std::memory_order_relaxed);
+        node.waiting.store(true, std::memory_order_relaxed);
+        Node* previous = m_tail.exchange(&node, std::memory_order_acq_rel);
+        if (!previous) return;
+
+        previous->next.store(&node, std::memory_order_release);
+        for (unsigned spins = 0; node.waiting.load(std::memory_order_acquire); ++spins) {
+            if (spins < 256) {
+                MemoryUtils::cpu_relax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void unlock(Node& node) {
+        Node* next = node.next.load(std::memory_order_acquire);
+        if (!next) {
+            Node* expected = &node;
+            if (m_tail.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel)) return;
+            // A successor swapped itself in but has not linked yet
+            while (!(next = node.next.load(std::memory_order_acquire))) MemoryUtils::cpu_relax();
+        }
+        next->waiting.store(false, std::memory_order_release);
+    }
+
+    void lock() { lock(thread_node()); }
+    void unlock() { unlock(thread_node()); }
+
+private:
+    alignas(MemoryUtils::CACHE_LINE_SIZE) std::atomic<Node*> m_tail{nullptr};
+
+    static Node& thread_node() {
+        static thread_local Node node;
+        return node;
+    }
+};
+
+/**
+ * @class FutexLock
+ * @brief Three-state futex mutex (Drepper, "Futexes Are Tricky")
+ *
+ * 0 = unlocked, 1 = locked, 2 = locked with sleepers. Uncontended lock and
+ * unlock are one atomic each; the kernel is only entered to sleep or to wake
+ * a sleeper. Uses futex(2) on Linux and WaitOnAddress on Windows; elsewhere
+ * sleeping degrades to yielding.
+ */
+class FutexLock {
+public:
+    void lock() {
+        uint32_t state = 0;
+        if (m_state.compare_exchange_strong(state, 1, std::memory_order_acquire)) return;
+
+        // Spin briefly before sleeping; most critical sections are short
+        for (int i = 0; i < 100; ++i) {
+            MemoryUtils::cpu_relax();
+            state = 0;
+            if (m_state.compare_exchange_weak(state, 1, std::memory_order_acquire)) return;
+        }
+
+        if (state != 2) state = m_state.exchange(2, std::memory_order_acquire);
+        while (state != 0) {
+            wait(2);
+            state = m_state.exchange(2, std::memory_order_acquire);
+        }
+    }
+
+    void unlock() {
+        if (m_state.exchange(0, std::memory_order_release) == 2) wake_one();
+    }
+
+private:
+    alignas(MemoryUtils::CACHE_LINE_SIZE) std::atomic<uint32_t> m_state{0};
+
+    void wait(uint32_t expected) {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_state), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#elif defined(_WIN32)
+        WaitOnAddress(&m_state, &expected, sizeof(expected), INFINITE);
+#else
+        (void)expected;
+        std::this_thread::yield();
+#endif
+    }
+
+    void wake_one() {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_state), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#elif defined(_WIN32)
+        WakeByAddressSingle(&m_state);
+#endif
+    }
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be a plain 32-bit integer");
+};
+
+} // namespace memory_engine
+
+#endif // LOCKS_HPP
@@ -0,0 +1,319 @@
+/**
+ * @file thread_pool.hpp
+ * @brief Persistent work-stealing thread pool
+ *
+ * Workers are created once and reused, so benchmarks measure the code under
+ * test rather than thread creation. Two ways to run work:
+ *
+ * - submit(): independent tasks. Each worker owns a deque; it pops its own
+ *   newest task and, when empty, steals the oldest task from another worker.
+ * - run_parallel(): one job on N distinct workers at once. Workers meet at a
+ *   start barrier and are released together, and the reported time runs
+ *   from that release until the last worker finishes.
+ */
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include "../utils/memory_utils.hpp"
+#include "../utils/timer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace memory_engine {
+
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    static constexpr size_t MAX_WORKERS = 256;
+
+    /**
+     * @param workers Workers started up front; run_parallel adds more on demand
+     *                (up to MAX_WORKERS)
+     * @param pin_threads Pin worker i to CPU i % hardware_concurrency
+     */
+    explicit ThreadPool(size_t workers = 0, bool pin_threads = false) : m_pin_threads(pin_threads) {
+        ensure_workers(workers);
+    }
+
+    ~ThreadPool() {
+        wait_idle();
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        for (size_t i = 0; i < worker_count(); ++i) m_workers[i]->thread.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return worker_count(); }
+
+    // Starts workers until there are at least count (capped at MAX_WORKERS)
+    void ensure_workers(size_t count) {
+        count = std::min(count, MAX_WORKERS);
+        if (worker_count() >= count) return;
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        for (size_t index = worker_count(); index < count; ++index) {
+            m_workers[index] = std::make_unique<Worker>();
+            m_workers[index]->thread = std::thread([this, index] { worker_loop(index); });
+            if (m_pin_threads) pin(m_workers[index]->thread, index);
+            m_worker_count.store(index + 1, std::memory_order_release);
+        }
+    }
+
+    /**
+     * @brief Pin (or unpin) every worker, current and future
+     *
+     * No-op on platforms without thread affinity.
+     */
+    void set_pinning(bool pin_threads) {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        if (m_pin_threads == pin_threads) return;
+        m_pin_threads = pin_threads;
+        for (size_t i = 0; i < worker_count(); ++i) {
+            if (pin_threads) {
+                pin(m_workers[i]->thread, i);
+            } else {
+                unpin(m_workers[i]->thread);
+            }
+        }
+    }
+
+    bool pinning() const { return m_pin_threads; }
+
+    /**
+     * @brief Queue a task
+     *
+     * From a worker the task goes on that worker's own deque (run next, or
+     * stolen by an idle worker); from outside the pool, on the next deque in
+     * round-robin order.
+     */
+    void submit(Task task) {
+        ensure_workers(1);
+        size_t count = worker_count();
+        size_t target = t_worker_pool == this ? t_worker_index
+                                             : m_next_queue.fetch_add(1, std::memory_order_relaxed) % count;
+        m_unfinished.fetch_add(1, std::memory_order_relaxed);
+        {
+            Worker& worker = *m_workers[target];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+            m_queued++;
+        }
+        m_wake.notify_one();
+    }
+
+    // Blocks until every submitted task has finished
+    void wait_idle() {
+        std::unique_lock<std::mutex> lock(m_sleep_mutex);
+        m_idle.wait(lock, [&] { return m_unfinished.load(std::memory_order_acquire) == 0; });
+    }
+
+    /**
+     * @brief Run fn(index) for index in [0, count) on count distinct workers
+     * @return Nanoseconds from the common release until the last worker returned
+     *
+     * Must not be called from a worker of this pool; count is capped at
+     * MAX_WORKERS. Concurrent callers are served one at a time.
+     */
+    template <typename Fn>
+    double run_parallel(size_t count, Fn&& fn) {
+        count = std::min(count, MAX_WORKERS);
+        if (count == 0) return 0.0;
+        std::lock_guard<std::mutex> serial(m_gang_mutex);
+        ensure_workers(count);
+
+        struct Gang {
+            std::atomic<size_t> arrived{0};
+            std::atomic<bool> go{false};
+            std::vector<uint64_t> finish_ticks;
+        };
+        Gang gang;
+        gang.finish_ticks.assign(count, 0);
+
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+            for (size_t i = 0; i < count; ++i) {
+                m_workers[i]->gang_job = [&gang, &fn, i] {
+                    gang.arrived.fetch_add(1, std::memory_order_acq_rel);
+                    for (unsigned spins = 0; !gang.go.load(std::memory_order_acquire); ++spins) {
+                        if (spins < 64) {
+                            MemoryUtils::cpu_relax();
+                        } else {
+                            std::this_thread::yield();
+                        }
+                    }
+                    fn(i);
+                    gang.finish_ticks[i] = Timer::ticks_end();
+                };
+            }
+            m_gang_pending += count;
+        }
+        m_wake.notify_all();
+
+        while (gang.arrived.load(std::memory_order_acquire) < count) std::this_thread::yield();
+        uint64_t release = Timer::ticks_begin();
+        gang.go.store(true, std::memory_order_release);
+
+        {
+            std::unique_lock<std::mutex> lock(m_sleep_mutex);
+            m_gang_done.wait(lock, [&] { return m_gang_pending == 0; });
+        }
+
+        uint64_t last = release;
+        for (uint64_t ticks : gang.finish_ticks) last = std::max(last, ticks);
+        return Timer::ticks_to_ns(last - release);
+    }
+
+private:
+    struct Worker {
+        std::thread thread;
+        std::mutex mutex;         ///< Guards tasks
+        std::deque<Task> tasks;   ///< Owner pops the back, thieves take the front
+        Task gang_job;            ///< run_parallel job; guarded by m_sleep_mutex
+    };
+
+    // Fixed slots so readers never race with growth; slots below
+    // m_worker_count are immutable once published
+    std::unique_ptr<Worker> m_workers[MAX_WORKERS];
+    std::atomic<size_t> m_worker_count{0};
+    mutable std::mutex m_sleep_mutex;
+    std::mutex m_gang_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_idle;
+    std::condition_variable m_gang_done;
+    size_t m_queued = 0;            ///< Tasks in deques; guarded by m_sleep_mutex
+    size_t m_gang_pending = 0;      ///< run_parallel jobs not yet finished
+    bool m_stopping = false;
+    bool m_pin_threads;
+    std::atomic<size_t> m_unfinished{0};
+    std::atomic<size_t> m_next_queue{0};
+
+    static inline thread_local ThreadPool* t_worker_pool = nullptr;
+    static inline thread_local size_t t_worker_index = 0;
+
+    size_t worker_count() const { return m_worker_count.load(std::memory_order_acquire); }
+
+    void worker_loop(size_t index) {
+        t_worker_pool = this;
+        t_worker_index = index;
+
+        for (;;) {
+            Task task;
+            bool gang = false;
+            {
+                std::unique_lock<std::mutex> lock(m_sleep_mutex);
+                Worker& self = *m_workers[index];
+                m_wake.wait(lock, [&] { return m_stopping || self.gang_job || m_queued > 0; });
+                if (self.gang_job) {
+                    task = std::move(self.gang_job);
+                    self.gang_job = nullptr;
+                    gang = true;
+                } else if (m_queued > 0) {
+                    m_queued--; // Reserve one task; find it below
+                } else {
+                    return; // Stopping with nothing left
+                }
+            }
+
+            if (gang) {
+                task();
+                std::lock_guard<std::mutex> lock(m_sleep_mutex);
+                if (--m_gang_pending == 0) m_gang_done.notify_all();
+                continue;
+            }
+
+            // A reserved task is in some deque; it may take a few passes if
+            // its submitter has bumped m_queued before we look
+            while (!take_task(index, task)) std::this_thread::yield();
+            task();
+            if (m_unfinished.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lock(m_sleep_mutex);
+                m_idle.notify_all();
+            }
+        }
+    }
+
+    // Own deque first (newest task, warm in cache), then steal the oldest
+    // task from the other workers
+    bool take_task(size_t index, Task& out) {
+        size_t count = worker_count();
+        {
+            Worker& self = *m_workers[index];
+            std::lock_guard<std::mutex> lock(self.mutex);
+            if (!self.tasks.empty()) {
+                out = std::move(self.tasks.back());
+                self.tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t offset = 1; offset < count; ++offset) {
+            Worker& victim = *m_workers[(index + offset) % count];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                out = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void pin(std::thread& thread, size_t index) {
+#if defined(__linux__)
+        unsigned cpus = std::max(1u, std::thread::hardware_concurrency());
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(index % cpus, &set);
+        pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#elif defined(_WIN32)
+        unsigned cpus = std::max(1u, std::thread::hardware_concurrency());
+        SetThreadAffinityMask(thread.native_handle(), DWORD_PTR(1) << (index % cpus % (sizeof(DWORD_PTR) * 8)));
+#else
+        (void)thread;
+        (void)index;
+#endif
+    }
+
+    static void unpin(std::thread& thread) {
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        unsigned cpus = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned cpu = 0; cpu < cpus; ++cpu) CPU_SET(cpu, &set);
+        pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#elif defined(_WIN32)
+        DWORD_PTR process_mask, system_mask;
+        if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) {
+            SetThreadAffinityMask(thread.native_handle(), process_mask);
+        }
+#else
+        (void)thread;
+#endif
+    }
+};
+
+} // namespace memory_engine
+
+#endif // THREAD_POOL_HPP
@@ -6,45 +6,156 @@
 #ifndef ENGINE_HPP
 #define ENGINE_HPP
 
+#include "allocators/allocator_adapters.hpp"
+#include "allocators/allocator_registry.hpp"
 #include "allocators/base_allocator.hpp"
+// Allocator headers register themselves as they are included, so this order
+// is the order the registry, the driver and the web UI list them in
 #include "allocators/standard_allocator.hpp"
 #include "allocators/pool_allocator.hpp"
+#include "allocators/bitmap_allocator.hpp"
 #include "allocators/stack_allocator.hpp"
 #include "allocators/freelist_allocator.hpp"
+#include "allocators/thread_cached_pool_allocator.hpp"
+#include "allocators/multi_arena_allocator.hpp"
+#include "allocators/size_class_allocator.hpp"
+#include "allocators/raw_malloc_allocator.hpp"
+#include "allocators/scoped_arena.hpp"
+#include "benchmarks/arena_benchmark.hpp"
+#include "benchmarks/auto_tuner.hpp"
+#include "benchmarks/benchmark_job.hpp"
 #include "benchmarks/benchmark_runner.hpp"
 #include "benchmarks/concurrency_benchmark.hpp"
+#include "benchmarks/locality_benchmark.hpp"
+#include "benchmarks/numa_benchmark.hpp"
+#include "benchmarks/result_report.hpp"
+#include "benchmarks/trace_replay.hpp"
 #include "utils/memory_utils.hpp"
+#include "utils/numa.hpp"
 #include <memory>
 #include <map>
+#include <string>
+#include <vector>
 
 namespace memory_engine {
 
+// Shorthand for the built-in registry entries; other allocators are selected by id
 enum class AllocatorType {
     STANDARD,
     POOL,
     STACK,
-    FREELIST
+    FREELIST,
+    THREAD_CACHED_POOL,
+    SIZE_CLASS,
+    RAW_MALLOC,
+    BITMAP,
+    MULTI_ARENA
 };
 
 enum class ConcurrencyTest {
     MUTEX_CONTENTION,
     ATOMIC_PERFORMANCE,
     PRODUCER_CONSUMER,
-    THREAD_CREATION
+    THREAD_CREATION,
+    COUNTER_CONTENTION,
+    TASK_SCHEDULING,
+    CROSS_THREAD_FREE
 };
 
 class Engine {
 public:
-    Engine() : m_current_allocator(AllocatorType::STANDARD) {
-        initialize_allocators();
+    Engine() : m_registry(AllocatorRegistry::instance()), m_numa_node(Numa::ANY_NODE) {
+        Timer::calibration(); // Calibrate up front rather than inside the first timed run
+        set_allocator(AllocatorType::STANDARD);
+        m_concurrency_bench.set_thread_pool(&m_thread_pool);
+        m_auto_tuner.set_thread_pool(&m_thread_pool);
+    }
+
+    // Registry id of a built-in allocator
+    static const char* allocator_id(AllocatorType type) {
+        switch (type) {
+            case AllocatorType::STANDARD: return "standard";
+            case AllocatorType::POOL: return "pool";
+            case AllocatorType::STACK: return "stack";
+            case AllocatorType::FREELIST: return "freelist";
+            case AllocatorType::THREAD_CACHED_POOL: return "thread_cached_pool";
+            case AllocatorType::SIZE_CLASS: return "size_class";
+            case AllocatorType::RAW_MALLOC: return "raw_malloc";
+            case AllocatorType::BITMAP: return "bitmap";
+            case AllocatorType::MULTI_ARENA: return "multi_arena";
+        }
+        return "";
     }
 
     void set_allocator(AllocatorType type) {
-        m_current_allocator = type;
+        set_allocator(allocator_id(type));
+    }
+
+    // Select a registered allocator; it is constructed on first selection.
+    // Returns false, leaving the selection unchanged, for an unknown id or a
+    // factory that could not build the allocator.
+    bool set_allocator(const std::string& id) {
+        int index = m_registry.index_of(id);
+        if (index < 0 || !instance(static_cast<size_t>(index), Numa::ANY_NODE)) return false;
+        m_current_index = static_cast<size_t>(index);
+        select_current();
+        return true;
     }
 
-    BaseAllocator* get_allocator() {
-        return m_allocators[m_current_allocator].get();
+    // Rebuild an allocator with non-default parameters (missing ones keep
+    // their defaults). Its node-bound copies are rebuilt with them on next
+    // use. Returns false, keeping the old instance, if the id or a parameter
+    // is unknown or the factory fails.
+    bool configure_allocator(const std::string& id, const AllocatorParams& params) {
+        int index = m_registry.index_of(id);
+        if (index < 0) return false;
+        const size_t slot = static_cast<size_t>(index);
+        AllocatorParams unbound = params;
+        unbound.numa_node = Numa::ANY_NODE;
+        auto allocator = AllocatorRegistry::create(m_registry.at(slot), unbound);
+        if (!allocator) return false;
+
+        grow(m_allocators);
+        grow(m_params);
+        m_allocators[slot] = std::move(allocator);
+        m_params[slot] = unbound;
+        for (auto& node_set : m_node_allocators) {
+            if (slot < node_set.second.size()) node_set.second[slot].reset();
+        }
+        if (slot == m_current_index) {
+            m_profiled = nullptr; // Destroyed above, ending its samples
+            select_current();
+        }
+        return true;
+    }
+
+    BaseAllocator* get_allocator() { return m_current; }
+
+    const AllocatorDescriptor& current_descriptor() const { return m_registry.at(m_current_index); }
+
+    // Every allocator the engine can select, in registration order
+    const AllocatorRegistry& registry() const { return m_registry; }
+
+    // Serve NUMA-bindable allocators (pool, stack, free list) from copies
+    // whose arenas are bound to node, created on first use; others keep
+    // their shared instance. Numa::ANY_NODE, or a node that does not exist,
+    // selects the unbound instances.
+    void set_numa_node(int node) {
+        if (node < 0 || node >= Numa::node_count()) node = Numa::ANY_NODE;
+        m_numa_node = node;
+        select_current();
+    }
+
+    int numa_node() const { return m_numa_node; }
+
+    // Per-request allocation bursts: new/delete and StandardAllocator vs. ScopedArena and FrameAllocator
+    std::vector<RequestBurstMetrics> run_request_burst(const RequestBurstConfig& config) {
+        return m_arena_bench.run_request_burst(config);
+    }
+
+    // Local vs. remote allocate-and-touch for every CPU node / memory node pair
+    std::vector<NumaMetrics> run_numa_locality(const NumaConfig& config) {
+        return m_numa_bench.run_matrix(config);
     }
 
     BenchmarkMetrics run_benchmark(const BenchmarkConfig& config) {
@@ -53,22 +164,101 @@ public:
         return m_benchmark_runner.run_allocation_benchmark(*allocator, config);
     }
 
+    std::vector<BenchmarkMetrics> run_thread_scaling(const BenchmarkConfig& config,
+                                                     const std::vector<size_t>& thread_counts) {
+        auto* allocator = get_allocator();
+        if (!allocator) return {};
+        return m_benchmark_runner.run_thread_scaling(*allocator, config, thread_counts);
+    }
+
+    // Vector growth, map churn and string building on the current allocator via each adapter
+    std::vector<ContainerMetrics> run_container_benchmark(const ContainerConfig& config) {
+        auto* allocator = get_allocator();
+        if (!allocator) return {};
+        return m_benchmark_runner.run_container_benchmark(*allocator, config);
+    }
+
+    // List, tree and pointer-table traversals over nodes the current allocator placed
+    std::vector<LocalityMetrics> run_locality(const LocalityConfig& config) {
+        auto* allocator = get_allocator();
+        if (!allocator) return {};
+        return m_locality_bench.run(*allocator, config);
+    }
+
+    TraceReplayMetrics run_trace_replay(const std::string& trace_path, const TraceReplayConfig& config = {}) {
+        auto* allocator = get_allocator();
+        if (!allocator) return {};
+        return m_trace_replayer.replay_file(*allocator, trace_path, config);
+    }
+
+    TraceReplayMetrics run_workload(const WorkloadConfig& workload, const TraceReplayConfig& config = {}) {
+        auto* allocator = get_allocator();
+        if (!allocator) return {};
+        return m_benchmark_runner.run_workload(*allocator, workload, config);
+    }
+
+    // Sweep pool, arena and fit-policy settings over a workload on fresh instances;
+    // independent of the current allocator
+    AutoTuneReport auto_tune(const WorkloadConfig& workload, const AutoTuneConfig& config = {}) {
+        return m_auto_tuner.tune(workload, config);
+    }
+
+    AutoTuneReport auto_tune_trace(const std::string& trace_path, const AutoTuneConfig& config = {}) {
+        return m_auto_tuner.tune_file(trace_path, config);
+    }
+
     ConcurrencyMetrics run_concurrency_test(ConcurrencyTest test, const ConcurrencyConfig& config) {
         switch (test) {
             case ConcurrencyTest::MUTEX_CONTENTION:
                 return m_concurrency_bench.run_mutex_contention(config);
             case ConcurrencyTest::ATOMIC_PERFORMANCE:
                 return m_concurrency_bench.run_atomic_performance(config);
-            case ConcurrencyTest::PRODUCER_CONSUMER:
-                return m_concurrency_bench.run_producer_consumer(config);
+            case ConcurrencyTest::PRODUCER_CONSUMER: {
+                // Lock-free queues take their storage from the selected allocator
+                ConcurrencyConfig queue_config = config;
+                if (!queue_config.queue_allocator) queue_config.queue_allocator = get_allocator();
+                return m_concurrency_bench.run_producer_consumer(queue_config);
+            }
             case ConcurrencyTest::THREAD_CREATION:
                 return m_concurrency_bench.run_thread_creation(config);
+            case ConcurrencyTest::COUNTER_CONTENTION:
+                return m_concurrency_bench.run_counter_contention(config);
+            case ConcurrencyTest::TASK_SCHEDULING:
+                return m_concurrency_bench.run_task_scheduling(config);
+            case ConcurrencyTest::CROSS_THREAD_FREE:
+                return m_concurrency_bench.run_cross_thread_free(with_allocator(config));
         }
         return {};
     }
 
+    // CROSS_THREAD_FREE on the selected allocator at 1, 2, 4, ... pairs
+    std::vector<ConcurrencyMetrics> run_cross_thread_sweep(const ConcurrencyConfig& config) {
+        return m_concurrency_bench.run_cross_thread_sweep(with_allocator(config));
+    }
+
+    // MUTEX_CONTENTION for every LockKind at 1, 2, 4, ... threads
+    std::vector<ConcurrencyMetrics> run_lock_sweep(const ConcurrencyConfig& config) {
+        return m_concurrency_bench.run_lock_sweep(config);
+    }
+
+    // COUNTER_CONTENTION for every layout and memory order
+    std::vector<ConcurrencyMetrics> run_counter_sweep(const ConcurrencyConfig& config) {
+        return m_concurrency_bench.run_counter_sweep(config);
+    }
+
+    // Workers shared by every concurrency benchmark
+    ThreadPool& thread_pool() { return m_thread_pool; }
+
     void set_progress_callback(BenchmarkRunner::ProgressCallback callback) {
         m_benchmark_runner.set_progress_callback(callback);
+        m_trace_replayer.set_progress_callback(callback);
+    }
+
+    // Allocation benchmarks and trace replays stop early once *flag is set;
+    // concurrency tests finish the run they are in
+    void set_cancel_flag(const std::atomic<bool>* flag) {
+        m_benchmark_runner.set_cancel_flag(flag);
+        m_trace_replayer.set_cancel_flag(flag);
     }
 
     void reset_current_allocator() {
@@ -82,25 +272,115 @@ public:
     }
 
     std::vector<bool> get_memory_grid() {
-        if (m_current_allocator == AllocatorType::POOL) {
-            auto* pool = dynamic_cast<PoolAllocator*>(get_allocator());
-            if (pool) return pool->get_allocation_grid();
+        auto* allocator = get_allocator();
+        return allocator ? allocator->get_allocation_grid() : std::vector<bool>{};
+    }
+
+    // Keep an occupancy map on the current allocator and on every allocator
+    // selected after it; disabling stops it on all instances
+    void set_occupancy_tracking(bool enabled) {
+        m_track_occupancy = enabled;
+        if (!enabled) {
+            for (auto& allocator : m_allocators) {
+                if (allocator) allocator->set_occupancy_tracking(false);
+            }
+            for (auto& node_set : m_node_allocators) {
+                for (auto& allocator : node_set.second) {
+                    if (allocator) allocator->set_occupancy_tracking(false);
+                }
+            }
         }
-        return {};
+        select_current();
     }
 
+    // Empty for allocators without an arena (standard, raw malloc) or while tracking is off
+    OccupancyView get_occupancy() {
+        auto* allocator = get_allocator();
+        return allocator ? allocator->occupancy() : OccupancyView{};
+    }
+
+    // Sample the current allocator, and every allocator selected after it,
+    // into one profiler. Enabling again applies config and clears the
+    // profile; disabling keeps it readable. Returns false if the current
+    // allocator refuses a profiler (thread-safe ones, NoStats); later selections
+    // are still profiled.
+    bool set_profiling(bool enabled, const ProfilerConfig& config = {}) {
+        m_profiling = enabled;
+        if (enabled) {
+            if (m_profiler) {
+                m_profiler->configure(config);
+            } else {
+                m_profiler = std::make_unique<AllocationProfiler>(config);
+            }
+        }
+        select_current();
+        return !enabled || m_profiled != nullptr;
+    }
+
+    // nullptr until profiling is first enabled
+    AllocationProfiler* profiler() { return m_profiler.get(); }
+
 private:
-    void initialize_allocators() {
-        m_allocators[AllocatorType::STANDARD] = std::make_unique<StandardAllocator>();
-        m_allocators[AllocatorType::POOL] = std::make_unique<PoolAllocator>(4096, 10000);
-        m_allocators[AllocatorType::STACK] = std::make_unique<StackAllocator>(MemoryUtils::MB(16));
-        m_allocators[AllocatorType::FREELIST] = std::make_unique<FreeListAllocator>(MemoryUtils::MB(16));
+    template <typename T>
+    void grow(std::vector<T>& slots) {
+        if (slots.size() < m_registry.size()) slots.resize(m_registry.size());
+    }
+
+    // The allocator at a registry index for one node (or Numa::ANY_NODE), built on first use
+    BaseAllocator* instance(size_t index, int node) {
+        auto& slots = node == Numa::ANY_NODE ? m_allocators : m_node_allocators[node];
+        grow(slots);
+        if (!slots[index]) {
+            AllocatorParams params = index < m_params.size() ? m_params[index] : AllocatorParams{};
+            params.numa_node = node;
+            slots[index] = AllocatorRegistry::create(m_registry.at(index), params);
+        }
+        return slots[index].get();
+    }
+
+    // The config, with allocator defaulting to the selected one
+    ConcurrencyConfig with_allocator(const ConcurrencyConfig& config) {
+        ConcurrencyConfig bound = config;
+        if (!bound.allocator) bound.allocator = get_allocator();
+        return bound;
+    }
+
+    void select_current() {
+        m_current = nullptr;
+        if (m_numa_node != Numa::ANY_NODE && current_descriptor().capabilities.numa_bindable) {
+            m_current = instance(m_current_index, m_numa_node);
+        }
+        if (!m_current) m_current = instance(m_current_index, Numa::ANY_NODE);
+        if (m_current && m_track_occupancy && !m_current->occupancy().levels) {
+            m_current->set_occupancy_tracking(true);
+        }
+
+        BaseAllocator* profiled = m_profiling ? m_current : nullptr;
+        if (profiled != m_profiled) {
+            if (m_profiled) m_profiled->set_profiler(nullptr);
+            m_profiled = profiled && profiled->set_profiler(m_profiler.get()) ? profiled : nullptr;
+        }
     }
 
-    std::map<AllocatorType, std::unique_ptr<BaseAllocator>> m_allocators;
-    AllocatorType m_current_allocator;
+    const AllocatorRegistry& m_registry;
+    std::unique_ptr<AllocationProfiler> m_profiler;   ///< Declared before the allocators so it outlives them
+    std::vector<std::unique_ptr<BaseAllocator>> m_allocators;   ///< Indexed like the registry
+    std::vector<AllocatorParams> m_params;                       ///< From configure_allocator
+    std::map<int, std::vector<std::unique_ptr<BaseAllocator>>> m_node_allocators;
+    size_t m_current_index = 0;
+    BaseAllocator* m_current = nullptr;
+    int m_numa_node;
+    bool m_track_occupancy = false;
+    bool m_profiling = false;
+    BaseAllocator* m_profiled = nullptr;   ///< Allocator the profiler is attached to
     BenchmarkRunner m_benchmark_runner;
+    TraceReplayer m_trace_replayer;
+    NumaBenchmark m_numa_bench;
+    ArenaBenchmark m_arena_bench;
+    LocalityBenchmark m_locality_bench;
+    ThreadPool m_thread_pool;   // Declared before its user so it outlives it
     ConcurrencyBenchmark m_concurrency_bench;
+    AutoTuner m_auto_tuner;
 };
 
 } // namespace memory_engine
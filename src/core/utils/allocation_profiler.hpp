@@ -0,0 +1,594 @@
+/**
+ * @file allocation_profiler.hpp
+ * @brief Sampling profiler for allocation sites, sizes and lifetimes
+ *
+ * The allocation history keeps the last few thousand events of every
+ * allocation, which is too costly to leave on and too short to show where
+ * memory comes from. The profiler instead samples one allocation in N, or
+ * one per N bytes, and captures its call stack. A sampled block is followed
+ * until it is freed. Samples are aggregated per call site into counts, bytes
+ * and a lifetime histogram, all in memory bounded by the config. Output is
+ * folded stacks for flamegraph.pl or speedscope, or JSON.
+ */
+
+#ifndef ALLOCATION_PROFILER_HPP
+#define ALLOCATION_PROFILER_HPP
+
+#include "memory_utils.hpp"
+#include "ring_buffer.hpp"
+#include "timer.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if !defined(__EMSCRIPTEN__) && (defined(__GLIBC__) || defined(__APPLE__))
+#define MEMORY_ENGINE_PROFILER_BACKTRACE 1
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <cstdlib>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+namespace memory_engine {
+
+enum class SamplingMode {
+    EVERY_NTH,       ///< One allocation in interval, on average
+    BYTE_INTERVAL    ///< One sample per interval bytes allocated, on average
+};
+
+enum class ProfileMetric {
+    ALLOCATIONS,     ///< Estimated allocation count
+    BYTES,           ///< Estimated bytes allocated
+    LIVE_BYTES       ///< Estimated bytes still allocated (leaks, long-lived data)
+};
+
+// What a site's samples suggest it should allocate from
+enum class SiteHint {
+    NONE,
+    POOL,            ///< Every sample had the same size
+    ARENA            ///< Nearly all samples freed, and quickly
+};
+
+struct ProfilerConfig {
+    SamplingMode mode = SamplingMode::BYTE_INTERVAL;
+    size_t interval = 64 * 1024;            ///< Allocations or bytes between samples, on average
+    size_t max_depth = 24;                  ///< Frames kept per stack
+    size_t max_sites = 1024;                ///< Distinct stacks; later ones count under "[other sites]"
+    size_t max_live = 16384;                ///< Sampled blocks followed until freed; more are not sampled
+    size_t timeline_capacity = 1024;        ///< Live-heap points kept
+    uint64_t arena_lifetime_ns = 1000000;   ///< ARENA hint when p90 lifetime is below this
+};
+
+/**
+ * @class LifetimeHistogram
+ * @brief Power-of-two buckets of nanosecond lifetimes, 512 bytes
+ *
+ * LatencyHistogram's precision costs ~30 KB; per site, a factor-of-two
+ * resolution is enough to tell microseconds from seconds.
+ */
+class LifetimeHistogram {
+public:
+    static constexpr size_t BUCKET_COUNT = 64;
+
+    void record(uint64_t ns) {
+        m_counts[ns ? MemoryUtils::floor_log2(ns) : 0]++;
+        m_total++;
+        m_max = std::max(m_max, ns);
+    }
+
+    uint64_t count() const { return m_total; }
+    uint64_t max() const { return m_max; }
+
+    // Upper bound of the bucket holding the percentile, capped at the largest value seen
+    uint64_t percentile(double p) const {
+        if (m_total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(std::max(1.0, p / 100.0 * m_total + 0.5));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += m_counts[i];
+            if (seen >= rank) {
+                uint64_t upper = i >= 63 ? UINT64_MAX : (uint64_t(2) << i) - 1;
+                return std::min(upper, m_max);
+            }
+        }
+        return m_max;
+    }
+
+    const std::array<uint64_t, BUCKET_COUNT>& buckets() const { return m_counts; }
+
+private:
+    std::array<uint64_t, BUCKET_COUNT> m_counts{};
+    uint64_t m_total = 0;
+    uint64_t m_max = 0;
+};
+
+/**
+ * @struct ProfileSite
+ * @brief Aggregated samples of one call stack
+ *
+ * The est_ fields scale samples by their sampling weight back to the whole
+ * allocation stream.
+ */
+struct ProfileSite {
+    uint64_t stack_hash = 0;
+    std::vector<const void*> frames;   ///< Innermost first; empty for "[other sites]"
+    size_t samples = 0;
+    size_t freed_samples = 0;
+    size_t live_samples = 0;
+    size_t min_size = SIZE_MAX;
+    size_t max_size = 0;
+    double est_allocations = 0;
+    double est_bytes = 0;
+    double est_live_bytes = 0;
+    LifetimeHistogram lifetime;        ///< Freed samples only
+    SiteHint hint = SiteHint::NONE;    ///< Brought up to date by AllocationProfiler::sites()
+
+    double value(ProfileMetric metric) const {
+        switch (metric) {
+            case ProfileMetric::ALLOCATIONS: return est_allocations;
+            case ProfileMetric::BYTES: return est_bytes;
+            case ProfileMetric::LIVE_BYTES: return est_live_bytes;
+        }
+        return 0;
+    }
+};
+
+/**
+ * @struct LiveHeapPoint
+ * @brief Estimated live bytes across all sites at one moment
+ */
+struct LiveHeapPoint {
+    uint64_t time_ns = 0;       ///< Since the profiler was configured
+    double live_bytes = 0;
+};
+
+/**
+ * @class AllocationProfiler
+ * @brief Samples allocations of one allocator and follows them until freed
+ *
+ * Attach it with BaseAllocator::set_profiler(). An unsampled allocation
+ * costs a countdown decrement; a free costs nothing while no sampled block
+ * is live, and a hash probe otherwise. Capturing a stack happens only for
+ * samples. Like OccupancyMap, updates are not synchronized, so a profiler
+ * belongs to a single-threaded allocator.
+ *
+ * Intervals are randomized around their mean so a periodic allocation
+ * pattern cannot hide a site between samples.
+ */
+class AllocationProfiler {
+public:
+    explicit AllocationProfiler(const ProfilerConfig& config = {}) { configure(config); }
+
+    AllocationProfiler(const AllocationProfiler&) = delete;
+    AllocationProfiler& operator=(const AllocationProfiler&) = delete;
+
+    // Apply config and drop everything collected so far
+    void configure(const ProfilerConfig& config) {
+        m_config = config;
+        m_config.interval = std::max<size_t>(m_config.interval, 1);
+        m_config.max_live = std::max<size_t>(m_config.max_live, 1);
+        m_live.assign(MemoryUtils::next_power_of_two(m_config.max_live * 2), LiveSample{});
+        m_timeline.set_capacity(m_config.timeline_capacity);
+        reset();
+    }
+
+    const ProfilerConfig& config() const { return m_config; }
+
+    void reset() {
+        m_sites.clear();
+        m_site_index.clear();
+        std::fill(m_live.begin(), m_live.end(), LiveSample{});
+        m_live_count = 0;
+        m_dropped_samples = 0;
+        m_total_live_bytes = 0;
+        m_timeline.clear();
+        m_epoch_ns = Timer::now_ns();
+        m_countdown = next_interval();
+    }
+
+    void on_allocate(void* ptr, size_t size) {
+        size_t step = m_config.mode == SamplingMode::EVERY_NTH ? 1 : size;
+        if (step < m_countdown) {
+            m_countdown -= step;
+            return;
+        }
+        m_countdown = next_interval();
+        sample(ptr, size);
+    }
+
+    void on_free(void* ptr) {
+        if (m_live_count == 0) return;
+        size_t slot = find(reinterpret_cast<uintptr_t>(ptr));
+        if (slot != NPOS) end_sample(slot, Timer::now_ns());
+    }
+
+    // The allocator freed everything at once (reset); live samples end now
+    void on_release_all() {
+        if (m_live_count == 0) return;
+        uint64_t now = Timer::now_ns();
+        for (auto& sample : m_live) {
+            if (sample.address) finish(sample, now);
+        }
+        std::fill(m_live.begin(), m_live.end(), LiveSample{});
+        m_live_count = 0;
+        m_timeline.push_back({now - m_epoch_ns, m_total_live_bytes});
+    }
+
+    // The allocator released [begin, end) at once (stack rollback); live samples in it end now
+    void on_release_range(const void* begin, const void* end) {
+        if (m_live_count == 0) return;
+        const uintptr_t lo = reinterpret_cast<uintptr_t>(begin);
+        const uintptr_t hi = reinterpret_cast<uintptr_t>(end);
+        uint64_t now = Timer::now_ns();
+
+        // Rebuild rather than delete in place: shifting entries while
+        // scanning could move one past the cursor or back over it
+        std::vector<LiveSample> kept;
+        for (auto& sample : m_live) {
+            if (!sample.address) continue;
+            if (sample.address >= lo && sample.address < hi) {
+                finish(sample, now);
+            } else {
+                kept.push_back(sample);
+            }
+        }
+        if (kept.size() == m_live_count) return;
+
+        std::fill(m_live.begin(), m_live.end(), LiveSample{});
+        m_live_count = 0;
+        for (const auto& sample : kept) insert(sample);
+        m_timeline.push_back({now - m_epoch_ns, m_total_live_bytes});
+    }
+
+    /**
+     * @brief Every site, with hints brought up to date
+     * @return Sites in first-sampled order; index 0 may be "[other sites]"
+     */
+    const std::vector<ProfileSite>& sites() const {
+        for (auto& site : m_sites) site.hint = hint_of(site);
+        return m_sites;
+    }
+
+    // Indices into sites(), largest metric first, at most limit (0 = all)
+    std::vector<size_t> top_sites(ProfileMetric metric, size_t limit = 0) const {
+        std::vector<size_t> order(m_sites.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return m_sites[a].value(metric) > m_sites[b].value(metric);
+        });
+        if (limit && order.size() > limit) order.resize(limit);
+        return order;
+    }
+
+    size_t live_samples() const { return m_live_count; }
+    size_t dropped_samples() const { return m_dropped_samples; }   ///< Skipped because max_live was reached
+    double live_bytes() const { return m_total_live_bytes; }
+    const RingBuffer<LiveHeapPoint>& timeline() const { return m_timeline; }
+
+    /**
+     * @brief Folded stacks: one "outer;...;inner value" line per site
+     *
+     * The format flamegraph.pl, inferno and speedscope read. Values are
+     * rounded estimates of metric; sites that round to 0 are left out.
+     */
+    std::string folded(ProfileMetric metric = ProfileMetric::BYTES) const {
+        std::string out;
+        for (const auto& site : m_sites) {
+            uint64_t value = static_cast<uint64_t>(site.value(metric) + 0.5);
+            if (value == 0) continue;
+            out += folded_stack(site);
+            out += ' ';
+            out += std::to_string(value);
+            out += '\n';
+        }
+        return out;
+    }
+
+    // Summary, the top limit sites by bytes with symbolized stacks, and the timeline
+    std::string to_json(size_t limit = 50) const {
+        sites();
+        std::string out = "{\"mode\":\"";
+        out += m_config.mode == SamplingMode::EVERY_NTH ? "every_nth" : "byte_interval";
+        out += "\",\"interval\":" + std::to_string(m_config.interval) +
+            ",\"live_samples\":" + std::to_string(m_live_count) +
+            ",\"dropped_samples\":" + std::to_string(m_dropped_samples) +
+            ",\"live_bytes\":" + number(m_total_live_bytes) + ",\"sites\":[";
+        bool first = true;
+        for (size_t index : top_sites(ProfileMetric::BYTES, limit)) {
+            const ProfileSite& site = m_sites[index];
+            if (!first) out += ',';
+            first = false;
+            out += "{\"stack\":[";
+            for (size_t f = 0; f < site.frames.size(); ++f) {
+                if (f) out += ',';
+                out += quote(symbolize(site.frames[f]));
+            }
+            out += "],\"samples\":" + std::to_string(site.samples) +
+                ",\"freed_samples\":" + std::to_string(site.freed_samples) +
+                ",\"live_samples\":" + std::to_string(site.live_samples) +
+                ",\"min_size\":" + std::to_string(site.samples ? site.min_size : 0) +
+                ",\"max_size\":" + std::to_string(site.max_size) +
+                ",\"allocations\":" + number(site.est_allocations) +
+                ",\"bytes\":" + number(site.est_bytes) +
+                ",\"live_bytes\":" + number(site.est_live_bytes) +
+                ",\"lifetime_p50_ns\":" + std::to_string(site.lifetime.percentile(50.0)) +
+                ",\"lifetime_p90_ns\":" + std::to_string(site.lifetime.percentile(90.0)) +
+                ",\"lifetime_p99_ns\":" + std::to_string(site.lifetime.percentile(99.0)) +
+                ",\"lifetime_log2\":[";
+            const auto& buckets = site.lifetime.buckets();
+            size_t used = buckets.size();
+            while (used > 0 && buckets[used - 1] == 0) used--;
+            for (size_t b = 0; b < used; ++b) {
+                if (b) out += ',';
+                out += std::to_string(buckets[b]);
+            }
+            out += "],\"hint\":\"";
+            out += hint_name(site.hint);
+            out += "\"}";
+        }
+        out += "],\"timeline\":[";
+        for (size_t i = 0; i < m_timeline.size(); ++i) {
+            if (i) out += ',';
+            out += "[" + std::to_string(m_timeline[i].time_ns) + "," + number(m_timeline[i].live_bytes) + "]";
+        }
+        out += "]}";
+        return out;
+    }
+
+    // Root-first frame names joined with ';', ready for folded output
+    std::string folded_stack(const ProfileSite& site) const {
+        if (site.frames.empty()) return "[other sites]";
+        std::string stack;
+        for (size_t f = site.frames.size(); f > 0; --f) {
+            std::string name = symbolize(site.frames[f - 1]);
+            std::replace(name.begin(), name.end(), ';', ':');
+            if (!stack.empty()) stack += ';';
+            stack += name;
+        }
+        return stack;
+    }
+
+    // Demangled function name, "module+0x..." without symbols, or a raw address
+    std::string symbolize(const void* frame) const {
+        auto cached = m_symbols.find(frame);
+        if (cached != m_symbols.end()) return cached->second;
+
+        char address[32];
+        std::snprintf(address, sizeof(address), "%p", frame);
+        std::string name = address;
+#ifdef MEMORY_ENGINE_PROFILER_BACKTRACE
+        Dl_info info;
+        if (dladdr(frame, &info)) {
+            if (info.dli_sname) {
+                int status = 0;
+                char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+                name = status == 0 && demangled ? demangled : info.dli_sname;
+                std::free(demangled);
+            } else if (info.dli_fname) {
+                std::string module = info.dli_fname;
+                size_t slash = module.find_last_of('/');
+                if (slash != std::string::npos) module = module.substr(slash + 1);
+                std::snprintf(address, sizeof(address), "+0x%zx",
+                              static_cast<size_t>(static_cast<const char*>(frame) -
+                                                  static_cast<const char*>(info.dli_fbase)));
+                name = module + address;
+            }
+        }
+#endif
+        m_symbols.emplace(frame, name);
+        return name;
+    }
+
+    static const char* hint_name(SiteHint hint) {
+        switch (hint) {
+            case SiteHint::NONE: return "none";
+            case SiteHint::POOL: return "pool";
+            case SiteHint::ARENA: return "arena";
+        }
+        return "none";
+    }
+
+private:
+    static constexpr size_t NPOS = SIZE_MAX;
+    static constexpr size_t MAX_CAPTURE = 64;
+    static constexpr size_t SKIPPED_FRAMES = 2;   ///< capture_stack and sample
+
+    struct LiveSample {
+        uintptr_t address = 0;   ///< 0 = empty slot
+        uint32_t site = 0;
+        size_t size = 0;
+        double weight = 0;       ///< Allocations this sample stands for
+        uint64_t start_ns = 0;
+    };
+
+    ProfilerConfig m_config;
+    mutable std::vector<ProfileSite> m_sites;
+    std::unordered_map<uint64_t, uint32_t> m_site_index;   ///< Stack hash -> index into m_sites
+    std::vector<LiveSample> m_live;                        ///< Linear probing, no tombstones
+    size_t m_live_count = 0;
+    size_t m_dropped_samples = 0;
+    double m_total_live_bytes = 0;
+    RingBuffer<LiveHeapPoint> m_timeline;
+    uint64_t m_epoch_ns = 0;
+    size_t m_countdown = 0;
+    uint64_t m_rng = 0x9E3779B97F4A7C15ull;
+    mutable std::unordered_map<const void*, std::string> m_symbols;
+
+    // Uniform in [1, 2 * interval - 1], so the mean is interval
+    size_t next_interval() {
+        m_rng ^= m_rng << 13;
+        m_rng ^= m_rng >> 7;
+        m_rng ^= m_rng << 17;
+        return 1 + static_cast<size_t>(m_rng % (2 * m_config.interval - 1));
+    }
+
+    static size_t hash_address(uintptr_t address) {
+        uint64_t h = static_cast<uint64_t>(address) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(h ^ (h >> 29));
+    }
+
+    size_t find(uintptr_t address) const {
+        size_t mask = m_live.size() - 1;
+        for (size_t slot = hash_address(address) & mask;; slot = (slot + 1) & mask) {
+            if (m_live[slot].address == address) return slot;
+            if (m_live[slot].address == 0) return NPOS;
+        }
+    }
+
+#if defined(__GNUC__) || defined(__clang__)
+    __attribute__((noinline))
+#endif
+    size_t capture_stack(void** frames, size_t max_frames) const {
+#if defined(MEMORY_ENGINE_PROFILER_BACKTRACE)
+        int captured = backtrace(frames, static_cast<int>(max_frames));
+        return captured > 0 ? static_cast<size_t>(captured) : 0;
+#elif defined(_WIN32)
+        return CaptureStackBackTrace(0, static_cast<DWORD>(max_frames), frames, nullptr);
+#else
+        (void)frames; (void)max_frames;
+        return 0;
+#endif
+    }
+
+#if defined(__GNUC__) || defined(__clang__)
+    __attribute__((noinline))
+#endif
+    void sample(void* ptr, size_t size) {
+        const uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+        if (!address) return;
+
+        // A block of the allocator's that was released without a free (or a
+        // foreign reuse of the address) ends the stale sample first
+        size_t stale = find(address);
+        if (stale != NPOS) end_sample(stale, Timer::now_ns());
+        if (m_live_count >= m_config.max_live) {
+            m_dropped_samples++;
+            return;
+        }
+
+        void* frames[MAX_CAPTURE];
+        size_t depth = capture_stack(frames, std::min(MAX_CAPTURE, m_config.max_depth + SKIPPED_FRAMES));
+        size_t skip = std::min(depth, SKIPPED_FRAMES);
+        uint32_t site_index = site_for(frames + skip, depth - skip);
+
+        double weight = m_config.interval;
+        if (m_config.mode == SamplingMode::BYTE_INTERVAL) {
+            weight = std::max(1.0, static_cast<double>(m_config.interval) / std::max<size_t>(size, 1));
+        }
+        ProfileSite& site = m_sites[site_index];
+        site.samples++;
+        site.live_samples++;
+        site.min_size = std::min(site.min_size, size);
+        site.max_size = std::max(site.max_size, size);
+        site.est_allocations += weight;
+        site.est_bytes += weight * size;
+        site.est_live_bytes += weight * size;
+        m_total_live_bytes += weight * size;
+
+        uint64_t now = Timer::now_ns();
+        insert({address, site_index, size, weight, now});
+        m_timeline.push_back({now - m_epoch_ns, m_total_live_bytes});
+    }
+
+    void insert(const LiveSample& sample) {
+        size_t mask = m_live.size() - 1;
+        size_t slot = hash_address(sample.address) & mask;
+        while (m_live[slot].address) slot = (slot + 1) & mask;
+        m_live[slot] = sample;
+        m_live_count++;
+    }
+
+    // Lifetime and live bytes of one sample that ended at now
+    void finish(const LiveSample& sample, uint64_t now) {
+        ProfileSite& site = m_sites[sample.site];
+        double bytes = sample.weight * sample.size;
+        site.freed_samples++;
+        site.live_samples--;
+        site.est_live_bytes = std::max(0.0, site.est_live_bytes - bytes);
+        m_total_live_bytes = std::max(0.0, m_total_live_bytes - bytes);
+        site.lifetime.record(now > sample.start_ns ? now - sample.start_ns : 0);
+    }
+
+    void end_sample(size_t slot, uint64_t now) {
+        finish(m_live[slot], now);
+        m_timeline.push_back({now - m_epoch_ns, m_total_live_bytes});
+
+        // Backward-shift deletion keeps every probe chain unbroken
+        size_t mask = m_live.size() - 1;
+        size_t hole = slot;
+        for (size_t next = (hole + 1) & mask; m_live[next].address; next = (next + 1) & mask) {
+            size_t home = hash_address(m_live[next].address) & mask;
+            // Move next into the hole unless its home lies cyclically in (hole, next]
+            bool stays = hole <= next ? (home > hole && home <= next) : (home > hole || home <= next);
+            if (!stays) {
+                m_live[hole] = m_live[next];
+                hole = next;
+            }
+        }
+        m_live[hole] = LiveSample{};
+        m_live_count--;
+    }
+
+    uint32_t site_for(void* const* frames, size_t depth) {
+        uint64_t hash = 0xCBF29CE484222325ull;
+        for (size_t i = 0; i < depth; ++i) {
+            hash ^= static_cast<uint64_t>(reinterpret_cast<uintptr_t>(frames[i]));
+            hash *= 0x100000001B3ull;
+        }
+
+        auto it = m_site_index.find(hash);
+        if (it != m_site_index.end()) return it->second;
+
+        if (m_sites.size() + 1 >= std::max<size_t>(m_config.max_sites, 1)) {
+            // Out of sites: one shared bucket, keyed by the hash no stack produces
+            auto other = m_site_index.find(0);
+            if (other != m_site_index.end()) return other->second;
+            m_sites.emplace_back();
+            m_site_index.emplace(0, static_cast<uint32_t>(m_sites.size() - 1));
+            return static_cast<uint32_t>(m_sites.size() - 1);
+        }
+
+        ProfileSite site;
+        site.stack_hash = hash;
+        site.frames.assign(frames, frames + depth);
+        m_sites.push_back(std::move(site));
+        m_site_index.emplace(hash, static_cast<uint32_t>(m_sites.size() - 1));
+        return static_cast<uint32_t>(m_sites.size() - 1);
+    }
+
+    SiteHint hint_of(const ProfileSite& site) const {
+        if (site.samples < 2) return SiteHint::NONE;
+        if (site.freed_samples * 10 >= site.samples * 9 &&
+            site.lifetime.percentile(90.0) < m_config.arena_lifetime_ns) {
+            return SiteHint::ARENA;
+        }
+        if (site.min_size == site.max_size) return SiteHint::POOL;
+        return SiteHint::NONE;
+    }
+
+    static std::string number(double value) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.0f", value);
+        return buffer;
+    }
+
+    static std::string quote(const std::string& text) {
+        std::string out = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\') out += '\\';
+            if (static_cast<unsigned char>(c) >= 0x20) out += c;
+        }
+        return out + "\"";
+    }
+};
+
+} // namespace memory_engine
+
+#endif // ALLOCATION_PROFILER_HPP
@@ -0,0 +1,184 @@
+/**
+ * @file histogram.hpp
+ * @brief Fixed-memory log-linear latency histogram
+ */
+
+#ifndef HISTOGRAM_HPP
+#define HISTOGRAM_HPP
+
+#include "memory_utils.hpp"
+#include "statistics.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+namespace memory_engine {
+
+// HDR-style histogram of nanosecond values. Values below 2^SUB_BUCKET_BITS
+// are counted exactly; every power of two above that is split into
+// 2^(SUB_BUCKET_BITS-1) linear sub-buckets, so any recorded value is reported
+// within 1/64 (~1.6%) of its true value across the full 64-bit range. The
+// bucket array is fixed (~30 KB), so recording never allocates and two
+// histograms merge by adding counts.
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 7;
+    static constexpr uint64_t SUB_BUCKET_COUNT = 1ull << SUB_BUCKET_BITS;       ///< Exact range [0, 128)
+    static constexpr uint64_t SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;           ///< Sub-buckets per octave
+    static constexpr size_t BUCKET_COUNT =
+        SUB_BUCKET_COUNT + (64 - SUB_BUCKET_BITS) * SUB_BUCKET_HALF;
+
+    void record(uint64_t value_ns) {
+        record_n(value_ns, 1);
+    }
+
+    void record(double value_ns) {
+        record_n(value_ns <= 0 ? 0 : static_cast<uint64_t>(value_ns + 0.5), 1);
+    }
+
+    // Records count occurrences of the same value (e.g. a batch split evenly)
+    void record_n(uint64_t value_ns, uint64_t count) {
+        if (count == 0) return;
+        m_counts[bucket_index(value_ns)] += count;
+        m_total += count;
+        m_min = std::min(m_min, value_ns);
+        m_max = std::max(m_max, value_ns);
+        double v = static_cast<double>(value_ns);
+        m_sum += v * count;
+        m_sum_squares += v * v * count;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        if (other.m_total == 0) return;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) m_counts[i] += other.m_counts[i];
+        m_total += other.m_total;
+        m_min = std::min(m_min, other.m_min);
+        m_max = std::max(m_max, other.m_max);
+        m_sum += other.m_sum;
+        m_sum_squares += other.m_sum_squares;
+    }
+
+    void reset() {
+        m_counts.fill(0);
+        m_total = 0;
+        m_min = UINT64_MAX;
+        m_max = 0;
+        m_sum = 0;
+        m_sum_squares = 0;
+    }
+
+    uint64_t count() const { return m_total; }
+    uint64_t min() const { return m_total ? m_min : 0; }
+    uint64_t max() const { return m_max; }
+    double mean() const { return m_total ? m_sum / m_total : 0.0; }
+
+    double std_dev() const {
+        if (m_total == 0) return 0.0;
+        double m = mean();
+        return std::sqrt(std::max(0.0, m_sum_squares / m_total - m * m));
+    }
+
+    // Value at percentile (0-100); the midpoint of the containing bucket,
+    // clamped to the recorded min/max so p0 and p100 are exact
+    double percentile(double percent) const {
+        if (m_total == 0) return 0.0;
+        if (percent >= 100.0) return static_cast<double>(m_max);
+
+        uint64_t rank = static_cast<uint64_t>(std::ceil(percent / 100.0 * m_total));
+        rank = std::max<uint64_t>(rank, 1);
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += m_counts[i];
+            if (seen >= rank) {
+                double mid = (static_cast<double>(bucket_lower(i)) + static_cast<double>(bucket_upper(i))) / 2.0;
+                return std::min(std::max(mid, static_cast<double>(min())), static_cast<double>(m_max));
+            }
+        }
+        return static_cast<double>(m_max);
+    }
+
+    // Summary in the same shape the sample-based Statistics::analyze returns
+    BenchmarkResult summarize() const {
+        BenchmarkResult result;
+        result.sample_count = static_cast<size_t>(m_total);
+        if (m_total == 0) return result;
+        result.mean = mean();
+        result.std_dev = std_dev();
+        result.min = static_cast<double>(min());
+        result.max = static_cast<double>(m_max);
+        result.median = percentile(50.0);
+        result.p95 = percentile(95.0);
+        result.p99 = percentile(99.0);
+        result.p999 = percentile(99.9);
+        Statistics::set_confidence_interval(result);
+        return result;
+    }
+
+    // Visits non-empty buckets in increasing order: fn(lower_ns, upper_ns, count)
+    template <typename Fn>
+    void for_each_bucket(Fn&& fn) const {
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            if (m_counts[i]) fn(bucket_lower(i), bucket_upper(i), m_counts[i]);
+        }
+    }
+
+    // {"count":..,"min":..,...,"buckets":[[lower,upper,count],...]}
+    std::string to_json() const {
+        std::string out = "{\"count\":" + std::to_string(m_total) +
+            ",\"min\":" + std::to_string(min()) +
+            ",\"max\":" + std::to_string(m_max) +
+            ",\"mean\":" + std::to_string(mean()) +
+            ",\"p50\":" + std::to_string(percentile(50.0)) +
+            ",\"p90\":" + std::to_string(percentile(90.0)) +
+            ",\"p99\":" + std::to_string(percentile(99.0)) +
+            ",\"p999\":" + std::to_string(percentile(99.9)) +
+            ",\"buckets\":[";
+        bool first = true;
+        for_each_bucket([&](uint64_t lower, uint64_t upper, uint64_t count) {
+            if (!first) out += ',';
+            first = false;
+            out += '[' + std::to_string(lower) + ',' + std::to_string(upper) + ',' + std::to_string(count) + ']';
+        });
+        out += "]}";
+        return out;
+    }
+
+    static size_t bucket_index(uint64_t value) {
+        if (value < SUB_BUCKET_COUNT) return static_cast<size_t>(value);
+        unsigned exponent = MemoryUtils::floor_log2(value);
+        unsigned shift = exponent - (SUB_BUCKET_BITS - 1);
+        uint64_t sub = (value >> shift) - SUB_BUCKET_HALF; // in [0, SUB_BUCKET_HALF)
+        return static_cast<size_t>(SUB_BUCKET_COUNT + (exponent - SUB_BUCKET_BITS) * SUB_BUCKET_HALF + sub);
+    }
+
+    static uint64_t bucket_lower(size_t index) {
+        if (index < SUB_BUCKET_COUNT) return index;
+        size_t octave = (index - SUB_BUCKET_COUNT) / SUB_BUCKET_HALF;
+        uint64_t sub = (index - SUB_BUCKET_COUNT) % SUB_BUCKET_HALF;
+        unsigned shift = static_cast<unsigned>(octave) + 1;
+        return (SUB_BUCKET_HALF + sub) << shift;
+    }
+
+    // Inclusive upper bound
+    static uint64_t bucket_upper(size_t index) {
+        if (index < SUB_BUCKET_COUNT) return index;
+        size_t octave = (index - SUB_BUCKET_COUNT) / SUB_BUCKET_HALF;
+        unsigned shift = static_cast<unsigned>(octave) + 1;
+        return bucket_lower(index) + ((uint64_t{1} << shift) - 1);
+    }
+
+private:
+    std::array<uint64_t, BUCKET_COUNT> m_counts{};
+    uint64_t m_total = 0;
+    uint64_t m_min = UINT64_MAX;
+    uint64_t m_max = 0;
+    double m_sum = 0;
+    double m_sum_squares = 0;
+};
+
+} // namespace memory_engine
+
+#endif // HISTOGRAM_HPP
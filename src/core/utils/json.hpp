@@ -0,0 +1,233 @@
+/**
+ * @file json.hpp
+ * @brief Minimal JSON value and parser, for reading back our own exports
+ *
+ * Writers in this repo build JSON by string concatenation (see
+ * LatencyHistogram::to_json). This is the other direction, just enough to
+ * load a baseline result file: objects, arrays, strings with the usual
+ * escapes, numbers, booleans and null. Errors return false with a message;
+ * nothing throws.
+ */
+
+#ifndef JSON_HPP
+#define JSON_HPP
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace memory_engine {
+
+class JsonValue {
+public:
+    enum class Type { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+    Type type() const { return m_type; }
+    bool is_object() const { return m_type == Type::OBJECT; }
+    bool is_array() const { return m_type == Type::ARRAY; }
+
+    double number(double fallback = 0) const { return m_type == Type::NUMBER ? m_number : fallback; }
+    bool boolean(bool fallback = false) const { return m_type == Type::BOOLEAN ? m_boolean : fallback; }
+    const std::string& string() const { return m_string; }
+    const std::vector<JsonValue>& items() const { return m_items; }
+    const std::vector<std::pair<std::string, JsonValue>>& members() const { return m_members; }
+
+    /**
+     * @brief Member of an object, or a null value when missing
+     */
+    const JsonValue& operator[](const std::string& key) const {
+        static const JsonValue null_value;
+        for (const auto& member : m_members) {
+            if (member.first == key) return member.second;
+        }
+        return null_value;
+    }
+
+    /**
+     * @brief Parse a complete document
+     * @param error Receives a message with the byte offset on failure
+     */
+    static bool parse(const std::string& text, JsonValue& out, std::string* error = nullptr) {
+        Parser parser{text, 0, {}};
+        out = JsonValue();
+        bool ok = parser.value(out, 0);
+        if (ok) {
+            parser.skip_space();
+            if (parser.pos != text.size()) ok = parser.fail("trailing characters");
+        }
+        if (!ok && error) *error = parser.error;
+        return ok;
+    }
+
+    // Quoted and escaped for embedding in JSON output
+    static std::string quote(const std::string& text) {
+        std::string out = "\"";
+        for (unsigned char c : text) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (c < 0x20) {
+                        char buffer[8];
+                        std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                        out += buffer;
+                    } else {
+                        out += static_cast<char>(c);
+                    }
+            }
+        }
+        return out + "\"";
+    }
+
+private:
+    static constexpr int MAX_DEPTH = 64;
+
+    Type m_type = Type::NUL;
+    bool m_boolean = false;
+    double m_number = 0;
+    std::string m_string;
+    std::vector<JsonValue> m_items;
+    std::vector<std::pair<std::string, JsonValue>> m_members; ///< In document order
+
+    struct Parser {
+        const std::string& text;
+        size_t pos;
+        std::string error;
+
+        bool fail(const char* message) {
+            error = std::string(message) + " at offset " + std::to_string(pos);
+            return false;
+        }
+
+        void skip_space() {
+            while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' ||
+                                         text[pos] == '\n' || text[pos] == '\r')) {
+                pos++;
+            }
+        }
+
+        bool literal(const char* word) {
+            size_t length = std::char_traits<char>::length(word);
+            if (text.compare(pos, length, word) != 0) return fail("invalid literal");
+            pos += length;
+            return true;
+        }
+
+        bool value(JsonValue& out, int depth) {
+            if (depth > MAX_DEPTH) return fail("nesting too deep");
+            skip_space();
+            if (pos >= text.size()) return fail("unexpected end");
+
+            char c = text[pos];
+            if (c == '{') return object(out, depth);
+            if (c == '[') return array(out, depth);
+            if (c == '"') {
+                out.m_type = Type::STRING;
+                return string(out.m_string);
+            }
+            if (c == 't' || c == 'f') {
+                out.m_type = Type::BOOLEAN;
+                out.m_boolean = c == 't';
+                return literal(c == 't' ? "true" : "false");
+            }
+            if (c == 'n') return literal("null");
+            return number(out);
+        }
+
+        bool object(JsonValue& out, int depth) {
+            out.m_type = Type::OBJECT;
+            pos++;
+            skip_space();
+            if (pos < text.size() && text[pos] == '}') { pos++; return true; }
+            while (true) {
+                skip_space();
+                std::string key;
+                if (pos >= text.size() || text[pos] != '"' || !string(key)) return fail("expected member name");
+                skip_space();
+                if (pos >= text.size() || text[pos] != ':') return fail("expected ':'");
+                pos++;
+                out.m_members.emplace_back(std::move(key), JsonValue());
+                if (!value(out.m_members.back().second, depth + 1)) return false;
+                skip_space();
+                if (pos < text.size() && text[pos] == ',') { pos++; continue; }
+                if (pos < text.size() && text[pos] == '}') { pos++; return true; }
+                return fail("expected ',' or '}'");
+            }
+        }
+
+        bool array(JsonValue& out, int depth) {
+            out.m_type = Type::ARRAY;
+            pos++;
+            skip_space();
+            if (pos < text.size() && text[pos] == ']') { pos++; return true; }
+            while (true) {
+                out.m_items.emplace_back();
+                if (!value(out.m_items.back(), depth + 1)) return false;
+                skip_space();
+                if (pos < text.size() && text[pos] == ',') { pos++; continue; }
+                if (pos < text.size() && text[pos] == ']') { pos++; return true; }
+                return fail("expected ',' or ']'");
+            }
+        }
+
+        // \uXXXX is decoded to UTF-8; surrogate pairs are not combined
+        bool string(std::string& out) {
+            pos++;
+            while (pos < text.size()) {
+                char c = text[pos++];
+                if (c == '"') return true;
+                if (c != '\\') { out += c; continue; }
+                if (pos >= text.size()) break;
+                char escape = text[pos++];
+                switch (escape) {
+                    case '"': out += '"'; break;
+                    case '\\': out += '\\'; break;
+                    case '/': out += '/'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'n': out += '\n'; break;
+                    case 'r': out += '\r'; break;
+                    case 't': out += '\t'; break;
+                    case 'u': {
+                        if (pos + 4 > text.size()) return fail("truncated \\u escape");
+                        unsigned long code = std::strtoul(text.substr(pos, 4).c_str(), nullptr, 16);
+                        pos += 4;
+                        if (code < 0x80) {
+                            out += static_cast<char>(code);
+                        } else if (code < 0x800) {
+                            out += static_cast<char>(0xC0 | (code >> 6));
+                            out += static_cast<char>(0x80 | (code & 0x3F));
+                        } else {
+                            out += static_cast<char>(0xE0 | (code >> 12));
+                            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                            out += static_cast<char>(0x80 | (code & 0x3F));
+                        }
+                        break;
+                    }
+                    default: return fail("invalid escape");
+                }
+            }
+            return fail("unterminated string");
+        }
+
+        bool number(JsonValue& out) {
+            const char* begin = text.c_str() + pos;
+            char* end = nullptr;
+            double parsed = std::strtod(begin, &end);
+            if (end == begin) return fail("unexpected character");
+            out.m_type = Type::NUMBER;
+            out.m_number = parsed;
+            pos += static_cast<size_t>(end - begin);
+            return true;
+        }
+    };
+};
+
+} // namespace memory_engine
+
+#endif // JSON_HPP
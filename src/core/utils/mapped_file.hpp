@@ -0,0 +1,115 @@
+/**
+ * @file mapped_file.hpp
+ * @brief Read-only memory-mapped file
+ */
+
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace memory_engine {
+
+// Maps a whole file read-only so large inputs are paged in on demand
+// instead of being loaded up front.
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path) { open(path); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+
+        #ifdef _WIN32
+        m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                             OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(m_file, &size)) { close(); return false; }
+        m_size = static_cast<size_t>(size.QuadPart);
+        if (m_size == 0) return true;
+
+        m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m_mapping) { close(); return false; }
+        m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!m_data) { close(); return false; }
+        #else
+        m_fd = ::open(path.c_str(), O_RDONLY);
+        if (m_fd < 0) return false;
+
+        struct stat st;
+        if (fstat(m_fd, &st) != 0) { close(); return false; }
+        m_size = static_cast<size_t>(st.st_size);
+        if (m_size == 0) return true;
+
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+        if (data == MAP_FAILED) { close(); return false; }
+        m_data = static_cast<const uint8_t*>(data);
+        #ifdef MADV_SEQUENTIAL
+        madvise(data, m_size, MADV_SEQUENTIAL);
+        #endif
+        #endif
+
+        return true;
+    }
+
+    void close() {
+        #ifdef _WIN32
+        if (m_data) UnmapViewOfFile(m_data);
+        if (m_mapping) CloseHandle(m_mapping);
+        if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+        m_mapping = nullptr;
+        m_file = INVALID_HANDLE_VALUE;
+        #else
+        if (m_data) munmap(const_cast<uint8_t*>(m_data), m_size);
+        if (m_fd >= 0) ::close(m_fd);
+        m_fd = -1;
+        #endif
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    bool is_open() const {
+        #ifdef _WIN32
+        return m_file != INVALID_HANDLE_VALUE;
+        #else
+        return m_fd >= 0;
+        #endif
+    }
+
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    #ifdef _WIN32
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+    #else
+    int m_fd = -1;
+    #endif
+};
+
+} // namespace memory_engine
+
+#endif // MAPPED_FILE_HPP
@@ -8,11 +8,44 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#endif
 
 namespace memory_engine {
 
 class MemoryUtils {
 public:
+    // Padding unit for data written by different threads
+    // (std::hardware_destructive_interference_size is missing from older toolchains)
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    // Spin-wait hint; frees pipeline resources for the sibling hyperthread
+    static inline void cpu_relax() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
     static constexpr size_t align_forward(size_t address, size_t alignment) {
         return (address + alignment - 1) & ~(alignment - 1);
     }
@@ -32,17 +65,131 @@ public:
         return value + 1;
     }
 
+    // Index of the lowest set bit; value must be non-zero
+    static inline unsigned count_trailing_zeros(uint64_t value) {
+        #if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctzll(value));
+        #elif defined(_MSC_VER) && defined(_WIN64)
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return static_cast<unsigned>(index);
+        #else
+        unsigned index = 0;
+        while (!(value & 1)) { value >>= 1; ++index; }
+        return index;
+        #endif
+    }
+
+    // Index of the highest set bit (floor(log2(value))); value must be non-zero
+    static inline unsigned floor_log2(uint64_t value) {
+        #if defined(__GNUC__) || defined(__clang__)
+        return 63u - static_cast<unsigned>(__builtin_clzll(value));
+        #elif defined(_MSC_VER) && defined(_WIN64)
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return static_cast<unsigned>(index);
+        #else
+        unsigned index = 0;
+        while (value >>= 1) ++index;
+        return index;
+        #endif
+    }
+
+    // Base page size of the OS, queried once
     static size_t get_page_size() {
-        #ifdef _WIN32
-        return 4096;
+        static const size_t page_size = [] {
+            #if defined(_WIN32)
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            return static_cast<size_t>(info.dwPageSize);
+            #elif defined(__unix__) || defined(__APPLE__)
+            long size = sysconf(_SC_PAGESIZE);
+            return size > 0 ? static_cast<size_t>(size) : size_t(4096);
+            #else
+            return size_t(65536); // WebAssembly page
+            #endif
+        }();
+        return page_size;
+    }
+
+    // Default huge/large page size, 0 if the OS has none
+    static size_t get_huge_page_size() {
+        static const size_t huge_page_size = [] {
+            #if defined(_WIN32)
+            return static_cast<size_t>(GetLargePageMinimum());
+            #elif defined(__linux__)
+            size_t kb = read_proc_file_kb("/proc/meminfo", "Hugepagesize:");
+            return kb ? kb * 1024 : size_t(2 * 1024 * 1024);
+            #else
+            return size_t(0);
+            #endif
+        }();
+        return huge_page_size;
+    }
+
+    // Resident anonymous memory of this process in bytes, 0 if unavailable.
+    // On Linux file-backed pages (e.g. a memory-mapped trace) are excluded.
+    static size_t current_rss() {
+        #if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return static_cast<size_t>(counters.WorkingSetSize);
+        }
+        return 0;
+        #elif defined(__linux__)
+        size_t anon_kb = read_proc_status_kb("RssAnon:");
+        return (anon_kb ? anon_kb : read_proc_status_kb("VmRSS:")) * 1024;
         #else
-        return 4096;
+        return 0;
+        #endif
+    }
+
+    // Peak resident set size of this process in bytes, 0 if unavailable
+    static size_t peak_rss() {
+        #if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return static_cast<size_t>(counters.PeakWorkingSetSize);
+        }
+        return 0;
+        #elif defined(__linux__)
+        return read_proc_status_kb("VmHWM:") * 1024;
+        #else
+        return 0;
         #endif
     }
 
     static constexpr size_t KB(size_t n) { return n * 1024; }
     static constexpr size_t MB(size_t n) { return n * 1024 * 1024; }
     static constexpr size_t GB(size_t n) { return n * 1024 * 1024 * 1024; }
+
+private:
+    #if defined(__linux__)
+    // Value of a "Key:   1234 kB" line in /proc/self/status
+    static size_t read_proc_status_kb(const char* key) {
+        return read_proc_file_kb("/proc/self/status", key);
+    }
+
+    static size_t read_proc_file_kb(const char* path, const char* key) {
+        FILE* file = std::fopen(path, "r");
+        if (!file) return 0;
+
+        char line[256];
+        size_t value = 0;
+        size_t key_length = std::strlen(key);
+        while (std::fgets(line, sizeof(line), file)) {
+            if (std::strncmp(line, key, key_length) == 0) {
+                unsigned long long kb = 0;
+                if (std::sscanf(line + key_length, "%llu", &kb) == 1) {
+                    value = static_cast<size_t>(kb);
+                }
+                break;
+            }
+        }
+        std::fclose(file);
+        return value;
+    }
+    #endif
 };
 
 } // namespace memory_engine
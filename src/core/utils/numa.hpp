@@ -0,0 +1,214 @@
+/**
+ * @file numa.hpp
+ * @brief NUMA topology queries, node-bound memory and thread placement
+ *
+ * Talks to the kernel directly (mbind/get_mempolicy/getcpu syscalls and
+ * sysfs on Linux, the Win32 NUMA API on Windows), so no libnuma is needed.
+ * Everywhere else the machine is reported as a single node and node-bound
+ * allocation is unavailable.
+ */
+
+#ifndef NUMA_HPP
+#define NUMA_HPP
+
+#include "memory_utils.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace memory_engine {
+
+class Numa {
+public:
+    static constexpr int ANY_NODE = -1;   ///< No binding; memory goes wherever it is first touched
+    static constexpr int MAX_NODES = 1024;
+
+    // Number of NUMA nodes (1 on non-NUMA machines and unsupported platforms)
+    static int node_count() {
+#if defined(__linux__)
+        std::vector<unsigned> online = read_cpulist("/sys/devices/system/node/online");
+        return online.empty() ? 1 : static_cast<int>(online.back()) + 1;
+#elif defined(_WIN32)
+        ULONG highest = 0;
+        return GetNumaHighestNodeNumber(&highest) ? static_cast<int>(highest) + 1 : 1;
+#else
+        return 1;
+#endif
+    }
+
+    // Node of the CPU the calling thread is running on right now
+    static int current_node() {
+#if defined(__linux__) && defined(SYS_getcpu)
+        unsigned cpu = 0, node = 0;
+        if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) return static_cast<int>(node);
+        return 0;
+#elif defined(_WIN32)
+        PROCESSOR_NUMBER processor;
+        GetCurrentProcessorNumberEx(&processor);
+        USHORT node = 0;
+        return GetNumaProcessorNodeEx(&processor, &node) ? static_cast<int>(node) : 0;
+#else
+        return 0;
+#endif
+    }
+
+    // CPUs belonging to node (every CPU for node 0 when topology is unknown)
+    static std::vector<unsigned> node_cpus(int node) {
+        std::vector<unsigned> cpus;
+#if defined(__linux__)
+        char path[64];
+        std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        cpus = read_cpulist(path);
+#elif defined(_WIN32)
+        GROUP_AFFINITY affinity;
+        if (GetNumaNodeProcessorMaskEx(static_cast<USHORT>(node), &affinity)) {
+            for (unsigned bit = 0; bit < sizeof(KAFFINITY) * 8; ++bit) {
+                if (affinity.Mask & (KAFFINITY(1) << bit)) cpus.push_back(affinity.Group * 64u + bit);
+            }
+        }
+#endif
+        if (cpus.empty() && node == 0) {
+            unsigned count = std::max(1u, std::thread::hardware_concurrency());
+            for (unsigned cpu = 0; cpu < count; ++cpu) cpus.push_back(cpu);
+        }
+        return cpus;
+    }
+
+    /**
+     * @brief Restrict the calling thread to the CPUs of one node
+     * @return false if the node has no CPUs or affinity is unsupported
+     */
+    static bool bind_current_thread(int node) {
+#if defined(__linux__)
+        std::vector<unsigned> cpus = node_cpus(node);
+        if (cpus.empty()) return false;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (unsigned cpu : cpus) {
+            if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+        }
+        return sched_setaffinity(0, sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+        GROUP_AFFINITY affinity;
+        if (!GetNumaNodeProcessorMaskEx(static_cast<USHORT>(node), &affinity)) return false;
+        return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+#else
+        (void)node;
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Map size bytes whose pages are bound to node
+     * @return Page-aligned memory, or nullptr if the node does not exist or
+     *         binding is unsupported (the caller falls back to unbound memory)
+     *
+     * Pages are bound, not just preferred: they land on node whichever
+     * thread touches them first. Release with free_on_node().
+     */
+    static void* allocate_on_node(size_t size, int node) {
+        if (node < 0 || node >= node_count() || size == 0) return nullptr;
+#if defined(__linux__) && defined(SYS_mbind)
+        size_t length = mapping_size(size);
+        void* memory = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) return nullptr;
+        if (!bind_range(memory, length, node)) {
+            munmap(memory, length);
+            return nullptr;
+        }
+        return memory;
+#elif defined(_WIN32)
+        return VirtualAllocExNuma(GetCurrentProcess(), nullptr, size, MEM_RESERVE | MEM_COMMIT,
+                                  PAGE_READWRITE, static_cast<DWORD>(node));
+#else
+        return nullptr;
+#endif
+    }
+
+    /**
+     * @brief Bind the pages of an existing mapping to node
+     * @param memory Page-aligned start of a mapping obtained from mmap
+     * @return false if binding is unsupported or the kernel refused
+     *
+     * Pages already faulted in stay where they are.
+     */
+    static bool bind_range(void* memory, size_t size, int node) {
+        if (node < 0 || node >= MAX_NODES || !memory) return false;
+#if defined(__linux__) && defined(SYS_mbind)
+        unsigned long mask[MAX_NODES / (8 * sizeof(unsigned long))] = {};
+        mask[node / (8 * sizeof(unsigned long))] = 1UL << (node % (8 * sizeof(unsigned long)));
+        return syscall(SYS_mbind, memory, mapping_size(size), MPOL_BIND, mask, MAX_NODES + 1, 0) == 0;
+#else
+        (void)size;
+        return false;
+#endif
+    }
+
+    static void free_on_node(void* memory, size_t size) {
+        if (!memory) return;
+#if defined(__linux__)
+        munmap(memory, mapping_size(size));
+#elif defined(_WIN32)
+        (void)size;
+        VirtualFree(memory, 0, MEM_RELEASE);
+#else
+        (void)size;
+#endif
+    }
+
+    // Node holding the page at address (faulting it in if needed), ANY_NODE if unknown
+    static int node_of(const void* address) {
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+        int node = ANY_NODE;
+        if (syscall(SYS_get_mempolicy, &node, nullptr, 0, address, MPOL_F_NODE | MPOL_F_ADDR) == 0) return node;
+        return ANY_NODE;
+#else
+        (void)address;
+        return ANY_NODE;
+#endif
+    }
+
+private:
+    static size_t mapping_size(size_t size) {
+        return MemoryUtils::align_forward(size, MemoryUtils::get_page_size());
+    }
+
+#if defined(__linux__)
+    // Parses sysfs lists such as "0-3,8-11"
+    static std::vector<unsigned> read_cpulist(const char* path) {
+        std::vector<unsigned> values;
+        FILE* file = std::fopen(path, "r");
+        if (!file) return values;
+
+        unsigned first, last;
+        char separator;
+        while (std::fscanf(file, "%u", &first) == 1) {
+            last = first;
+            separator = static_cast<char>(std::fgetc(file));
+            if (separator == '-') {
+                if (std::fscanf(file, "%u", &last) != 1) break;
+                separator = static_cast<char>(std::fgetc(file));
+            }
+            for (unsigned value = first; value <= last; ++value) values.push_back(value);
+            if (separator != ',') break;
+        }
+        std::fclose(file);
+        return values;
+    }
+#endif
+};
+
+} // namespace memory_engine
+
+#endif // NUMA_HPP
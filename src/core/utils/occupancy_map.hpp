@@ -0,0 +1,171 @@
+/**
+ * @file occupancy_map.hpp
+ * @brief Incrementally maintained byte-per-cell occupancy of an arena
+ *
+ * The visualizer used to rebuild a std::vector<bool> by walking a pool's
+ * free list, then copy it into JavaScript one element at a time. Allocators
+ * now keep this map current as they allocate and free, and the WASM layer
+ * hands the level bytes to JavaScript as a view over linear memory. Nothing
+ * is walked or copied per frame.
+ */
+
+#ifndef OCCUPANCY_MAP_HPP
+#define OCCUPANCY_MAP_HPP
+
+#include "memory_utils.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace memory_engine {
+
+/**
+ * @struct OccupancyView
+ * @brief Read-only snapshot handle of an OccupancyMap
+ *
+ * levels stays valid until tracking is disabled or re-enabled; its contents
+ * change under the reader as the allocator runs.
+ */
+struct OccupancyView {
+    const uint8_t* levels = nullptr;  ///< One byte per cell: 0 free ... 255 fully used
+    size_t cell_count = 0;
+    size_t cell_size = 0;             ///< Arena bytes per cell
+    size_t span = 0;                  ///< Arena bytes covered
+    size_t high_water = 0;            ///< Highest arena offset used since tracking was enabled
+    uint64_t version = 0;             ///< Changes whenever any level may have changed
+};
+
+/**
+ * @class OccupancyMap
+ * @brief Per-cell used-byte counts over [base, base + span), exposed as 0-255 levels
+ *
+ * Disabled maps cost one predictable branch per operation in the owning
+ * allocator. Updates are not synchronized; it belongs to single-threaded
+ * allocators. The version and high-water mark are atomic so another
+ * thread (the page, while a benchmark runs on a worker) can poll it;
+ * levels read that way may be a frame stale but never out of bounds.
+ */
+class OccupancyMap {
+public:
+    OccupancyMap() = default;
+
+    OccupancyMap(OccupancyMap&& other) noexcept
+        : m_enabled(other.m_enabled)
+        , m_base(other.m_base)
+        , m_span(other.m_span)
+        , m_cell_size(other.m_cell_size)
+        , m_high_water(other.m_high_water.load(std::memory_order_relaxed))
+        , m_version(other.m_version.load(std::memory_order_relaxed))
+        , m_used(std::move(other.m_used))
+        , m_levels(std::move(other.m_levels)) {
+        other.m_enabled = false;
+    }
+
+    static constexpr size_t MAX_CELLS = 16384;   ///< Default cap when the cell size is derived
+    static constexpr size_t MIN_CELL_SIZE = 64;
+
+    /**
+     * @brief Start tracking, with every cell free
+     * @param cell_size Bytes per cell; 0 picks a power of two keeping cells <= MAX_CELLS
+     */
+    void enable(const void* base, size_t span, size_t cell_size = 0) {
+        if (cell_size == 0) {
+            size_t wanted = (span + MAX_CELLS - 1) / MAX_CELLS;
+            cell_size = std::max(MIN_CELL_SIZE, MemoryUtils::next_power_of_two(std::max<size_t>(wanted, 1)));
+        }
+        m_base = reinterpret_cast<uintptr_t>(base);
+        m_span = span;
+        m_cell_size = cell_size;
+        size_t cells = (span + cell_size - 1) / cell_size;
+        m_used.assign(cells, 0);
+        m_levels.assign(cells, 0);
+        m_high_water.store(0, std::memory_order_relaxed);
+        bump();
+        m_enabled = true;
+    }
+
+    void disable() {
+        m_enabled = false;
+        std::vector<size_t>().swap(m_used);
+        std::vector<uint8_t>().swap(m_levels);
+        bump();
+    }
+
+    bool enabled() const { return m_enabled; }
+
+    void add(const void* ptr, size_t size) { update(ptr, size, true); }
+
+    void remove(const void* ptr, size_t size) { update(ptr, size, false); }
+
+    /**
+     * @brief Mark or clear [from, to) as arena offsets; either order
+     *
+     * For bump allocators, whose used range is a prefix that moves.
+     */
+    void move_top(size_t from, size_t to) {
+        if (from == to) return;
+        const void* start = reinterpret_cast<const void*>(m_base + std::min(from, to));
+        update(start, from < to ? to - from : from - to, from < to);
+    }
+
+    // Everything free again; the high-water mark is kept
+    void clear() {
+        std::fill(m_used.begin(), m_used.end(), 0);
+        std::fill(m_levels.begin(), m_levels.end(), 0);
+        bump();
+    }
+
+    OccupancyView view() const {
+        OccupancyView view;
+        if (!m_enabled) return view;
+        view.levels = m_levels.data();
+        view.cell_count = m_levels.size();
+        view.cell_size = m_cell_size;
+        view.span = m_span;
+        view.high_water = m_high_water.load(std::memory_order_relaxed);
+        view.version = version();
+        return view;
+    }
+
+    uint64_t version() const { return m_version.load(std::memory_order_acquire); }
+
+private:
+    bool m_enabled = false;
+    uintptr_t m_base = 0;
+    size_t m_span = 0;
+    size_t m_cell_size = 0;
+    std::atomic<size_t> m_high_water{0};
+    std::atomic<uint64_t> m_version{0};
+    std::vector<size_t> m_used;      ///< Used bytes per cell
+    std::vector<uint8_t> m_levels;   ///< What readers see
+
+    void update(const void* ptr, size_t size, bool used) {
+        uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+        if (!m_enabled || size == 0 || address < m_base || address - m_base >= m_span) return;
+
+        size_t begin = address - m_base;
+        size_t end = std::min(begin + size, m_span);
+        if (used && end > m_high_water.load(std::memory_order_relaxed)) {
+            m_high_water.store(end, std::memory_order_relaxed);
+        }
+
+        for (size_t cell = begin / m_cell_size; cell * m_cell_size < end; ++cell) {
+            size_t cell_begin = cell * m_cell_size;
+            size_t overlap = std::min(end, cell_begin + m_cell_size) - std::max(begin, cell_begin);
+            size_t& count = m_used[cell];
+            count = used ? count + overlap : count - std::min(count, overlap);   // Double frees clamp at 0
+            // Round up so a cell with any live byte is visibly non-empty
+            m_levels[cell] = static_cast<uint8_t>(std::min<size_t>(255, (count * 255 + m_cell_size - 1) / m_cell_size));
+        }
+        bump();
+    }
+
+    // Single writer, so a load and a release store; no locked read-modify-write
+    void bump() { m_version.store(m_version.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+};
+
+} // namespace memory_engine
+
+#endif // OCCUPANCY_MAP_HPP
@@ -0,0 +1,240 @@
+/**
+ * @file perf_counters.hpp
+ * @brief Hardware event counters (Linux perf_event_open) around a measured region
+ *
+ * Each event is opened on its own, so a PMU that lacks one event (or a
+ * kernel that refuses it) only loses that event. When nothing can be opened
+ * (WebAssembly, macOS, Windows, containers without CAP_PERFMON,
+ * perf_event_paranoid > 2) every reading comes back with available == 0 and
+ * the benchmark runs unchanged.
+ *
+ * Counts are for the calling thread only, user space only for the hardware
+ * events, and scaled up when the kernel multiplexed the event.
+ */
+
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Set MEMORY_ENGINE_PERF_COUNTERS=0 to compile the counters out entirely
+#ifndef MEMORY_ENGINE_PERF_COUNTERS
+#define MEMORY_ENGINE_PERF_COUNTERS 1
+#endif
+
+#if MEMORY_ENGINE_PERF_COUNTERS && defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/perf_event.h>)
+#define MEMORY_ENGINE_HAS_PERF_EVENT 1
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#endif
+
+namespace memory_engine {
+
+enum class PerfEvent {
+    CYCLES,
+    INSTRUCTIONS,
+    L1D_MISSES,        ///< L1 data cache read misses
+    LLC_MISSES,        ///< Last-level cache misses
+    DTLB_MISSES,       ///< Data TLB read misses
+    BRANCH_MISSES,
+    CONTEXT_SWITCHES,  ///< Software event; includes kernel time when permitted
+    COUNT
+};
+
+constexpr size_t PERF_EVENT_COUNT = static_cast<size_t>(PerfEvent::COUNT);
+
+/**
+ * @struct PerfCounters
+ * @brief Event counts, totals or per operation
+ */
+struct PerfCounters {
+    double values[PERF_EVENT_COUNT] = {};
+    uint32_t available = 0;   ///< Bit i set when PerfEvent i was counted
+
+    bool any() const { return available != 0; }
+    bool has(PerfEvent event) const { return available & (1u << static_cast<size_t>(event)); }
+    double value(PerfEvent event) const { return values[static_cast<size_t>(event)]; }
+
+    // Instructions per cycle, 0 when either is missing
+    double ipc() const {
+        if (!has(PerfEvent::CYCLES) || !has(PerfEvent::INSTRUCTIONS) || value(PerfEvent::CYCLES) <= 0) return 0;
+        return value(PerfEvent::INSTRUCTIONS) / value(PerfEvent::CYCLES);
+    }
+
+    /**
+     * @brief Add another reading
+     *
+     * An event stays available only if both sides counted it, so a sum over
+     * threads never mixes counted and uncounted shares. Adding to an empty
+     * (default) value just copies.
+     */
+    PerfCounters& operator+=(const PerfCounters& other) {
+        available = m_summed ? (available & other.available) : other.available;
+        m_summed = true;
+        for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) values[i] += other.values[i];
+        return *this;
+    }
+
+    PerfCounters per_op(size_t operations) const {
+        PerfCounters result = *this;
+        if (operations == 0) return result;
+        for (double& v : result.values) v /= static_cast<double>(operations);
+        return result;
+    }
+
+    static const char* event_name(PerfEvent event) {
+        switch (event) {
+            case PerfEvent::CYCLES: return "cycles";
+            case PerfEvent::INSTRUCTIONS: return "instructions";
+            case PerfEvent::L1D_MISSES: return "L1d misses";
+            case PerfEvent::LLC_MISSES: return "LLC misses";
+            case PerfEvent::DTLB_MISSES: return "dTLB misses";
+            case PerfEvent::BRANCH_MISSES: return "branch misses";
+            case PerfEvent::CONTEXT_SWITCHES: return "context switches";
+            case PerfEvent::COUNT: break;
+        }
+        return "unknown";
+    }
+
+private:
+    bool m_summed = false;
+};
+
+/**
+ * @class PerfCounterGroup
+ * @brief The calling thread's event counters
+ *
+ * Opening costs one syscall per event, so use for_this_thread() and open
+ * outside the timed region. Counters run continuously once opened;
+ * start()/stop() take deltas, which keeps both calls to plain reads.
+ */
+class PerfCounterGroup {
+public:
+    PerfCounterGroup() {
+        for (int& fd : m_fds) fd = -1;
+        open_all();
+    }
+
+    ~PerfCounterGroup() {
+        #ifdef MEMORY_ENGINE_HAS_PERF_EVENT
+        for (int fd : m_fds) {
+            if (fd >= 0) close(fd);
+        }
+        #endif
+    }
+
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+    /**
+     * @brief The group for the calling thread, opened on first use
+     */
+    static PerfCounterGroup& for_this_thread() {
+        thread_local PerfCounterGroup group;
+        return group;
+    }
+
+    // Bit per PerfEvent that could be opened
+    uint32_t opened() const { return m_opened; }
+
+    void start() {
+        for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) m_start_ok[i] = read_event(i, m_start[i]);
+    }
+
+    /**
+     * @brief Counts since start(), scaled for multiplexing
+     */
+    PerfCounters stop() {
+        PerfCounters counters;
+        for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+            Reading end;
+            if (!m_start_ok[i] || !read_event(i, end)) continue;
+            uint64_t value = end.value - m_start[i].value;
+            uint64_t enabled = end.enabled - m_start[i].enabled;
+            uint64_t running = end.running - m_start[i].running;
+            if (running == 0) continue; // Never got a hardware counter in this window
+            counters.values[i] = static_cast<double>(value) * (static_cast<double>(enabled) / running);
+            counters.available |= 1u << i;
+        }
+        return counters;
+    }
+
+private:
+    struct Reading {
+        uint64_t value = 0;
+        uint64_t enabled = 0;
+        uint64_t running = 0;
+    };
+
+    int m_fds[PERF_EVENT_COUNT];
+    Reading m_start[PERF_EVENT_COUNT];
+    bool m_start_ok[PERF_EVENT_COUNT] = {};
+    uint32_t m_opened = 0;
+
+    bool read_event(size_t index, Reading& out) const {
+        #ifdef MEMORY_ENGINE_HAS_PERF_EVENT
+        if (m_fds[index] < 0) return false;
+        uint64_t data[3];
+        if (read(m_fds[index], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) return false;
+        out.value = data[0];
+        out.enabled = data[1];
+        out.running = data[2];
+        return true;
+        #else
+        (void)index;
+        (void)out;
+        return false;
+        #endif
+    }
+
+    void open_all() {
+        #ifdef MEMORY_ENGINE_HAS_PERF_EVENT
+        auto cache = [](uint64_t id) {
+            return id | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        };
+        const struct { uint32_t type; uint64_t config; } events[PERF_EVENT_COUNT] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_L1D)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_DTLB)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+        };
+
+        for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+            // Context switches happen in the kernel; try to include it first
+            bool software = events[i].type == PERF_TYPE_SOFTWARE;
+            m_fds[i] = open_event(events[i].type, events[i].config, !software);
+            if (m_fds[i] < 0 && software) m_fds[i] = open_event(events[i].type, events[i].config, true);
+            if (m_fds[i] >= 0) m_opened |= 1u << i;
+        }
+        #endif
+    }
+
+    #ifdef MEMORY_ENGINE_HAS_PERF_EVENT
+    static int open_event(uint32_t type, uint64_t config, bool user_only) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.exclude_kernel = user_only ? 1 : 0;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        long fd = syscall(SYS_perf_event_open, &attr, 0 /* this thread */, -1 /* any CPU */, -1,
+                          PERF_FLAG_FD_CLOEXEC);
+        return fd < 0 ? -1 : static_cast<int>(fd);
+    }
+    #endif
+};
+
+} // namespace memory_engine
+
+#endif // PERF_COUNTERS_HPP
@@ -0,0 +1,146 @@
+/**
+ * @file pointer_set.hpp
+ * @brief Three-level radix bitmap of live, max_align_t-aligned pointers
+ *
+ * Answers "is this exactly one of my live blocks?" in three dependent loads,
+ * without hashing, without touching the block itself and without allocating
+ * except the first time a 2 MB-aligned region (with 16-byte granules) is
+ * used. Foreign, interior and already-freed pointers simply test false.
+ */
+
+#ifndef POINTER_SET_HPP
+#define POINTER_SET_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace memory_engine {
+
+namespace pointer_set_detail {
+constexpr unsigned log2_of(size_t value) { return value > 1 ? 1 + log2_of(value >> 1) : 0; }
+} // namespace pointer_set_detail
+
+class PointerSet {
+public:
+    static constexpr size_t GRANULE = alignof(std::max_align_t);  ///< One bit per granule
+
+    PointerSet() : m_root(ROOT_FANOUT) {}
+
+    PointerSet(const PointerSet&) = delete;
+    PointerSet& operator=(const PointerSet&) = delete;
+
+    /**
+     * @brief Mark ptr live
+     * @param ptr GRANULE-aligned pointer
+     * @return false if ptr is misaligned, outside the mapped address bits,
+     *         or a node could not be allocated
+     */
+    bool insert(const void* ptr) {
+        uint64_t index;
+        if (!index_of(ptr, index)) return false;
+        uint64_t* word = create(index);
+        if (!word) return false;
+        *word |= bit_of(index);
+        return true;
+    }
+
+    /**
+     * @brief Mark ptr no longer live; no-op if it was not inserted
+     */
+    void erase(const void* ptr) {
+        uint64_t index;
+        if (!index_of(ptr, index)) return;
+        if (uint64_t* word = find(index)) *word &= ~bit_of(index);
+    }
+
+    /**
+     * @brief Check whether ptr was inserted and not erased since
+     */
+    bool contains(const void* ptr) const {
+        uint64_t index;
+        if (!index_of(ptr, index)) return false;
+        const uint64_t* word = find(index);
+        return word && (*word & bit_of(index)) != 0;
+    }
+
+    /**
+     * @brief Erase every pointer; nodes are kept for reuse
+     */
+    void clear() {
+        for (auto& mid : m_root) {
+            if (!mid) continue;
+            for (auto& leaf : mid->leaves) {
+                if (leaf) std::fill(std::begin(leaf->words), std::end(leaf->words), uint64_t(0));
+            }
+        }
+    }
+
+private:
+    // 48-bit user-space addresses on x86-64 and AArch64, all of them on 32-bit targets
+    static constexpr unsigned ADDRESS_BITS = sizeof(void*) >= 8 ? 48 : 32;
+    static constexpr unsigned INDEX_BITS = ADDRESS_BITS - pointer_set_detail::log2_of(GRANULE);
+    static constexpr unsigned LEAF_BITS = 17;  ///< 16 KB bitmap per leaf
+    static constexpr unsigned MID_BITS = 14;   ///< 128 KB of leaf pointers per mid
+    static constexpr unsigned ROOT_BITS = INDEX_BITS > LEAF_BITS + MID_BITS ? INDEX_BITS - LEAF_BITS - MID_BITS : 0;
+    static constexpr size_t ROOT_FANOUT = size_t(1) << ROOT_BITS;
+
+    struct Leaf {
+        uint64_t words[(size_t(1) << LEAF_BITS) / 64] = {}; ///< One bit per granule
+    };
+
+    struct Mid {
+        std::unique_ptr<Leaf> leaves[size_t(1) << MID_BITS];
+    };
+
+    std::vector<std::unique_ptr<Mid>> m_root;
+
+    static bool index_of(const void* ptr, uint64_t& index) {
+        uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+        if (address % GRANULE != 0) return false;
+        index = static_cast<uint64_t>(address) / GRANULE;
+        return (index >> (LEAF_BITS + MID_BITS)) < ROOT_FANOUT;
+    }
+
+    static uint64_t bit_of(uint64_t index) {
+        return uint64_t(1) << (index % 64);
+    }
+
+    static size_t mid_slot(uint64_t index) {
+        return static_cast<size_t>((index >> LEAF_BITS) & ((uint64_t(1) << MID_BITS) - 1));
+    }
+
+    static size_t word_slot(uint64_t index) {
+        return static_cast<size_t>((index & ((uint64_t(1) << LEAF_BITS) - 1)) / 64);
+    }
+
+    uint64_t* find(uint64_t index) const {
+        const std::unique_ptr<Mid>& mid = m_root[static_cast<size_t>(index >> (LEAF_BITS + MID_BITS))];
+        if (!mid) return nullptr;
+        Leaf* leaf = mid->leaves[mid_slot(index)].get();
+        return leaf ? &leaf->words[word_slot(index)] : nullptr;
+    }
+
+    uint64_t* create(uint64_t index) {
+        std::unique_ptr<Mid>& mid = m_root[static_cast<size_t>(index >> (LEAF_BITS + MID_BITS))];
+        if (!mid) {
+            mid.reset(new (std::nothrow) Mid());
+            if (!mid) return nullptr;
+        }
+
+        std::unique_ptr<Leaf>& leaf = mid->leaves[mid_slot(index)];
+        if (!leaf) {
+            leaf.reset(new (std::nothrow) Leaf());
+            if (!leaf) return nullptr;
+        }
+        return &leaf->words[word_slot(index)];
+    }
+};
+
+} // namespace memory_engine
+
+#endif // POINTER_SET_HPP
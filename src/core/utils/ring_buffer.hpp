@@ -0,0 +1,71 @@
+/**
+ * @file ring_buffer.hpp
+ * @brief Fixed-capacity ring buffer that overwrites its oldest entries
+ */
+
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace memory_engine {
+
+template <typename T>
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t capacity = 0) : m_capacity(capacity) {}
+
+    // Storage is reserved on first push so idle buffers cost nothing
+    void push_back(const T& value) {
+        if (m_capacity == 0) return;
+        if (m_data.size() < m_capacity) {
+            m_data.push_back(value);
+        } else {
+            m_data[m_head] = value;
+            m_head = (m_head + 1) % m_capacity;
+        }
+        m_total_pushed++;
+    }
+
+    // Index 0 is the oldest retained entry
+    const T& operator[](size_t index) const { return m_data[(m_head + index) % m_data.size()]; }
+    T& operator[](size_t index) { return m_data[(m_head + index) % m_data.size()]; }
+
+    const T& back() const { return (*this)[m_data.size() - 1]; }
+    T& back() { return (*this)[m_data.size() - 1]; }
+
+    size_t size() const { return m_data.size(); }
+    bool empty() const { return m_data.empty(); }
+    size_t capacity() const { return m_capacity; }
+    size_t total_pushed() const { return m_total_pushed; }
+    size_t dropped() const { return m_total_pushed - m_data.size(); }
+
+    void clear() {
+        m_data.clear();
+        m_head = 0;
+        m_total_pushed = 0;
+    }
+
+    // Changing capacity discards the current contents
+    void set_capacity(size_t capacity) {
+        clear();
+        m_data.shrink_to_fit();
+        m_capacity = capacity;
+    }
+
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (size_t i = 0; i < m_data.size(); ++i) fn((*this)[i]);
+    }
+
+private:
+    std::vector<T> m_data;
+    size_t m_capacity;
+    size_t m_head = 0;
+    size_t m_total_pushed = 0;
+};
+
+} // namespace memory_engine
+
+#endif // RING_BUFFER_HPP
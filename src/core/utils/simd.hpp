@@ -0,0 +1,317 @@
+/**
+ * @file simd.hpp
+ * @brief Vector kernels for sample statistics and bitmap scanning
+ *
+ * One implementation per instruction set, picked at compile time from the
+ * target flags: AVX2 (-mavx2 or -march=native), SSE2 (every x86-64 build),
+ * NEON (AArch64) and WebAssembly SIMD128 (-msimd128), with a scalar
+ * fallback. The kernels only read memory, so every backend returns the same
+ * result up to floating-point summation order.
+ */
+
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @def MEMORY_ENGINE_SIMD
+ * @brief Use vector instructions where the target provides them (default 1)
+ *
+ * Define as 0 (CMake option MEMORY_ENGINE_ENABLE_SIMD=OFF) to run the scalar
+ * kernels everywhere, e.g. to rule them out when results look wrong.
+ */
+#ifndef MEMORY_ENGINE_SIMD
+#define MEMORY_ENGINE_SIMD 1
+#endif
+
+#if MEMORY_ENGINE_SIMD && defined(__AVX2__)
+#define MEMORY_ENGINE_SIMD_AVX2 1
+#include <immintrin.h>
+#elif MEMORY_ENGINE_SIMD && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MEMORY_ENGINE_SIMD_SSE2 1
+#include <emmintrin.h>
+#elif MEMORY_ENGINE_SIMD && defined(__aarch64__) && defined(__ARM_NEON)
+#define MEMORY_ENGINE_SIMD_NEON 1
+#include <arm_neon.h>
+#elif MEMORY_ENGINE_SIMD && defined(__wasm_simd128__)
+#define MEMORY_ENGINE_SIMD_WASM 1
+#include <wasm_simd128.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace memory_engine {
+
+class Simd {
+public:
+    static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+    static const char* backend() {
+#if defined(MEMORY_ENGINE_SIMD_AVX2)
+        return "avx2";
+#elif defined(MEMORY_ENGINE_SIMD_SSE2)
+        return "sse2";
+#elif defined(MEMORY_ENGINE_SIMD_NEON)
+        return "neon";
+#elif defined(MEMORY_ENGINE_SIMD_WASM)
+        return "simd128";
+#else
+        return "scalar";
+#endif
+    }
+
+    static double sum(const double* values, size_t count) {
+        size_t i = 0;
+        double total = 0;
+#if defined(MEMORY_ENGINE_SIMD_AVX2)
+        __m256d a = _mm256_setzero_pd(), b = _mm256_setzero_pd();
+        for (; i + 8 <= count; i += 8) {
+            a = _mm256_add_pd(a, _mm256_loadu_pd(values + i));
+            b = _mm256_add_pd(b, _mm256_loadu_pd(values + i + 4));
+        }
+        total = horizontal_sum(_mm256_add_pd(a, b));
+#elif defined(MEMORY_ENGINE_SIMD_SSE2)
+        __m128d a = _mm_setzero_pd(), b = _mm_setzero_pd();
+        for (; i + 4 <= count; i += 4) {
+            a = _mm_add_pd(a, _mm_loadu_pd(values + i));
+            b = _mm_add_pd(b, _mm_loadu_pd(values + i + 2));
+        }
+        total = horizontal_sum(_mm_add_pd(a, b));
+#elif defined(MEMORY_ENGINE_SIMD_NEON)
+        float64x2_t a = vdupq_n_f64(0), b = vdupq_n_f64(0);
+        for (; i + 4 <= count; i += 4) {
+            a = vaddq_f64(a, vld1q_f64(values + i));
+            b = vaddq_f64(b, vld1q_f64(values + i + 2));
+        }
+        total = vaddvq_f64(vaddq_f64(a, b));
+#elif defined(MEMORY_ENGINE_SIMD_WASM)
+        v128_t a = wasm_f64x2_splat(0), b = wasm_f64x2_splat(0);
+        for (; i + 4 <= count; i += 4) {
+            a = wasm_f64x2_add(a, wasm_v128_load(values + i));
+            b = wasm_f64x2_add(b, wasm_v128_load(values + i + 2));
+        }
+        a = wasm_f64x2_add(a, b);
+        total = wasm_f64x2_extract_lane(a, 0) + wasm_f64x2_extract_lane(a, 1);
+#endif
+        for (; i < count; ++i) total += values[i];
+        return total;
+    }
+
+    // Sum of (value - mean)^2; divide by count for the population variance
+    static double sum_squared_deviation(const double* values, size_t count, double mean) {
+        size_t i = 0;
+        double total = 0;
+#if defined(MEMORY_ENGINE_SIMD_AVX2)
+        const __m256d m = _mm256_set1_pd(mean);
+        __m256d a = _mm256_setzero_pd(), b = _mm256_setzero_pd();
+        for (; i + 8 <= count; i += 8) {
+            __m256d d0 = _mm256_sub_pd(_mm256_loadu_pd(values + i), m);
+            __m256d d1 = _mm256_sub_pd(_mm256_loadu_pd(values + i + 4), m);
+            a = _mm256_add_pd(a, _mm256_mul_pd(d0, d0));
+            b = _mm256_add_pd(b, _mm256_mul_pd(d1, d1));
+        }
+        total = horizontal_sum(_mm256_add_pd(a, b));
+#elif defined(MEMORY_ENGINE_SIMD_SSE2)
+        const __m128d m = _mm_set1_pd(mean);
+        __m128d a = _mm_setzero_pd(), b = _mm_setzero_pd();
+        for (; i + 4 <= count; i += 4) {
+            __m128d d0 = _mm_sub_pd(_mm_loadu_pd(values + i), m);
+            __m128d d1 = _mm_sub_pd(_mm_loadu_pd(values + i + 2), m);
+            a = _mm_add_pd(a, _mm_mul_pd(d0, d0));
+            b = _mm_add_pd(b, _mm_mul_pd(d1, d1));
+        }
+        total = horizontal_sum(_mm_add_pd(a, b));
+#elif defined(MEMORY_ENGINE_SIMD_NEON)
+        const float64x2_t m = vdupq_n_f64(mean);
+        float64x2_t a = vdupq_n_f64(0), b = vdupq_n_f64(0);
+        for (; i + 4 <= count; i += 4) {
+            float64x2_t d0 = vsubq_f64(vld1q_f64(values + i), m);
+            float64x2_t d1 = vsubq_f64(vld1q_f64(values + i + 2), m);
+            a = vfmaq_f64(a, d0, d0);
+            b = vfmaq_f64(b, d1, d1);
+        }
+        total = vaddvq_f64(vaddq_f64(a, b));
+#elif defined(MEMORY_ENGINE_SIMD_WASM)
+        const v128_t m = wasm_f64x2_splat(mean);
+        v128_t a = wasm_f64x2_splat(0), b = wasm_f64x2_splat(0);
+        for (; i + 4 <= count; i += 4) {
+            v128_t d0 = wasm_f64x2_sub(wasm_v128_load(values + i), m);
+            v128_t d1 = wasm_f64x2_sub(wasm_v128_load(values + i + 2), m);
+            a = wasm_f64x2_add(a, wasm_f64x2_mul(d0, d0));
+            b = wasm_f64x2_add(b, wasm_f64x2_mul(d1, d1));
+        }
+        a = wasm_f64x2_add(a, b);
+        total = wasm_f64x2_extract_lane(a, 0) + wasm_f64x2_extract_lane(a, 1);
+#endif
+        for (; i < count; ++i) {
+            double d = values[i] - mean;
+            total += d * d;
+        }
+        return total;
+    }
+
+    // count must be > 0
+    static void min_max(const double* values, size_t count, double& min_out, double& max_out) {
+        size_t i = 0;
+        double lo = values[0], hi = values[0];
+#if defined(MEMORY_ENGINE_SIMD_AVX2)
+        if (count >= 4) {
+            __m256d vlo = _mm256_loadu_pd(values), vhi = vlo;
+            for (i = 4; i + 4 <= count; i += 4) {
+                __m256d v = _mm256_loadu_pd(values + i);
+                vlo = _mm256_min_pd(vlo, v);
+                vhi = _mm256_max_pd(vhi, v);
+            }
+            __m128d lo2 = _mm_min_pd(_mm256_castpd256_pd128(vlo), _mm256_extractf128_pd(vlo, 1));
+            __m128d hi2 = _mm_max_pd(_mm256_castpd256_pd128(vhi), _mm256_extractf128_pd(vhi, 1));
+            lo = _mm_cvtsd_f64(_mm_min_sd(lo2, _mm_unpackhi_pd(lo2, lo2)));
+            hi = _mm_cvtsd_f64(_mm_max_sd(hi2, _mm_unpackhi_pd(hi2, hi2)));
+        }
+#elif defined(MEMORY_ENGINE_SIMD_SSE2)
+        if (count >= 2) {
+            __m128d vlo = _mm_loadu_pd(values), vhi = vlo;
+            for (i = 2; i + 2 <= count; i += 2) {
+                __m128d v = _mm_loadu_pd(values + i);
+                vlo = _mm_min_pd(vlo, v);
+                vhi = _mm_max_pd(vhi, v);
+            }
+            lo = _mm_cvtsd_f64(_mm_min_sd(vlo, _mm_unpackhi_pd(vlo, vlo)));
+            hi = _mm_cvtsd_f64(_mm_max_sd(vhi, _mm_unpackhi_pd(vhi, vhi)));
+        }
+#elif defined(MEMORY_ENGINE_SIMD_NEON)
+        if (count >= 2) {
+            float64x2_t vlo = vld1q_f64(values), vhi = vlo;
+            for (i = 2; i + 2 <= count; i += 2) {
+                float64x2_t v = vld1q_f64(values + i);
+                vlo = vminq_f64(vlo, v);
+                vhi = vmaxq_f64(vhi, v);
+            }
+            lo = vminvq_f64(vlo);
+            hi = vmaxvq_f64(vhi);
+        }
+#elif defined(MEMORY_ENGINE_SIMD_WASM)
+        if (count >= 2) {
+            v128_t vlo = wasm_v128_load(values), vhi = vlo;
+            for (i = 2; i + 2 <= count; i += 2) {
+                v128_t v = wasm_v128_load(values + i);
+                vlo = wasm_f64x2_pmin(vlo, v);
+                vhi = wasm_f64x2_pmax(vhi, v);
+            }
+            lo = std::min(wasm_f64x2_extract_lane(vlo, 0), wasm_f64x2_extract_lane(vlo, 1));
+            hi = std::max(wasm_f64x2_extract_lane(vhi, 0), wasm_f64x2_extract_lane(vhi, 1));
+        }
+#endif
+        for (; i < count; ++i) {
+            lo = std::min(lo, values[i]);
+            hi = std::max(hi, values[i]);
+        }
+        min_out = lo;
+        max_out = hi;
+    }
+
+    /**
+     * @brief Index of the first set bit at or after from_bit
+     * @param words Bitmap, bit i is bit (i % 64) of words[i / 64]
+     * @return Bit index, or NPOS if there is none
+     *
+     * Whole runs of zero words are skipped four (AVX2) or two words per test.
+     * Padding bits in the last word are scanned like the rest, so callers
+     * either keep them clear (set, for find_first_clear) or bound-check the
+     * result.
+     */
+    static size_t find_first_set(const uint64_t* words, size_t word_count, size_t from_bit = 0) {
+        return find_first(words, word_count, from_bit, 0);
+    }
+
+    // Index of the first clear bit at or after from_bit, or NPOS
+    static size_t find_first_clear(const uint64_t* words, size_t word_count, size_t from_bit = 0) {
+        return find_first(words, word_count, from_bit, ~uint64_t{0});
+    }
+
+    static size_t count_set(const uint64_t* words, size_t word_count) {
+        size_t total = 0;
+        for (size_t i = 0; i < word_count; ++i) total += popcount(words[i]);
+        return total;
+    }
+
+    static unsigned count_trailing_zeros(uint64_t word) {   // word must be non-zero
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward64(&index, word);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctzll(word));
+#endif
+    }
+
+    static unsigned popcount(uint64_t word) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        return static_cast<unsigned>(__popcnt64(word));
+#else
+        return static_cast<unsigned>(__builtin_popcountll(word));
+#endif
+    }
+
+private:
+#if defined(MEMORY_ENGINE_SIMD_AVX2)
+    static double horizontal_sum(__m256d v) {
+        return horizontal_sum(_mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1)));
+    }
+#endif
+#if defined(MEMORY_ENGINE_SIMD_AVX2) || defined(MEMORY_ENGINE_SIMD_SSE2)
+    static double horizontal_sum(__m128d v) {
+        return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+    }
+#endif
+
+    // skip is the word value with no interesting bit: 0 when looking for set
+    // bits, all ones when looking for clear ones
+    static size_t find_first(const uint64_t* words, size_t word_count, size_t from_bit, uint64_t skip) {
+        size_t w = from_bit / 64;
+        if (w >= word_count) return NPOS;
+
+        // Partial first word: mask off bits below from_bit
+        uint64_t first = (words[w] ^ skip) & (~uint64_t{0} << (from_bit % 64));
+        if (first) return w * 64 + count_trailing_zeros(first);
+        ++w;
+
+#if defined(MEMORY_ENGINE_SIMD_AVX2)
+        const __m256i s = _mm256_set1_epi64x(static_cast<long long>(skip));
+        for (; w + 4 <= word_count; w += 4) {
+            __m256i v = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + w)), s);
+            if (!_mm256_testz_si256(v, v)) break;
+        }
+#elif defined(MEMORY_ENGINE_SIMD_SSE2)
+        const __m128i s = _mm_set1_epi64x(static_cast<long long>(skip));
+        for (; w + 2 <= word_count; w += 2) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + w));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, s)) != 0xFFFF) break;
+        }
+#elif defined(MEMORY_ENGINE_SIMD_NEON)
+        const uint64x2_t s = vdupq_n_u64(skip);
+        for (; w + 2 <= word_count; w += 2) {
+            uint64x2_t v = veorq_u64(vld1q_u64(words + w), s);
+            if (vmaxvq_u32(vreinterpretq_u32_u64(v)) != 0) break;
+        }
+#elif defined(MEMORY_ENGINE_SIMD_WASM)
+        const v128_t s = wasm_i64x2_splat(static_cast<int64_t>(skip));
+        for (; w + 2 <= word_count; w += 2) {
+            if (wasm_v128_any_true(wasm_v128_xor(wasm_v128_load(words + w), s))) break;
+        }
+#endif
+        for (; w < word_count; ++w) {
+            uint64_t word = words[w] ^ skip;
+            if (word) return w * 64 + count_trailing_zeros(word);
+        }
+        return NPOS;
+    }
+};
+
+} // namespace memory_engine
+
+#endif // SIMD_HPP
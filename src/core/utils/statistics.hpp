@@ -6,6 +6,7 @@
 #ifndef STATISTICS_HPP
 #define STATISTICS_HPP
 
+#include "simd.hpp"
 #include <vector>
 #include <algorithm>
 #include <cmath>
@@ -21,43 +22,139 @@ struct BenchmarkResult {
     double max = 0;
     double p95 = 0;
     double p99 = 0;
+    double p999 = 0;
+    double ci_low = 0;      ///< 95% confidence interval of the mean (Student's t)
+    double ci_high = 0;
     size_t sample_count = 0;
 };
 
+/**
+ * @struct Comparison
+ * @brief Baseline vs. current result of the same measurement
+ */
+struct Comparison {
+    double change_percent = 0;     ///< (current - baseline) / baseline, percent
+    double t_statistic = 0;        ///< Welch's t; 0 when either side has fewer than 2 samples
+    double degrees_of_freedom = 0;
+    bool significant = false;      ///< Means differ at 95% confidence
+};
+
 class Statistics {
 public:
+    /**
+     * @brief Summarize samples
+     *
+     * Order statistics come from successive nth_element passes over shrinking
+     * ranges, O(n) rather than a full sort; sum, variance and min/max use the
+     * Simd kernels. The samples are reordered in the process (partitioned
+     * around each percentile, not sorted).
+     */
     static BenchmarkResult analyze(std::vector<double>& samples) {
         BenchmarkResult result;
         if (samples.empty()) return result;
 
-        result.sample_count = samples.size();
-        std::sort(samples.begin(), samples.end());
-
-        result.min = samples.front();
-        result.max = samples.back();
-        result.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
-        
-        size_t mid = samples.size() / 2;
-        result.median = (samples.size() % 2 == 0) 
-            ? (samples[mid - 1] + samples[mid]) / 2.0 
-            : samples[mid];
-
-        double variance = 0;
-        for (double s : samples) {
-            variance += (s - result.mean) * (s - result.mean);
+        const size_t n = samples.size();
+        const double* data = samples.data();
+        result.sample_count = n;
+        Simd::min_max(data, n, result.min, result.max);
+        result.mean = Simd::sum(data, n) / n;
+        result.std_dev = std::sqrt(Simd::sum_squared_deviation(data, n, result.mean) / n);
+
+        // Ascending ranks; each pass leaves everything >= its rank to the right
+        const size_t mid = n / 2;
+        const size_t ranks[] = {n % 2 == 0 ? mid - 1 : mid, mid,
+                                static_cast<size_t>(n * 0.95), static_cast<size_t>(n * 0.99),
+                                static_cast<size_t>(n * 0.999)};
+        double values[5];
+        size_t start = 0;
+        for (size_t i = 0; i < 5; ++i) {
+            size_t rank = ranks[i];
+            if (rank >= start) {
+                std::nth_element(samples.begin() + start, samples.begin() + rank, samples.end());
+                start = rank + 1;
+            }
+            values[i] = samples[rank];
         }
-        result.std_dev = std::sqrt(variance / samples.size());
 
-        result.p95 = samples[static_cast<size_t>(samples.size() * 0.95)];
-        result.p99 = samples[static_cast<size_t>(samples.size() * 0.99)];
+        result.median = (values[0] + values[1]) / 2.0;
+        result.p95 = values[2];
+        result.p99 = values[3];
+        result.p999 = values[4];
+        set_confidence_interval(result);
 
         return result;
     }
 
+    /**
+     * @brief Fill ci_low/ci_high from mean, std_dev and sample_count
+     *
+     * std_dev is the population deviation, so it is corrected to the sample
+     * deviation first. With one sample the interval is the mean itself.
+     */
+    static void set_confidence_interval(BenchmarkResult& result) {
+        result.ci_low = result.ci_high = result.mean;
+        if (result.sample_count < 2) return;
+        double n = static_cast<double>(result.sample_count);
+        double half_width = t_critical_95(n - 1) * sample_std_dev(result) / std::sqrt(n);
+        result.ci_low = result.mean - half_width;
+        result.ci_high = result.mean + half_width;
+    }
+
+    /**
+     * @brief Welch's t-test between two summaries
+     *
+     * Works from mean, std_dev and sample_count alone, so a baseline loaded
+     * from an earlier run's export can be compared without its samples.
+     */
+    static Comparison compare(const BenchmarkResult& baseline, const BenchmarkResult& current) {
+        Comparison comparison;
+        if (baseline.mean != 0) {
+            comparison.change_percent = (current.mean - baseline.mean) / baseline.mean * 100.0;
+        }
+        if (baseline.sample_count < 2 || current.sample_count < 2) return comparison;
+
+        double n1 = static_cast<double>(baseline.sample_count);
+        double n2 = static_cast<double>(current.sample_count);
+        double v1 = sample_std_dev(baseline) * sample_std_dev(baseline) / n1;
+        double v2 = sample_std_dev(current) * sample_std_dev(current) / n2;
+        if (v1 + v2 <= 0) {
+            // Both sides constant: any difference at all is real
+            comparison.significant = current.mean != baseline.mean;
+            return comparison;
+        }
+
+        comparison.t_statistic = (current.mean - baseline.mean) / std::sqrt(v1 + v2);
+        comparison.degrees_of_freedom = (v1 + v2) * (v1 + v2) /
+            (v1 * v1 / (n1 - 1) + v2 * v2 / (n2 - 1));
+        comparison.significant = std::fabs(comparison.t_statistic) > t_critical_95(comparison.degrees_of_freedom);
+        return comparison;
+    }
+
+    // Two-sided 95% critical value of Student's t
+    static double t_critical_95(double degrees_of_freedom) {
+        static const double TABLE[] = {
+            12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+            2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+            2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+        if (degrees_of_freedom < 1) return TABLE[0];
+        if (degrees_of_freedom <= 30) return TABLE[static_cast<size_t>(degrees_of_freedom) - 1];
+        if (degrees_of_freedom <= 40) return 2.021;
+        if (degrees_of_freedom <= 60) return 2.000;
+        if (degrees_of_freedom <= 120) return 1.980;
+        return 1.960;
+    }
+
     static double throughput(size_t operations, double time_ns) {
         if (time_ns <= 0) return 0;
         return (operations * 1e9) / time_ns;
     }
+
+private:
+    static double sample_std_dev(const BenchmarkResult& result) {
+        if (result.sample_count < 2) return 0;
+        double n = static_cast<double>(result.sample_count);
+        return result.std_dev * std::sqrt(n / (n - 1));
+    }
 };
 
 } // namespace memory_engine
@@ -1,34 +1,229 @@
 /**
  * @file timer.hpp
  * @brief High-resolution timer for benchmarking
+ *
+ * Timestamps come from the CPU cycle counter (rdtsc/rdtscp on x86-64,
+ * cntvct_el0 on AArch64) when it runs at a constant rate, and from
+ * std::chrono::steady_clock otherwise (including WebAssembly). The counter
+ * frequency and the cost of one begin/end timestamp pair are measured once,
+ * on first use; sample_ns() subtracts that cost from every short sample.
  */
 
 #ifndef TIMER_HPP
 #define TIMER_HPP
 
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
+
+/**
+ * @def MEMORY_ENGINE_CYCLE_TIMER
+ * @brief Use the CPU cycle counter where the architecture provides one (default 1)
+ *
+ * Define as 0 (CMake option MEMORY_ENGINE_ENABLE_CYCLE_TIMER=OFF) to time
+ * everything with steady_clock.
+ */
+#ifndef MEMORY_ENGINE_CYCLE_TIMER
+#define MEMORY_ENGINE_CYCLE_TIMER 1
+#endif
+
+#if MEMORY_ENGINE_CYCLE_TIMER && !defined(__EMSCRIPTEN__) && \
+    (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86))
+#define MEMORY_ENGINE_TIMER_X86 1
+#ifdef _WIN32
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#elif MEMORY_ENGINE_CYCLE_TIMER && !defined(__EMSCRIPTEN__) && defined(__aarch64__)
+#define MEMORY_ENGINE_TIMER_ARM64 1
+#endif
 
 namespace memory_engine {
 
+// Result of the one-time timer calibration
+struct TimerCalibration {
+    const char* backend = "steady_clock";
+    bool cycle_counter = false;    ///< Ticks come from the CPU counter, not steady_clock
+    double ticks_per_ns = 1.0;
+    uint64_t overhead_ticks = 0;   ///< Cheapest back-to-back begin/end pair
+    double overhead_ns = 0.0;
+};
+
+namespace timer_detail {
+
+inline uint64_t steady_ticks() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+#if defined(MEMORY_ENGINE_TIMER_X86)
+// lfence keeps earlier instructions from drifting past the first read and
+// later ones from starting before it; rdtscp waits for the measured code.
+inline uint64_t cycle_begin() {
+    _mm_lfence();
+    uint64_t t = __rdtsc();
+    _mm_lfence();
+    return t;
+}
+
+inline uint64_t cycle_end() {
+    unsigned aux;
+    uint64_t t = __rdtscp(&aux);
+    _mm_lfence();
+    return t;
+}
+
+// Invariant TSC (CPUID 0x80000007 EDX bit 8): constant rate across P/C-states
+inline bool cycle_counter_usable() {
+#ifdef _WIN32
+    int regs[4];
+    __cpuid(regs, 0x80000000);
+    if (static_cast<unsigned>(regs[0]) < 0x80000007u) return false;
+    __cpuid(regs, 0x80000007);
+    return (regs[3] & (1 << 8)) != 0;
+#else
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) return false;
+    return (edx & (1u << 8)) != 0;
+#endif
+}
+#elif defined(MEMORY_ENGINE_TIMER_ARM64)
+inline uint64_t cycle_begin() {
+    uint64_t t;
+    asm volatile("isb\n\tmrs %0, cntvct_el0" : "=r"(t) : : "memory");
+    return t;
+}
+
+inline uint64_t cycle_end() {
+    uint64_t t;
+    asm volatile("isb\n\tmrs %0, cntvct_el0\n\tisb" : "=r"(t) : : "memory");
+    return t;
+}
+
+// The generic timer always runs at a fixed frequency
+inline bool cycle_counter_usable() { return true; }
+
+inline uint64_t cycle_frequency_hz() {
+    uint64_t hz;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(hz));
+    return hz;
+}
+#endif
+
+template <typename Begin, typename End>
+uint64_t measure_overhead(Begin begin, End end) {
+    constexpr int TRIALS = 1000;
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < TRIALS; ++i) {
+        uint64_t t0 = begin();
+        uint64_t t1 = end();
+        best = std::min(best, t1 - t0);
+    }
+    return best;
+}
+
+inline TimerCalibration calibrate() {
+    TimerCalibration result;
+
+#if defined(MEMORY_ENGINE_TIMER_X86) || defined(MEMORY_ENGINE_TIMER_ARM64)
+    if (cycle_counter_usable()) {
+        result.cycle_counter = true;
+#if defined(MEMORY_ENGINE_TIMER_ARM64)
+        result.backend = "cntvct";
+        result.ticks_per_ns = cycle_frequency_hz() / 1e9;
+#else
+        result.backend = "rdtscp";
+        // Count ticks across a steady_clock window; each steady read is
+        // bracketed by counter reads so the window edges line up
+        constexpr uint64_t WINDOW_NS = 20000000;
+        uint64_t c0 = cycle_begin();
+        uint64_t s0 = steady_ticks();
+        uint64_t c1 = cycle_end();
+        uint64_t s1, c2, c3;
+        do {
+            c2 = cycle_begin();
+            s1 = steady_ticks();
+            c3 = cycle_end();
+        } while (s1 - s0 < WINDOW_NS);
+        double ticks = ((c2 + c3) / 2.0) - ((c0 + c1) / 2.0);
+        result.ticks_per_ns = ticks / static_cast<double>(s1 - s0);
+#endif
+        if (result.ticks_per_ns <= 0) {
+            result = TimerCalibration{};
+        } else {
+            result.overhead_ticks = measure_overhead(cycle_begin, cycle_end);
+        }
+    }
+#endif
+
+    if (!result.cycle_counter) {
+        result.overhead_ticks = measure_overhead(steady_ticks, steady_ticks);
+    }
+    result.overhead_ns = result.overhead_ticks / result.ticks_per_ns;
+    return result;
+}
+
+} // namespace timer_detail
+
 class Timer {
 public:
-    using Clock = std::chrono::high_resolution_clock;
+    using Clock = std::chrono::steady_clock;
     using TimePoint = Clock::time_point;
     using Duration = std::chrono::nanoseconds;
 
-    Timer() : m_running(false), m_elapsed(0) {}
+    Timer() : m_running(false), m_start(0), m_elapsed(0) {}
+
+    // Calibrated once per process (thread-safe on first use)
+    static const TimerCalibration& calibration() {
+        static const TimerCalibration calibration = timer_detail::calibrate();
+        return calibration;
+    }
+
+    // Fenced timestamps in backend ticks; pair them around the measured code
+    static uint64_t ticks_begin() {
+#if defined(MEMORY_ENGINE_TIMER_X86) || defined(MEMORY_ENGINE_TIMER_ARM64)
+        if (calibration().cycle_counter) return timer_detail::cycle_begin();
+#endif
+        return timer_detail::steady_ticks();
+    }
+
+    static uint64_t ticks_end() {
+#if defined(MEMORY_ENGINE_TIMER_X86) || defined(MEMORY_ENGINE_TIMER_ARM64)
+        if (calibration().cycle_counter) return timer_detail::cycle_end();
+#endif
+        return timer_detail::steady_ticks();
+    }
+
+    static double ticks_to_ns(uint64_t ticks) {
+        return ticks / calibration().ticks_per_ns;
+    }
+
+    // Duration of one short operation with the timer's own cost removed.
+    // Stamps from different cores may be slightly skewed; an end before its
+    // begin reads as zero.
+    static uint64_t sample_ns(uint64_t begin_ticks, uint64_t end_ticks) {
+        uint64_t overhead = calibration().overhead_ticks;
+        if (end_ticks < begin_ticks || end_ticks - begin_ticks <= overhead) return 0;
+        return static_cast<uint64_t>(ticks_to_ns(end_ticks - begin_ticks - overhead) + 0.5);
+    }
+
+    // Wall-clock timestamp (steady_clock) for long spans and logging
+    static uint64_t now_ns() {
+        return timer_detail::steady_ticks();
+    }
 
     void start() {
         if (!m_running) {
-            m_start = Clock::now();
+            m_start = ticks_begin();
             m_running = true;
         }
     }
 
     void stop() {
         if (m_running) {
-            auto end = Clock::now();
-            m_elapsed += std::chrono::duration_cast<Duration>(end - m_start).count();
+            m_elapsed += ticks_end() - m_start;
             m_running = false;
         }
     }
@@ -38,11 +233,9 @@ public:
 
     double elapsed_ns() const {
         if (m_running) {
-            auto now = Clock::now();
-            return static_cast<double>(m_elapsed + 
-                std::chrono::duration_cast<Duration>(now - m_start).count());
+            return ticks_to_ns(m_elapsed + (ticks_end() - m_start));
         }
-        return static_cast<double>(m_elapsed);
+        return ticks_to_ns(m_elapsed);
     }
 
     double elapsed_us() const { return elapsed_ns() / 1000.0; }
@@ -51,9 +244,9 @@ public:
     bool is_running() const { return m_running; }
 
 private:
-    TimePoint m_start;
     bool m_running;
-    int64_t m_elapsed;
+    uint64_t m_start;
+    uint64_t m_elapsed;   ///< Backend ticks
 };
 
 class ScopedTimer {
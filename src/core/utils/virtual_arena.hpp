@@ -0,0 +1,258 @@
+/**
+ * @file virtual_arena.hpp
+ * @brief Reserve-then-commit virtual memory range for growable arenas
+ *
+ * The whole range is reserved up front (address space only) and committed
+ * from the start as the owner grows, so a large arena costs nothing until it
+ * is used. Committed pages can be returned to the OS without giving up the
+ * reservation.
+ */
+
+#ifndef VIRTUAL_ARENA_HPP
+#define VIRTUAL_ARENA_HPP
+
+#include "memory_utils.hpp"
+#include "numa.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace memory_engine {
+
+/**
+ * @enum HugePages
+ * @brief Page size requested for a virtual arena
+ */
+enum class HugePages {
+    NONE,         ///< Base pages
+    TRANSPARENT,  ///< Huge-page aligned range with madvise(MADV_HUGEPAGE) (Linux THP)
+    EXPLICIT      ///< MAP_HUGETLB / MEM_LARGE_PAGES; falls back to TRANSPARENT, then NONE
+};
+
+struct VirtualArenaConfig {
+    size_t reserve_size = MemoryUtils::GB(1); ///< Address space reserved; the arena's hard cap
+    size_t initial_commit = 0;                ///< Committed up front and kept across reset()
+    size_t commit_step = MemoryUtils::KB(64); ///< Growth granularity (a huge page when huge pages are used)
+    HugePages huge_pages = HugePages::NONE;
+    int numa_node = Numa::ANY_NODE;           ///< Bind the range to this node (Linux)
+};
+
+class VirtualArena {
+public:
+    VirtualArena() = default;
+
+    /**
+     * @brief Reserve the range described by config
+     *
+     * On failure the arena stays empty (base() == nullptr). huge_pages()
+     * reports what was actually obtained after any fallback.
+     */
+    explicit VirtualArena(const VirtualArenaConfig& config) {
+        reserve(config);
+        if (m_base && config.initial_commit) commit(config.initial_commit);
+    }
+
+    ~VirtualArena() { release(); }
+
+    VirtualArena(const VirtualArena&) = delete;
+    VirtualArena& operator=(const VirtualArena&) = delete;
+
+    VirtualArena(VirtualArena&& other) noexcept { swap(other); }
+
+    VirtualArena& operator=(VirtualArena&& other) noexcept {
+        if (this != &other) {
+            release();
+            swap(other);
+        }
+        return *this;
+    }
+
+    uint8_t* base() const { return m_base; }
+    size_t reserved() const { return m_reserved; }
+    size_t committed() const { return m_committed; }
+    size_t granularity() const { return m_granularity; }
+    HugePages huge_pages() const { return m_huge_pages; }
+    bool numa_bound() const { return m_numa_bound; }
+
+    /**
+     * @brief Make at least bytes from the start of the range usable
+     * @return false if bytes exceeds the reservation or the OS refused
+     *
+     * Rounds up to the granularity; never shrinks.
+     */
+    bool commit(size_t bytes) {
+        if (!m_base || bytes > m_reserved) return false;
+        if (bytes <= m_committed) return true;
+        size_t target = std::min(MemoryUtils::align_forward(bytes, m_granularity), m_reserved);
+        if (!os_commit(m_base + m_committed, target - m_committed)) return false;
+        m_committed = target;
+        return true;
+    }
+
+    /**
+     * @brief Return the physical pages past keep_bytes to the OS
+     *
+     * The range stays reserved; the released part reads back as zeros once
+     * it is committed again.
+     */
+    void decommit(size_t keep_bytes) {
+        if (!m_base) return;
+        size_t keep = std::min(MemoryUtils::align_forward(keep_bytes, m_granularity), m_committed);
+        if (keep < m_committed) {
+            os_decommit(m_base + keep, m_committed - keep);
+            m_committed = keep;
+        }
+    }
+
+private:
+    uint8_t* m_base = nullptr;
+    size_t m_reserved = 0;
+    size_t m_committed = 0;
+    size_t m_granularity = 0;
+    size_t m_mapping_offset = 0;   ///< m_base minus the start of the OS mapping
+    size_t m_mapping_size = 0;
+    HugePages m_huge_pages = HugePages::NONE;
+    bool m_numa_bound = false;
+
+    void swap(VirtualArena& other) noexcept {
+        std::swap(m_base, other.m_base);
+        std::swap(m_reserved, other.m_reserved);
+        std::swap(m_committed, other.m_committed);
+        std::swap(m_granularity, other.m_granularity);
+        std::swap(m_mapping_offset, other.m_mapping_offset);
+        std::swap(m_mapping_size, other.m_mapping_size);
+        std::swap(m_huge_pages, other.m_huge_pages);
+        std::swap(m_numa_bound, other.m_numa_bound);
+    }
+
+    void reserve(const VirtualArenaConfig& config) {
+        const size_t page = MemoryUtils::get_page_size();
+        const size_t huge = MemoryUtils::get_huge_page_size();
+        HugePages mode = huge ? config.huge_pages : HugePages::NONE;
+
+#if defined(__linux__)
+        if (mode == HugePages::EXPLICIT) {
+            // Taken from the hugetlbfs pool at mmap time, so this fails
+            // cleanly when the pool is too small instead of faulting later
+            size_t size = MemoryUtils::align_forward(config.reserve_size, huge);
+            void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (memory != MAP_FAILED) {
+                adopt(static_cast<uint8_t*>(memory), 0, size, size, huge, HugePages::EXPLICIT);
+                m_numa_bound = Numa::bind_range(m_base, m_reserved, config.numa_node);
+                return;
+            }
+            mode = HugePages::TRANSPARENT;
+        }
+
+        // PROT_NONE reservation; commit() opens it up with mprotect
+        size_t align = mode == HugePages::TRANSPARENT ? huge : page;
+        size_t size = MemoryUtils::align_forward(config.reserve_size, align);
+        size_t mapping = size + (align > page ? align : 0);
+        void* memory = mmap(nullptr, mapping, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (memory == MAP_FAILED) return;
+        uint8_t* start = static_cast<uint8_t*>(memory);
+        uint8_t* aligned = reinterpret_cast<uint8_t*>(
+            MemoryUtils::align_forward(reinterpret_cast<size_t>(start), align));
+
+        if (mode == HugePages::TRANSPARENT && madvise(aligned, size, MADV_HUGEPAGE) != 0) {
+            mode = HugePages::NONE;
+        }
+        size_t step = mode == HugePages::NONE ? std::max(config.commit_step, page) : huge;
+        adopt(aligned, static_cast<size_t>(aligned - start), mapping, size,
+              MemoryUtils::align_forward(step, page), mode);
+        m_numa_bound = Numa::bind_range(m_base, m_reserved, config.numa_node);
+#elif defined(_WIN32)
+        if (mode == HugePages::EXPLICIT) {
+            // Large pages cannot be committed piecemeal and need
+            // SeLockMemoryPrivilege; commit the whole range or fall back
+            size_t size = MemoryUtils::align_forward(config.reserve_size, huge);
+            void* memory = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+            if (memory) {
+                adopt(static_cast<uint8_t*>(memory), 0, size, size, huge, HugePages::EXPLICIT);
+                m_committed = size;
+                return;
+            }
+        }
+        mode = HugePages::NONE; // No transparent huge pages on Windows
+
+        size_t size = MemoryUtils::align_forward(config.reserve_size, page);
+        void* memory = config.numa_node >= 0
+            ? VirtualAllocExNuma(GetCurrentProcess(), nullptr, size, MEM_RESERVE, PAGE_NOACCESS,
+                                 static_cast<DWORD>(config.numa_node))
+            : VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+        if (!memory) return;
+        adopt(static_cast<uint8_t*>(memory), 0, size, size,
+              MemoryUtils::align_forward(std::max(config.commit_step, page), page), mode);
+        m_numa_bound = config.numa_node >= 0;
+#else
+        // No virtual memory control (e.g. WebAssembly): one eager block
+        size_t size = MemoryUtils::align_forward(config.reserve_size, page);
+        void* memory = std::aligned_alloc(page, size);
+        if (!memory) return;
+        adopt(static_cast<uint8_t*>(memory), 0, size, size, std::max(config.commit_step, page), HugePages::NONE);
+#endif
+    }
+
+    void adopt(uint8_t* base, size_t offset, size_t mapping_size, size_t reserved,
+               size_t granularity, HugePages mode) {
+        m_base = base;
+        m_mapping_offset = offset;
+        m_mapping_size = mapping_size;
+        m_reserved = reserved;
+        m_granularity = granularity;
+        m_huge_pages = mode;
+        m_committed = 0;
+    }
+
+    bool os_commit(uint8_t* start, size_t size) {
+#if defined(__linux__)
+        if (m_huge_pages == HugePages::EXPLICIT) return true; // Mapped read-write already
+        return mprotect(start, size, PROT_READ | PROT_WRITE) == 0;
+#elif defined(_WIN32)
+        if (m_huge_pages == HugePages::EXPLICIT) return true; // Committed at reservation
+        return VirtualAlloc(start, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+        (void)start;
+        (void)size;
+        return true;
+#endif
+    }
+
+    void os_decommit(uint8_t* start, size_t size) {
+#if defined(__linux__)
+        madvise(start, size, MADV_DONTNEED);
+        if (m_huge_pages != HugePages::EXPLICIT) mprotect(start, size, PROT_NONE);
+#elif defined(_WIN32)
+        if (m_huge_pages == HugePages::EXPLICIT) return; // Large pages stay locked
+        VirtualFree(start, size, MEM_DECOMMIT);
+#else
+        (void)start;
+        (void)size;
+#endif
+    }
+
+    void release() {
+        if (!m_base) return;
+#if defined(__linux__)
+        munmap(m_base - m_mapping_offset, m_mapping_size);
+#elif defined(_WIN32)
+        VirtualFree(m_base, 0, MEM_RELEASE);
+#else
+        std::free(m_base);
+#endif
+        m_base = nullptr;
+        m_reserved = 0;
+        m_committed = 0;
+    }
+};
+
+} // namespace memory_engine
+
+#endif // VIRTUAL_ARENA_HPP
@@ -6,6 +6,10 @@
 #include "core/engine.hpp"
 #include <iostream>
 #include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
 
 using namespace memory_engine;
 
@@ -21,9 +25,235 @@ void print_benchmark_results(const BenchmarkMetrics& metrics) {
     std::cout << "  Min/Max:           " << metrics.allocation_time.min << " / " 
               << metrics.allocation_time.max << " ns" << std::endl;
     std::cout << "  Std Dev:           " << metrics.allocation_time.std_dev << " ns" << std::endl;
+    std::cout << "  Alloc p99/p99.9:   " << metrics.allocation_time.p99 << " / "
+              << metrics.allocation_time.p999 << " ns" << std::endl;
+    std::cout << "  Dealloc p50/p99.9: " << metrics.deallocation_time.median << " / "
+              << metrics.deallocation_time.p999 << " ns" << std::endl;
     std::cout << "  Throughput:        " << metrics.throughput << " ops/sec" << std::endl;
     std::cout << "  Peak Memory:       " << metrics.peak_memory / 1024.0 << " KB" << std::endl;
     std::cout << "  Fragmentation:     " << metrics.fragmentation << "%" << std::endl;
+    if (metrics.failed_allocations || metrics.rejected_deallocations) {
+        std::cout << "  Failed/Rejected:   " << metrics.failed_allocations << " allocs / "
+                  << metrics.rejected_deallocations << " frees" << std::endl;
+    }
+}
+
+void print_perf_counters(const std::string& label, const PerfCounters& counters, bool header) {
+    static const PerfEvent columns[] = {PerfEvent::CYCLES, PerfEvent::INSTRUCTIONS, PerfEvent::L1D_MISSES,
+                                        PerfEvent::LLC_MISSES, PerfEvent::DTLB_MISSES, PerfEvent::BRANCH_MISSES,
+                                        PerfEvent::CONTEXT_SWITCHES};
+    if (header) {
+        std::cout << std::left << std::setw(36) << "  Region" << std::right << std::setw(9) << "Cycles"
+                  << std::setw(9) << "Instr" << std::setw(6) << "IPC" << std::setw(9) << "L1d"
+                  << std::setw(9) << "LLC" << std::setw(9) << "dTLB" << std::setw(9) << "BrMiss"
+                  << std::setw(9) << "CtxSw" << std::endl;
+    }
+    std::cout << "  " << std::left << std::setw(34) << label << std::right << std::fixed;
+    if (!counters.any()) {
+        std::cout << "  unavailable (no perf_event access)" << std::endl;
+        return;
+    }
+    for (size_t i = 0; i < 2; ++i) {
+        std::cout << std::setprecision(1) << std::setw(9);
+        if (counters.has(columns[i])) std::cout << counters.value(columns[i]); else std::cout << "-";
+    }
+    std::cout << std::setprecision(2) << std::setw(6);
+    if (counters.ipc() > 0) std::cout << counters.ipc(); else std::cout << "-";
+    for (size_t i = 2; i < sizeof(columns) / sizeof(columns[0]); ++i) {
+        std::cout << std::setprecision(3) << std::setw(9);
+        if (counters.has(columns[i])) std::cout << counters.value(columns[i]); else std::cout << "-";
+    }
+    std::cout << std::endl;
+}
+
+void print_scaling_results(const std::vector<BenchmarkMetrics>& results) {
+    if (results.empty()) return;
+    std::cout << "\nAllocator: " << results.front().allocator_name << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& metrics : results) {
+        std::cout << "  " << std::setw(2) << metrics.thread_count << " threads: "
+                  << std::setw(10) << metrics.allocation_time.mean << " ns alloc, "
+                  << std::setw(10) << metrics.deallocation_time.mean << " ns dealloc, "
+                  << metrics.throughput << " ops/sec" << std::endl;
+    }
+}
+
+// Same pool under each policy. Every pool is warmed up first and the
+// policies take turns for several rounds, so page faults and clock drift
+// hit them alike; the median round's per-op median is reported.
+void print_policy_overhead(const BenchmarkConfig& config) {
+    constexpr size_t ROUNDS = 7;
+    BenchmarkConfig warmed = config;
+    warmed.warmup_iterations = 2;
+
+    BasicPoolAllocator<NoStats> no_stats(config.object_size, config.object_count);
+    BasicPoolAllocator<CountersOnly> counters(config.object_size, config.object_count);
+    BasicPoolAllocator<SampledTiming<>> sampled(config.object_size, config.object_count);
+    BasicPoolAllocator<FullHistory> history(config.object_size, config.object_count);
+    struct Row {
+        const char* label;
+        BaseAllocator* pool;
+        std::vector<double> alloc_ns;
+        std::vector<double> dealloc_ns;
+    };
+    Row rows[] = {{"NoStats", &no_stats, {}, {}}, {"CountersOnly", &counters, {}, {}},
+                  {"SampledTiming", &sampled, {}, {}}, {"FullHistory", &history, {}, {}}};
+
+    BenchmarkRunner runner;
+    for (size_t round = 0; round < ROUNDS; ++round) {
+        for (Row& row : rows) {
+            auto metrics = runner.run_allocation_benchmark(*row.pool, warmed);
+            row.alloc_ns.push_back(metrics.allocation_time.median);
+            row.dealloc_ns.push_back(metrics.deallocation_time.median);
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (Row& row : rows) {
+        std::cout << "  " << std::left << std::setw(16) << row.label << std::right
+                  << std::setw(10) << Statistics::analyze(row.alloc_ns).median << " ns alloc, "
+                  << std::setw(10) << Statistics::analyze(row.dealloc_ns).median << " ns dealloc" << std::endl;
+    }
+}
+
+void print_batch_comparison(Engine& engine, AllocatorType type, const BenchmarkConfig& config) {
+    BenchmarkConfig batched = config;
+    batched.batch_size = 64;
+
+    engine.set_allocator(type);
+    auto single = engine.run_benchmark(config);
+    auto batch = engine.run_benchmark(batched);
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  " << std::left << std::setw(24) << single.allocator_name << std::right
+              << std::setw(8) << single.allocation_time.mean << " ns per-call, "
+              << std::setw(8) << batch.allocation_time.mean << " ns batched" << std::endl;
+}
+
+const char* huge_pages_name(HugePages mode) {
+    switch (mode) {
+        case HugePages::NONE: return "base pages";
+        case HugePages::TRANSPARENT: return "transparent huge";
+        case HugePages::EXPLICIT: return "explicit huge";
+    }
+    return "unknown";
+}
+
+// Fills a stack with 4 KB blocks, writing each, then resets it
+template <typename Stack>
+void print_arena_fill(const char* label, Stack& stack, size_t bytes, double construct_ns, const char* pages) {
+    size_t rss_before = MemoryUtils::current_rss();
+    Timer timer;
+    timer.start();
+    size_t filled = 0;
+    while (filled < bytes) {
+        void* block = stack.allocate(4096);
+        if (!block) break;
+        std::memset(block, 1, 4096);
+        filled += 4096;
+    }
+    timer.stop();
+    size_t rss_full = MemoryUtils::current_rss();
+    stack.reset();
+    size_t rss_reset = MemoryUtils::current_rss();
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  " << std::left << std::setw(30) << label << std::right
+              << std::setw(10) << construct_ns / 1000.0 << " us"
+              << std::setw(10) << timer.elapsed_ms() << " ms"
+              << std::setw(10) << filled / 1048576.0 << " MB"
+              << std::setw(10) << (rss_full > rss_before ? rss_full - rss_before : 0) / 1048576.0
+              << std::setw(10) << (rss_reset > rss_before ? rss_reset - rss_before : 0) / 1048576.0
+              << "  " << pages << std::endl;
+}
+
+// One row per structure: sequential and random ns per node, plus the layout they ran over
+void print_locality_results(const std::vector<LocalityMetrics>& results) {
+    if (results.empty()) return;
+    const auto& layout = results.front();
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n" << layout.allocator_name << ": " << layout.nodes << " nodes on " << layout.pages_touched
+              << " pages, median stride " << layout.median_stride << " B, "
+              << layout.adjacent_ratio * 100.0 << "% adjacent";
+    if (layout.failed_allocations || layout.rejected_deallocations) {
+        std::cout << "  [" << layout.failed_allocations << " failed, "
+                  << layout.rejected_deallocations << " rejected]";
+    }
+    std::cout << std::endl;
+    for (const auto& result : results) {
+        std::cout << "  " << std::left << std::setw(16) << LocalityBenchmark::structure_name(result.structure)
+                  << std::right << " seq " << std::setw(7) << result.sequential_time.median
+                  << " ns  random " << std::setw(7) << result.random_time.median
+                  << " ns  (" << result.random_penalty << "x)" << std::endl;
+    }
+}
+
+// Pareto front first; the rest are dominated or failed part of the workload
+void print_auto_tune(const AutoTuneReport& report) {
+    if (!report.error.empty()) {
+        std::cout << "  Error: " << report.error << std::endl;
+        return;
+    }
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  " << report.op_count << " ops, peak " << report.peak_live_objects << " objects / "
+              << report.peak_live_bytes / 1024.0 << " KB live, " << report.candidates.size()
+              << " candidates in " << report.total_time_ms << " ms" << std::endl;
+    std::cout << std::left << std::setw(54) << "  Configuration" << std::right << std::setw(14) << "Ops/s"
+              << std::setw(10) << "p99 ns" << std::setw(14) << "Footprint KB" << std::endl;
+    for (const auto& candidate : report.candidates) {
+        if (!candidate.feasible) continue;
+        std::string label = candidate.allocator + " " + candidate.parameters;
+        std::cout << (candidate.pareto ? "* " : "  ") << std::left << std::setw(52) << label << std::right
+                  << std::setw(14) << candidate.throughput
+                  << std::setw(10) << candidate.p99_latency_ns
+                  << std::setw(14) << candidate.footprint_bytes / 1024.0 << std::endl;
+    }
+    size_t infeasible = static_cast<size_t>(std::count_if(report.candidates.begin(), report.candidates.end(),
+        [](const TuningResult& candidate) { return !candidate.feasible; }));
+    if (infeasible) std::cout << "  (" << infeasible << " candidates failed allocations or frees)" << std::endl;
+}
+
+void print_trace_results(const TraceReplayMetrics& metrics) {
+    std::cout << "\nAllocator: " << metrics.allocator_name << std::endl;
+    if (!metrics.error.empty()) {
+        std::cout << "  Error: " << metrics.error << std::endl;
+        return;
+    }
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  Ops:               " << metrics.op_count << " (" << metrics.thread_count
+              << " recorded threads)" << std::endl;
+    std::cout << "  Failed/Unmatched:  " << metrics.failed_allocations << " / "
+              << metrics.unmatched_frees << std::endl;
+    std::cout << "  Alloc p50/p99:     " << metrics.allocation_time.median << " / "
+              << metrics.allocation_time.p99 << " ns" << std::endl;
+    std::cout << "  Dealloc p50/p99:   " << metrics.deallocation_time.median << " / "
+              << metrics.deallocation_time.p99 << " ns" << std::endl;
+    std::cout << "  Throughput:        " << metrics.throughput << " ops/sec" << std::endl;
+    std::cout << "  Peak Live:         " << metrics.peak_live_bytes / 1024.0 << " KB" << std::endl;
+    std::cout << "  RSS Growth:        " << metrics.rss_growth_bytes / 1024.0 << " KB" << std::endl;
+
+    double peak_fragmentation = 0;
+    for (const auto& point : metrics.timeline) {
+        peak_fragmentation = std::max(peak_fragmentation, point.fragmentation);
+    }
+    std::cout << "  Peak Fragmentation: " << peak_fragmentation << "% over "
+              << metrics.timeline.size() << " samples" << std::endl;
+}
+
+void print_workload_row(const TraceReplayMetrics& metrics) {
+    double peak_fragmentation = 0;
+    for (const auto& point : metrics.timeline) {
+        peak_fragmentation = std::max(peak_fragmentation, point.fragmentation);
+    }
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  " << std::left << std::setw(24) << metrics.allocator_name << std::right
+              << " alloc p50/p99 " << std::setw(7) << metrics.allocation_time.median << " / "
+              << std::setw(8) << metrics.allocation_time.p99 << " ns, frag "
+              << std::setw(6) << peak_fragmentation << "%";
+    if (metrics.failed_allocations || metrics.rejected_frees) {
+        std::cout << "  [" << metrics.failed_allocations << " failed, "
+                  << metrics.rejected_frees << " rejected]";
+    }
+    std::cout << std::endl;
 }
 
 void print_concurrency_results(const ConcurrencyMetrics& metrics) {
@@ -34,11 +264,497 @@ void print_concurrency_results(const ConcurrencyMetrics& metrics) {
     std::cout << "  Throughput:     " << metrics.throughput << " ops/sec" << std::endl;
 }
 
-int main() {
+// Class::function of a demangled name, without return type, template
+// arguments or parameters, to fit a table column
+std::string short_symbol(const std::string& name) {
+    std::string out;
+    int depth = 0;
+    for (char c : name) {
+        if (c == '<') {
+            if (depth++ == 0) out += "<>";
+        } else if (c == '>') {
+            if (depth > 0) depth--;
+        } else if (depth == 0) {
+            if (c == '(') break;
+            if (c == ' ') out.clear(); // Return type
+            else out += c;
+        }
+    }
+    size_t last = out.rfind("::");
+    size_t scope = last == std::string::npos || last == 0 ? std::string::npos : out.rfind("::", last - 1);
+    return scope == std::string::npos ? out : out.substr(scope + 2);
+}
+
+// First frame of a site outside the allocator and its adapters
+std::string profile_caller(const AllocationProfiler& profiler, const ProfileSite& site) {
+    for (const void* frame : site.frames) {
+        std::string name = short_symbol(profiler.symbolize(frame));
+        if (name.find("llocat") != std::string::npos || name.find("memory_resource") != std::string::npos) continue;
+        return name;
+    }
+    return site.frames.empty() ? "[other sites]" : short_symbol(profiler.symbolize(site.frames.front()));
+}
+
+void print_profile_sites(const AllocationProfiler& profiler, size_t limit) {
+    const auto& sites = profiler.sites();
+    std::cout << std::left << std::setw(44) << "  Site (first caller)" << std::right << std::setw(9) << "Samples"
+              << std::setw(12) << "Est. MB" << std::setw(10) << "Freed" << std::setw(12) << "p50 life"
+              << std::setw(12) << "p90 life" << std::setw(8) << "Hint" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (size_t index : profiler.top_sites(ProfileMetric::BYTES, limit)) {
+        const ProfileSite& site = sites[index];
+        std::string caller = profile_caller(profiler, site);
+        if (caller.size() > 41) caller = caller.substr(0, 38) + "...";
+        std::cout << "  " << std::left << std::setw(42) << caller << std::right
+                  << std::setw(9) << site.samples
+                  << std::setw(12) << site.est_bytes / (1024.0 * 1024.0)
+                  << std::setw(9) << (site.samples ? 100.0 * site.freed_samples / site.samples : 0.0) << "%"
+                  << std::setw(9) << site.lifetime.percentile(50.0) / 1000.0 << " us"
+                  << std::setw(9) << site.lifetime.percentile(90.0) / 1000.0 << " us"
+                  << std::setw(8) << AllocationProfiler::hint_name(site.hint) << std::endl;
+    }
+    std::cout << "  " << sites.size() << " sites, " << profiler.live_samples() << " samples still live ("
+              << profiler.live_bytes() / 1024.0 << " KB est.), " << profiler.dropped_samples() << " dropped"
+              << std::endl;
+}
+
+// Command-line driver: selected allocators and tests, results as a
+// table, JSON or CSV, optionally compared against an earlier JSON export
+struct DriverOptions {
+    bool enabled = false;              ///< Any driver option given; otherwise the full suite runs
+    bool help = false;
+    bool list_allocators = false;
+    std::vector<std::string> allocators;         ///< Registry ids
+    std::vector<std::pair<std::string, AllocatorParams>> params;   ///< From --param, per id
+    std::vector<std::string> tests = {"alloc"};
+    std::vector<size_t> sizes = {256};
+    std::vector<size_t> threads = {1, 2, 4, 8};
+    size_t count = 10000;
+    size_t iterations = 10;
+    size_t warmup = 2;
+    bool per_op = false;
+    std::string format = "table";
+    std::string output;
+    std::string baseline;
+    double threshold = 5.0;            ///< Percent
+    std::vector<std::pair<std::string, std::string>> given;   ///< As typed, for the report
+};
+
+const char* const DRIVER_TESTS[] = {"alloc", "batch", "scaling", "container", "locality"};
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  (no options)            full human-readable suite\n"
+              << "  --trace <file>          replay a recorded trace against every allocator\n"
+              << "  --histograms <file>     with the full suite, write latency histograms as JSON\n"
+              << "  --profile <file>        with the full suite, write profiled call sites as folded stacks\n\n"
+              << "Driver options:\n"
+              << "  --allocators a,b,...    registered allocator ids, or all (default all)\n"
+              << "  --list-allocators       print the registered allocators and their parameters\n"
+              << "  --param id.name=value   construct allocator id with a non-default parameter\n"
+              << "  --tests t,...           alloc, batch, scaling, container, locality, or all (default alloc)\n"
+              << "  --sizes n,...           object sizes in bytes (default 256)\n"
+              << "  --threads n,...         thread counts for scaling (default 1,2,4,8)\n"
+              << "  --count n               objects per iteration (default 10000)\n"
+              << "  --iterations n          timed iterations, one sample each (default 10)\n"
+              << "  --warmup n              untimed iterations first (default 2)\n"
+              << "  --per-op                time every call as well (adds two clock reads per op)\n"
+              << "  --format table|json|csv output format (default table)\n"
+              << "  --output <file>         write json/csv there instead of stdout\n"
+              << "  --baseline <file>       compare against an earlier --format json export\n"
+              << "  --threshold <percent>   smallest significant change to flag (default 5)\n\n"
+              << "With --baseline the exit status is 2 when any regression is flagged.\n";
+}
+
+void print_allocator_list(std::ostream& out) {
+    for (const AllocatorDescriptor& entry : AllocatorRegistry::instance().entries()) {
+        const AllocatorCapabilities& caps = entry.capabilities;
+        out << std::left << std::setw(20) << entry.id << std::right << entry.display_name;
+        std::string flags;
+        if (caps.thread_safe) flags += " thread-safe";
+        if (!caps.arbitrary_free) flags += " lifo-free";
+        if (caps.fixed_size) flags += " fixed-size";
+        if (caps.numa_bindable) flags += " numa";
+        if (!flags.empty()) out << "  [" << flags.substr(1) << "]";
+        out << "\n";
+        for (const AllocatorParameter& parameter : entry.parameters) {
+            out << "    " << std::left << std::setw(18) << parameter.name << std::right << "default "
+                << parameter.default_value << ", " << parameter.description << "\n";
+        }
+    }
+}
+
+std::vector<std::string> split_list(const std::string& text) {
+    std::vector<std::string> items;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t comma = text.find(',', start);
+        if (comma == std::string::npos) comma = text.size();
+        if (comma > start) items.push_back(text.substr(start, comma - start));
+        start = comma + 1;
+    }
+    return items;
+}
+
+bool parse_size(const std::string& text, size_t& out) {
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) return false;
+    out = static_cast<size_t>(std::strtoull(text.c_str(), nullptr, 10));
+    return true;
+}
+
+bool parse_size_list(const std::string& text, std::vector<size_t>& out) {
+    out.clear();
+    for (const std::string& item : split_list(text)) {
+        size_t value = 0;
+        if (!parse_size(item, value) || value == 0) return false;
+        out.push_back(value);
+    }
+    return !out.empty();
+}
+
+// False with error set on a bad option; --trace, --histograms and --profile are left to main
+bool parse_driver_options(int argc, char** argv, DriverOptions& options, std::string& error) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            options.help = true;
+            continue;
+        }
+        if (arg == "--list-allocators") {
+            options.list_allocators = true;
+            continue;
+        }
+        if (arg == "--per-op") {
+            options.enabled = options.per_op = true;
+            options.given.emplace_back("per_op", "true");
+            continue;
+        }
+        if (i + 1 >= argc) {
+            error = "missing value for " + arg;
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--trace" || arg == "--histograms" || arg == "--profile") continue;
+
+        options.enabled = true;
+        options.given.emplace_back(arg.substr(2), value);
+        bool ok = true;
+        if (arg == "--allocators") {
+            options.allocators.clear();
+            for (const std::string& name : split_list(value)) {
+                if (name == "all") {
+                    for (const auto& entry : AllocatorRegistry::instance().entries()) {
+                        options.allocators.push_back(entry.id);
+                    }
+                } else if (AllocatorRegistry::instance().find(name)) {
+                    options.allocators.push_back(name);
+                } else {
+                    error = "unknown allocator '" + name + "' (see --list-allocators)";
+                    return false;
+                }
+            }
+        } else if (arg == "--param") {
+            size_t dot = value.find('.');
+            size_t equals = value.find('=');
+            size_t number = 0;
+            const AllocatorDescriptor* entry =
+                dot == std::string::npos ? nullptr : AllocatorRegistry::instance().find(value.substr(0, dot));
+            std::string name = equals == std::string::npos || equals < dot ? "" :
+                value.substr(dot + 1, equals - dot - 1);
+            ok = entry && AllocatorRegistry::find_parameter(*entry, name) &&
+                 parse_size(value.substr(equals + 1), number);
+            if (ok) {
+                auto it = std::find_if(options.params.begin(), options.params.end(),
+                                       [&](const auto& param) { return param.first == entry->id; });
+                if (it == options.params.end()) {
+                    options.params.emplace_back(entry->id, AllocatorParams{});
+                    it = options.params.end() - 1;
+                }
+                it->second.set(name, number);
+            }
+        } else if (arg == "--tests") {
+            options.tests.clear();
+            for (const std::string& name : split_list(value)) {
+                bool found = false;
+                for (const char* test : DRIVER_TESTS) {
+                    if (name == "all" || name == test) {
+                        options.tests.push_back(test);
+                        found = true;
+                    }
+                }
+                if (!found) {
+                    error = "unknown test '" + name + "'";
+                    return false;
+                }
+            }
+        } else if (arg == "--sizes") {
+            ok = parse_size_list(value, options.sizes);
+        } else if (arg == "--threads") {
+            ok = parse_size_list(value, options.threads);
+        } else if (arg == "--count") {
+            ok = parse_size(value, options.count) && options.count > 0;
+        } else if (arg == "--iterations") {
+            ok = parse_size(value, options.iterations) && options.iterations > 0;
+        } else if (arg == "--warmup") {
+            ok = parse_size(value, options.warmup);
+        } else if (arg == "--format") {
+            options.format = value;
+            ok = value == "table" || value == "json" || value == "csv";
+        } else if (arg == "--output") {
+            options.output = value;
+        } else if (arg == "--baseline") {
+            options.baseline = value;
+        } else if (arg == "--threshold") {
+            char* end = nullptr;
+            options.threshold = std::strtod(value.c_str(), &end);
+            ok = end && *end == '\0' && options.threshold >= 0;
+        } else {
+            error = "unknown option " + arg;
+            return false;
+        }
+        if (!ok) {
+            error = "invalid value '" + value + "' for " + arg;
+            return false;
+        }
+    }
+    if (options.allocators.empty()) {
+        for (const auto& entry : AllocatorRegistry::instance().entries()) options.allocators.push_back(entry.id);
+    }
+    return true;
+}
+
+ResultRecord make_record(const std::string& test, const std::string& allocator, const std::string& variant,
+                         const std::string& metric, const std::string& unit, const BenchmarkResult& result) {
+    ResultRecord record;
+    record.test = test;
+    record.allocator = allocator;
+    record.variant = variant;
+    record.metric = metric;
+    record.unit = unit;
+    record.result = result;
+    return record;
+}
+
+void add_allocation_records(ResultReport& report, const std::string& test, const std::string& variant,
+                            const BenchmarkMetrics& metrics) {
+    report.add(make_record(test, metrics.allocator_name, variant, "alloc", "ns/op", metrics.alloc_iteration_time));
+    report.add(make_record(test, metrics.allocator_name, variant, "free", "ns/op", metrics.dealloc_iteration_time));
+}
+
+void run_driver_tests(Engine& engine, const DriverOptions& options, ResultReport& report) {
+    for (const std::string& test : options.tests) {
+        for (const std::string& id : options.allocators) {
+            engine.set_allocator(id);
+            const std::string name = engine.get_allocator()->name();
+
+            if (test == "alloc" || test == "batch" || test == "scaling") {
+                for (size_t size : options.sizes) {
+                    BenchmarkConfig config;
+                    config.object_size = size;
+                    config.object_count = options.count;
+                    config.iterations = options.iterations;
+                    config.warmup_iterations = options.warmup;
+                    config.alignment = 16;
+                    config.per_op_timing = options.per_op;
+                    // The stack can only release its top allocation
+                    if (!engine.current_descriptor().capabilities.arbitrary_free) {
+                        config.free_order = FreeOrder::LIFO;
+                    }
+                    std::string variant = "size=" + std::to_string(size);
+
+                    if (test == "alloc") {
+                        add_allocation_records(report, test, variant, engine.run_benchmark(config));
+                    } else if (test == "batch") {
+                        config.batch_size = 64;
+                        add_allocation_records(report, test, variant + " batch=64", engine.run_benchmark(config));
+                    } else {
+                        auto results = engine.run_thread_scaling(config, options.threads);
+                        for (size_t i = 0; i < results.size(); ++i) {
+                            add_allocation_records(report, test,
+                                                   variant + " threads=" + std::to_string(options.threads[i]),
+                                                   results[i]);
+                        }
+                    }
+                }
+            } else if (test == "container") {
+                ContainerConfig config;
+                config.iterations = std::max<size_t>(options.iterations, 2);
+                for (const auto& result : engine.run_container_benchmark(config)) {
+                    std::string variant = std::string(BenchmarkRunner::container_workload_name(result.workload)) +
+                        " / " + BenchmarkRunner::container_adapter_name(result.adapter);
+                    report.add(make_record(test, name, variant, "iteration", "ns", result.iteration_time));
+                }
+            } else if (test == "locality") {
+                LocalityConfig config;
+                config.passes = options.iterations;
+                for (const auto& result : engine.run_locality(config)) {
+                    const char* structure = LocalityBenchmark::structure_name(result.structure);
+                    report.add(make_record(test, name, structure, "sequential", "ns/node", result.sequential_time));
+                    report.add(make_record(test, name, structure, "random", "ns/node", result.random_time));
+                }
+            }
+        }
+    }
+}
+
+void print_report_table(const ResultReport& report, std::ostream& out) {
+    out << std::fixed << std::setprecision(2);
+    out << std::left << std::setw(52) << "  Test / allocator / variant" << std::setw(12) << "Metric"
+        << std::right << std::setw(12) << "Mean" << std::setw(20) << "95% CI" << std::setw(12) << "Median"
+        << std::setw(5) << "n" << std::endl;
+    for (const ResultRecord& record : report.records) {
+        const BenchmarkResult& r = record.result;
+        std::ostringstream ci;
+        ci << std::fixed << std::setprecision(2) << "[" << r.ci_low << ", " << r.ci_high << "]";
+        out << "  " << std::left << std::setw(50) << (record.test + " / " + record.allocator + " / " + record.variant)
+            << std::setw(12) << record.metric << std::right << std::setw(12) << r.mean
+            << std::setw(20) << ci.str() << std::setw(12) << r.median << std::setw(5) << r.sample_count
+            << "  " << record.unit << std::endl;
+    }
+}
+
+// Returns the number of regressions
+size_t print_comparison(const ResultReport& report, const ResultReport& baseline, double threshold,
+                        std::ostream& out) {
+    std::vector<std::string> differences = report.environment.differences(baseline.environment);
+    if (!differences.empty()) {
+        out << "\nWarning: baseline environment differs in";
+        for (const std::string& field : differences) out << " " << field;
+        out << "\n";
+    }
+    // Output and comparison options do not change what was measured
+    auto measured = [](const std::vector<std::pair<std::string, std::string>>& settings) {
+        std::vector<std::pair<std::string, std::string>> kept;
+        for (const auto& setting : settings) {
+            if (setting.first != "format" && setting.first != "output" && setting.first != "baseline" &&
+                setting.first != "threshold") {
+                kept.push_back(setting);
+            }
+        }
+        return kept;
+    };
+    if (measured(report.settings) != measured(baseline.settings)) {
+        out << "Warning: baseline was run with different settings\n";
+    }
+
+    std::vector<ResultChange> changes = report.compare(baseline, threshold);
+    size_t regressions = 0, improvements = 0;
+    out << "\n=== Baseline Comparison (" << baseline.environment.timestamp << ", threshold "
+        << threshold << "%) ===\n";
+    out << std::fixed << std::setprecision(2);
+    for (const ResultChange& change : changes) {
+        if (change.regression) regressions++;
+        if (change.improvement) improvements++;
+        out << "  " << std::left << std::setw(62) << change.current.key() << std::right
+            << std::setw(10) << change.baseline.result.mean << " -> " << std::setw(10) << change.current.result.mean
+            << std::setw(9) << std::showpos << change.comparison.change_percent << std::noshowpos << "%"
+            << (change.regression ? "  REGRESSION" : change.improvement ? "  improved" :
+                change.comparison.significant ? "  (significant, below threshold)" : "") << std::endl;
+    }
+    out << "  " << changes.size() << " matched of " << report.records.size() << " records: "
+        << regressions << " regressed, " << improvements << " improved" << std::endl;
+    return regressions;
+}
+
+int run_driver(Engine& engine, const DriverOptions& options) {
+    // Machine-readable output on stdout keeps the log on stderr
+    const bool data_on_stdout = options.format != "table" && options.output.empty();
+    std::ostream& log = data_on_stdout ? std::cerr : std::cout;
+
+    ResultReport baseline;
+    if (!options.baseline.empty()) {
+        std::string error;
+        if (!ResultReport::load_json(options.baseline, baseline, &error)) {
+            std::cerr << "Cannot load baseline: " << error << std::endl;
+            return 1;
+        }
+    }
+
+    for (const auto& param : options.params) {
+        if (!engine.configure_allocator(param.first, param.second)) {
+            std::cerr << "Cannot construct " << param.first << " with the given --param values" << std::endl;
+            return 1;
+        }
+    }
+
+    ResultReport report;
+    report.environment = EnvironmentInfo::collect();
+    report.settings = options.given;
+    run_driver_tests(engine, options, report);
+
+    if (options.format == "table") {
+        print_report_table(report, std::cout);
+    } else {
+        std::string text = options.format == "json" ? report.to_json() : report.to_csv();
+        if (options.output.empty()) {
+            std::cout << text;
+        } else {
+            std::ofstream out(options.output);
+            out << text;
+            if (!out) {
+                std::cerr << "Cannot write " << options.output << std::endl;
+                return 1;
+            }
+            print_report_table(report, log);
+            log << "\n" << report.records.size() << " results written to " << options.output << std::endl;
+        }
+    }
+
+    if (options.baseline.empty()) return 0;
+    return print_comparison(report, baseline, options.threshold, log) ? 2 : 0;
+}
+
+int main(int argc, char** argv) {
+    DriverOptions options;
+    std::string option_error;
+    if (!parse_driver_options(argc, argv, options, option_error)) {
+        std::cerr << option_error << "\n\n";
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (options.help) {
+        print_usage(argv[0]);
+        return 0;
+    }
+    if (options.list_allocators) {
+        print_allocator_list(std::cout);
+        return 0;
+    }
+    if (options.enabled) {
+        Engine engine;
+        return run_driver(engine, options);
+    }
+
     std::cout << "\nMemory Engine Diagnostics Suite - Native Test\n";
     print_separator();
 
     Engine engine;
+
+    const TimerCalibration& clock = Timer::calibration();
+    std::cout << "Timer: " << clock.backend << std::fixed << std::setprecision(3)
+              << " (" << clock.ticks_per_ns << " ticks/ns, overhead " << clock.overhead_ns
+              << " ns subtracted per sample)\n";
+    std::cout << "SIMD: " << Simd::backend() << "\n";
+
+    // --histograms <file>: write every allocator's latency histograms as JSON
+    // --profile <file>: write the allocation profile below as folded stacks (flamegraph.pl, speedscope)
+    const char* histogram_path = nullptr;
+    const char* profile_path = nullptr;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--histograms") == 0) histogram_path = argv[i + 1];
+        if (std::strcmp(argv[i], "--profile") == 0) profile_path = argv[i + 1];
+    }
+
+    // memory_engine_test --trace <file>: replay a recorded trace against every allocator
+    if (argc >= 3 && std::strcmp(argv[1], "--trace") == 0) {
+        std::cout << "\n=== Trace Replay: " << argv[2] << " ===\n";
+        for (const auto& entry : engine.registry().entries()) {
+            engine.set_allocator(entry.id);
+            print_trace_results(engine.run_trace_replay(argv[2]));
+        }
+        print_separator();
+        return 0;
+    }
     BenchmarkConfig config;
     config.object_size = 256;
     config.object_count = 10000;
@@ -48,17 +764,149 @@ int main() {
     // Test each allocator
     std::cout << "\n=== Allocator Benchmarks ===\n";
     
-    AllocatorType allocators[] = {
+    std::string histogram_json = "{\"allocators\":[";
+    for (const auto& entry : engine.registry().entries()) {
+        engine.set_allocator(entry.id);
+        BenchmarkConfig run = config;
+        // The stack can only release its top allocation
+        if (!entry.capabilities.arbitrary_free) run.free_order = FreeOrder::LIFO;
+        auto metrics = engine.run_benchmark(run);
+        print_benchmark_results(metrics);
+
+        if (histogram_json.back() != '[') histogram_json += ',';
+        histogram_json += "{\"name\":\"" + metrics.allocator_name +
+            "\",\"alloc\":" + metrics.alloc_latency.to_json() +
+            ",\"dealloc\":" + metrics.dealloc_latency.to_json() + "}";
+    }
+    histogram_json += "]}";
+
+    if (histogram_path) {
+        std::ofstream out(histogram_path);
+        out << histogram_json << std::endl;
+        std::cout << "\nLatency histograms written to " << histogram_path << std::endl;
+    }
+
+    // Why the allocators differ: hardware events per operation
+    std::cout << "\n=== Hardware Counters (per op) ===\n";
+    BenchmarkConfig counted = config;
+    counted.per_op_timing = false;
+    counted.perf_counters = true;
+    bool counters_printed = false;
+    for (auto type : {AllocatorType::RAW_MALLOC, AllocatorType::POOL, AllocatorType::BITMAP,
+                      AllocatorType::FREELIST, AllocatorType::SIZE_CLASS}) {
+        engine.set_allocator(type);
+        auto metrics = engine.run_benchmark(counted);
+        print_perf_counters(metrics.allocator_name + " alloc", metrics.alloc_counters, !counters_printed);
+        print_perf_counters(metrics.allocator_name + " free", metrics.dealloc_counters, false);
+        counters_printed = true;
+    }
+
+    // Cost of the instrumentation itself, same pool under each policy
+    std::cout << "\n=== Instrumentation Overhead (Pool, median of 7 rounds) ===\n";
+    print_policy_overhead(config);
+
+    // Per-call virtual dispatch and bookkeeping vs. one allocate_batch per 64 objects
+    std::cout << "\n=== Batch API (alloc, 64 per batch) ===\n";
+    print_batch_comparison(engine, AllocatorType::POOL, config);
+    print_batch_comparison(engine, AllocatorType::BITMAP, config);
+    print_batch_comparison(engine, AllocatorType::STACK, config);
+    print_batch_comparison(engine, AllocatorType::FREELIST, config);
+
+    // Churn patterns: sizes, lifetimes and free order drawn from distributions
+    std::vector<WorkloadConfig> workloads(3);
+    workloads[0].name = "Uniform 16-4096, exponential lifetimes";
+    workloads[1].name = "Power-law sizes, generational lifetimes";
+    workloads[1].size_distribution = SizeDistribution::POWER_LAW;
+    workloads[1].lifetime_model = LifetimeModel::GENERATIONAL;
+    workloads[2].name = "Bimodal 32/2048, random free order";
+    workloads[2].size_distribution = SizeDistribution::BIMODAL;
+    workloads[2].free_order = FreeOrder::RANDOM;
+    workloads[2].object_count = 20000;
+
+    AllocatorType workload_allocators[] = {
+        AllocatorType::RAW_MALLOC,
         AllocatorType::STANDARD,
+        AllocatorType::STACK,
+        AllocatorType::FREELIST,
+        AllocatorType::SIZE_CLASS
+    };
+
+    for (const auto& workload : workloads) {
+        std::cout << "\n=== Workload: " << workload.name << " ===\n";
+        for (auto type : workload_allocators) {
+            engine.set_allocator(type);
+            print_workload_row(engine.run_workload(workload));
+        }
+    }
+
+    // Pool, arena and fit-policy sweep over the power-law workload; * marks the Pareto front
+    std::cout << "\n=== Auto-Tune: " << workloads[1].name << " ===\n";
+    WorkloadConfig tune_workload = workloads[1];
+    tune_workload.object_count = 50000;
+    print_auto_tune(engine.auto_tune(tune_workload));
+
+    // std containers on each allocator through the pmr and STL adapters
+    ContainerConfig containers;
+    containers.iterations = 3;
+    AllocatorType container_allocators[] = {
         AllocatorType::POOL,
         AllocatorType::STACK,
-        AllocatorType::FREELIST
+        AllocatorType::FREELIST,
+        AllocatorType::SIZE_CLASS
     };
 
-    for (auto type : allocators) {
+    for (auto type : container_allocators) {
         engine.set_allocator(type);
-        auto metrics = engine.run_benchmark(config);
-        print_benchmark_results(metrics);
+        auto results = engine.run_container_benchmark(containers);
+        std::cout << "\n=== Containers: " << engine.get_allocator()->name() << " ===\n";
+        std::cout << std::left << std::setw(34) << "  Workload / adapter" << std::right << std::setw(14) << "Ops/s"
+                  << std::setw(10) << "Speedup" << std::setw(11) << "Fallback" << std::endl;
+        for (const auto& result : results) {
+            std::string label = std::string(BenchmarkRunner::container_workload_name(result.workload)) + " / " +
+                BenchmarkRunner::container_adapter_name(result.adapter);
+            std::cout << "  " << std::left << std::setw(32) << label << std::right
+                      << std::setw(14) << result.throughput
+                      << std::setw(9) << result.speedup << "x"
+                      << std::setw(11) << result.fallback_allocations << std::endl;
+        }
+    }
+
+    // Which call sites allocate what, and for how long: one container run, sampled
+    ProfilerConfig profiling;
+    profiling.interval = 4096;
+    engine.set_allocator(AllocatorType::SIZE_CLASS);
+    if (engine.set_profiling(true, profiling)) {
+        ContainerConfig profiled = containers;
+        profiled.iterations = 1;
+        engine.run_container_benchmark(profiled);
+        engine.set_profiling(false);
+        std::cout << "\n=== Allocation Profile: " << engine.get_allocator()->name()
+                  << " containers, 1 sample per 4 KB ===\n";
+        print_profile_sites(*engine.profiler(), 8);
+        if (profile_path) {
+            std::ofstream out(profile_path);
+            out << engine.profiler()->folded(ProfileMetric::BYTES);
+            std::cout << "\nFolded stacks written to " << profile_path << std::endl;
+        }
+    } else {
+        engine.set_profiling(false);
+        std::cout << "\n=== Allocation Profile: skipped, built without profiler hooks ===\n";
+    }
+
+    // Multi-threaded scaling on a shared allocator
+    std::cout << "\n=== Thread Scaling ===\n";
+
+    const std::vector<size_t> thread_counts = {1, 2, 4, 8, 16};
+    AllocatorType scaling_allocators[] = {
+        AllocatorType::RAW_MALLOC,
+        AllocatorType::STANDARD,
+        AllocatorType::THREAD_CACHED_POOL,
+        AllocatorType::MULTI_ARENA
+    };
+
+    for (auto type : scaling_allocators) {
+        engine.set_allocator(type);
+        print_scaling_results(engine.run_thread_scaling(config, thread_counts));
     }
 
     // Test concurrency
@@ -75,6 +923,169 @@ int main() {
     auto atomic_result = engine.run_concurrency_test(ConcurrencyTest::ATOMIC_PERFORMANCE, cc);
     print_concurrency_results(atomic_result);
 
+    // Spawning a thread per task vs. dispatching to the persistent pool
+    ConcurrencyConfig spawn_config = cc;
+    spawn_config.iterations = 200;
+    for (auto test : {ConcurrencyTest::THREAD_CREATION, ConcurrencyTest::TASK_SCHEDULING}) {
+        auto result = engine.run_concurrency_test(test, spawn_config);
+        print_concurrency_results(result);
+        std::cout << "  Start p50/p99:  " << result.start_latency.percentile(50.0) << " / "
+                  << result.start_latency.percentile(99.0) << " ns" << std::endl;
+    }
+
+    // Same handoff test for each queue; storage comes from the size-class allocator
+    std::cout << "\n=== Producer-Consumer Queues ===\n";
+    engine.set_allocator(AllocatorType::SIZE_CLASS);
+    ConcurrencyConfig qc;
+    qc.iterations = 100000;
+    qc.producers = 2;
+    qc.consumers = 2;
+    for (auto kind : {QueueKind::MUTEX, QueueKind::MPMC_RING, QueueKind::SPSC_RING, QueueKind::SEGMENTED}) {
+        qc.queue = kind;
+        auto result = engine.run_concurrency_test(ConcurrencyTest::PRODUCER_CONSUMER, qc);
+        print_concurrency_results(result);
+        std::cout << "  Handoff p50/p99:    " << result.handoff_latency.percentile(50.0) << " / "
+                  << result.handoff_latency.percentile(99.0) << " ns (" << result.items << " items)" << std::endl;
+    }
+
+    // Producer allocates, consumer frees: every free is remote. The standard
+    // allocator is serialized behind a mutex; the multi-arena allocator
+    // routes frees back to the owning arena through its remote-free list.
+    std::cout << "\n=== Cross-Thread Free (64 B objects) ===\n";
+    ConcurrencyConfig cross;
+    cross.thread_count = 8;
+    cross.iterations = 100000;
+    std::cout << std::left << std::setw(64) << "  Test" << std::right << std::setw(10) << "Mops/s"
+              << std::setw(12) << "Free p50" << std::setw(12) << "Free p99" << std::setw(12) << "vs Standard"
+              << std::endl;
+    std::vector<double> standard_throughput;
+    for (auto type : {AllocatorType::STANDARD, AllocatorType::THREAD_CACHED_POOL, AllocatorType::MULTI_ARENA}) {
+        engine.set_allocator(type);
+        auto results = engine.run_cross_thread_sweep(cross);
+        if (type == AllocatorType::STANDARD) {
+            for (const auto& result : results) standard_throughput.push_back(result.throughput);
+        }
+        for (size_t i = 0; i < results.size(); ++i) {
+            const auto& result = results[i];
+            double baseline = i < standard_throughput.size() ? standard_throughput[i] : 0;
+            std::cout << "  " << std::left << std::setw(62) << result.test_name << std::right
+                      << std::setw(10) << result.throughput / 1e6
+                      << std::setw(12) << result.free_latency.percentile(50.0)
+                      << std::setw(12) << result.free_latency.percentile(99.0)
+                      << std::setw(11) << (baseline > 0 ? result.throughput / baseline : 0) << "x" << std::endl;
+        }
+    }
+
+    // Which lock to wrap a non-thread-safe allocator in, per thread count
+    std::cout << "\n=== Lock Shootout (30% reads) ===\n";
+    ConcurrencyConfig locks;
+    locks.thread_count = 4;
+    locks.iterations = 20000;
+    locks.work_size = 20;
+    locks.read_ratio = 0.3;
+    std::cout << std::left << std::setw(44) << "  Test" << std::right << std::setw(12) << "Mops/s"
+              << std::setw(14) << "Acquire p50" << std::setw(14) << "Acquire p99" << std::endl;
+    for (const auto& result : engine.run_lock_sweep(locks)) {
+        std::cout << "  " << std::left << std::setw(42) << result.test_name << std::right
+                  << std::setw(12) << result.throughput / 1e6
+                  << std::setw(14) << result.acquire_latency.percentile(50.0)
+                  << std::setw(14) << result.acquire_latency.percentile(99.0) << std::endl;
+    }
+
+    // Reference data for laying out shared statistics
+    std::cout << "\n=== Counter Layout / Memory Order ===\n";
+    ConcurrencyConfig counters;
+    counters.thread_count = 4;
+    counters.iterations = 1000000;
+    std::cout << std::left << std::setw(40) << "  Test" << std::right << std::setw(14) << "Mops/s"
+              << std::setw(14) << "Combine ns" << std::endl;
+    for (const auto& result : engine.run_counter_sweep(counters)) {
+        std::cout << "  " << std::left << std::setw(38) << result.test_name << std::right
+                  << std::setw(14) << result.throughput / 1e6
+                  << std::setw(14) << result.combine_time_ns << std::endl;
+    }
+
+    // Typical request: 64 allocations of 16-512 bytes, a quarter of them objects
+    std::cout << "\n=== Request Bursts (64 allocations per request) ===\n";
+    RequestBurstConfig burst;
+    burst.requests = 5000;
+    std::cout << std::left << std::setw(32) << "  Allocator" << std::right << std::setw(14) << "Requests/s"
+              << std::setw(12) << "p50 ns" << std::setw(12) << "p99 ns" << std::endl;
+    for (const auto& result : engine.run_request_burst(burst)) {
+        std::cout << "  " << std::left << std::setw(30) << result.allocator_name << std::right
+                  << std::setw(14) << result.throughput
+                  << std::setw(12) << result.request_latency.percentile(50.0)
+                  << std::setw(12) << result.request_latency.percentile(99.0) << std::endl;
+    }
+
+    // Same nodes, churned, then walked; the pool is sized to the node so
+    // only its free-list order differs from the bump layout
+    std::cout << "\n=== Traversal Locality (64 B nodes, 2 churn rounds of 10%) ===\n";
+    LocalityConfig locality;
+    AllocatorType locality_allocators[] = {
+        AllocatorType::RAW_MALLOC,
+        AllocatorType::STANDARD,
+        AllocatorType::STACK,
+        AllocatorType::FREELIST,
+        AllocatorType::SIZE_CLASS
+    };
+    for (auto type : locality_allocators) {
+        engine.set_allocator(type);
+        print_locality_results(engine.run_locality(locality));
+    }
+    {
+        PoolAllocator node_pool(locality.node_size, locality.node_count);
+        print_locality_results(LocalityBenchmark().run(node_pool, locality));
+        BitmapAllocator node_bitmap(locality.node_size, locality.node_count);
+        print_locality_results(LocalityBenchmark().run(node_bitmap, locality));
+    }
+
+    // Reserve-and-commit arenas vs. one fixed buffer, 64 MB filled each
+    std::cout << "\n=== Virtual Arenas (64 MB fill) ===\n";
+    std::cout << std::left << std::setw(32) << "  Backend" << std::right << std::setw(13) << "Construct"
+              << std::setw(13) << "Fill" << std::setw(10) << "Filled" << std::setw(10) << "RSS"
+              << std::setw(10) << "Reset" << "  Pages" << std::endl;
+    {
+        double construct_ns = 0;
+        std::unique_ptr<StackAllocator> fixed;
+        {
+            ScopedTimer timer(construct_ns);
+            fixed = std::make_unique<StackAllocator>(MemoryUtils::MB(64) + MemoryUtils::MB(1));
+        }
+        print_arena_fill("fixed aligned_alloc", *fixed, MemoryUtils::MB(64), construct_ns, "");
+    }
+    for (auto mode : {HugePages::NONE, HugePages::TRANSPARENT, HugePages::EXPLICIT}) {
+        VirtualArenaConfig arena;
+        arena.reserve_size = MemoryUtils::GB(1);
+        arena.huge_pages = mode;
+        double construct_ns = 0;
+        std::unique_ptr<StackAllocator> growable;
+        {
+            ScopedTimer timer(construct_ns);
+            growable = std::make_unique<StackAllocator>(arena);
+        }
+        std::string label = std::string("1 GB reserve, ") + huge_pages_name(mode);
+        print_arena_fill(label.c_str(), *growable, MemoryUtils::MB(64), construct_ns,
+                         huge_pages_name(growable->arena().huge_pages()));
+    }
+
+    // Local vs. remote arenas; one row per CPU node / memory node pair
+    std::cout << "\n=== NUMA Locality (" << Numa::node_count() << " node"
+              << (Numa::node_count() == 1 ? "" : "s") << ") ===\n";
+    NumaConfig numa;
+    numa.thread_count = 2;
+    numa.blocks_per_round = 65536;
+    numa.rounds = 5;
+    std::cout << std::left << std::setw(48) << "  Test" << std::right << std::setw(10) << "GB/s"
+              << std::setw(12) << "Penalty %" << "  Placement" << std::endl;
+    for (const auto& result : engine.run_numa_locality(numa)) {
+        std::cout << "  " << std::left << std::setw(46) << result.test_name << std::right
+                  << std::setw(10) << result.bandwidth_gbps
+                  << std::setw(12) << result.remote_penalty << "  "
+                  << (result.pinned ? "pinned" : "unpinned") << ", "
+                  << (result.bound ? "bound" : "first-touch") << std::endl;
+    }
+
     print_separator();
     std::cout << "Tests complete.\n" << std::endl;
 
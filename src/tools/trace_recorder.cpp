@@ -0,0 +1,209 @@
+/**
+ * @file trace_recorder.cpp
+ * @brief LD_PRELOAD allocation trace recorder (Linux/glibc)
+ *
+ * Build as a shared library and preload it into the process to capture:
+ *
+ *   MEMORY_ENGINE_TRACE=/tmp/service.trace LD_PRELOAD=./libmemory_engine_trace_recorder.so ./service
+ *
+ * Without MEMORY_ENGINE_TRACE the trace goes to memory_engine.<pid>.trace in
+ * the working directory. The output replays with TraceReplayer.
+ *
+ * Calls are forwarded to glibc's __libc_* entry points, which avoids the
+ * dlsym bootstrap problem. Records go into one process-wide buffer under a
+ * spin lock so the file order matches the real order of frees and address
+ * reuse across threads; the buffer is written out every RECORDS_PER_BUFFER
+ * records. Frees are recorded before the real free so an address can never
+ * be handed out again before its release is in the trace. Nested calls (from
+ * the recorder itself or from libc while writing) are forwarded untraced.
+ */
+
+#include "../core/benchmarks/trace_format.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <malloc.h>
+#include <sched.h>
+#include <unistd.h>
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+}
+
+namespace {
+
+using memory_engine::TraceFileHeader;
+using memory_engine::TraceOp;
+using memory_engine::TraceRecord;
+
+constexpr size_t RECORDS_PER_BUFFER = 4096;
+constexpr size_t MAX_RECORDED_ALIGNMENT = 32768;
+
+int g_fd = -1;
+std::atomic<bool> g_enabled{false};
+std::atomic<uint32_t> g_next_thread_id{1};
+std::atomic_flag g_lock = ATOMIC_FLAG_INIT;
+uint64_t g_record_count = 0;
+size_t g_buffered = 0;
+TraceRecord g_records[RECORDS_PER_BUFFER];
+
+// initial-exec keeps TLS access from calling back into malloc
+__attribute__((tls_model("initial-exec"))) thread_local uint32_t t_thread_id = 0;
+__attribute__((tls_model("initial-exec"))) thread_local bool t_in_recorder = false;
+
+void spin_lock() {
+    for (unsigned spins = 0; g_lock.test_and_set(std::memory_order_acquire); ++spins) {
+        if (spins > 64) sched_yield(); // Holder is probably inside write()
+    }
+}
+
+void spin_unlock() {
+    g_lock.clear(std::memory_order_release);
+}
+
+// Caller holds g_lock
+void flush_locked() {
+    const char* p = reinterpret_cast<const char*>(g_records);
+    size_t bytes = g_buffered * sizeof(TraceRecord);
+    while (bytes > 0) {
+        ssize_t written = ::write(g_fd, p, bytes);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            g_enabled.store(false, std::memory_order_relaxed);
+            break;
+        }
+        p += written;
+        bytes -= static_cast<size_t>(written);
+    }
+    g_record_count += g_buffered;
+    g_buffered = 0;
+}
+
+void record(TraceOp op, const void* ptr, size_t size, size_t alignment) {
+    if (!g_enabled.load(std::memory_order_relaxed) || t_in_recorder || !ptr) return;
+    t_in_recorder = true;
+
+    if (t_thread_id == 0) {
+        t_thread_id = g_next_thread_id.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    spin_lock();
+    if (g_enabled.load(std::memory_order_relaxed)) {
+        TraceRecord& r = g_records[g_buffered++];
+        r.object_id = reinterpret_cast<uint64_t>(ptr);
+        r.size = size;
+        r.thread_id = t_thread_id;
+        r.alignment = static_cast<uint16_t>(alignment > MAX_RECORDED_ALIGNMENT ? MAX_RECORDED_ALIGNMENT : alignment);
+        r.op = static_cast<uint8_t>(op);
+        r.reserved = 0;
+        if (g_buffered == RECORDS_PER_BUFFER) flush_locked();
+    }
+    spin_unlock();
+
+    t_in_recorder = false;
+}
+
+void write_header(uint64_t record_count) {
+    TraceFileHeader header{};
+    std::memcpy(header.magic, memory_engine::TRACE_MAGIC, sizeof(header.magic));
+    header.version = memory_engine::TRACE_VERSION;
+    header.record_size = sizeof(TraceRecord);
+    header.record_count = record_count;
+    (void)::pwrite(g_fd, &header, sizeof(header), 0);
+}
+
+__attribute__((constructor)) void recorder_init() {
+    t_in_recorder = true;
+
+    char default_path[64];
+    const char* path = std::getenv("MEMORY_ENGINE_TRACE");
+    if (!path || !*path) {
+        std::snprintf(default_path, sizeof(default_path), "memory_engine.%d.trace", static_cast<int>(getpid()));
+        path = default_path;
+    }
+
+    g_fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (g_fd >= 0) {
+        write_header(0);
+        ::lseek(g_fd, sizeof(TraceFileHeader), SEEK_SET);
+        g_enabled.store(true, std::memory_order_release);
+    }
+
+    t_in_recorder = false;
+}
+
+// Writes what is buffered and patches the record count into the header
+__attribute__((destructor)) void recorder_shutdown() {
+    if (g_fd < 0) return;
+    t_in_recorder = true;
+
+    spin_lock();
+    flush_locked();
+    g_enabled.store(false, std::memory_order_relaxed);
+    write_header(g_record_count);
+    ::close(g_fd);
+    g_fd = -1;
+    spin_unlock();
+}
+
+} // namespace
+
+extern "C" {
+
+void* malloc(size_t size) {
+    void* ptr = __libc_malloc(size);
+    record(TraceOp::ALLOCATE, ptr, size, 0);
+    return ptr;
+}
+
+void* calloc(size_t count, size_t size) {
+    void* ptr = __libc_calloc(count, size);
+    record(TraceOp::ALLOCATE, ptr, count * size, 0);
+    return ptr;
+}
+
+void* realloc(void* old_ptr, size_t size) {
+    // The old block may be released inside realloc, so record that first
+    size_t old_size = old_ptr ? malloc_usable_size(old_ptr) : 0;
+    record(TraceOp::DEALLOCATE, old_ptr, 0, 0);
+    void* ptr = __libc_realloc(old_ptr, size);
+    if (!ptr && size != 0) {
+        record(TraceOp::ALLOCATE, old_ptr, old_size, 0); // Failed: old block is still live
+    }
+    record(TraceOp::ALLOCATE, ptr, size, 0);
+    return ptr;
+}
+
+void free(void* ptr) {
+    record(TraceOp::DEALLOCATE, ptr, 0, 0);
+    __libc_free(ptr);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    void* ptr = __libc_memalign(alignment, size);
+    record(TraceOp::ALLOCATE, ptr, size, alignment);
+    return ptr;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    return memalign(alignment, size);
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size) {
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) return EINVAL;
+    void* ptr = __libc_memalign(alignment, size);
+    if (!ptr) return ENOMEM;
+    record(TraceOp::ALLOCATE, ptr, size, alignment);
+    *out = ptr;
+    return 0;
+}
+
+} // extern "C"
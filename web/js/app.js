@@ -6,6 +6,19 @@ import { Visualizer } from './visualizer.js';
 import { MetricsDisplay } from './metrics.js';
 import { Controls } from './controls.js';
 
+// Shown until the WASM module lists its registry; demoCost scales the simulated latency
+const DEMO_ALLOCATORS = [
+    { id: 'standard', name: 'Standard (new/delete)', demoCost: 1.5 },
+    { id: 'pool', name: 'Pool Allocator', demoCost: 0.3 },
+    { id: 'bitmap', name: 'Bitmap Allocator', demoCost: 0.35 },
+    { id: 'stack', name: 'Stack Allocator', demoCost: 0.2 },
+    { id: 'freelist', name: 'Free List Allocator', demoCost: 0.8 },
+    { id: 'thread_cached_pool', name: 'Thread-Cached Pool Allocator', demoCost: 0.35 },
+    { id: 'multi_arena', name: 'Multi-Arena Free List Allocator', demoCost: 0.85 },
+    { id: 'size_class', name: 'Size-Class Allocator', demoCost: 0.4 },
+    { id: 'raw_malloc', name: 'Raw malloc', demoCost: 1.2 }
+];
+
 class MemoryEngineApp {
     constructor() {
         this.visualizer = null;
@@ -13,7 +26,9 @@ class MemoryEngineApp {
         this.controls = null;
         this.wasmModule = null;
         this.isRunning = false;
-        this.currentAllocator = 1;
+        this.cancelRequested = false;
+        this.allocators = DEMO_ALLOCATORS;
+        this.currentAllocator = 'pool';
         this.currentTest = 1;
     }
 
@@ -27,10 +42,13 @@ class MemoryEngineApp {
 
         // Try to load WASM module
         await this.loadWasmModule();
+        this.controls.renderAllocators(this.allocators, this.currentAllocator);
+        this.setAllocator(this.currentAllocator);
 
         // Initialize visualization
         this.visualizer.init();
         this.visualizer.generateDemoGrid();
+        this.startOccupancyLoop();
 
         // Setup pressure bars
         this.metrics.initPressureBars();
@@ -44,7 +62,10 @@ class MemoryEngineApp {
             // Check if WASM is available
             if (typeof Module !== 'undefined') {
                 this.wasmModule = Module;
-                this.log('init', '[Init] WebAssembly module loaded.');
+                if (this.wasmModule.listAllocators) {
+                    this.allocators = this.wasmModule.listAllocators();
+                }
+                this.log('init', `[Init] WebAssembly module loaded, ${this.allocators.length} allocators registered.`);
             } else {
                 this.log('warmup', '[System] Running in demo mode (WASM not available).');
             }
@@ -53,15 +74,43 @@ class MemoryEngineApp {
         }
     }
 
-    setAllocator(type) {
-        this.currentAllocator = type;
+    // Redraw the grid from the engine's occupancy map whenever it changes.
+    // One version poll per frame; the map itself is a view, not a copy.
+    startOccupancyLoop() {
+        const wasm = this.wasmModule;
+        if (!wasm || !wasm.getOccupancy) return;
+
+        wasm.setOccupancyTracking(true);
+        let drawn = null;
+        const frame = () => {
+            const key = `${this.currentAllocator}:${wasm.getOccupancyVersion()}`;
+            if (key !== drawn || this.visualizer.needsRedraw) {
+                drawn = key;
+                this.visualizer.setOccupancy(wasm.getOccupancy());
+            }
+            requestAnimationFrame(frame);
+        };
+        requestAnimationFrame(frame);
+    }
 
-        if (this.wasmModule && this.wasmModule.setAllocator) {
-            this.wasmModule.setAllocator(type);
+    setAllocator(id) {
+        if (this.wasmModule && this.wasmModule.setAllocator && !this.wasmModule.setAllocator(id)) {
+            this.log('system', `[Error] Unknown allocator: ${id}`);
+            return;
         }
+        this.currentAllocator = id;
 
-        const allocatorNames = ['Standard (new/delete)', 'Pool Allocator', 'Stack Allocator', 'Free List Allocator'];
-        this.log('config', `[Config] Allocator: ${allocatorNames[type]}`);
+        const allocator = this.findAllocator(id);
+        this.log('config', `[Config] Allocator: ${allocator ? allocator.name : id}`);
+    }
+
+    findAllocator(id) {
+        return this.allocators.find(allocator => allocator.id === id);
+    }
+
+    demoCost() {
+        const demo = DEMO_ALLOCATORS.find(allocator => allocator.id === this.currentAllocator);
+        return demo ? demo.demoCost : 1;
     }
 
     setConcurrencyTest(type) {
@@ -74,8 +123,10 @@ class MemoryEngineApp {
         if (this.isRunning) return;
 
         this.isRunning = true;
+        this.cancelRequested = false;
         this.updateStatus('RUNNING');
         document.body.classList.add('running');
+        this.controls.setRunning(true);
 
         const config = this.controls.getConfig();
 
@@ -84,7 +135,7 @@ class MemoryEngineApp {
         this.log('init', `[Init] Allocated ${config.objectCount.toLocaleString()} objects, size ${this.getObjectSizeName(config.objectSize)}.`);
 
         // Simulate benchmark if no WASM
-        if (!this.wasmModule || !this.wasmModule.runBenchmark) {
+        if (!this.wasmModule || !this.wasmModule.startBenchmark) {
             await this.runDemoBenchmark(config);
         } else {
             await this.runRealBenchmark(config);
@@ -93,6 +144,45 @@ class MemoryEngineApp {
         this.isRunning = false;
         this.updateStatus('NOMINAL');
         document.body.classList.remove('running');
+        this.controls.setRunning(false);
+    }
+
+    // Allocation benchmarks stop after the current iteration; a concurrency
+    // test already under way finishes first
+    cancelSuite() {
+        if (!this.isRunning || this.cancelRequested) return;
+        this.cancelRequested = true;
+        if (this.wasmModule && this.wasmModule.cancelBenchmark) this.wasmModule.cancelBenchmark();
+        this.log('warmup', '[Cancel] Stopping after the current iteration...');
+    }
+
+    // Starts a job on the engine's worker thread and drains its progress once
+    // per frame, so the page stays responsive (and the occupancy grid live)
+    // for the whole run. Resolves with the result, or null if it did not start.
+    runJob(start) {
+        const wasm = this.wasmModule;
+        if (!start()) return Promise.resolve(null);
+
+        let lastDecile = -1;
+        return new Promise(resolve => {
+            const frame = () => {
+                const progress = wasm.pollProgress();
+                for (const event of progress.events) {
+                    this.updateStatus(`RUNNING ${event.percent}%`);
+                    const decile = Math.floor(event.percent / 10);
+                    if (decile !== lastDecile) {
+                        lastDecile = decile;
+                        this.log('system', `[Progress] ${event.percent}% ${event.status}`);
+                    }
+                }
+                if (progress.state === 'running') {
+                    requestAnimationFrame(frame);
+                } else {
+                    resolve(wasm.takeResult());
+                }
+            };
+            requestAnimationFrame(frame);
+        });
     }
 
     async runDemoBenchmark(config) {
@@ -100,6 +190,10 @@ class MemoryEngineApp {
         const stepDelay = 50;
 
         for (let step = 0; step < totalSteps; step++) {
+            if (this.cancelRequested) {
+                this.log('warmup', '[Cancel] Benchmark cancelled.');
+                return;
+            }
             await this.delay(stepDelay);
 
             // Update visualization
@@ -121,12 +215,17 @@ class MemoryEngineApp {
     }
 
     async runRealBenchmark(config) {
-        const result = this.wasmModule.runBenchmark(
+        const wasm = this.wasmModule;
+        const result = await this.runJob(() => wasm.startBenchmark(
             config.objectSize,
             config.objectCount,
             config.iterations,
             config.alignment
-        );
+        ));
+        if (!result) {
+            this.log('system', '[Error] Benchmark could not start: another run is in progress.');
+            return;
+        }
 
         this.metrics.update({
             latency: result.meanAllocTime,
@@ -138,20 +237,26 @@ class MemoryEngineApp {
             peakDepth: 0
         });
 
+        if (result.cancelled || this.cancelRequested) {
+            this.log('warmup', '[Cancel] Benchmark cancelled; metrics cover the completed iterations.');
+            return;
+        }
+        this.log('init', `[Complete] Benchmark finished. Latency: ${result.meanAllocTime.toFixed(1)}ns`);
+
         // Run concurrency test
-        const concurrencyResult = this.wasmModule.runConcurrencyTest(
+        const concurrencyResult = await this.runJob(() => wasm.startConcurrencyTest(
             this.currentTest,
             config.threads,
             config.iterations,
             100
-        );
+        ));
 
-        this.metrics.updateConcurrency(concurrencyResult);
+        if (concurrencyResult) this.metrics.updateConcurrency(concurrencyResult);
     }
 
     generateDemoMetrics(progress, config) {
         const baseLatency = 20 + Math.random() * 30;
-        const allocatorMultiplier = [1.5, 0.3, 0.2, 0.8][this.currentAllocator];
+        const allocatorMultiplier = this.demoCost();
 
         return {
             latency: baseLatency * allocatorMultiplier * (1 + progress * 0.5),
@@ -165,7 +270,7 @@ class MemoryEngineApp {
     }
 
     generateFinalMetrics(config) {
-        const allocatorMultiplier = [1.5, 0.3, 0.2, 0.8][this.currentAllocator];
+        const allocatorMultiplier = this.demoCost();
         const baseLatency = 41.4;
 
         return {
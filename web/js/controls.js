@@ -19,17 +19,36 @@ class Controls {
         const container = document.getElementById('allocator-buttons');
         if (!container) return;
 
-        container.querySelectorAll('.btn').forEach(btn => {
-            btn.addEventListener('click', () => {
-                container.querySelectorAll('.btn').forEach(b => b.classList.remove('active'));
-                btn.classList.add('active');
-
-                const allocatorType = parseInt(btn.dataset.allocator);
-                this.app.setAllocator(allocatorType);
-            });
+        // Buttons are rebuilt from the registry, so listen on the container
+        container.addEventListener('click', event => {
+            const btn = event.target.closest('.btn');
+            if (!btn || !container.contains(btn)) return;
+
+            container.querySelectorAll('.btn').forEach(b => b.classList.remove('active'));
+            btn.classList.add('active');
+            this.app.setAllocator(btn.dataset.allocator);
         });
     }
 
+    renderAllocators(allocators, activeId) {
+        const container = document.getElementById('allocator-buttons');
+        if (!container) return;
+
+        container.replaceChildren(...allocators.map(allocator => {
+            const btn = document.createElement('button');
+            btn.className = 'btn' + (allocator.id === activeId ? ' active' : '');
+            btn.dataset.allocator = allocator.id;
+            btn.textContent = allocator.name;
+
+            const traits = [];
+            if (allocator.threadSafe) traits.push('thread-safe');
+            if (allocator.arbitraryFree === false) traits.push('LIFO frees only');
+            if (allocator.fixedSize) traits.push('fixed size');
+            if (traits.length) btn.title = traits.join(', ');
+            return btn;
+        }));
+    }
+
     setupConcurrencyButtons() {
         const container = document.getElementById('concurrency-buttons');
         if (!container) return;
@@ -81,11 +100,24 @@ class Controls {
         const runBtn = document.getElementById('run-btn');
         if (!runBtn) return;
 
+        // The same button cancels a run in progress
         runBtn.addEventListener('click', () => {
-            this.app.runSuite();
+            if (this.app.isRunning) {
+                this.app.cancelSuite();
+            } else {
+                this.app.runSuite();
+            }
         });
     }
 
+    setRunning(running) {
+        const runBtn = document.getElementById('run-btn');
+        if (!runBtn) return;
+        runBtn.innerHTML = running
+            ? '<span class="btn-icon">■</span>\n                    CANCEL'
+            : '<span class="btn-icon">▶</span>\n                    RUN SUITE';
+    }
+
     getConfig() {
         return {
             objectSize: parseInt(document.getElementById('object-size')?.value || 4096),
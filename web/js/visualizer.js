@@ -15,6 +15,8 @@ class Visualizer {
         this.cellGap = 2;
         this.columns = 0;
         this.rows = 0;
+        this.live = false;          // Drawing engine occupancy rather than the demo pattern
+        this.needsRedraw = false;
     }
 
     init() {
@@ -31,7 +33,11 @@ class Visualizer {
             this.columns = Math.floor(rect.width / (this.cellSize + this.cellGap));
             this.rows = Math.floor(rect.height / (this.cellSize + this.cellGap));
 
-            this.generateDemoGrid();
+            if (this.live) {
+                this.needsRedraw = true;
+            } else {
+                this.generateDemoGrid();
+            }
         }
 
         if (this.graphCanvas) {
@@ -174,6 +180,42 @@ class Visualizer {
         ctx.stroke();
     }
 
+    /**
+     * Draw an occupancy map from getOccupancy(). Each on-screen cell shows the
+     * mean level of the arena cells it covers; the cell holding the
+     * high-water mark is outlined.
+     */
+    setOccupancy(view) {
+        const levels = view.levels;
+        const shown = Math.min(this.columns * this.rows, levels ? levels.length : 0);
+        this.live = true;
+        this.needsRedraw = false;
+        if (shown === 0) {
+            // No map for this allocator; don't leave the previous one on screen
+            this.gridData = [];
+            this.drawGrid();
+            return;
+        }
+
+        if (this.gridData.length !== shown) {
+            this.gridData = Array.from({ length: shown }, () => ({ allocated: false, active: false, intensity: 0 }));
+        }
+        const highWaterCell = view.span ? Math.min(shown - 1, Math.floor(view.highWater / view.span * shown)) : -1;
+
+        for (let i = 0; i < shown; i++) {
+            const start = Math.floor(i * levels.length / shown);
+            const end = Math.max(start + 1, Math.floor((i + 1) * levels.length / shown));
+            let sum = 0;
+            for (let j = start; j < end; j++) sum += levels[j];
+
+            const cell = this.gridData[i];
+            cell.intensity = sum / ((end - start) * 255);
+            cell.allocated = sum > 0;
+            cell.active = view.highWater > 0 && i === highWaterCell;
+        }
+        this.drawGrid();
+    }
+
     setGridFromData(boolArray) {
         this.gridData = boolArray.map(allocated => ({
             allocated,